@@ -22,5 +22,5 @@ TRICK_CFLAGS += --std=c++11 ${INCLUDES} -g -D_GNU_SOURCE -DCONFIG_HIL_ENABLE
 TRICK_CFLAGS += -Wall -Wmissing-prototypes -Wextra -Wshadow
 TRICK_CXXFLAGS += --std=c++11 ${INCLUDES} -g -DCONFIG_HIL_ENABLE
 TRICK_CXXFLAGS += -Wall -Wextra -Wshadow -Wno-narrowing
-TRICK_USER_LINK_LIBS += -larmadillo -lboost_serialization -lbiodaq
+TRICK_USER_LINK_LIBS += -larmadillo -lboost_serialization -lbiodaq -lrt
 MAKEFLAGS += -j16
@@ -14,5 +14,5 @@ TRICK_CFLAGS += ${INCLUDES} -g -D_GNU_SOURCE -DCONFIG_SAMPLE_SDT_ENABLE
 TRICK_CFLAGS += -Wall -Wmissing-prototypes -Wextra -Wshadow
 TRICK_CXXFLAGS += --std=c++11 ${INCLUDES} -g
 TRICK_CXXFLAGS += -Wall -Wextra -Wshadow -Wno-narrowing
-TRICK_USER_LINK_LIBS += -larmadillo -lboost_serialization -lbiodaq
+TRICK_USER_LINK_LIBS += -larmadillo -lboost_serialization -lbiodaq -lrt
 MAKEFLAGS += -j16
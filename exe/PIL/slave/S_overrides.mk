@@ -17,5 +17,5 @@ TRICK_CFLAGS += --std=c++11 ${INCLUDES} -g -D_GNU_SOURCE -DCONFIG_PIL_ENABLE
 TRICK_CFLAGS += -Wall -Wmissing-prototypes -Wextra -Wshadow
 TRICK_CXXFLAGS += --std=c++11 ${INCLUDES} -g -DCONFIG_PIL_ENABLE
 TRICK_CXXFLAGS += -Wall -Wextra -Wshadow
-TRICK_USER_LINK_LIBS += -larmadillo -lboost_serialization
+TRICK_USER_LINK_LIBS += -larmadillo -lboost_serialization -lrt
 MAKEFLAGS += -j16
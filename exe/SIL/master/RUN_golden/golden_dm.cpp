@@ -12,6 +12,7 @@
 #include "../../../xil_common/include/realtime.h"
 #include "../../../xil_common/include/flight_events_handler.h"
 #include "../../../xil_common/include/sirius_utility.h"
+#include "../../../xil_common/include/icf_transport.h"
 
 extern "C" int run_me() {
     record_nspo();
@@ -21,6 +22,7 @@ extern "C" int run_me() {
     // external_clock_switch(&rkt.ext_clk);
     // realtime();
     master_startup(&rkt);
+    icf_transport_switch(&rkt.icf_ctrl);
     fprintf(stderr, "time_tic_value = %d tics per seconds\n", exec_get_time_tic_value());
     fprintf(stderr, "software_frame = %lf second per frame.\n", exec_get_software_frame());
     fprintf(stderr, "software_frame_tics = %lld tics per_frame\n", exec_get_software_frame_tics());
@@ -1,6 +1,11 @@
 #!/bin/bash
 set -e
 
+# --shm: master and slave talk over shared memory instead of TCP loopback
+if [ "$1" == "--shm" ]; then
+    export SIRIUS_ICF_TRANSPORT=shm
+fi
+
 SCRIPT_FILE_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
 SIM_HOME_PATH=$(echo $SCRIPT_FILE_DIR | sed 's/\/exe\/SIL\/master//g')
 S_DEFINE_PATH=$SCRIPT_FILE_DIR
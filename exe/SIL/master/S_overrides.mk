@@ -20,5 +20,5 @@ TRICK_CFLAGS += --std=c++11 ${INCLUDES} -g -D_GNU_SOURCE -DCONFIG_SIL_ENABLE
 TRICK_CFLAGS += -Wall -Wmissing-prototypes -Wextra -Wshadow
 TRICK_CXXFLAGS += --std=c++11 ${INCLUDES} -g -DCONFIG_SIL_ENABLE
 TRICK_CXXFLAGS += -Wall -Wextra -Wshadow
-TRICK_USER_LINK_LIBS += -larmadillo -lboost_serialization -lgsl -lgslcblas
+TRICK_USER_LINK_LIBS += -larmadillo -lboost_serialization -lgsl -lgslcblas -lrt
 MAKEFLAGS += -j16
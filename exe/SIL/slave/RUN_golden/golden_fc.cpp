@@ -7,11 +7,13 @@
 #include "../../../xil_common/include/realtime.h"
 #include "../../../xil_common/Modified_data/gps_fc.h"
 #include "../../../xil_common/include/flight_events_trigger.h"
+#include "../../../xil_common/include/icf_transport.h"
 
 extern "C" int run_me() {
     record_gps_slave();
     // realtime();
     slave_init_time(&fc);
+    icf_transport_switch(&fc.icf_esps_ctrl);
     /* INS */
     slave_init_ins_variable(&fc);
     /* GPS */
@@ -22,5 +22,7 @@ cd $SIM_HOME_PATH/exe/SIL/master
 make clean
 cd $SIM_HOME_PATH/exe/SIL/slave
 make clean
+cd $SIM_HOME_PATH/exe/monte_batch
+make clean
 $SIM_HOME_PATH/exe/xil_common/script/clean_script.sh $SIM_HOME_PATH/exe/
 set +x
@@ -0,0 +1,147 @@
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "checkpoint.hh"
+#include "trajectory.hh"
+#include "egse_configuration.h"
+
+/*
+ * A restored trajectory flies on as the one it was saved from.
+ *
+ * One dispersed run is flown uninterrupted to the terminate time. The same
+ * run is flown again to each branch time, checkpointed through a file, and
+ * restored into a freshly built trajectory which flies on to the terminate
+ * time. Its record and its final checkpoint image must be the uninterrupted
+ * ones bit for bit. The branch times straddle liftoff, hot staging and S3
+ * separation, so the restore also crosses the aero deck switch.
+ *
+ * Usage: checkpoint_test [aux_dir]
+ */
+
+static const double BRANCH_TIMES[] = { 1.0, 30.05, 101.3, 130.0 };
+static const uint64_t SEED = 7;
+static const uint64_t RUN = 3;
+
+static double elapsed(const struct timespec &since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since.tv_sec) + (now.tv_nsec - since.tv_nsec) * 1e-9;
+}
+
+static int read_text(const std::string &path, std::string &text) {
+    FILE *fp = fopen(path.c_str(), "r");
+    if (!fp) {
+        fprintf(stderr, "[%s:%d] Cannot open %s\n", __FUNCTION__, __LINE__, path.c_str());
+        return -1;
+    }
+    char buf[4096];
+    size_t n;
+    text.clear();
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+        text.append(buf, n);
+    fclose(fp);
+    return 0;
+}
+
+static int make_dir(const std::string &dir) {
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "[%s:%d] Cannot create %s: %s\n", __FUNCTION__, __LINE__, dir.c_str(), strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    Trajectory::options_t opt;
+    opt.aux_dir = argc > 1 ? argv[1] : "../../auxiliary";
+    opt.ideal = false;
+    opt.record_cycle = 1.0;
+
+    GPS_constellation ephemeris;
+    ephemeris.readfile((opt.aux_dir + "/" + egse_config::RINEX_NAV).c_str());
+    dispersion_t disp;
+    draw_dispersion(&disp, SEED, RUN);
+
+    const std::string dir = "checkpoint_test_out";
+    if (make_dir(dir) != 0 || make_dir(dir + "/whole") != 0)
+        return 1;
+
+    std::vector<char> whole_image;
+    std::string whole_record;
+    {
+        Trajectory whole(opt, ephemeris, disp, SEED, RUN);
+        if (whole.run(dir + "/whole") != 0)
+            return 1;
+        whole.save_checkpoint(whole_image);
+    }
+    if (read_text(dir + "/whole/log_rocket_csv.csv", whole_record) != 0)
+        return 1;
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(BRANCH_TIMES) / sizeof(BRANCH_TIMES[0]); i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/branch_%g", BRANCH_TIMES[i]);
+        const std::string branch_dir = dir + name;
+        const std::string file = branch_dir + "/branch.ckpt";
+        if (make_dir(branch_dir) != 0)
+            return 1;
+
+        std::vector<char> image;
+        double save_time;
+        {
+            Trajectory trunk(opt, ephemeris, disp, SEED, RUN);
+            trunk.fly_to(BRANCH_TIMES[i]);
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            trunk.save_checkpoint(image);
+            save_time = elapsed(start);
+            if (Checkpoint::write_file(file.c_str(), image) != 0)
+                return 1;
+        }
+
+        std::vector<char> read_back;
+        if (Checkpoint::read_file(file.c_str(), read_back) != 0)
+            return 1;
+
+        Trajectory branch(opt, ephemeris, disp, SEED, RUN);
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (branch.restore_checkpoint(read_back) != 0) {
+            fprintf(stderr, "FAIL branch at %g s: restore\n", BRANCH_TIMES[i]);
+            failures++;
+            continue;
+        }
+        double restore_time = elapsed(start);
+        if (branch.run(branch_dir) != 0)
+            return 1;
+
+        std::vector<char> branch_image;
+        std::string branch_record;
+        branch.save_checkpoint(branch_image);
+        if (read_text(branch_dir + "/log_rocket_csv.csv", branch_record) != 0)
+            return 1;
+
+        /* the rows of the branch, from the branch point on, end the uninterrupted record */
+        std::string rows = branch_record.substr(branch_record.find('\n') + 1);
+        bool record_ok = !rows.empty() && whole_record.size() > rows.size()
+                         && whole_record.compare(whole_record.size() - rows.size(), rows.size(), rows) == 0;
+        bool image_ok = branch_image.size() == whole_image.size()
+                        && memcmp(branch_image.data(), whole_image.data(), whole_image.size()) == 0;
+        if (!record_ok || !image_ok)
+            failures++;
+        printf("%s branch at %7.2f s: %zu bytes, save %.1f us, restore %.1f us, record %s, final state %s\n",
+               record_ok && image_ok ? "PASS" : "FAIL", BRANCH_TIMES[i], image.size(),
+               save_time * 1e6, restore_time * 1e6,
+               record_ok ? "identical" : "differs", image_ok ? "identical" : "differs");
+    }
+
+    printf("%s\n", failures ? "checkpoint_test FAILED" : "checkpoint_test passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+#include <getopt.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "datadeck.hh"
+#include "checkpoint.hh"
+#include "trajectory.hh"
+#include "egse_configuration.h"
+
+/*
+ * In-process Monte Carlo batch of the SIL golden run.
+ *
+ * RUN_monte/monte.py runs every dispersion as a Trick MonteSlave: a process
+ * with its own S_define initialization, deck parsing, RINEX reading and
+ * master/slave handshake. Here the runs are Trajectory objects stepped by a
+ * pool of threads in one process. The decks are compiled once and mapped by
+ * every trajectory, the broadcast ephemerides are read once and copied.
+ *
+ * Usage: monte_batch [-n runs] [-j threads] [-s seed] [-o dir] [-a aux_dir]
+ *                    [-r record_cycle] [-b time | -c file] [--ideal]
+ *
+ * Run i writes <dir>/RUN_<i>/log_rocket_csv.csv in the format of the golden
+ * record (Modified_data/golden.h), read by tools/plot_landing_point.py;
+ * <dir>/monte_runs lists the dispersions of every run.
+ *
+ * With -b every run branches from a common state instead of starting at
+ * t = 0: a trunk trajectory without dispersion is flown to the branch time
+ * and checkpointed into <dir>/branch.ckpt, each run restores it with its own
+ * static dispersion and sensor noise stream and flies on. -c branches from
+ * a branch.ckpt of an earlier batch.
+ */
+
+/* auxiliary/ seen from exe/monte_batch */
+static const char DEFAULT_AUX_DIR[] = "../../auxiliary";
+
+static const char *DECKS[] = {
+    egse_config::AERO_S2_DECK,
+    egse_config::AERO_S3_DECK,
+    egse_config::PROP_DECK,
+};
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [-n runs] [-j threads] [-s seed] [-o dir] [-a aux_dir] [-r record_cycle]\n"
+            "          [-b time | -c file] [--ideal]\n"
+            "  -n runs          number of dispersed runs (20)\n"
+            "  -j threads       worker threads (online CPUs)\n"
+            "  -s seed          dispersion and sensor noise seed (0)\n"
+            "  -o dir           output directory (MONTE_RUN_batch)\n"
+            "  -a aux_dir       auxiliary/ directory (%s)\n"
+            "  -r record_cycle  recording cycle - s, 0 records the landing point only (0)\n"
+            "  -b time          branch the runs from an undispersed trunk flown to time - s\n"
+            "  -c file          branch the runs from the checkpoint file of an earlier -b\n"
+            "  --ideal          ideal sensors, no dispersion\n",
+            name, DEFAULT_AUX_DIR);
+}
+
+static int make_dir(const std::string &dir) {
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "[%s:%d] Cannot create %s: %s\n", __FUNCTION__, __LINE__, dir.c_str(), strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+/* Compile a deck into its '.bdeck' sibling unless an up-to-date one exists */
+static void compile_deck(const std::string &text) {
+    std::string compiled = text + ".bdeck";
+    struct stat text_stat, compiled_stat;
+
+    if (stat(text.c_str(), &text_stat) != 0)
+        return;
+    if (stat(compiled.c_str(), &compiled_stat) == 0 && compiled_stat.st_mtime >= text_stat.st_mtime)
+        return;
+    Datadeck deck(text.c_str());
+    if (deck.save_binary(compiled.c_str()) != 0)
+        fprintf(stderr, "[%s:%d] %s is parsed by every run\n", __FUNCTION__, __LINE__, text.c_str());
+}
+
+static void write_monte_runs(const std::string &dir, const std::vector<dispersion_t> &disp) {
+    std::string path = dir + "/monte_runs";
+    FILE *fp = fopen(path.c_str(), "w");
+    if (!fp) {
+        fprintf(stderr, "[%s:%d] Cannot open %s\n", __FUNCTION__, __LINE__, path.c_str());
+        return;
+    }
+    fprintf(fp, "#run_num");
+    for (int i = 0; i < 3; i++) fprintf(fp, " emisa[%d]", i);
+    for (int i = 0; i < 3; i++) fprintf(fp, " escala[%d]", i);
+    for (int i = 0; i < 3; i++) fprintf(fp, " ebiasa[%d]", i);
+    for (int i = 0; i < 3; i++) fprintf(fp, " emisg[%d]", i);
+    for (int i = 0; i < 3; i++) fprintf(fp, " escalg[%d]", i);
+    for (int i = 0; i < 3; i++) fprintf(fp, " ebiasg[%d]", i);
+    fprintf(fp, " ucfreq_noise ucbias_error");
+    for (int i = 0; i < 4; i++) fprintf(fp, " PR_BIAS[%d]", i);
+    for (int i = 0; i < 4; i++) fprintf(fp, " PR_NOISE[%d]", i);
+    for (int i = 0; i < 4; i++) fprintf(fp, " DR_NOISE[%d]", i);
+    fputc('\n', fp);
+
+    for (size_t run = 0; run < disp.size(); run++) {
+        const double *v = &disp[run].EMISA[0];
+        fprintf(fp, "%05zu", run);
+        for (size_t i = 0; i < sizeof(dispersion_t) / sizeof(double); i++)
+            fprintf(fp, " %.16g", v[i]);
+        fputc('\n', fp);
+    }
+    fclose(fp);
+}
+
+/* Fly the undispersed trunk to the branch time, or read its checkpoint */
+static int make_branch(const Trajectory::options_t &opt, const GPS_constellation &ephemeris, uint64_t seed,
+                       double branch_time, const std::string &branch_file, const std::string &out_dir,
+                       std::vector<char> &image) {
+    if (!branch_file.empty())
+        return Checkpoint::read_file(branch_file.c_str(), image);
+
+    dispersion_t none;
+    memset(&none, 0, sizeof(none));
+    Trajectory trunk(opt, ephemeris, none, seed, 0);
+    trunk.fly_to(branch_time);
+    trunk.save_checkpoint(image);
+    return Checkpoint::write_file((out_dir + "/branch.ckpt").c_str(), image);
+}
+
+static double elapsed(clockid_t clock, const struct timespec &since) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (now.tv_sec - since.tv_sec) + (now.tv_nsec - since.tv_nsec) * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+    int runs = 20;
+    int threads = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+    uint64_t seed = 0;
+    std::string out_dir = "MONTE_RUN_batch";
+    Trajectory::options_t opt;
+    opt.aux_dir = DEFAULT_AUX_DIR;
+    opt.ideal = false;
+    opt.record_cycle = 0.0;
+    double branch_time = -1.0;
+    std::string branch_file;
+
+    static const struct option long_options[] = {
+        { "ideal", no_argument, NULL, 'i' },
+        { "help",  no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "n:j:s:o:a:r:b:c:h", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'n': runs = atoi(optarg); break;
+            case 'j': threads = atoi(optarg); break;
+            case 's': seed = strtoull(optarg, NULL, 0); break;
+            case 'o': out_dir = optarg; break;
+            case 'a': opt.aux_dir = optarg; break;
+            case 'r': opt.record_cycle = atof(optarg); break;
+            case 'b': branch_time = atof(optarg); break;
+            case 'c': branch_file = optarg; break;
+            case 'i': opt.ideal = true; break;
+            default:
+                usage(argv[0]);
+                return c == 'h' ? 0 : 1;
+        }
+    }
+    if (runs <= 0 || threads <= 0 || (branch_time >= 0 && !branch_file.empty())) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (threads > runs)
+        threads = runs;
+
+    struct timespec wall_start, cpu_start;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_start);
+
+    /* read-only inputs shared by the runs */
+    for (size_t i = 0; i < sizeof(DECKS) / sizeof(DECKS[0]); i++)
+        compile_deck(opt.aux_dir + "/" + DECKS[i]);
+    GPS_constellation ephemeris;
+    ephemeris.readfile((opt.aux_dir + "/" + egse_config::RINEX_NAV).c_str());
+
+    std::vector<dispersion_t> disp(runs);
+    for (int run = 0; run < runs; run++) {
+        if (opt.ideal)
+            memset(&disp[run], 0, sizeof(dispersion_t));
+        else
+            draw_dispersion(&disp[run], seed, run);
+    }
+
+    if (make_dir(out_dir) != 0)
+        return 1;
+    write_monte_runs(out_dir, disp);
+
+    fprintf(stderr, "** Monte Carlo batch: %d runs on %d threads, seed %llu%s **\n",
+            runs, threads, static_cast<unsigned long long>(seed), opt.ideal ? ", ideal sensors" : "");
+
+    std::vector<char> branch;
+    if (branch_time >= 0 || !branch_file.empty()) {
+        if (make_branch(opt, ephemeris, seed, branch_time, branch_file, out_dir, branch) != 0)
+            return 1;
+        fprintf(stderr, "runs branch from a %zu byte checkpoint\n", branch.size());
+    }
+
+    std::atomic<int> next_run(0);
+    std::atomic<int> failed(0);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.push_back(std::thread([&]() {
+            int run;
+            while ((run = next_run.fetch_add(1)) < runs) {
+                char name[32];
+                snprintf(name, sizeof(name), "/RUN_%05d", run);
+                std::string run_dir = out_dir + name;
+                if (make_dir(run_dir) != 0) {
+                    failed++;
+                    continue;
+                }
+                Trajectory trajectory(opt, ephemeris, disp[run], seed, run);
+                if (!branch.empty()) {
+                    if (trajectory.restore_checkpoint(branch) != 0) {
+                        failed++;
+                        continue;
+                    }
+                    trajectory.reseed_noise(seed, run);
+                }
+                if (trajectory.run(run_dir) != 0)
+                    failed++;
+            }
+        }));
+    }
+    for (size_t t = 0; t < pool.size(); t++)
+        pool[t].join();
+
+    double wall = elapsed(CLOCK_MONOTONIC, wall_start);
+    double cpu = elapsed(CLOCK_PROCESS_CPUTIME_ID, cpu_start);
+    int done = runs - failed;
+    fprintf(stderr, "%d/%d runs in %.3f s wall, %.3f s CPU\n", done, runs, wall, cpu);
+    if (cpu > 0)
+        fprintf(stderr, "%.1f trajectories per core-hour, %.1f per hour on %d threads\n",
+                done * 3600.0 / cpu, done * 3600.0 / wall, threads);
+
+    return failed ? 1 : 0;
+}
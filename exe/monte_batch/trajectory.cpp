@@ -0,0 +1,542 @@
+#include "trajectory.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "gyro/gyro_ideal.hh"
+#include "gyro/gyro_rocket6g.hh"
+#include "accel/accelerometer_ideal.hh"
+#include "accel/accelerometer_rocket6g.hh"
+#include "sdt/SDT_IDEAL.hh"
+#include "stochastic.hh"
+
+#include "egse_configuration.h"
+#include "fc_configuration.h"
+
+const double Trajectory::FC_CYCLE = 0.05;
+
+static thread_local double thread_sim_time = 0.0;
+
+void set_thread_sim_time(double t) {
+    thread_sim_time = t;
+}
+
+/* The Trick executive services the models call, answered per thread */
+extern "C" double get_rettime(void) {
+    return thread_sim_time;
+}
+
+extern "C" double exec_get_sim_time(void) {
+    return thread_sim_time;
+}
+
+void draw_dispersion(dispersion_t *d, uint64_t seed, uint64_t run) {
+    RngStream rng(seed, run << 2);
+
+    for (int i = 0; i < 3; i++) d->EMISA[i]  = rng.gauss(0, 1.1e-4);
+    for (int i = 0; i < 3; i++) d->ESCALA[i] = rng.gauss(0, 5e-4);
+    for (int i = 0; i < 3; i++) d->EBIASA[i] = rng.gauss(0, 3.56e-3);
+    for (int i = 0; i < 3; i++) d->EMISG[i]  = rng.gauss(0, 1.1e-4);
+    for (int i = 0; i < 3; i++) d->ESCALG[i] = rng.gauss(0, 2e-5);
+    for (int i = 0; i < 3; i++) d->EBIASG[i] = rng.gauss(0, 1e-6);
+    d->ucfreq_noise = rng.gauss(0, 0.1);
+    d->ucbias_error = rng.gauss(0, 3);
+    for (int i = 0; i < 4; i++) d->PR_BIAS[i]  = rng.gauss(0, 0.842);
+    for (int i = 0; i < 4; i++) d->PR_NOISE[i] = rng.gauss(0, 0.25);
+    for (int i = 0; i < 4; i++) d->DR_NOISE[i] = rng.gauss(0, 0.03);
+}
+
+RocketObject::RocketObject()
+    :   propulsion  (  )      ,
+        tvc         (  ) ,
+        dynamics    (  ),
+        env         (  ) ,
+        forces      ( propulsion   , tvc ) ,
+        aerodynamics( propulsion ) ,
+        gyro(NULL),
+        accelerometer(NULL),
+        sdt(NULL),
+        gps_con     (  ) {
+    /* zeroed as the Trick sim object globals are */
+    memset(&dm_ins_db, 0, sizeof(dm_ins_db));
+    memset(&ctl_tvc_db, 0, sizeof(ctl_tvc_db));
+}
+
+RocketObject::~RocketObject() {
+    delete gyro;
+    delete accelerometer;
+    delete sdt;
+}
+
+void RocketObject::link() {
+    tvc.grab_theta_a_cmd       = GRAB_VAR(ctl_tvc_db.theta_a_cmd);
+    tvc.grab_theta_b_cmd       = GRAB_VAR(ctl_tvc_db.theta_b_cmd);
+    tvc.grab_theta_c_cmd       = GRAB_VAR(ctl_tvc_db.theta_c_cmd);
+    tvc.grab_theta_d_cmd       = GRAB_VAR(ctl_tvc_db.theta_d_cmd);
+
+    sdt->grab_WBICB            = LINK( *gyro   , get_computed_WBIB);
+    sdt->grab_FSPCB            = LINK( *accelerometer   , get_computed_FSPB);
+    sdt->grab_CONING           = LINK( dynamics , get_CONING);
+    sdt->grab_GHIGH            = LINK( *gyro   , get_HIGH);
+    sdt->grab_GLOW             = LINK( *gyro   , get_LOW);
+    sdt->grab_AHIGH            = LINK( *accelerometer   , get_HIGH);
+    sdt->grab_ALOW             = LINK( *accelerometer   , get_LOW);
+
+    tvc.grab_pdynmc            = LINK( env, get_pdynmc);
+    tvc.grab_xcg               = LINK( propulsion, get_xcg);
+    tvc.grab_thrust            = LINK( propulsion, get_thrust);
+    tvc.grab_alphax            = LINK( dynamics, get_alphax);
+    tvc.grab_TBI               = LINK( dynamics, get_TBI);
+    tvc.grab_SBII              = LINK( dynamics, get_SBII);
+
+    aerodynamics.grab_alppx    = LINK( dynamics, get_alppx);
+    aerodynamics.grab_phipx    = LINK( dynamics, get_phipx);
+    aerodynamics.grab_alphax   = LINK( dynamics, get_alphax);
+    aerodynamics.grab_betax    = LINK( dynamics, get_betax);
+    aerodynamics.grab_rho      = LINK( env, get_rho);
+    aerodynamics.grab_vmach    = LINK( env, get_vmach);
+    aerodynamics.grab_pdynmc   = LINK( env, get_pdynmc);
+    aerodynamics.grab_tempk    = LINK( env, get_tempk);
+    aerodynamics.grab_dvba     = LINK( env, get_dvba);
+    aerodynamics.grab_ppx      = LINK( dynamics, get_ppx);
+    aerodynamics.grab_qqx      = LINK( dynamics, get_qqx);
+    aerodynamics.grab_rrx      = LINK( dynamics, get_rrx);
+    aerodynamics.grab_WBIB     = LINK( dynamics, get_WBIB);
+    aerodynamics.grab_alt      = LINK( dynamics, get_alt);
+    aerodynamics.grab_xcg      = LINK( propulsion, get_xcg);
+    aerodynamics.grab_liftoff  = LINK( dynamics, get_liftoff);
+
+    env.grab_dvbe              = LINK( dynamics, get_dvbe);
+    env.grab_SBII              = LINK( dynamics, get_SBII);
+    env.grab_VBED              = LINK( dynamics, get_VBED);
+    env.grab_alt               = LINK( dynamics, get_alt);
+    env.grab_TGI               = LINK( dynamics, get_TGI);
+    env.grab_TBI               = LINK( dynamics, get_TBI);
+    env.grab_TBD               = LINK( dynamics, get_TBD);
+    env.grab_alppx             = LINK( dynamics, get_alppx);
+    env.grab_phipx             = LINK( dynamics, get_phipx);
+    env.grab_VBEE              = LINK( dynamics, get_VBEE);
+    env.grab_TDE               = LINK( dynamics, get_TDE);
+
+    forces.grab_pdynmc         = LINK( env, get_pdynmc);
+    forces.grab_thrust         = LINK( propulsion, get_thrust);
+    forces.grab_refa           = LINK( aerodynamics, get_refa);
+    forces.grab_refd           = LINK( aerodynamics, get_refd);
+    forces.grab_cy             = LINK( aerodynamics, get_cy);
+    forces.grab_cll            = LINK( aerodynamics, get_cll);
+    forces.grab_clm            = LINK( aerodynamics, get_clm);
+    forces.grab_cln            = LINK( aerodynamics, get_cln);
+    forces.grab_cx             = LINK( aerodynamics, get_cx);
+    forces.grab_cz             = LINK( aerodynamics, get_cz);
+    forces.grab_FPB            = LINK( tvc, get_FPB);
+    forces.grab_FMPB           = LINK( tvc, get_FMPB);
+    forces.grab_Q_TVC          = LINK( tvc, get_Q_TVC);
+    forces.grab_lx             = LINK( tvc, get_lx);
+    forces.grab_GRAVG          = LINK( env, get_GRAVG);
+    forces.grab_vmass          = LINK( propulsion, get_vmass);
+    forces.grab_TBI            = LINK( dynamics, get_TBI);
+    forces.grab_IBBB           = LINK( propulsion, get_IBBB);
+    forces.grab_WBIBD          = LINK( dynamics, get_WBIBD);
+    forces.grab_WBIB           = LINK( dynamics, get_WBIB);
+    forces.grab_ABII           = LINK( dynamics, get_ABII);
+    forces.grab_xcg_0          = LINK( propulsion, get_xcg_0);
+    forces.grab_xcp            = LINK( aerodynamics, get_xcp);
+    forces.grab_xcg            = LINK( propulsion, get_xcg);
+    forces.grab_oxidizer_mass  = LINK( propulsion, get_oxidizer_mass);
+    forces.grab_ang_slosh_theta = LINK( dynamics, get_ang_slosh_theta);
+    forces.grab_ang_slosh_psi = LINK( dynamics, get_ang_slosh_psi);
+    forces.grab_dang_slosh_theta = LINK( dynamics, get_dang_slosh_theta);
+    forces.grab_dang_slosh_psi = LINK( dynamics, get_dang_slosh_psi);
+    forces.grab_NEXT_ACC       = LINK( dynamics, get_NEXT_ACC);
+    forces.grab_liftoff        = LINK( dynamics, get_liftoff);
+    forces.grab_FSPB           = LINK( dynamics, get_FSPB);
+    forces.grab_dang_e1_B      = LINK(tvc, get_s2_act1_rate);
+    forces.grab_dang_e2_B      = LINK(tvc, get_s2_act2_rate);
+    forces.grab_dang_e3_B      = LINK(tvc, get_s2_act3_rate);
+    forces.grab_dang_e4_B      = LINK(tvc, get_s2_act4_rate);
+    forces.grab_ang_e1_theta   = LINK(tvc, get_s2_act1_y2_saturation);
+    forces.grab_ang_e2_psi     = LINK(tvc, get_s2_act2_y2_saturation);
+    forces.grab_ang_e3_theta   = LINK(tvc, get_s2_act3_y2_saturation);
+    forces.grab_ang_e4_psi     = LINK(tvc, get_s2_act4_y2_saturation);
+    forces.grab_e1_XCG         = LINK(propulsion, get_S2_E1_xcg);
+    forces.grab_e2_XCG         = LINK(propulsion, get_S2_E2_xcg);
+    forces.grab_e3_XCG         = LINK(propulsion, get_S2_E3_xcg);
+    forces.grab_e4_XCG         = LINK(propulsion, get_S2_E4_xcg);
+    forces.grab_e1_mass        = LINK(propulsion, get_S2_E1_mass);
+    forces.grab_e2_mass        = LINK(propulsion, get_S2_E2_mass);
+    forces.grab_e3_mass        = LINK(propulsion, get_S2_E3_mass);
+    forces.grab_e4_mass        = LINK(propulsion, get_S2_E4_mass);
+    forces.grab_I_S2_E1        = LINK(propulsion, get_I_S2_E1);
+    forces.grab_I_S2_E2        = LINK(propulsion, get_I_S2_E2);
+    forces.grab_I_S2_E3        = LINK(propulsion, get_I_S2_E3);
+    forces.grab_I_S2_E4        = LINK(propulsion, get_I_S2_E4);
+    forces.grab_s2_act1_acc    = LINK(tvc, get_s2_act1_acc);
+    forces.grab_s2_act2_acc    = LINK(tvc, get_s2_act2_acc);
+    forces.grab_s2_act3_acc    = LINK(tvc, get_s2_act3_acc);
+    forces.grab_s2_act4_acc    = LINK(tvc, get_s2_act4_acc);
+    forces.grab_structure_XCG  = LINK(propulsion, get_structure_XCG);
+
+    gps_con.grab_SBEE          = LINK( dynamics, get_SBEE);
+    gps_con.grab_TEI           = LINK( env, get_TEI);
+    gps_con.grab_phibdx        = LINK( dynamics, get_phibdx);
+    gps_con.grab_thtbdx        = LINK( dynamics, get_thtbdx);
+    gps_con.grab_psibdx        = LINK( dynamics, get_psibdx);
+    gps_con.grab_TBI           = LINK( dynamics, get_TBI);
+
+    dynamics.grab_TEI          = LINK( env, get_TEI);
+    dynamics.grab_dvba         = LINK( env, get_dvba);
+    dynamics.grab_VAED         = LINK( env, get_VAED);
+    dynamics.grab_FMB          = LINK( forces, get_FMB);
+    dynamics.grab_IBBB         = LINK( propulsion, get_IBBB);
+    dynamics.grab_vmass        = LINK( propulsion, get_vmass);
+    dynamics.grab_xcg_0        = LINK( propulsion, get_xcg_0);
+    dynamics.grab_FAPB         = LINK( forces, get_FAPB);
+    dynamics.grab_FAP          = LINK( forces, get_FAP);
+    dynamics.grab_GRAVG        = LINK( env, get_GRAVG);
+    dynamics.grab_grav         = LINK( env, get_grav);
+    dynamics.grab_ddrP_1       = LINK( forces, get_ddrP_1);
+    dynamics.grab_ddang_1      = LINK( forces, get_ddang_1);
+    dynamics.grab_thrust       = LINK( propulsion, get_thrust);
+    dynamics.grab_rhoC_1       = LINK( forces, get_rhoC_1);
+    dynamics.grab_ddrhoC_1     = LINK( forces, get_ddrhoC_1);
+    dynamics.collect_forces_and_propagate = LINK( forces, collect_forces_and_propagate);
+    dynamics.grab_ddang_slosh_theta = LINK( forces, get_ddang_slosh_theta);
+    dynamics.grab_ddang_slosh_psi = LINK( forces, get_ddang_slosh_psi);
+    dynamics.grab_Q_TVC        = LINK( tvc, get_Q_TVC);
+
+    accelerometer->grab_FSPB   = LINK( dynamics, get_FSPB);
+
+    gyro->grab_WBIB            = LINK( dynamics, get_WBIB);
+    gyro->grab_FSPB            = LINK( dynamics, get_FSPB);
+
+    propulsion.grab_press      = LINK( env, get_press);
+    propulsion.grab_SLOSH_CG   = LINK( forces, get_SLOSH_CG);
+    propulsion.grab_slosh_mass = LINK( forces, get_slosh_mass);
+    propulsion.grab_e1_XCG    = LINK( forces, get_e1_XCG);
+    propulsion.grab_e2_XCG    = LINK( forces, get_e2_XCG);
+    propulsion.grab_e3_XCG    = LINK( forces, get_e3_XCG);
+    propulsion.grab_e4_XCG    = LINK( forces, get_e4_XCG);
+    propulsion.grab_alt       = LINK( dynamics, get_alt);
+}
+
+/* In the order of the jobs, the ICF packets as the plain structs they are */
+void RocketObject::checkpoint(Checkpoint &cp) {
+    cp.section("RKT");
+    cp(int_step, stand_still_time, dm_ins_db, ctl_tvc_db, egse_flight_event_handler_bitmap,
+       flight_event_code_record);
+    dynamics.checkpoint(cp);
+    env.checkpoint(cp);
+    forces.checkpoint(cp);
+    propulsion.checkpoint(cp);
+    tvc.checkpoint(cp);
+    aerodynamics.checkpoint(cp);
+    gyro->checkpoint(cp);
+    accelerometer->checkpoint(cp);
+    sdt->checkpoint(cp);
+    gps_con.checkpoint(cp);
+}
+
+FlightComputerObject::FlightComputerObject()
+    :   ins(),
+        gps() {
+    memset(&dm_ins_db, 0, sizeof(dm_ins_db));
+    memset(&ins_ctl_db, 0, sizeof(ins_ctl_db));
+    memset(&ctl_tvc_db, 0, sizeof(ctl_tvc_db));
+    clear_flag();
+}
+
+Trajectory::Trajectory(const options_t &opt, const GPS_constellation &ephemeris, const dispersion_t &disp,
+                       uint64_t seed, uint64_t run)
+    :   opt(opt),
+        egse_clock(time_management::create()),
+        fc_clock(time_management::create()),
+        rkt(NULL),
+        fc(NULL),
+        fc_timed_events(0),
+        tics(0) {
+    memset(&downlink, 0, sizeof(downlink));
+    set_thread_sim_time(0.0);
+
+    time_management::set_thread_instance(egse_clock);
+    rkt = new RocketObject;
+    time_management::set_thread_instance(fc_clock);
+    fc = new FlightComputerObject;
+    time_management::set_thread_instance(NULL);
+
+    init_rocket(ephemeris, disp, seed, run);
+    init_flight_computer(disp);
+}
+
+Trajectory::~Trajectory() {
+    delete fc;
+    delete rkt;
+    delete fc_clock;
+    delete egse_clock;
+}
+
+/* RUN_golden/golden.cpp run_me() and the initialization jobs of the master */
+void Trajectory::init_rocket(const GPS_constellation &ephemeris, const dispersion_t &disp,
+                             uint64_t seed, uint64_t run) {
+    rkt->egse_flight_event_handler_bitmap &= ~(0x1U << 0);
+    egse_config::model_configuration(rkt);
+    egse_config::init_time(rkt);
+    egse_config::init_environment(rkt);
+    rkt->gps_con.load_ephemeris(ephemeris);
+    egse_config::init_slv(rkt);
+    egse_config::init_aerodynamics(rkt, opt.aux_dir);
+    egse_config::init_propulsion(rkt, opt.aux_dir);
+
+    if (opt.ideal) {
+        rkt->accelerometer = new sensor::AccelerometerIdeal();
+        rkt->gyro = new sensor::GyroIdeal();
+    } else {
+        double emisa[3], escala[3], ebiasa[3];
+        double emisg[3], escalg[3], ebiasg[3];
+        memcpy(emisa, disp.EMISA, sizeof(emisa));
+        memcpy(escala, disp.ESCALA, sizeof(escala));
+        memcpy(ebiasa, disp.EBIASA, sizeof(ebiasa));
+        memcpy(emisg, disp.EMISG, sizeof(emisg));
+        memcpy(escalg, disp.ESCALG, sizeof(escalg));
+        memcpy(ebiasg, disp.EBIASG, sizeof(ebiasg));
+        rkt->accelerometer = new sensor::AccelerometerRocket6G(emisa, escala, ebiasa);
+        rkt->gyro = new sensor::GyroRocket6G(emisg, escalg, ebiasg);
+    }
+    reseed_noise(seed, run);
+    rkt->sdt = new SDT_ideal();
+    egse_config::init_tvc(rkt);
+
+    rkt->link();
+    rkt->aerodynamics.initialize();
+    rkt->dynamics.initialize();
+    rkt->env.initialize();
+    rkt->tvc.initialize();
+    rkt->propulsion.initialize();
+    rkt->forces.initialize();
+    rkt->gps_con.initialize();
+}
+
+void Trajectory::reseed_noise(uint64_t seed, uint64_t run) {
+    rkt->gyro->set_noise_seed(seed, run << 2 | 1);
+    rkt->accelerometer->set_noise_seed(seed, run << 2 | 2);
+}
+
+/* RUN_golden/golden_fc.cpp run_me() and the initialization jobs of the slave */
+void Trajectory::init_flight_computer(const dispersion_t &disp) {
+    fc_config::init_time(fc);
+    fc_config::init_ins_variable(fc);
+    fc_config::init_gps_fc_variable(fc);
+    if (!opt.ideal) {
+        fc->gps.ucfreq_noise = disp.ucfreq_noise;
+        fc->gps.ucbias_error = disp.ucbias_error;
+        memcpy(fc->gps.PR_BIAS, disp.PR_BIAS, sizeof(disp.PR_BIAS));
+        memcpy(fc->gps.PR_NOISE, disp.PR_NOISE, sizeof(disp.PR_NOISE));
+        memcpy(fc->gps.DR_NOISE, disp.DR_NOISE, sizeof(disp.DR_NOISE));
+    }
+    fc_config::init_stage2_control(fc);
+
+    fc->link();
+    fc->gps.initialize(FC_CYCLE);
+    fc->control.initialize();
+    fc->ins.initialize();
+}
+
+void FlightComputerObject::checkpoint(Checkpoint &cp) {
+    cp.section("FC");
+    cp(clear_gps, stand_still_time, egse_flight_event_trigger_bitmap, dm_ins_db, ins_ctl_db, ctl_tvc_db);
+    ins.checkpoint(cp);
+    control.checkpoint(cp);
+    gps.checkpoint(cp);
+}
+
+/* flight_events_handler_configuration(): checked every DM step */
+void Trajectory::egse_events() {
+    egse_config::liftoff(rkt);
+    egse_config::s3_separation(rkt, opt.aux_dir);
+    egse_config::fairing_separation(rkt);
+    egse_config::hot_staging(rkt);
+}
+
+/* flight_events_trigger_configuration(): timed events in schedule order, then the conditional ones */
+void Trajectory::fc_events(int64_t tics) {
+    static const struct {
+        double time;
+        void (*action)(FlightComputerObject *);
+    } timed[] = {
+        { fc_config::LIFTOFF_TIME,       fc_config::liftoff<FlightComputerObject> },
+        { fc_config::S2_CONTROL_ON_TIME, fc_config::s2_control_on<FlightComputerObject> },
+        { fc_config::HOT_STAGING_TIME,   fc_config::hot_staging<FlightComputerObject> },
+        { fc_config::S3_SEPARATION_TIME, fc_config::s3_seperation<FlightComputerObject> },
+        { fc_config::S3_CONTROL_ON_TIME, fc_config::s3_control_on<FlightComputerObject> },
+    };
+
+    for (uint32_t i = 0; i < sizeof(timed) / sizeof(timed[0]); i++) {
+        if (fc_timed_events & (1U << i))
+            continue;
+        int64_t at = llround((timed[i].time + fc->stand_still_time) * TIME_TIC_VALUE);
+        if (tics >= at) {
+            timed[i].action(fc);
+            fc_timed_events |= 1U << i;
+        }
+    }
+
+    fc_config::pitch_down_phase_1(fc);
+    fc_config::pitch_down_phase_2(fc);
+    fc_config::fairing_jettison(fc);
+    fc_config::aoac_on(fc);
+}
+
+/* P1/P2 jobs of FlightComputer_SimObject */
+void Trajectory::fc_frame() {
+    fc->time->dm_time(FC_CYCLE);
+    fc->dm_ins_db = rkt->dm_ins_db;
+    fc->clear_flag();
+
+    fc->gps.filter_extrapolation(FC_CYCLE);
+    fc->gps.measure(FC_CYCLE);
+
+    fc->ins.update(FC_CYCLE);
+    fc->INS_SaveOutData(fc->ins, fc->dm_ins_db, fc->ins_ctl_db);
+    fc->control.control(FC_CYCLE);
+    fc->Control_SaveOutData(fc->control, fc->ctl_tvc_db);
+    downlink = fc->ctl_tvc_db;
+}
+
+/* The columns of Modified_data/golden.h */
+static const char RECORD_HEADER[] =
+    "sys.exec.out.time {s},"
+    "rkt.dynamics.lonx {degree},"
+    "rkt.dynamics.latx {degree},"
+    "rkt.dynamics.alt {m},"
+    "rkt.dynamics._dvbi {m/s},"
+    "rkt.dynamics._SBII[0] {m},"
+    "rkt.dynamics._SBII[1] {m},"
+    "rkt.dynamics._SBII[2] {m},"
+    "rkt.dynamics._VBII[0] {m/s},"
+    "rkt.dynamics._VBII[1] {m/s},"
+    "rkt.dynamics._VBII[2] {m/s},"
+    "rkt.dynamics.thtbdx {degree}\n";
+
+void Trajectory::record(FILE *fp) {
+    arma::vec3 SBII = rkt->dynamics.get_SBII();
+    arma::vec3 VBII = rkt->dynamics.get_VBII();
+    double row[12] = {
+        thread_sim_time,
+        rkt->dynamics.get_lonx(),
+        rkt->dynamics.get_latx(),
+        rkt->dynamics.get_alt(),
+        rkt->dynamics.get_dvbi(),
+        SBII(0), SBII(1), SBII(2),
+        VBII(0), VBII(1), VBII(2),
+        rkt->dynamics.get_thtbdx(),
+    };
+    for (int i = 0; i < 12; i++)
+        fprintf(fp, i ? ",%20.16g" : "%20.16g", row[i]);
+    fputc('\n', fp);
+}
+
+/* Step the frames from the current one up to stop_tics, recording into fp if given */
+void Trajectory::fly(int64_t stop_tics, FILE *fp) {
+    const double int_step = rkt->int_step;
+    const int64_t step_tics = llround(int_step * TIME_TIC_VALUE);
+    const int64_t fc_tics = llround(FC_CYCLE * TIME_TIC_VALUE);
+    const int64_t record_tics = llround(opt.record_cycle * TIME_TIC_VALUE);
+
+    for (; tics < stop_tics; tics += step_tics) {
+        bool fc_due = (tics % fc_tics) == 0;
+        set_thread_sim_time(static_cast<double>(tics) / TIME_TIC_VALUE);
+
+        egse_events();
+        if (fc_due)
+            fc_events(tics);
+
+        rkt->time->dm_time(int_step);
+        rkt->env.propagate(int_step);
+        rkt->propulsion.propagate(int_step);
+        rkt->aerodynamics.calculate_aero(int_step);
+        if (fc_due)
+            rkt->gps_con.compute();
+        rkt->gyro->propagate_error(int_step);
+        rkt->accelerometer->propagate_error(int_step, NULL);
+        rkt->sdt->compute(int_step);
+
+        if (fc_due) {
+            rkt->DM_SaveOutData(rkt->dm_ins_db);
+            rkt->ctl_tvc_db = downlink;
+            rkt->flight_event_code_record = downlink.flight_event_code;
+            fc_frame();
+        }
+
+        rkt->tvc.actuate(int_step, NULL);
+        rkt->dynamics.propagate(int_step);
+        rkt->env.update_diagnostic_attributes(int_step);
+        rkt->dynamics.update_diagnostic_attributes(int_step);
+
+        if (!fp)
+            continue;
+        if (record_tics > 0 && tics % record_tics == 0)
+            record(fp);
+        else if (record_tics <= 0 && tics + step_tics >= stop_tics)
+            record(fp);
+    }
+}
+
+void Trajectory::fly_to(double time) {
+    fly(llround(time * TIME_TIC_VALUE), NULL);
+}
+
+int Trajectory::run(const std::string &run_dir) {
+    std::string path = run_dir + "/log_rocket_csv.csv";
+    FILE *fp = fopen(path.c_str(), "w");
+    if (!fp) {
+        fprintf(stderr, "[%s:%d] Cannot open %s\n", __FUNCTION__, __LINE__, path.c_str());
+        return -1;
+    }
+    fputs(RECORD_HEADER, fp);
+
+    fly(llround((egse_config::TERMINATE_TIME + rkt->stand_still_time) * TIME_TIC_VALUE), fp);
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "[%s:%d] Cannot write %s\n", __FUNCTION__, __LINE__, path.c_str());
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * The clocks go first: the models read them. The decks are not in the image,
+ * so the aero deck of the restored stage is reloaded when it differs.
+ */
+void Trajectory::checkpoint(Checkpoint &cp) {
+    cp.section("TRAJ");
+    cp(tics, fc_timed_events, downlink);
+    egse_clock->checkpoint(cp);
+    fc_clock->checkpoint(cp);
+    rkt->checkpoint(cp);
+    fc->checkpoint(cp);
+}
+
+void Trajectory::save_checkpoint(std::vector<char> &image) {
+    Checkpoint cp;
+    checkpoint(cp);
+    image = cp.image();
+}
+
+static bool s3_separated(const RocketObject *rkt) {
+    return !(rkt->egse_flight_event_handler_bitmap & (0x1U << FLIGHT_EVENT_CODE_S3_SEPERATION));
+}
+
+int Trajectory::restore_checkpoint(const std::vector<char> &image) {
+    bool was_s3 = s3_separated(rkt);
+
+    Checkpoint cp(image);
+    checkpoint(cp);
+    if (!cp.ok())
+        return -1;
+
+    bool s3 = s3_separated(rkt);
+    if (s3 != was_s3)
+        rkt->aerodynamics.load_aerotable(
+            (opt.aux_dir + "/" + (s3 ? egse_config::AERO_S3_DECK : egse_config::AERO_S2_DECK)).c_str());
+    return 0;
+}
@@ -0,0 +1,207 @@
+#ifndef EXE_MONTE_BATCH_TRAJECTORY_HH_
+#define EXE_MONTE_BATCH_TRAJECTORY_HH_
+/*
+ * One Monte Carlo trajectory of the SIL golden run without Trick: the EGSE
+ * (dynamics) and flight computer objects of exe/SIL/{master,slave}/S_define,
+ * linked the same way, configured by egse_configuration.h/fc_configuration.h
+ * and stepped by Trajectory::run() on the calling thread.
+ */
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "checkpoint.hh"
+#include "Tvc.hh"
+#include "Force.hh"
+#include "Propulsion.hh"
+#include "Aerodynamics.hh"
+#include "Time_management.hh"
+#include "GPS_constellation.hh"
+#include "Rocket_Flight_DM.hh"
+#include "Environment.hh"
+
+#include "gyro/gyro.hh"
+#include "accel/accelerometer.hh"
+#include "sdt/SDT.hh"
+
+#include "Ins.hh"
+#include "Control.hh"
+#include "GPS.hh"
+#include "Dataflow_Binding.hh"
+#include "DM_FSW_Interface.hh"
+
+/* Static errors of one run, the MonteVarRandom variables of RUN_monte/monte.py */
+struct dispersion_t {
+    double EMISA[3];        /* (r)      Accelerometer misalignment, gauss(0, 1.1e-4) */
+    double ESCALA[3];       /* (--)     Accelerometer scale factor, gauss(0, 5e-4) */
+    double EBIASA[3];       /* (m/s2)   Accelerometer bias, gauss(0, 3.56e-3) */
+    double EMISG[3];        /* (r)      Gyro misalignment, gauss(0, 1.1e-4) */
+    double ESCALG[3];       /* (--)     Gyro scale factor, gauss(0, 2e-5) */
+    double EBIASG[3];       /* (r/s)    Gyro bias, gauss(0, 1e-6) */
+    double ucfreq_noise;    /* (m/s)    User clock frequency error, gauss(0, 0.1) */
+    double ucbias_error;    /* (m)      User clock bias error, gauss(0, 3) */
+    double PR_BIAS[4];      /* (m)      Pseudo-range bias, gauss(0, 0.842) */
+    double PR_NOISE[4];     /* (m)      Pseudo-range noise, gauss(0, 0.25) */
+    double DR_NOISE[4];     /* (m/s)    Delta-range noise, gauss(0, 0.03) */
+};
+
+/* Draw the dispersions of run 'run' from stream (seed, run << 2) */
+void draw_dispersion(dispersion_t *d, uint64_t seed, uint64_t run);
+
+/* Models of Rocket_SimObject, exe/SIL/master/S_define */
+class RocketObject {
+ public:
+    RocketObject();
+    ~RocketObject();
+
+    double int_step = 0.005;
+    double stand_still_time = 0.0;
+    Propulsion propulsion;  /* ahead of the models keeping a reference to it */
+    TVC tvc;
+    Rocket_Flight_DM dynamics;
+    Environment env;
+    Forces forces;
+    AeroDynamics aerodynamics;
+    sensor::Gyro *gyro;
+    sensor::Accelerometer *accelerometer;
+    SDT *sdt;
+
+    time_management *time = time_management::get_instance();
+    GPS_constellation gps_con;
+
+    refactor_uplink_packet_t dm_ins_db;
+    refactor_downlink_packet_t ctl_tvc_db;
+    DM_SAVE_decl();
+    uint64_t egse_flight_event_handler_bitmap = 0xFFFFFFFFFFFFFFFF;
+    uint64_t flight_event_code_record = 0;
+
+    void link();
+    void checkpoint(Checkpoint &cp);
+
+ private:
+    RocketObject(const RocketObject &);
+    RocketObject &operator=(const RocketObject &);
+};
+
+/* Models of FlightComputer_SimObject, exe/SIL/slave/S_define */
+class FlightComputerObject {
+ public:
+    FlightComputerObject();
+
+    double clear_gps;
+    double stand_still_time = 0.0;
+    INS ins;
+
+    Control control;
+
+    time_management *time = time_management::get_instance();
+    uint64_t egse_flight_event_trigger_bitmap = 0xFFFFFFFFFFFFFFFF;
+
+    GPS_FSW gps;
+
+    refactor_uplink_packet_t dm_ins_db;
+    refactor_ins_to_ctl_t ins_ctl_db;
+    refactor_downlink_packet_t ctl_tvc_db;
+
+    GPS_LINK_decl();
+    INS_LINK_decl();
+    CONTROL_LINK_decl();
+
+    INS_SAVE_decl();
+    CONTROL_SAVE_decl();
+
+    void link() {
+        GPSLinkInData(gps, dm_ins_db, ins);
+        INSLinkInData(ins, dm_ins_db, gps);
+        ControlLinkInData(control, ins_ctl_db);
+
+        ins.clear_gps_flag  = [this](){ this->clear_gps = 1; };
+    }
+
+    void clear_flag() {
+        this->clear_gps = 0;
+    }
+
+    void checkpoint(Checkpoint &cp);
+
+ private:
+    FlightComputerObject(const FlightComputerObject &);
+    FlightComputerObject &operator=(const FlightComputerObject &);
+};
+
+/*
+ * Trajectory: an EGSE and a flight computer, each on its own GPS clock as in
+ * the two SIL processes. Both are built and stepped on one thread; the clocks
+ * are only installed as that thread's time_management instance while the
+ * models are constructed, since the models keep the pointer.
+ *
+ * The frame of one DM step (int_step) is, as scheduled by the two S_defines:
+ *   top of frame  EGSE flight events; every FC frame, FC flight events
+ *   P1            DM environment, propulsion, aero, GPS constellation, sensors
+ *   P2 (FC frame) DM_SaveOutData, uplink, FC GPS/INS/control, downlink
+ *   P3            TVC, dynamics
+ * The DM reads the downlink sent in the previous FC frame, the delay of the
+ * SIL ICF link running in lockstep.
+ *
+ * A trajectory flown to a branch point with fly_to() can be saved with
+ * save_checkpoint() and restored into any number of trajectories built with
+ * the same options, which then fly on from there. The static dispersions,
+ * given to the constructor, stay those of the trajectory restored into.
+ */
+class Trajectory {
+ public:
+    struct options_t {
+        std::string aux_dir;        /* auxiliary/ directory holding the decks */
+        bool ideal;                 /* Ideal sensors, no dispersion */
+        double record_cycle;        /* Recording cycle - s, 0 records the last frame only */
+    };
+
+    Trajectory(const options_t &opt, const GPS_constellation &ephemeris, const dispersion_t &disp,
+               uint64_t seed, uint64_t run);
+    ~Trajectory();
+
+    /* Fly from the current frame to the terminate time, writing log_rocket_csv.csv into run_dir */
+    int run(const std::string &run_dir);
+    /* Fly without recording to 'time' - s, rounded up to a DM step */
+    void fly_to(double time);
+
+    /* Dynamic state of both objects, see checkpoint.hh */
+    void save_checkpoint(std::vector<char> &image);
+    /* Returns -1 on an image of another layout; the trajectory is then unusable */
+    int restore_checkpoint(const std::vector<char> &image);
+
+    /* Sensor noise streams (seed, run << 2 | 1..2), apart from the dispersion draw */
+    void reseed_noise(uint64_t seed, uint64_t run);
+
+    static const double FC_CYCLE;
+    static const int64_t TIME_TIC_VALUE = 1000000;  /* tics per second, Trick's default */
+
+ private:
+    void init_rocket(const GPS_constellation &ephemeris, const dispersion_t &disp, uint64_t seed, uint64_t run);
+    void init_flight_computer(const dispersion_t &disp);
+
+    void egse_events();
+    void fc_events(int64_t tics);
+    void fc_frame();
+    void record(FILE *fp);
+    void fly(int64_t stop_tics, FILE *fp);
+    void checkpoint(Checkpoint &cp);
+
+    options_t opt;
+    time_management *egse_clock;
+    time_management *fc_clock;
+    RocketObject *rkt;
+    FlightComputerObject *fc;
+    refactor_downlink_packet_t downlink;    /* sent by the FC, read by the DM next FC frame */
+    uint32_t fc_timed_events;               /* timed FC events already triggered */
+    int64_t tics;                           /* time of the next frame - tics */
+
+    Trajectory(const Trajectory &);
+    Trajectory &operator=(const Trajectory &);
+};
+
+/* Simulation time of the trajectory stepped on this thread, for get_rettime() */
+void set_thread_sim_time(double t);
+
+#endif  // EXE_MONTE_BATCH_TRAJECTORY_HH_
@@ -0,0 +1,23 @@
+#ifndef EXE_XIL_COMMON_INCLUDE_ICF_TRANSPORT_H_
+#define EXE_XIL_COMMON_INCLUDE_ICF_TRANSPORT_H_
+
+#include <cstdlib>
+#include <cstring>
+#include "icf_trx_ctrl.h"
+
+/*
+ * SIL master and slave share a host: SIRIUS_ICF_TRANSPORT=shm (SIL.sh --shm)
+ * moves their ICF link from TCP loopback to shared memory. Call it from the
+ * input file, before the ICF initialization jobs run.
+ */
+extern "C" void icf_transport_switch(struct icf_ctrlblk_t *C) {
+    const char *transport = getenv("SIRIUS_ICF_TRANSPORT");
+
+    if (transport && strcmp(transport, "shm") == 0)
+        icf_ctrlblk_set_transport(C, ICF_TRANSPORT_SHM);
+    else
+        icf_ctrlblk_set_transport(C, ICF_TRANSPORT_SOCKET);
+    fprintf(stderr, "ICF transport: %s\n", C->transport == ICF_TRANSPORT_SHM ? "shared memory" : "socket");
+}
+
+#endif  // EXE_XIL_COMMON_INCLUDE_ICF_TRANSPORT_H_
@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the Time Management Module Variables and Algorithm)
 LIBRARY DEPENDENCY:
-      ((../src/Time_management.cpp))
+      ((../src/Time_management.cpp)
+       (../src/checkpoint.cpp))
 PROGRAMMERS:
       (((Lai Jun Xu) () () () ))
 *******************************************************************************/
@@ -16,6 +17,8 @@ PROGRAMMERS:
 #include <armadillo>
 #include <iostream>
 
+class Checkpoint;
+
 class time_management {
     TRICK_INTERFACE(time_management);
 
@@ -26,11 +29,11 @@ class time_management {
     uint32_t tm_gps_start_time_hour;
     uint32_t tm_gps_start_time_minute;
     double tm_gps_start_time_second;
-    static time_management* get_instance() {
-        static time_management time;
-
-        return &time;
-    }
+    /* the clock models capture at construction: the one set for this thread, else the process one */
+    static time_management* get_instance();
+    /* a clock of its own for one of several trajectories in a process */
+    static time_management* create() { return new time_management; }
+    static void set_thread_instance(time_management *clock);
 
     time_management(const time_management &other) = delete;
     time_management& operator=(const time_management &other) = delete;
@@ -47,6 +50,9 @@ class time_management {
 
     time_util::Modified_julian_date get_modified_julian_date();
 
+    /* GPS time of the clock, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
+
  private:
     time_management();
 
@@ -0,0 +1,84 @@
+#ifndef __CHECKPOINT_HH__
+#define __CHECKPOINT_HH__
+/********************************* TRICK HEADER *******************************
+PURPOSE:
+      (Binary snapshot of the dynamic state of the models)
+LIBRARY DEPENDENCY:
+      ((../src/checkpoint.cpp)
+       (../../math/src/crc32.cpp))
+*******************************************************************************/
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <armadillo>
+#include "time_utility.hh"
+
+/**
+ * \brief Saves the state of models into a flat image, or restores it.
+ *
+ * Each model lists its members once, in a checkpoint(Checkpoint &cp)
+ * method, and the same list both saves and restores:
+ *
+ *     cp.section("TVC");
+ *     cp(etas, etasd, zeta, zetad, FPB, FMPB, ...);
+ *
+ * Trivially copyable members (scalars, plain arrays, C structs) are copied
+ * as bytes, arma matrices as their elements. A matrix bound to its '_X'
+ * array is the array, so only one of the two is listed. Pointers, links
+ * and decks are not state and are left to the object restored into: it
+ * has to be built and initialized the way the saved one was.
+ *
+ * Unlike a Trick ASCII checkpoint nothing is named or formatted; a restore
+ * is a memcpy per member. section() tags guard against images of another
+ * layout: a restore stops at the first tag or size that does not match and
+ * ok() turns false.
+ */
+class Checkpoint {
+ public:
+    /* Saving into an empty image */
+    Checkpoint();
+    /* Restoring from 'image', which is only read and must outlive the restore */
+    explicit Checkpoint(const std::vector<char> &image);
+
+    bool saving() const { return mode == SAVE; }
+    bool ok() const { return !failed; }
+
+    void section(const char *tag);
+
+    template <typename T>
+    typename std::enable_if<!std::is_base_of<arma::mat, T>::value>::type operator()(T &value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "checkpoint members are copied as bytes, give the type a checkpoint() of its own");
+        bytes(&value, sizeof(value));
+    }
+    void operator()(arma::mat &value);
+    void operator()(time_util::GPS_TIME &value);
+
+    template <typename T, typename U, typename... Rest>
+    void operator()(T &first, U &second, Rest &... rest) {
+        (*this)(first);
+        (*this)(second, rest...);
+    }
+
+    void bytes(void *data, size_t size);
+
+    /* The saved image */
+    const std::vector<char> &image() const { return buffer; }
+
+    /* Image files: header with magic, version, size and CRC-32, then the image */
+    static int write_file(const char *file_name, const std::vector<char> &image);
+    static int read_file(const char *file_name, std::vector<char> &image);
+
+ private:
+    enum { SAVE, RESTORE } mode;
+    bool failed;
+
+    std::vector<char> buffer;       /* ** image being saved */
+    const std::vector<char> *in;    /* ** image being restored */
+    size_t offset;                  /* ** read position in *in */
+};
+
+#endif  // __CHECKPOINT_HH__
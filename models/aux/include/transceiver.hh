@@ -4,7 +4,9 @@
 PURPOSE:
       (Master-Slave Transmission)
 LIBRARY DEPENDENCY:
-      ((../src/transceiver.cpp))
+      ((../src/transceiver.cpp)
+       (../../icf/src/shm_channel.c)
+       (../../math/src/crc32.cpp))
 *******************************************************************************/
 #include "trick_utils/comm/include/tc.h"
 #include "trick_utils/comm/include/tc_proto.h"
@@ -15,23 +17,53 @@ LIBRARY DEPENDENCY:
 #include <map>
 #include <set>
 #include <list>
+#include <vector>
 #include "../../dm/include/GPS_constellation.hh"
 #include "../../gnc/include/DM_FSW_Interface.hh"
+#include "../../icf/include/shm_channel.h"
 
 class Transceiver;
 class TransceiverProxy;
 
+/* link under transmit / receive */
+enum transceiver_transport {
+    TR_TRANSPORT_TC = 0,    /* Trick comm socket */
+    TR_TRANSPORT_SHM = 1    /* shared memory, master and slave on one host */
+};
+
+/* packed mode frame options */
+enum transceiver_packed_option {
+    TR_PACKED_SEQ = 0x1,    /* sequence number in the frame header */
+    TR_PACKED_CRC = 0x2     /* CRC-32 trailer */
+};
+
 class Transceiver {
  public:
-    Transceiver() {}
+    Transceiver()
+        :   packed_mode(0), tx_options(TR_PACKED_SEQ | TR_PACKED_CRC), rx_options(0), schema_sent(0), rx_packed(0),
+            tx_seq(0), rx_seq(0), rx_seq_errors(0), transport(TR_TRANSPORT_TC), shm(NULL) {}
+    ~Transceiver();
 
+    /* Pick the link before initialize_connection(), both ends alike */
+    void set_transport(unsigned int transport);
     void initialize_connection(char* name);
+    /* Packed mode: the name / type layout goes out once, ahead of the first
+     * frame, then every transmit is one contiguous frame in one write.
+     * The receiver switches over by itself when it sees the schema. */
+    void set_packed_mode(unsigned int enable, unsigned int options = TR_PACKED_SEQ | TR_PACKED_CRC);
+    unsigned int get_rx_seq_errors() { return rx_seq_errors; }
 
     void register_for_transmit(std::string cid, std::string id, std::function<double()> in);
     void register_for_transmit(std::string cid, std::string id, std::function<arma::mat()> in);
     void register_for_transmit(std::string cid, std::string id, std::function<transmit_channel*()> in);
     void register_for_transmit(std::string cid, std::string id, std::function<refactor_downlink_packet_t()> in);
     void register_for_transmit(std::string cid, std::string id, std::function<refactor_uplink_packet_t()> in);
+    /* Plain variables, read in place at every transmit without a getter call */
+    void register_for_transmit(std::string cid, std::string id, const double *in);
+    void register_for_transmit(std::string cid, std::string id, const arma::mat *in);
+    void register_for_transmit(std::string cid, std::string id, const transmit_channel *in);  /* 12 channels */
+    void register_for_transmit(std::string cid, std::string id, const refactor_downlink_packet_t *in);
+    void register_for_transmit(std::string cid, std::string id, const refactor_uplink_packet_t *in);
 
     void transmit();
     void receive();
@@ -45,20 +77,67 @@ class Transceiver {
     std::function<refactor_uplink_packet_t()> get_uplink(std::string cid, std::string id);
 
  private:
+    /* transmit descriptor, one per registered channel, in registration order */
+    template <typename T>
+    struct tx_entry {
+        std::string name;
+        std::function<T()> source;  /* getter, unless registered as a variable */
+        const void *var;            /* the variable, read in place, or NULL */
+        uint32_t size;      /* bytes on the wire, matrices: fixed by the packed schema */
+    };
+
+    /* receive descriptor, the value itself lives in rx_store */
+    struct rx_slot {
+        std::string name;
+        uint32_t type;
+        uint32_t rows;
+        uint32_t cols;
+        uint32_t offset;    /* in rx_store, doubles */
+        uint32_t size;      /* bytes */
+    };
+
+    template <typename T>
+    void add_tx_entry(std::vector<tx_entry<T>> &table, std::string cid, std::string id, std::function<T()> in,
+                      const void *var);
+    uint32_t rx_slot_find(uint32_t type, const std::string &name, uint32_t rows, uint32_t cols);
+    char *rx_data(uint32_t idx) { return reinterpret_cast<char*>(rx_store.data() + rx_slots[idx].offset); }
+
+    int link_valid();
+    int link_write(char *buf, int size);
+    int link_read(char *buf, int size);
+
+    void check_registration_open();
+    void transmit_schema();
+    void transmit_packed();
+    void receive_schema();
+    void receive_packed();
+
     TCDevice dev;
     TrickErrorHndlr   err_hndlr;
 
-    std::map<std::string, std::function<double()>> data_double_out;
-    std::map<std::string, std::function<arma::mat()>> data_mat_out;
-    std::map<std::string, std::function<transmit_channel*()>> data_gpsr_out;
-    std::map<std::string, std::function<refactor_downlink_packet_t()>> data_downlink_out;
-    std::map<std::string, std::function<refactor_uplink_packet_t()>> data_uplink_out;
-
-    std::map<std::string, double> data_double_in;
-    std::map<std::string, arma::mat> data_mat_in;
-    std::map<std::string, transmit_channel*> data_gpsr_in;
-    std::map<std::string, refactor_downlink_packet_t> data_downlink_in;
-    std::map<std::string, refactor_uplink_packet_t> data_uplink_in;
+    unsigned int packed_mode;       /* *io (--) 1: schema once, then one packed frame per cycle */
+    unsigned int tx_options;        /* *io (--) transceiver_packed_option flags of the frames sent */
+    unsigned int rx_options;        /* *o  (--) transceiver_packed_option flags of the peer schema */
+    unsigned int schema_sent;       /* *o  (--) packed schema is out */
+    unsigned int rx_packed;         /* *o  (--) peer schema received, frames are packed */
+    uint32_t tx_seq;                /* *o  (--) last packed frame sent */
+    uint32_t rx_seq;                /* *o  (--) last packed frame received */
+    unsigned int rx_seq_errors;     /* *o  (--) packed frames received out of sequence */
+    unsigned int transport;         /* *io (--) transceiver_transport */
+    struct shm_channel_t *shm;      /* ** */
+    std::vector<char> tx_frame;           /* ** */
+    std::vector<char> rx_frame;           /* ** */
+
+    std::vector<tx_entry<double>> tx_double;                        /* ** */
+    std::vector<tx_entry<arma::mat>> tx_mat;                        /* ** */
+    std::vector<tx_entry<transmit_channel*>> tx_gpsr;               /* ** */
+    std::vector<tx_entry<refactor_downlink_packet_t>> tx_downlink;  /* ** */
+    std::vector<tx_entry<refactor_uplink_packet_t>> tx_uplink;      /* ** */
+
+    std::vector<rx_slot> rx_slots;      /* ** */
+    std::vector<double> rx_store;       /* ** received values, contiguous */
+    std::vector<uint32_t> rx_layout;    /* ** slots in the order the peer sends them */
+    std::map<std::pair<uint32_t, std::string>, uint32_t> rx_index;  /* ** (type, name) -> slot, off the hot path */
 };
 
 class TransceiverProxy{
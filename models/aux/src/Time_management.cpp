@@ -1,10 +1,26 @@
 #include "Time_management.hh"
+#include "checkpoint.hh"
 // #include "sim_services/include/simtime.h"
 
+static thread_local time_management *thread_instance = NULL;
+
 time_management::time_management() {
     last_time = 0;
 }
 
+time_management* time_management::get_instance() {
+    static time_management time;
+
+    if (thread_instance)
+        return thread_instance;
+    return &time;
+}
+
+/* NULL goes back to the process clock */
+void time_management::set_thread_instance(time_management *clock) {
+    thread_instance = clock;
+}
+
 void time_management::dm_time(double int_step) { /* convert simulation time to gps time */
     // double this_time = get_rettime();
 
@@ -60,3 +76,9 @@ uint32_t time_management::get_gpstime_msec_of_week() {
     msec_of_week = gpstime.get_SOW() * 1000.0;
     return msec_of_week;
 }
+
+void time_management::checkpoint(Checkpoint &cp) {
+    cp.section("TIME");
+    cp(tm_gps_start_time_year, tm_gps_start_time_month, tm_gps_start_time_day, tm_gps_start_time_hour,
+       tm_gps_start_time_minute, tm_gps_start_time_second, last_time, gpstime);
+}
@@ -0,0 +1,161 @@
+#include "checkpoint.hh"
+#include "crc32.hh"
+
+#include <cstdio>
+#include <cstring>
+
+/*
+ * Image file layout, native byte order, see Checkpoint::write_file():
+ *
+ *   CheckpointFileHeader
+ *   char[size]                the image
+ *
+ * The checksum is the CRC-32 of the image.
+ */
+#define CHECKPOINT_MAGIC "SIRCKPT"
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_BYTE_ORDER 0x01020304u
+#define CHECKPOINT_TAG_LEN 8
+
+struct CheckpointFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t size;
+    uint32_t checksum;
+    uint32_t reserved;
+};
+
+Checkpoint::Checkpoint()
+    :   mode(SAVE), failed(false), in(NULL), offset(0) {
+}
+
+Checkpoint::Checkpoint(const std::vector<char> &image)
+    :   mode(RESTORE), failed(false), in(&image), offset(0) {
+}
+
+void Checkpoint::bytes(void *data, size_t size) {
+    if (mode == SAVE) {
+        const char *p = static_cast<const char *>(data);
+        buffer.insert(buffer.end(), p, p + size);
+        return;
+    }
+    if (failed)
+        return;
+    if (size > in->size() - offset) {
+        fprintf(stderr, "[%s:%d] Checkpoint image ends at byte %zu, %zu more wanted\n",
+                __FUNCTION__, __LINE__, offset, size);
+        failed = true;
+        return;
+    }
+    memcpy(data, in->data() + offset, size);
+    offset += size;
+}
+
+void Checkpoint::section(const char *tag) {
+    char name[CHECKPOINT_TAG_LEN];
+    memset(name, 0, sizeof(name));
+    strncpy(name, tag, sizeof(name));
+
+    if (mode == SAVE) {
+        bytes(name, sizeof(name));
+        return;
+    }
+    char saved[CHECKPOINT_TAG_LEN];
+    memset(saved, 0, sizeof(saved));
+    size_t at = offset;
+    bytes(saved, sizeof(saved));
+    if (!failed && memcmp(saved, name, sizeof(name)) != 0) {
+        fprintf(stderr, "[%s:%d] Checkpoint section '%.8s' at byte %zu, '%.8s' expected\n",
+                __FUNCTION__, __LINE__, saved, at, name);
+        failed = true;
+    }
+}
+
+void Checkpoint::operator()(arma::mat &value) {
+    uint32_t dim[2] = { static_cast<uint32_t>(value.n_rows), static_cast<uint32_t>(value.n_cols) };
+    uint32_t saved[2] = { dim[0], dim[1] };
+
+    bytes(saved, sizeof(saved));
+    if (failed)
+        return;
+    if (saved[0] != dim[0] || saved[1] != dim[1]) {
+        fprintf(stderr, "[%s:%d] Checkpoint matrix of %ux%u restored into %ux%u\n",
+                __FUNCTION__, __LINE__, saved[0], saved[1], dim[0], dim[1]);
+        failed = true;
+        return;
+    }
+    bytes(value.memptr(), value.n_elem * sizeof(double));
+}
+
+void Checkpoint::operator()(time_util::GPS_TIME &value) {
+    uint32_t week = value.get_week();
+    double SOW = value.get_SOW();
+
+    (*this)(week, SOW);
+    if (mode == RESTORE && !failed) {
+        value.set_week(week);
+        value.set_SOW(SOW);
+    }
+}
+
+int Checkpoint::write_file(const char *file_name, const std::vector<char> &image) {
+    CheckpointFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.byte_order = CHECKPOINT_BYTE_ORDER;
+    header.size = image.size();
+    header.checksum = crc32_ieee(image.data(), image.size());
+
+    FILE *fp = fopen(file_name, "wb");
+    if (!fp) {
+        fprintf(stderr, "[%s:%d] Cannot open %s\n", __FUNCTION__, __LINE__, file_name);
+        return -1;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+              && (image.empty() || fwrite(image.data(), image.size(), 1, fp) == 1);
+    if (fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "[%s:%d] Cannot write %s\n", __FUNCTION__, __LINE__, file_name);
+        return -1;
+    }
+    return 0;
+}
+
+int Checkpoint::read_file(const char *file_name, std::vector<char> &image) {
+    FILE *fp = fopen(file_name, "rb");
+    if (!fp) {
+        fprintf(stderr, "[%s:%d] Cannot open %s\n", __FUNCTION__, __LINE__, file_name);
+        return -1;
+    }
+
+    CheckpointFileHeader header;
+    const char *error = NULL;
+    long start = -1, end = -1;
+    if (fread(&header, sizeof(header), 1, fp) != 1
+        || memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) {
+        error = "not a checkpoint";
+    } else if (header.version != CHECKPOINT_VERSION || header.byte_order != CHECKPOINT_BYTE_ORDER) {
+        error = "unsupported version or byte order";
+    } else if ((start = ftell(fp)) < 0 || fseek(fp, 0, SEEK_END) != 0 || (end = ftell(fp)) < start
+               || fseek(fp, start, SEEK_SET) != 0) {
+        error = "cannot get the file size";
+    } else if (header.size > static_cast<uint64_t>(end - start)) {
+        /* before resize(): a corrupt size must not allocate */
+        error = "truncated file";
+    } else {
+        image.resize(header.size);
+        if (header.size && fread(image.data(), header.size, 1, fp) != 1)
+            error = "truncated file";
+        else if (crc32_ieee(image.data(), image.size()) != header.checksum)
+            error = "checksum mismatch";
+    }
+    fclose(fp);
+
+    if (error) {
+        fprintf(stderr, "[%s:%d] %s is not usable (%s)\n", __FUNCTION__, __LINE__, file_name, error);
+        image.clear();
+        return -1;
+    }
+    return 0;
+}
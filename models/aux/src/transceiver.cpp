@@ -1,12 +1,17 @@
 #include "transceiver.hh"
+#include "crc32.hh"
 #include "sim_services/include/simtime.h"
 
 #include "trick_utils/comm/include/tc.h"
 #include "trick_utils/comm/include/tc_proto.h"
 
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
 
 #define TR_BUFFER_SIZE 102400
+#define TR_SCHEMA_MAGIC 0x43535254  /* "TRSC", sent in place of the legacy entry count */
+#define TR_FRAME_MAGIC  0x52465254  /* "TRFR" */
 
 enum packet_type {
     DOUBLE,
@@ -27,12 +32,80 @@ struct __attribute__((__packed__)) mat_header {
     uint64_t y : 4;
 };
 
+struct __attribute__((__packed__)) schema_header {
+    uint32_t magic;
+    uint32_t count;
+    uint32_t options;
+    uint32_t payload_size;
+};
+
+struct __attribute__((__packed__)) schema_entry {
+    uint32_t type;
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t name_length;
+};
+
+struct __attribute__((__packed__)) frame_header {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t payload_size;
+};
+
+static void append(std::vector<char> &buf, const void *src, size_t size) {
+    buf.insert(buf.end(), reinterpret_cast<const char*>(src), reinterpret_cast<const char*>(src) + size);
+}
+
+/* value of a transmit entry: its variable in place, or the getter's result kept in tmp */
+template <typename Entry, typename T>
+static const T &tx_value(const Entry &entry, T &tmp) {
+    if (entry.var)
+        return *static_cast<const T *>(entry.var);
+    tmp = entry.source();
+    return tmp;
+}
+
+template <typename Entry>
+static const void *tx_gpsr_data(const Entry &entry) {
+    return entry.var ? entry.var : entry.source();
+}
+
+#define TR_SHM_WAIT_MS 15000
+
+Transceiver::~Transceiver() {
+    shm_channel_close(&shm);
+}
+
+void Transceiver::set_transport(unsigned int transport) {
+    if (transport != TR_TRANSPORT_TC && transport != TR_TRANSPORT_SHM) throw std::out_of_range("Unknown transport");
+    this->transport = transport;
+}
+
 void Transceiver::initialize_connection(char* name) {
     memset(reinterpret_cast<void*>(&err_hndlr), '\0', sizeof(TrickErrorHndlr));
     trick_error_init(&err_hndlr, (TrickErrorFuncPtr)NULL,
                      (TrickErrorDataPtr)NULL, TRICK_ERROR_TRIVIAL);
 
     char buf[32] = "SIRIUS";
+    if (transport == TR_TRANSPORT_SHM) {
+        /* the two ends pair up like tc_multiconnect does: same tag, first one in creates */
+        char shm_name[64];
+        snprintf(shm_name, sizeof(shm_name), "/sirius_transceiver_%u_%s", (unsigned int)getuid(), buf);
+        if (shm_channel_open(&shm, shm_name, SHM_CHANNEL_ANY) < 0) {
+            perror("Error from shm_channel_open\n");
+            exit(255);
+        }
+        struct timespec tick = {0, 1000000};
+        for (int ms = 0; shm_channel_poll(shm) != ICF_LINK_UP; ms++) {
+            if (ms > TR_SHM_WAIT_MS) {
+                fprintf(stderr, "%s: no peer on %s after %d ms\n", name, shm_name, TR_SHM_WAIT_MS);
+                exit(255);
+            }
+            nanosleep(&tick, NULL);
+        }
+        return;
+    }
+
     int status = tc_multiconnect(&dev, name, buf, &err_hndlr);
     tc_blockio(&dev, TC_COMM_BLOCKIO);
     if (status != TC_SUCCESS) {
@@ -41,188 +114,384 @@ void Transceiver::initialize_connection(char* name) {
     }
 }
 
-void Transceiver::register_for_transmit(std::string cid, std::string id, std::function<double()> in) {
+int Transceiver::link_valid() {
+    if (transport == TR_TRANSPORT_SHM) return shm != NULL && shm->link_state == ICF_LINK_UP;
+    return tc_isValid(&dev);
+}
+
+int Transceiver::link_write(char *buf, int size) {
+    if (transport == TR_TRANSPORT_SHM) return shm_channel_write(shm, buf, size);
+    return tc_write(&dev, buf, size);
+}
+
+int Transceiver::link_read(char *buf, int size) {
+    if (transport == TR_TRANSPORT_SHM) return shm_channel_read(shm, buf, size);
+    return tc_read(&dev, buf, size);
+}
+
+/* re-registering a name replaces its source, as the map it used to be did */
+template <typename T>
+void Transceiver::add_tx_entry(std::vector<tx_entry<T>> &table, std::string cid, std::string id, std::function<T()> in,
+                               const void *var) {
     std::string tid = cid + "." + id;
     if (tid.length() > 127) throw std::out_of_range("ID too long");
-    data_double_out[tid] = in;
+    check_registration_open();
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        if (it->name == tid) {
+            it->source = in;
+            it->var = var;
+            return;
+        }
+    }
+    struct tx_entry<T> entry = { tid, in, var, sizeof(T) };
+    table.push_back(entry);
+}
+
+void Transceiver::register_for_transmit(std::string cid, std::string id, std::function<double()> in) {
+    add_tx_entry(tx_double, cid, id, in, NULL);
 }
 
 void Transceiver::register_for_transmit(std::string cid, std::string id, std::function<arma::mat()> in) {
-    std::string tid = cid + "." + id;
-    if (tid.length() > 127) throw std::out_of_range("ID too long");
-    data_mat_out[tid] = in;
+    add_tx_entry(tx_mat, cid, id, in, NULL);
 }
 
 void Transceiver::register_for_transmit(std::string cid, std::string id, std::function<transmit_channel*()> in) {
-    std::string tid = cid + "." +id;
-    if (tid.length() > 127) throw std::out_of_range("ID too long");
-    data_gpsr_out[tid] = in;
+    add_tx_entry(tx_gpsr, cid, id, in, NULL);
+    tx_gpsr.back().size = sizeof(transmit_channel) * 12;
 }
 
 void Transceiver::register_for_transmit(std::string cid, std::string id, std::function<refactor_downlink_packet_t()> in) {
-    std::string tid = cid + "." + id;
-    if (tid.length() > 127) throw std::out_of_range("ID too long");
-    data_downlink_out[tid] = in;
+    add_tx_entry(tx_downlink, cid, id, in, NULL);
 }
 
 void Transceiver::register_for_transmit(std::string cid, std::string id, std::function<refactor_uplink_packet_t()> in) {
-    std::string tid = cid + "." + id;
-    if (tid.length() > 127) throw std::out_of_range("ID too long");
-    data_uplink_out[tid] = in;
+    add_tx_entry(tx_uplink, cid, id, in, NULL);
 }
 
-void Transceiver::transmit() {
-    uint32_t size = data_double_out.size() + data_mat_out.size() + data_gpsr_out.size() + data_downlink_out.size() + data_uplink_out.size();
-    if (tc_isValid(&dev)) {
-        tc_write(&dev, reinterpret_cast<char*>(&size), sizeof(uint32_t));
+void Transceiver::register_for_transmit(std::string cid, std::string id, const double *in) {
+    add_tx_entry(tx_double, cid, id, std::function<double()>(), in);
+}
+
+void Transceiver::register_for_transmit(std::string cid, std::string id, const arma::mat *in) {
+    add_tx_entry(tx_mat, cid, id, std::function<arma::mat()>(), in);
+}
+
+void Transceiver::register_for_transmit(std::string cid, std::string id, const transmit_channel *in) {
+    add_tx_entry(tx_gpsr, cid, id, std::function<transmit_channel*()>(), in);
+    tx_gpsr.back().size = sizeof(transmit_channel) * 12;
+}
+
+void Transceiver::register_for_transmit(std::string cid, std::string id, const refactor_downlink_packet_t *in) {
+    add_tx_entry(tx_downlink, cid, id, std::function<refactor_downlink_packet_t()>(), in);
+}
+
+void Transceiver::register_for_transmit(std::string cid, std::string id, const refactor_uplink_packet_t *in) {
+    add_tx_entry(tx_uplink, cid, id, std::function<refactor_uplink_packet_t()>(), in);
+}
+
+void Transceiver::set_packed_mode(unsigned int enable, unsigned int options) {
+    check_registration_open();
+    packed_mode = enable;
+    tx_options = options;
+}
+
+/* the packed layout is fixed once the schema is out */
+void Transceiver::check_registration_open() {
+    if (schema_sent) throw std::logic_error("Transceiver layout changed after the packed schema was sent");
+}
+
+/*
+ * Slot for a received (type, name), created on first use by either side:
+ * the getter bound before the first receive, or the first receive itself.
+ * A matrix whose dimensions change gets fresh storage at the end of the
+ * store, the getters follow it through the slot index.
+ */
+uint32_t Transceiver::rx_slot_find(uint32_t type, const std::string &name, uint32_t rows, uint32_t cols) {
+    auto found = rx_index.find(std::make_pair(type, name));
+    uint32_t idx;
+
+    if (found == rx_index.end()) {
+        struct rx_slot slot = { name, type, 0, 0, (uint32_t)rx_store.size(), 0 };
+        switch (type) {
+            case DOUBLE:          slot.size = sizeof(double); break;
+            case STRUCT:          slot.size = sizeof(transmit_channel) * 12; break;
+            case DOWNLINK_STRUCT: slot.size = sizeof(refactor_downlink_packet_t); break;
+            case UPLINK_STRUCT:   slot.size = sizeof(refactor_uplink_packet_t); break;
+        }
+        idx = rx_slots.size();
+        rx_slots.push_back(slot);
+        rx_store.resize(rx_store.size() + (slot.size + sizeof(double) - 1) / sizeof(double), 0.0);
+        rx_index[std::make_pair(type, name)] = idx;
+    } else {
+        idx = found->second;
     }
 
-    for (auto it = data_double_out.begin(); it != data_double_out.end(); ++it) {
-        struct generic_header gh = { .type = DOUBLE, .name_length = (unsigned int)it->first.length() };
+    struct rx_slot &slot = rx_slots[idx];
+    if (type == MAT && rows * cols != 0 && (slot.rows != rows || slot.cols != cols)) {
+        slot.rows = rows;
+        slot.cols = cols;
+        slot.size = rows * cols * sizeof(double);
+        slot.offset = rx_store.size();
+        rx_store.resize(rx_store.size() + rows * cols, 0.0);
+    }
+    return idx;
+}
+
+void Transceiver::transmit_schema() {
+    std::vector<char> schema;
+    uint32_t payload_size = 0;
+    uint32_t count = tx_double.size() + tx_mat.size() + tx_gpsr.size() + tx_downlink.size() + tx_uplink.size();
+
+    auto add_entry = [&schema, &payload_size](uint32_t type, const std::string &name, uint32_t rows, uint32_t cols, uint32_t size) {
+        struct schema_entry se = { .type = type, .rows = rows, .cols = cols, .name_length = (uint32_t)name.length() };
+        append(schema, &se, sizeof(se));
+        append(schema, name.data(), name.length());
+        payload_size += size;
+    };
+
+    schema.resize(sizeof(struct schema_header));
+    for (auto it = tx_double.begin(); it != tx_double.end(); ++it)
+        add_entry(DOUBLE, it->name, 1, 1, it->size);
+    for (auto it = tx_mat.begin(); it != tx_mat.end(); ++it) {
+        arma::mat tmp;
+        const arma::mat &m = tx_value(*it, tmp);
+        it->size = m.n_elem * sizeof(double);
+        add_entry(MAT, it->name, m.n_rows, m.n_cols, it->size);
+    }
+    for (auto it = tx_gpsr.begin(); it != tx_gpsr.end(); ++it)
+        add_entry(STRUCT, it->name, 12, 1, it->size);
+    for (auto it = tx_downlink.begin(); it != tx_downlink.end(); ++it)
+        add_entry(DOWNLINK_STRUCT, it->name, 1, 1, it->size);
+    for (auto it = tx_uplink.begin(); it != tx_uplink.end(); ++it)
+        add_entry(UPLINK_STRUCT, it->name, 1, 1, it->size);
+
+    struct schema_header sh = { .magic = TR_SCHEMA_MAGIC, .count = count, .options = tx_options, .payload_size = payload_size };
+    memcpy(schema.data(), &sh, sizeof(sh));
+    if (link_write(schema.data(), schema.size()) != (int)schema.size())
+        return;  // sent again ahead of the next frame
+
+    tx_frame.assign(sizeof(struct frame_header) + payload_size + ((tx_options & TR_PACKED_CRC) ? sizeof(uint32_t) : 0), 0);
+    schema_sent = 1;
+}
+
+void Transceiver::transmit_packed() {
+    if (!link_valid())
+        return;
+    if (!schema_sent) {
+        transmit_schema();
+        if (!schema_sent)
+            return;
+    }
+
+    char *p = tx_frame.data() + sizeof(struct frame_header);
+    for (auto it = tx_double.begin(); it != tx_double.end(); ++it) {
         double tmp;
-        char buf[256];
-        snprintf(buf, sizeof(buf), "%s", it->first.c_str());
-        tc_write(&dev, reinterpret_cast<char*>(&gh), sizeof(gh));
-        tc_write(&dev, buf, gh.name_length);
-        tmp = it->second();
-        tc_write(&dev, reinterpret_cast<char*>(&tmp), sizeof(double));
+        memcpy(p, &tx_value(*it, tmp), sizeof(double));
+        p += sizeof(double);
+    }
+    for (auto it = tx_mat.begin(); it != tx_mat.end(); ++it) {
+        arma::mat tmp;
+        const arma::mat &m = tx_value(*it, tmp);
+        if (m.n_elem * sizeof(double) != it->size) throw std::runtime_error("Matrix size changed in packed mode");
+        memcpy(p, m.memptr(), it->size);
+        p += it->size;
+    }
+    for (auto it = tx_gpsr.begin(); it != tx_gpsr.end(); ++it) {
+        memcpy(p, tx_gpsr_data(*it), it->size);
+        p += it->size;
+    }
+    for (auto it = tx_downlink.begin(); it != tx_downlink.end(); ++it) {
+        refactor_downlink_packet_t tmp;
+        memcpy(p, &tx_value(*it, tmp), sizeof(refactor_downlink_packet_t));
+        p += sizeof(refactor_downlink_packet_t);
+    }
+    for (auto it = tx_uplink.begin(); it != tx_uplink.end(); ++it) {
+        refactor_uplink_packet_t tmp;
+        memcpy(p, &tx_value(*it, tmp), sizeof(refactor_uplink_packet_t));
+        p += sizeof(refactor_uplink_packet_t);
     }
 
-    for (auto it = data_mat_out.begin(); it != data_mat_out.end(); ++it) {
-        struct generic_header gh = { .type = MAT, .name_length = (unsigned int)it->first.length() };
-        struct mat_header mh = { .x = it->second().n_rows, .y = it->second().n_cols };
-        char buf[256];
-        snprintf(buf, sizeof(buf), "%s", it->first.c_str());
-        tc_write(&dev, reinterpret_cast<char*>(&gh), sizeof(gh));
-        tc_write(&dev, reinterpret_cast<char*>(&mh), sizeof(mh));
-        tc_write(&dev, buf, gh.name_length);
+    struct frame_header fh = { .magic = TR_FRAME_MAGIC,
+                               .seq = (tx_options & TR_PACKED_SEQ) ? ++tx_seq : 0,
+                               .payload_size = (uint32_t)(p - tx_frame.data() - sizeof(struct frame_header)) };
+    memcpy(tx_frame.data(), &fh, sizeof(fh));
+    if (tx_options & TR_PACKED_CRC) {
+        uint32_t crc = crc32_ieee(tx_frame.data(), p - tx_frame.data());
+        memcpy(p, &crc, sizeof(uint32_t));
+    }
+    link_write(tx_frame.data(), tx_frame.size());
+}
 
-        auto out_fn = [this](double& val) { tc_write(&dev, reinterpret_cast<char*>(&val), sizeof(double)); };
-        it->second().for_each(out_fn);
+/*
+ * Legacy stream format, assembled in tx_frame and sent in one write. The
+ * entries go by type, each type in registration order (it was name order);
+ * the receiver matches them by name.
+ */
+void Transceiver::transmit() {
+    if (packed_mode) {
+        transmit_packed();
+        return;
     }
+    if (!link_valid())
+        return;
 
-    for (auto it = data_gpsr_out.begin(); it != data_gpsr_out.end(); ++it) {
-        struct generic_header gh = { .type = STRUCT, .name_length = (unsigned int)it->first.length() };
-        transmit_channel * tmp;
-        char buf[256];
-        snprintf(buf, sizeof(buf), "%s", it->first.c_str());
-        tc_write(&dev, reinterpret_cast<char*>(&gh), sizeof(gh));
-        tc_write(&dev, buf, gh.name_length);
-        tmp = it->second();
-        tc_write(&dev, reinterpret_cast<char*>(tmp), sizeof(transmit_channel)*12);
+    uint32_t size = tx_double.size() + tx_mat.size() + tx_gpsr.size() + tx_downlink.size() + tx_uplink.size();
+    tx_frame.clear();
+    append(tx_frame, &size, sizeof(uint32_t));
+
+    for (auto it = tx_double.begin(); it != tx_double.end(); ++it) {
+        struct generic_header gh = { .type = DOUBLE, .name_length = (unsigned int)it->name.length() };
+        double tmp;
+        append(tx_frame, &gh, sizeof(gh));
+        append(tx_frame, it->name.data(), gh.name_length);
+        append(tx_frame, &tx_value(*it, tmp), sizeof(double));
+    }
+
+    for (auto it = tx_mat.begin(); it != tx_mat.end(); ++it) {
+        arma::mat tmp;
+        const arma::mat &m = tx_value(*it, tmp);
+        struct generic_header gh = { .type = MAT, .name_length = (unsigned int)it->name.length() };
+        struct mat_header mh = { .x = m.n_rows, .y = m.n_cols };
+        append(tx_frame, &gh, sizeof(gh));
+        append(tx_frame, &mh, sizeof(mh));
+        append(tx_frame, it->name.data(), gh.name_length);
+        append(tx_frame, m.memptr(), m.n_elem * sizeof(double));
     }
 
-    for (auto it = data_downlink_out.begin(); it != data_downlink_out.end(); ++it) {
-        struct generic_header gh = { .type = DOWNLINK_STRUCT, .name_length = (unsigned int)it->first.length() };
+    for (auto it = tx_gpsr.begin(); it != tx_gpsr.end(); ++it) {
+        struct generic_header gh = { .type = STRUCT, .name_length = (unsigned int)it->name.length() };
+        append(tx_frame, &gh, sizeof(gh));
+        append(tx_frame, it->name.data(), gh.name_length);
+        append(tx_frame, tx_gpsr_data(*it), it->size);
+    }
+
+    for (auto it = tx_downlink.begin(); it != tx_downlink.end(); ++it) {
+        struct generic_header gh = { .type = DOWNLINK_STRUCT, .name_length = (unsigned int)it->name.length() };
         refactor_downlink_packet_t tmp;
-        char buf[256];
-        snprintf(buf, sizeof(buf), "%s", it->first.c_str());
-        tc_write(&dev, reinterpret_cast<char*>(&gh), sizeof(gh));
-        tc_write(&dev, buf, gh.name_length);
-        tmp = it->second();
-        tc_write(&dev, reinterpret_cast<char*>(&tmp), sizeof(refactor_downlink_packet_t));
+        append(tx_frame, &gh, sizeof(gh));
+        append(tx_frame, it->name.data(), gh.name_length);
+        append(tx_frame, &tx_value(*it, tmp), sizeof(refactor_downlink_packet_t));
     }
 
-    for (auto it = data_uplink_out.begin(); it != data_uplink_out.end(); ++it) {
-        struct generic_header gh = { .type = UPLINK_STRUCT, .name_length = (unsigned int)it->first.length() };
+    for (auto it = tx_uplink.begin(); it != tx_uplink.end(); ++it) {
+        struct generic_header gh = { .type = UPLINK_STRUCT, .name_length = (unsigned int)it->name.length() };
         refactor_uplink_packet_t tmp;
+        append(tx_frame, &gh, sizeof(gh));
+        append(tx_frame, it->name.data(), gh.name_length);
+        append(tx_frame, &tx_value(*it, tmp), sizeof(refactor_uplink_packet_t));
+    }
+
+    link_write(tx_frame.data(), tx_frame.size());
+}
+
+/* the schema magic is already consumed, in place of the entry count */
+void Transceiver::receive_schema() {
+    struct schema_header sh;
+    uint32_t payload_size = 0;
+    if (link_read(reinterpret_cast<char*>(&sh.count), sizeof(sh) - sizeof(sh.magic)) != sizeof(sh) - sizeof(sh.magic))
+        throw std::runtime_error("Received Data Corrupted");
+
+    rx_layout.clear();
+    for (uint32_t i = 0; i < sh.count; i++) {
+        struct schema_entry se;
         char buf[256];
-        snprintf(buf, sizeof(buf), "%s", it->first.c_str());
-        tc_write(&dev, reinterpret_cast<char*>(&gh), sizeof(gh));
-        tc_write(&dev, buf, gh.name_length);
-        tmp = it->second();
-        tc_write(&dev, reinterpret_cast<char*>(&tmp), sizeof(refactor_uplink_packet_t));
+        if (link_read(reinterpret_cast<char*>(&se), sizeof(se)) != sizeof(se)
+            || se.name_length >= sizeof(buf) || se.type > UPLINK_STRUCT
+            || link_read(buf, se.name_length) != (int)se.name_length)
+            throw std::runtime_error("Received Data Corrupted");
+        buf[se.name_length] = '\0';
+
+        uint32_t idx = rx_slot_find(se.type, std::string(buf), se.rows, se.cols);
+        rx_layout.push_back(idx);
+        payload_size += rx_slots[idx].size;
+    }
+    if (payload_size != sh.payload_size) throw std::runtime_error("Received Data Corrupted");
+
+    rx_options = sh.options;
+    rx_frame.assign(sizeof(struct frame_header) + payload_size + ((rx_options & TR_PACKED_CRC) ? sizeof(uint32_t) : 0), 0);
+    rx_packed = 1;
+}
+
+/* a frame cut short by the link going down is dropped, the values stay those of the last frame */
+void Transceiver::receive_packed() {
+    struct frame_header fh;
+    const char *p = rx_frame.data() + sizeof(struct frame_header);
+
+    if (!link_valid())
+        return;
+    if (link_read(rx_frame.data(), rx_frame.size()) != (int)rx_frame.size())
+        return;
+    memcpy(&fh, rx_frame.data(), sizeof(fh));
+    if (fh.magic != TR_FRAME_MAGIC || fh.payload_size != rx_frame.size() - sizeof(fh)
+                                      - ((rx_options & TR_PACKED_CRC) ? sizeof(uint32_t) : 0))
+        throw std::runtime_error("Received Data Corrupted");
+    if (rx_options & TR_PACKED_CRC) {
+        uint32_t crc;
+        memcpy(&crc, p + fh.payload_size, sizeof(uint32_t));
+        if (crc != crc32_ieee(rx_frame.data(), sizeof(fh) + fh.payload_size))
+            throw std::runtime_error("Received Data Corrupted");
+    }
+    if (rx_options & TR_PACKED_SEQ) {
+        if (fh.seq != rx_seq + 1)
+            rx_seq_errors++;
+        rx_seq = fh.seq;
+    }
+
+    for (auto idx = rx_layout.begin(); idx != rx_layout.end(); ++idx) {
+        memcpy(rx_data(*idx), p, rx_slots[*idx].size);
+        p += rx_slots[*idx].size;
     }
 }
 
+/*
+ * Legacy stream. The peer sends its entries in the same order every cycle,
+ * so the slot of entry i is looked up by name once and remembered in
+ * rx_layout; later cycles only confirm the name against it.
+ */
 void Transceiver::receive() {
-    uint32_t size;
-    if (tc_isValid(&dev)) {
-        tc_read(&dev, reinterpret_cast<char*>(&size), sizeof(uint32_t));
+    uint32_t size = 0;
+    if (rx_packed) {
+        receive_packed();
+        return;
     }
 
-    for (int i = 0; i < size; i++) {
-        char *buf;
+    if (!link_valid())
+        return;
+    if (link_read(reinterpret_cast<char*>(&size), sizeof(uint32_t)) != sizeof(uint32_t))
+        return;
+    if (size == TR_SCHEMA_MAGIC) {
+        receive_schema();
+        receive_packed();
+        return;
+    }
+
+    if (rx_layout.size() > size)
+        rx_layout.resize(size);
+    for (uint32_t i = 0; i < size; i++) {
+        char buf[256];
         struct generic_header gh;
-        struct mat_header mh;
-        tc_read(&dev, reinterpret_cast<char*>(&gh), sizeof(gh));
-        switch (gh.type) {
-            case DOUBLE:
-                {
-                    buf = new char[gh.name_length + 1];
-                    tc_read(&dev, buf, gh.name_length);
-                    buf[gh.name_length] = '\0';
-                    std::string name(buf);
-                    delete[] buf;
-
-                    double in;
-                    tc_read(&dev, reinterpret_cast<char*>(&in), sizeof(double));
-                    data_double_in[name] = in;
-                }
-                break;
-            case MAT:
-                {
-                    tc_read(&dev, reinterpret_cast<char*>(&mh), sizeof(mh));
-                    buf = new char[gh.name_length + 1];
-                    tc_read(&dev, buf, gh.name_length);
-                    buf[gh.name_length] = '\0';
-                    std::string name(buf);
-                    delete[] buf;
-
-                    arma::mat in(mh.x, mh.y);
-                    auto in_fn = [this](double& val) { tc_read(&dev, reinterpret_cast<char*>(&val), sizeof(double)); };
-                    in.for_each(in_fn);
-                    if (!data_mat_in.count(name)) {
-                        data_mat_in.insert(std::make_pair(name, in));
-                    } else {
-                        data_mat_in[name] = in;
-                    }
-                }
-                break;
-            case STRUCT:
-                {
-                    buf = new char[gh.name_length];
-                    tc_read(&dev, buf, gh.name_length);
-                    buf[gh.name_length] = '\0';
-                    std::string name(buf);
-                    delete[] buf;
-
-                    transmit_channel * in;
-                    in = new transmit_channel[12];
-                    tc_read(&dev, reinterpret_cast<char*>(in), sizeof(transmit_channel)*12);
-                    data_gpsr_in[name] = in;
-                }
-                break;
-            case DOWNLINK_STRUCT:
-                {
-                    buf = new char[gh.name_length + 1];
-                    tc_read(&dev, buf, gh.name_length);
-                    buf[gh.name_length] = '\0';
-                    std::string name(buf);
-                    delete[] buf;
-
-                    refactor_downlink_packet_t in;
-                    tc_read(&dev, reinterpret_cast<char*>(&in), sizeof(refactor_downlink_packet_t));
-                    data_downlink_in[name] = in;
-                }
-                break;
-            case UPLINK_STRUCT:
-                {
-                    buf = new char[gh.name_length + 1];
-                    tc_read(&dev, buf, gh.name_length);
-                    buf[gh.name_length] = '\0';
-                    std::string name(buf);
-                    delete[] buf;
-
-                    refactor_uplink_packet_t in;
-                    tc_read(&dev, reinterpret_cast<char*>(&in), sizeof(refactor_uplink_packet_t));
-                    data_uplink_in[name] = in;
-                }
-                break;
-            default:
-                throw std::runtime_error("Received Data Corrupted");
-                break;
+        struct mat_header mh = { .x = 1, .y = 1 };
+        link_read(reinterpret_cast<char*>(&gh), sizeof(gh));
+        if (gh.type > UPLINK_STRUCT || gh.name_length >= sizeof(buf)) throw std::runtime_error("Received Data Corrupted");
+        if (gh.type == MAT)
+            link_read(reinterpret_cast<char*>(&mh), sizeof(mh));
+        link_read(buf, gh.name_length);
+
+        uint32_t idx;
+        if (i < rx_layout.size()) {
+            struct rx_slot &slot = rx_slots[rx_layout[i]];
+            if (slot.type == gh.type && slot.name.length() == gh.name_length
+                && memcmp(slot.name.data(), buf, gh.name_length) == 0
+                && (gh.type != MAT || (slot.rows == mh.x && slot.cols == mh.y))) {
+                idx = rx_layout[i];
+            } else {
+                idx = rx_layout[i] = rx_slot_find(gh.type, std::string(buf, gh.name_length), mh.x, mh.y);
+            }
+        } else {
+            idx = rx_slot_find(gh.type, std::string(buf, gh.name_length), mh.x, mh.y);
+            rx_layout.push_back(idx);
         }
+        link_read(rx_data(idx), rx_slots[idx].size);
     }
 
     return;
@@ -233,21 +502,29 @@ TransceiverProxy Transceiver::operator()(std::string cid, std::string id) {
 }
 
 std::function<double()> Transceiver::get_double(std::string cid, std::string id) {
-    return [this, cid, id](){ return data_double_in[cid + "." + id]; };
+    uint32_t idx = rx_slot_find(DOUBLE, cid + "." + id, 1, 1);
+    return [this, idx](){ return *reinterpret_cast<double*>(rx_data(idx)); };
 }
 
 std::function<arma::mat()> Transceiver::get_mat(std::string cid, std::string id) {
-    return [this, cid, id](){ return data_mat_in[cid + "." + id]; };
+    uint32_t idx = rx_slot_find(MAT, cid + "." + id, 0, 0);
+    return [this, idx](){
+        const struct rx_slot &slot = rx_slots[idx];
+        return arma::mat(rx_store.data() + slot.offset, slot.rows, slot.cols);
+    };
 }
 
 std::function<transmit_channel *()> Transceiver::get_gpsr(std::string cid, std::string id) {
-    return [this, cid, id](){ return data_gpsr_in[cid + "." + id]; };
+    uint32_t idx = rx_slot_find(STRUCT, cid + "." + id, 12, 1);
+    return [this, idx](){ return reinterpret_cast<transmit_channel*>(rx_data(idx)); };
 }
 
 std::function<refactor_downlink_packet_t()> Transceiver::get_downlink(std::string cid, std::string id) {
-    return [this, cid, id](){ return data_downlink_in[cid + "." + id]; };
+    uint32_t idx = rx_slot_find(DOWNLINK_STRUCT, cid + "." + id, 1, 1);
+    return [this, idx](){ return *reinterpret_cast<refactor_downlink_packet_t*>(rx_data(idx)); };
 }
 
 std::function<refactor_uplink_packet_t()> Transceiver::get_uplink(std::string cid, std::string id) {
-    return [this, cid, id](){ return data_uplink_in[cid + "." + id]; };
+    uint32_t idx = rx_slot_find(UPLINK_STRUCT, cid + "." + id, 1, 1);
+    return [this, idx](){ return *reinterpret_cast<refactor_uplink_packet_t*>(rx_data(idx)); };
 }
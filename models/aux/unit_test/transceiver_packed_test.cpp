@@ -0,0 +1,332 @@
+#include "transceiver.hh"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+/*
+ * Master -> slave Transceiver link over a socketpair, legacy stream against
+ * packed mode, with a stand-in for the Trick comm calls that counts them.
+ *
+ * The master switches to packed mode mid-run, the slave has to pick up the
+ * schema on its own. Every value must arrive intact in both modes, its
+ * channel registered as a getter or as a variable read in place. Packed
+ * frames must take one tc_write and one tc_read per cycle, a corrupted
+ * frame must be rejected by the CRC and a frame cut short by the link
+ * closing must be dropped. Two ends then exchange packed frames both ways
+ * with different frame options, after a failed schema write. The same
+ * exchange is then repeated over the shared memory transport.
+ */
+
+static const int N_DOUBLE = 40;
+static const int N_VEC3 = 6;
+static const int N_MAT33 = 2;
+static const int N_CYCLES = 2000;
+
+static int pair_fd[2];
+static int n_connect = 0;
+static long n_write = 0, n_read = 0;
+static bool corrupt_next = false;
+static bool truncate_next = false;
+static bool fail_next = false;
+
+/* Trick comm stand-in: blocking reads and writes on the socketpair */
+extern "C" {
+int trick_error_init(TrickErrorHndlr *error_handle, TrickErrorFuncPtr error_func,
+                     TrickErrorDataPtr error_data, TrickErrorLevel report_level) {
+    return 0;
+}
+
+int tc_multiconnect(TCDevice *dev_ptr, char *my_tag, char *other_tags, TrickErrorHndlr *not_used) {
+    dev_ptr->socket = pair_fd[n_connect++ % 2];
+    return TC_SUCCESS;
+}
+
+int tc_blockio(TCDevice *device, TCCommBlocking blockio_type) {
+    return 0;
+}
+
+int tc_isValid(TCDevice *device) {
+    return device->socket >= 0;
+}
+
+int tc_write(TCDevice *device, char *buffer, int size) {
+    int offset = 0;
+    n_write++;
+    if (fail_next) {
+        fail_next = false;
+        return -1;
+    }
+    if (corrupt_next && size > 64) {
+        buffer[size / 2] ^= 0x10;
+        corrupt_next = false;
+    }
+    if (truncate_next) {
+        /* half the frame, then the peer sees the link close */
+        size /= 2;
+        truncate_next = false;
+        if (write(device->socket, buffer, size) != size) return -1;
+        shutdown(device->socket, SHUT_WR);
+        return size;
+    }
+    while (offset < size) {
+        int n = write(device->socket, buffer + offset, size - offset);
+        if (n <= 0) return -1;
+        offset += n;
+    }
+    return size;
+}
+
+int tc_read(TCDevice *device, char *buffer, int size) {
+    int offset = 0;
+    n_read++;
+    while (offset < size) {
+        int n = read(device->socket, buffer + offset, size - offset);
+        if (n <= 0) return -1;
+        offset += n;
+    }
+    return size;
+}
+}
+
+struct Source {
+    double d[N_DOUBLE];
+    arma::vec3 v[N_VEC3];
+    arma::mat33 m[N_MAT33];
+    transmit_channel gps[12];
+    refactor_downlink_packet_t downlink;
+
+    void update(int cycle) {
+        for (int i = 0; i < N_DOUBLE; i++) d[i] = cycle * 100.0 + i + 0.25;
+        for (int i = 0; i < N_VEC3; i++)
+            for (int k = 0; k < 3; k++) v[i](k) = cycle - i * 3.0 - k;
+        for (int i = 0; i < N_MAT33; i++)
+            for (int k = 0; k < 9; k++) m[i](k % 3, k / 3) = cycle * 0.5 + i * 9 + k;
+        for (int i = 0; i < 12; i++) {
+            memset(&gps[i], 0, sizeof(gps[i]));
+            gps[i].prn = cycle + i;
+            gps[i].range = 2.0e7 + cycle;
+        }
+        memset(&downlink, 0, sizeof(downlink));
+        downlink.theta_a_cmd = cycle * 0.01;
+        downlink.flight_event_code = cycle;
+    }
+};
+
+struct Sink {
+    std::function<double()> d[N_DOUBLE];
+    std::function<arma::vec3()> v[N_VEC3];
+    std::function<arma::mat33()> m[N_MAT33];
+    std::function<transmit_channel*()> gps;
+    std::function<refactor_downlink_packet_t()> downlink;
+
+    /* number of values that do not match the source */
+    int compare(const Source &src) {
+        int bad = 0;
+        for (int i = 0; i < N_DOUBLE; i++) bad += d[i]() != src.d[i];
+        for (int i = 0; i < N_VEC3; i++) {
+            arma::vec3 in = v[i]();
+            for (int k = 0; k < 3; k++) bad += in(k) != src.v[i](k);
+        }
+        for (int i = 0; i < N_MAT33; i++) {
+            arma::mat33 in = m[i]();
+            for (int k = 0; k < 9; k++) bad += in(k % 3, k / 3) != src.m[i](k % 3, k / 3);
+        }
+        bad += memcmp(gps(), src.gps, sizeof(src.gps)) != 0;
+        refactor_downlink_packet_t dl = downlink();
+        bad += memcmp(&dl, &src.downlink, sizeof(dl)) != 0;
+        return bad;
+    }
+};
+
+static void register_source(Transceiver &tx, Source &src) {
+    char id[32];
+    for (int i = 0; i < N_DOUBLE; i++) {
+        snprintf(id, sizeof(id), "d%02d", i);
+        if (i % 2)
+            tx.register_for_transmit("src", id, &src.d[i]);
+        else
+            tx.register_for_transmit("src", id, std::function<double()>([&src, i]() { return src.d[i]; }));
+    }
+    for (int i = 0; i < N_VEC3; i++) {
+        snprintf(id, sizeof(id), "v%02d", i);
+        tx.register_for_transmit("src", id, &src.v[i]);
+    }
+    for (int i = 0; i < N_MAT33; i++) {
+        snprintf(id, sizeof(id), "m%02d", i);
+        tx.register_for_transmit("src", id, std::function<arma::mat()>([&src, i]() -> arma::mat { return src.m[i]; }));
+    }
+    tx.register_for_transmit("src", "gps", src.gps);
+    tx.register_for_transmit("src", "downlink", std::function<refactor_downlink_packet_t()>([&src]() { return src.downlink; }));
+}
+
+static void bind_sink(Transceiver &rx, Sink &sink) {
+    char id[32];
+    for (int i = 0; i < N_DOUBLE; i++) {
+        snprintf(id, sizeof(id), "d%02d", i);
+        sink.d[i] = rx("src", id);
+    }
+    for (int i = 0; i < N_VEC3; i++) {
+        snprintf(id, sizeof(id), "v%02d", i);
+        sink.v[i] = rx("src", id);
+    }
+    for (int i = 0; i < N_MAT33; i++) {
+        snprintf(id, sizeof(id), "m%02d", i);
+        sink.m[i] = rx("src", id);
+    }
+    sink.gps = rx("src", "gps");
+    sink.downlink = rx("src", "downlink");
+}
+
+struct RunResult {
+    int bad;
+    double writes, reads, us;
+};
+
+static RunResult run(Transceiver &master, Transceiver &slave, Source &src, Sink &sink, int first_cycle) {
+    RunResult res = {0, 0.0, 0.0, 0.0};
+    long w0 = n_write, r0 = n_read;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int c = first_cycle; c < first_cycle + N_CYCLES; c++) {
+        src.update(c);
+        master.transmit();
+        slave.receive();
+        res.bad += sink.compare(src);
+    }
+    res.us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / N_CYCLES;
+    res.writes = static_cast<double>(n_write - w0) / N_CYCLES;
+    res.reads = static_cast<double>(n_read - r0) / N_CYCLES;
+    return res;
+}
+
+static int check(const char *what, bool ok) {
+    fprintf(stderr, "%s %s\n", ok ? "PASS" : "FAIL", what);
+    return !ok;
+}
+
+int main(int argc, char const *argv[]) {
+    Transceiver master, slave;
+    Source src;
+    Sink sink;
+    int failed = 0;
+    char master_name[] = "master", slave_name[] = "slave";
+
+    fprintf(stderr, "** Transceiver packed mode test **\n");
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair_fd) < 0) {
+        perror("socketpair");
+        return 1;
+    }
+    master.initialize_connection(master_name);
+    slave.initialize_connection(slave_name);
+    register_source(master, src);
+    bind_sink(slave, sink);
+
+    RunResult legacy = run(master, slave, src, sink, 0);
+    failed += check("legacy stream values", legacy.bad == 0);
+
+    /* one schema cycle, then steady state */
+    master.set_packed_mode(1);
+    src.update(N_CYCLES);
+    master.transmit();
+    slave.receive();
+    failed += check("schema picked up by the slave", sink.compare(src) == 0);
+    RunResult packed = run(master, slave, src, sink, N_CYCLES + 1);
+    failed += check("packed frame values", packed.bad == 0 && slave.get_rx_seq_errors() == 0);
+    failed += check("one tc_write and one tc_read per packed cycle", packed.writes == 1.0 && packed.reads == 1.0);
+    fprintf(stderr, "     %d channels: legacy %.0f tc_write + %.0f tc_read, %.1f us per cycle; "
+            "packed %.0f + %.0f, %.1f us per cycle\n",
+            N_DOUBLE + N_VEC3 + N_MAT33 + 2, legacy.writes, legacy.reads, legacy.us,
+            packed.writes, packed.reads, packed.us);
+
+    bool rejected = false;
+    corrupt_next = true;
+    master.transmit();
+    try {
+        slave.receive();
+    } catch (std::runtime_error &e) {
+        rejected = true;
+    }
+    failed += check("corrupted frame rejected by the CRC", rejected);
+
+    bool locked = false;
+    try {
+        master.register_for_transmit("src", "late", std::function<double()>([]() { return 0.0; }));
+    } catch (std::logic_error &e) {
+        locked = true;
+    }
+    failed += check("layout locked once the schema is out", locked);
+
+    Source last = src;
+    src.update(3 * N_CYCLES);
+    truncate_next = true;
+    master.transmit();
+    bool dropped = true;
+    try {
+        slave.receive();
+    } catch (std::runtime_error &e) {
+        dropped = false;
+    }
+    failed += check("truncated frame dropped, last values kept", dropped && sink.compare(last) == 0);
+
+    close(pair_fd[0]);
+    close(pair_fd[1]);
+
+    /* both ways, the peer schema must not change the options of the frames sent */
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair_fd) < 0) {
+        perror("socketpair");
+        return 1;
+    }
+    Transceiver end_a, end_b;
+    Source src_b;
+    Sink sink_a, sink_b;
+    end_a.initialize_connection(master_name);
+    end_b.initialize_connection(slave_name);
+    register_source(end_a, src);
+    bind_sink(end_b, sink_b);
+    register_source(end_b, src_b);
+    bind_sink(end_a, sink_a);
+    end_a.set_packed_mode(1, TR_PACKED_SEQ);
+    end_b.set_packed_mode(1, TR_PACKED_SEQ | TR_PACKED_CRC);
+    fail_next = true;
+    end_a.transmit();
+    int both_bad = 0;
+    for (int c = 0; c < N_CYCLES; c++) {
+        src.update(c);
+        src_b.update(c + 7);
+        end_b.transmit();
+        end_a.receive();
+        end_a.transmit();
+        end_b.receive();
+        both_bad += sink_a.compare(src_b) + sink_b.compare(src);
+    }
+    failed += check("failed schema write sent again, both ways with their own options",
+                    both_bad == 0 && end_a.get_rx_seq_errors() == 0 && end_b.get_rx_seq_errors() == 0);
+    close(pair_fd[0]);
+    close(pair_fd[1]);
+
+    /* shared memory: the two ends pair up on their own, no Trick comm calls */
+    Transceiver shm_master, shm_slave;
+    Sink shm_sink;
+    long w0 = n_write, r0 = n_read;
+    shm_master.set_transport(TR_TRANSPORT_SHM);
+    shm_slave.set_transport(TR_TRANSPORT_SHM);
+    std::thread peer([&shm_slave, slave_name]() { shm_slave.initialize_connection(const_cast<char*>(slave_name)); });
+    shm_master.initialize_connection(master_name);
+    peer.join();
+    register_source(shm_master, src);
+    bind_sink(shm_slave, shm_sink);
+    RunResult shm_legacy = run(shm_master, shm_slave, src, shm_sink, 0);
+    shm_master.set_packed_mode(1);
+    RunResult shm_packed = run(shm_master, shm_slave, src, shm_sink, N_CYCLES);
+    failed += check("shared memory transport values, legacy and packed",
+                    shm_legacy.bad == 0 && shm_packed.bad == 0 && n_write == w0 && n_read == r0);
+    fprintf(stderr, "     shared memory: legacy %.1f us per cycle, packed %.1f us per cycle\n",
+            shm_legacy.us, shm_packed.us);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+#include "transceiver.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/*
+ * Per-cycle cost of the Transceiver registry with 150 registered channels.
+ *
+ * The Trick comm calls are replaced by an in-memory loopback so the numbers
+ * are the registry walk, the (de)serialisation and the consumer side getters,
+ * not the socket. Each cycle the master transmits, the slave receives and
+ * every bound getter is read once, as the slave models do.
+ */
+
+static const int N_DOUBLE = 120;
+static const int N_VEC3 = 20;
+static const int N_MAT33 = 8;
+static const int N_CHANNELS = N_DOUBLE + N_VEC3 + N_MAT33 + 2;
+static const int N_CYCLES = 20000;
+
+/* loopback: tc_write appends, tc_read consumes */
+static std::vector<char> wire;
+static size_t wire_pos = 0;
+
+extern "C" {
+int trick_error_init(TrickErrorHndlr *error_handle, TrickErrorFuncPtr error_func,
+                     TrickErrorDataPtr error_data, TrickErrorLevel report_level) {
+    return 0;
+}
+
+int tc_multiconnect(TCDevice *dev_ptr, char *my_tag, char *other_tags, TrickErrorHndlr *not_used) {
+    dev_ptr->socket = 0;
+    return TC_SUCCESS;
+}
+
+int tc_blockio(TCDevice *device, TCCommBlocking blockio_type) {
+    return 0;
+}
+
+int tc_isValid(TCDevice *device) {
+    return 1;
+}
+
+int tc_write(TCDevice *device, char *buffer, int size) {
+    wire.insert(wire.end(), buffer, buffer + size);
+    return size;
+}
+
+int tc_read(TCDevice *device, char *buffer, int size) {
+    if (wire_pos + size > wire.size()) return -1;
+    memcpy(buffer, wire.data() + wire_pos, size);
+    wire_pos += size;
+    if (wire_pos == wire.size()) {
+        wire.clear();
+        wire_pos = 0;
+    }
+    return size;
+}
+}
+
+struct Source {
+    double d[N_DOUBLE];
+    arma::vec3 v[N_VEC3];
+    arma::mat33 m[N_MAT33];
+    transmit_channel gps[12];
+    refactor_downlink_packet_t downlink;
+};
+
+struct Sink {
+    std::function<double()> d[N_DOUBLE];
+    std::function<arma::vec3()> v[N_VEC3];
+    std::function<arma::mat33()> m[N_MAT33];
+    std::function<transmit_channel*()> gps;
+    std::function<refactor_downlink_packet_t()> downlink;
+};
+
+static void setup(Transceiver &tx, Transceiver &rx, Source &src, Sink &sink) {
+    char id[32];
+
+    memset(src.gps, 0, sizeof(src.gps));
+    memset(&src.downlink, 0, sizeof(src.downlink));
+    for (int i = 0; i < N_DOUBLE; i++) {
+        src.d[i] = i;
+        snprintf(id, sizeof(id), "double_channel_%03d", i);
+        tx.register_for_transmit("src", id, std::function<double()>([&src, i]() { return src.d[i]; }));
+        sink.d[i] = rx("src", id);
+    }
+    for (int i = 0; i < N_VEC3; i++) {
+        snprintf(id, sizeof(id), "vec3_channel_%03d", i);
+        tx.register_for_transmit("src", id, std::function<arma::mat()>([&src, i]() -> arma::mat { return src.v[i]; }));
+        sink.v[i] = rx("src", id);
+    }
+    for (int i = 0; i < N_MAT33; i++) {
+        snprintf(id, sizeof(id), "mat33_channel_%03d", i);
+        tx.register_for_transmit("src", id, std::function<arma::mat()>([&src, i]() -> arma::mat { return src.m[i]; }));
+        sink.m[i] = rx("src", id);
+    }
+    tx.register_for_transmit("src", "gps", std::function<transmit_channel*()>([&src]() { return src.gps; }));
+    sink.gps = rx("src", "gps");
+    tx.register_for_transmit("src", "downlink", std::function<refactor_downlink_packet_t()>([&src]() { return src.downlink; }));
+    sink.downlink = rx("src", "downlink");
+}
+
+struct Cost {
+    double tx_us, rx_us, get_us;
+    double check;
+};
+
+static Cost run(Transceiver &tx, Transceiver &rx, Source &src, Sink &sink) {
+    typedef std::chrono::steady_clock clock;
+    Cost cost = {0.0, 0.0, 0.0, 0.0};
+
+    for (int c = 0; c < N_CYCLES; c++) {
+        src.d[c % N_DOUBLE] = c;
+        src.v[c % N_VEC3](0) = c;
+        clock::time_point t0 = clock::now();
+        tx.transmit();
+        clock::time_point t1 = clock::now();
+        rx.receive();
+        clock::time_point t2 = clock::now();
+        for (int i = 0; i < N_DOUBLE; i++) cost.check += sink.d[i]();
+        for (int i = 0; i < N_VEC3; i++) cost.check += sink.v[i]()(0);
+        for (int i = 0; i < N_MAT33; i++) cost.check += sink.m[i]()(0, 0);
+        cost.check += sink.gps()[0].prn + sink.downlink().flight_event_code;
+        clock::time_point t3 = clock::now();
+        cost.tx_us += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        cost.rx_us += std::chrono::duration<double, std::micro>(t2 - t1).count();
+        cost.get_us += std::chrono::duration<double, std::micro>(t3 - t2).count();
+    }
+    cost.tx_us /= N_CYCLES;
+    cost.rx_us /= N_CYCLES;
+    cost.get_us /= N_CYCLES;
+    return cost;
+}
+
+static void report(const char *mode, const Cost &cost) {
+    fprintf(stderr, "%-7s transmit %6.2f us  receive %6.2f us  getters %6.2f us  total %6.2f us per cycle\n",
+            mode, cost.tx_us, cost.rx_us, cost.get_us, cost.tx_us + cost.rx_us + cost.get_us);
+}
+
+int main(int argc, char const *argv[]) {
+    Transceiver master, slave;
+    Source src;
+    Sink sink;
+    char master_name[] = "master", slave_name[] = "slave";
+
+    fprintf(stderr, "** Transceiver registry benchmark, %d channels, %d cycles **\n", N_CHANNELS, N_CYCLES);
+    master.initialize_connection(master_name);
+    slave.initialize_connection(slave_name);
+    setup(master, slave, src, sink);
+
+    report("legacy", run(master, slave, src, sink));
+    master.set_packed_mode(1);
+    report("packed", run(master, slave, src, sink));
+
+    return 0;
+}
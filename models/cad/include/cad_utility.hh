@@ -48,6 +48,18 @@ namespace cad {
     std::tuple<double, double, double> geo84_in(arma::vec3 SBII,
                                                 arma::mat33 TEI);
 
+    /**
+     * @brief Geodetic latitude and altitude of an earth-fixed position, the
+     *        iteration of geo84_in()
+     *
+     * @return std::tuple(lat, alt)
+     *                    lat geodetic latitude - rad
+     *                    alt altitude above ellipsoid - m
+     *
+     * @param[in] SBEE(3x1) = Position in ECEF coordinate - m
+     */
+    std::tuple<double, double> geo84_lat_alt(const double SBEE[3]);
+
     /**
      * @return geodetic velocity vector information from inertial postion and
      * velocity
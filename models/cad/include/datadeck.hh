@@ -4,10 +4,13 @@
 PURPOSE:
       (DATADECK class)
 LIBRARY DEPENDENCY:
-      ((../src/datadeck.cpp))
+      ((../src/datadeck.cpp)
+       (../../math/src/crc32.cpp))
 *******************************************************************************/
 #include <string>
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include <iostream>
 
 // sizing of arrays
@@ -21,6 +24,7 @@ class Table {
     int var1_dim;
     int var2_dim;
     int var3_dim;
+    bool mapped;        ///< values live in a compiled deck mapping, not in the vectors
 
  public:
     std::vector<double> var1_values;
@@ -28,9 +32,69 @@ class Table {
     std::vector<double> var3_values;
     std::vector<double> data;
 
-    Table() {}
+    /* Read-only views used by the look-ups: either the vectors above
+       or a compiled deck mapped by Datadeck */
+    const double *var1_ptr;
+    const double *var2_ptr;
+    const double *var3_ptr;
+    const double *data_ptr;
+
+    Table()
+        :   dim(0), var1_dim(1), var2_dim(1), var3_dim(1), mapped(false),
+            var1_ptr(0), var2_ptr(0), var3_ptr(0), data_ptr(0) {}
+    Table(const Table &other)
+        :   name(other.name), dim(other.dim), var1_dim(other.var1_dim),
+            var2_dim(other.var2_dim), var3_dim(other.var3_dim), mapped(other.mapped),
+            var1_values(other.var1_values), var2_values(other.var2_values),
+            var3_values(other.var3_values), data(other.data),
+            var1_ptr(other.var1_ptr), var2_ptr(other.var2_ptr),
+            var3_ptr(other.var3_ptr), data_ptr(other.data_ptr) {
+        if (!mapped) bind_storage();
+    }
+    Table& operator=(const Table &other) {
+        if (&other != this) {
+            Table copy(other);
+            name = copy.name;
+            dim = copy.dim;
+            var1_dim = copy.var1_dim;
+            var2_dim = copy.var2_dim;
+            var3_dim = copy.var3_dim;
+            var1_values.swap(copy.var1_values);
+            var2_values.swap(copy.var2_values);
+            var3_values.swap(copy.var3_values);
+            data.swap(copy.data);
+            if (copy.mapped)
+                bind_storage(copy.var1_ptr, copy.var2_ptr, copy.var3_ptr, copy.data_ptr);
+            else
+                bind_storage();
+        }
+        return *this;
+    }
     virtual ~Table() {}
 
+    /**
+     * @brief Pointing the look-up views at the table's own vectors
+     */
+    void bind_storage() {
+        mapped = false;
+        var1_ptr = var1_values.data();
+        var2_ptr = var2_values.data();
+        var3_ptr = var3_values.data();
+        data_ptr = data.data();
+    }
+
+    /**
+     * @brief Pointing the look-up views at external read-only storage
+     */
+    void bind_storage(const double *var1, const double *var2, const double *var3,
+                      const double *values) {
+        mapped = true;
+        var1_ptr = var1;
+        var2_ptr = var2;
+        var3_ptr = var3;
+        data_ptr = values;
+    }
+
     /**
      * @return dimension of table
      * @author 030710 Created by Peter H Zipfel
@@ -125,12 +189,48 @@ class Table {
     }
 };
 
+/**
+ * @brief Pre-resolved reference to a table of a Datadeck
+ * Obtained once through Datadeck::get_handle() and then passed to
+ * Datadeck::look_up() instead of the table name, so that the lookup
+ * does neither string construction nor table search
+ */
+struct TableHandle {
+    int slot;   /* ** (--) Slot of the table in the deck, -1 if unresolved */
+    int dim;    /* ** (--) Dimension of the table */
+
+    TableHandle() : slot(-1), dim(0) {}
+
+    bool is_valid() const {return slot >= 0;}
+};
+
+struct DatadeckStorage;
+
 class Datadeck {
  private:
     std::string title;
     int capacity;
     int tbl_counter;
     std::vector<Table*> table_ptr;
+    std::unordered_map<std::string, int> table_index;  /* ** (--) Table name to slot */
+    std::shared_ptr<DatadeckStorage> storage;           /* ** (--) Tables owned by the deck */
+    std::vector<int> var_hint;                          /* ** (--) Last bracket per table and axis, 3 per slot */
+
+    /**
+     * @brief Parsing a text deck
+     */
+    void load_text(const char *file_name);
+
+    /**
+     * @brief Mapping a compiled deck, see save_binary()
+     * @return false if the file is not a usable compiled deck
+     */
+    bool load_binary(const char *file_name, bool fallback);
+
+    /**
+     * @brief Aborting on a handle that does not refer to a table of the deck
+     */
+    void check_handle(const TableHandle &tbl);
 
  public:
     Datadeck() {}
@@ -143,6 +243,8 @@ class Datadeck {
      */
     void alloc_mem() {
         table_ptr = std::vector<Table*>(capacity);
+        // the tables are shared by copies of the deck, the look-up hints are not
+        var_hint.assign(3 * capacity, 0);
         // for(int i = 0; i < capacity; i++)
             // table_ptr[i] = new Table();
     }
@@ -190,9 +292,30 @@ class Datadeck {
     void add_table(Table &pt) {
         if (tbl_counter < capacity) {
             table_ptr[tbl_counter] = &pt;
+            // first table of a given name wins, as with the former linear search
+            table_index.insert(std::make_pair(pt.get_name(), tbl_counter));
         }
     }
 
+    /**
+     * @brief Resolving a table name into a handle for repeated look-ups
+     * @return handle of the table, invalid handle if the deck has no such table
+     */
+    TableHandle get_handle(const std::string &name);
+
+    /**
+     * @brief Resolving a table name, aborting if the deck has no such table
+     * To be used for the tables a model cannot run without
+     */
+    TableHandle require_handle(const std::string &name);
+
+    /**
+     * @brief Writing the deck as a compiled deck (versioned, checksummed,
+     * mmap-able), which the constructor picks up as '<text deck>.bdeck'
+     * @return 0 on success, -1 on failure
+     */
+    int save_binary(const char *file_name);
+
     /**
      * @brief Overloaded operator [] returns a 'Table' pointer
      * @author 030711 Created by Peter H Zipfel
@@ -238,6 +361,22 @@ class Datadeck {
      */
     double look_up(std::string name, double value1, double value2, double value3, unsigned int flag);
 
+    /**
+     * @brief Single independent variable look-up through a pre-resolved handle
+     * Aborts on an invalid handle, see TableHandle::is_valid()
+     */
+    double look_up(const TableHandle &tbl, double value1, unsigned int flag);
+
+    /**
+     * @brief Two independent variables look-up through a pre-resolved handle
+     */
+    double look_up(const TableHandle &tbl, double value1, double value2, unsigned int flag);
+
+    /**
+     * @brief Three independent variables look-up through a pre-resolved handle
+     */
+    double look_up(const TableHandle &tbl, double value1, double value2, double value3, unsigned int flag);
+
     /**
      * @brief Table index finder
      * This is a binary search method it is O(lgN)
@@ -247,7 +386,19 @@ class Datadeck {
      *
      * @author 010628 Created by Peter H Zipfel
      */
-    int find_index(int max, double value, std::vector<double> list);
+    int find_index(int max, double value, const std::vector<double> &list);
+
+    /**
+     * @brief Table index finder with bracket caching
+     * Checks the bracket found by the previous call (and its neighbours) first,
+     * falls back to the binary search only when the hint misses, so monotonic
+     * trajectories through the table cost O(1) per look-up.
+     * Returns the same locater as find_index(int, double, const std::vector<double> &)
+     *
+     * @param[in] list breakpoints, max + 1 entries
+     * @param[in,out] hint bracket of the previous call on this axis
+     */
+    static int find_index(int max, double value, const double *list, int *hint);
 
     /**
      * @brief Linear one-dimensional interpolation
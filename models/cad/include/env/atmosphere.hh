@@ -17,6 +17,9 @@ class Atmosphere {
 
     virtual ~Atmosphere() {}
 
+    /* Copy of the concrete model, see Environment(const Environment&) */
+    virtual Atmosphere *clone() const { return new Atmosphere(*this); }
+
     virtual void set_altitude(double altitude_in_meter) {}
 
     virtual double get_temperature_in_kelvin() { return tempk; }
@@ -27,6 +30,12 @@ class Atmosphere {
     virtual double get_speed_of_wind() { return vwind; }
     virtual double get_direction_of_wind() { return dwind; }
 
+    /* State for a Checkpoint (checkpoint.hh), the same for every model */
+    template <typename Visitor> void checkpoint(Visitor &cp) {
+        cp.section("ATMOS");
+        cp(altitude, tempk, density, pressure, vsound, vwind, dwind);
+    }
+
  protected:
     double altitude;
 
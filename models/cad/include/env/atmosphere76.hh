@@ -17,8 +17,13 @@ class Atmosphere76 : public Atmosphere {
 
     virtual ~Atmosphere76();
 
+    virtual Atmosphere *clone() const;
+
     virtual void set_altitude(double altitude_in_meter);
 
+    /* Temperature (K), density (kg/m3) and pressure (pa) at a geometric altitude (m) */
+    static void evaluate(double altitude_in_meter, double *tempk, double *density, double *pressure);
+
  private:
     void update_values();
 };
@@ -15,6 +15,8 @@ class Atmosphere_nasa2002 : public Atmosphere {
 
     virtual ~Atmosphere_nasa2002();
 
+    virtual Atmosphere *clone() const;
+
     virtual void set_altitude(double altitude_in_meter);
 
  private:
@@ -17,10 +17,15 @@ class Atmosphere_weatherdeck : public Atmosphere {
 
     virtual ~Atmosphere_weatherdeck();
 
+    virtual Atmosphere *clone() const;
+
     virtual void set_altitude(double altitude_in_meter);
 
  private:
     Datadeck weathertable;
+    TableHandle density_table;
+    TableHandle pressure_table;
+    TableHandle temperature_table;
 
     void update_values();
 };
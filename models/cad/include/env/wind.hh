@@ -4,10 +4,15 @@
 PURPOSE:
       (wind model interface definition)
 LIBRARY DEPENDENCY:
-      ((../../src/env/wind.cpp))
+      ((../../src/env/wind.cpp)
+       (../../../aux/src/checkpoint.cpp))
 *******************************************************************************/
 #include <armadillo>
 #include <aux.hh>
+#include <stdint.h>
+#include "stochastic.hh"
+
+class Checkpoint;
 
 namespace cad {
 class Wind {
@@ -17,9 +22,13 @@ class Wind {
     char name[256];
 
     Wind(double twind, double vertical_wind);
+    Wind(const Wind &other);
 
     virtual ~Wind() {}
 
+    /* Copy of the concrete model, see Environment(const Environment&) */
+    virtual Wind *clone() const { return new Wind(*this); }
+
     virtual void set_altitude(double altitude_in_meter) {}
     virtual void propagate_VAED(double int_step);
     virtual void apply_turbulance_if_have(double int_step, double dvba, arma::mat33 TBD, double alppx, double phipx);
@@ -47,6 +56,12 @@ class Wind {
         this->gauss_value = gauss_value;
     }
     virtual void disable_turbulance() { has_turbulance = false; }
+    virtual void set_turbulance_seed(uint64_t seed, uint64_t stream) { turb_noise.set_seed(seed, stream); }
+
+    /* State and turbulence stream, the same for every model, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
+
+    static const uint64_t DEFAULT_TURBULANCE_STREAM = 3;
 
  protected:
     bool   has_turbulance;
@@ -77,6 +92,8 @@ class Wind {
     double taux2d;      /* *o (1/s)        First turbulence state variable derivative - 1/s*/
     double tau;         /* *o (m/s)        Turblence velocity component in load factor plane - m/s*/
     double gauss_value; /* *o (--)         White Gaussian noise - ND*/
+
+    RngStream turb_noise;   /* *io (--)        Turbulence white noise stream */
 };
 }  // namespace cad
 
@@ -16,6 +16,8 @@ class Wind_Constant : public Wind {
 
     virtual ~Wind_Constant();
 
+    virtual Wind *clone() const;
+
     virtual void set_altitude(double altitude_in_meter);
 };
 }  // namespace cad
@@ -17,10 +17,14 @@ class Wind_Tabular : public Wind {
 
     virtual ~Wind_Tabular();
 
+    virtual Wind *clone() const;
+
     virtual void set_altitude(double altitude_in_meter);
 
  private:
     Datadeck weathertable;
+    TableHandle speed_table;
+    TableHandle direction_table;
 };
 }  // namespace cad
 
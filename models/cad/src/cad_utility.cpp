@@ -57,8 +57,6 @@ double cad::distance(const double &lon1,
  */
 std::tuple<double, double, double> cad::geo84_in(arma::vec3 SBII,
                                                  arma::mat33 TEI) {
-    int count(0);
-    double lat0(0);
     double alamda(0);
 
     /* tuple */
@@ -68,28 +66,7 @@ std::tuple<double, double, double> cad::geo84_in(arma::vec3 SBII,
 
     arma::vec3 SBEE;
     SBEE = TEI * SBII;
-    /** initializing geodetic latitude using geocentric latitude */
-    double dbi = norm(SBEE);
-    double latg = asin(SBEE(2, 0) / dbi);
-    // double latg = atan2(SBEE(2), sqrt(SBEE(0) * SBEE(0) + SBEE(1) * SBEE(1)));
-    lat = latg;
-
-    /** iterating to calculate geodetic latitude and altitude */
-    do {
-        lat0 = lat;
-        double r0 =
-            SMAJOR_AXIS *
-            (1. - FLATTENING * (1. - cos(2. * lat0)) / 2. +
-             5. * pow(FLATTENING, 2) * (1. - cos(4. * lat0)) / 16.);  /** eq 4-21 */
-        alt = dbi - r0;
-        double dd = FLATTENING * sin(2. * lat0) *
-                    (1. - FLATTENING / 2. - alt / r0);  /** eq 4-15 */
-        lat = latg + dd;
-        count++;
-        assert(count <= 100 &&
-               " *** Stop: Geodetic latitude does not "
-               "converge,'cad_geo84_in()' *** ");
-    }while (fabs(lat - lat0) > SMALL);
+    std::tie(lat, alt) = geo84_lat_alt(SBEE.memptr());
 
     /** longitude */
     double sbee1 = SBEE(0, 0);
@@ -112,6 +89,48 @@ std::tuple<double, double, double> cad::geo84_in(arma::vec3 SBII,
     return std::make_tuple(lon, lat, alt);
 }
 
+/**
+ * @brief Geodetic latitude and altitude of an earth-fixed position, the
+ *        iteration of geo84_in()
+ *        Reference: Britting,K.R."Inertial Navigation Systems Analysis", Wiley. 1971
+ *
+ * @return std::tuple(lat, alt)
+ *                    lat geodetic latitude - rad
+ *                    alt altitude above ellipsoid - m
+ *
+ * @param[in] SBEE(3x1) = Position in ECEF coordinate - m
+ */
+std::tuple<double, double> cad::geo84_lat_alt(const double SBEE[3]) {
+    int count(0);
+    double lat0(0);
+    double alt(0);
+
+    /** initializing geodetic latitude using geocentric latitude */
+    double dbi = sqrt(SBEE[0] * SBEE[0] + SBEE[1] * SBEE[1] + SBEE[2] * SBEE[2]);
+    double latg = asin(SBEE[2] / dbi);
+    // double latg = atan2(SBEE[2], sqrt(SBEE[0] * SBEE[0] + SBEE[1] * SBEE[1]));
+    double lat = latg;
+
+    /** iterating to calculate geodetic latitude and altitude */
+    do {
+        lat0 = lat;
+        double r0 =
+            SMAJOR_AXIS *
+            (1. - FLATTENING * (1. - cos(2. * lat0)) / 2. +
+             5. * pow(FLATTENING, 2) * (1. - cos(4. * lat0)) / 16.);  /** eq 4-21 */
+        alt = dbi - r0;
+        double dd = FLATTENING * sin(2. * lat0) *
+                    (1. - FLATTENING / 2. - alt / r0);  /** eq 4-15 */
+        lat = latg + dd;
+        count++;
+        assert(count <= 100 &&
+               " *** Stop: Geodetic latitude does not "
+               "converge,'cad_geo84_in()' *** ");
+    }while (fabs(lat - lat0) > SMALL);
+
+    return std::make_tuple(lat, alt);
+}
+
 /**
  * @return geodetic velocity vector information from inertial postion and
  * velocity
@@ -1,13 +1,93 @@
 #include "datadeck.hh"
+#include "crc32.hh"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
 
 #include <armadillo>
 
+#include <cstdio>
 #include <iostream>
 
+/**
+ * @brief Backing storage of the tables of a deck, shared by all copies of
+ * the Datadeck: the parsed tables of a text deck, and the read-only
+ * mapping of a compiled deck if it was loaded from one
+ */
+struct DatadeckStorage {
+    std::vector<Table> tables;
+    void *map_addr;
+    size_t map_len;
+
+    DatadeckStorage() : map_addr(MAP_FAILED), map_len(0) {}
+    ~DatadeckStorage() {
+        if (map_addr != MAP_FAILED)
+            munmap(map_addr, map_len);
+    }
+};
+
+/*
+ * Compiled deck layout, all little-endian, see Datadeck::save_binary():
+ *
+ *   DeckFileHeader
+ *   DeckFileEntry[table_count]
+ *   double[value_count]       breakpoints and data of all tables, 8-byte aligned
+ *
+ * The checksum is the CRC-32 of everything following the header.
+ */
+#define DECK_MAGIC "SIRDECK"
+#define DECK_VERSION 1
+#define DECK_BYTE_ORDER 0x01020304u
+#define DECK_TITLE_LEN 256
+#define DECK_NAME_LEN 128
+
+struct DeckFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t table_count;
+    uint32_t checksum;
+    uint64_t value_offset;
+    uint64_t value_count;
+    uint64_t file_size;
+    char title[DECK_TITLE_LEN];
+};
+
+struct DeckFileEntry {
+    char name[DECK_NAME_LEN];
+    int32_t dim;
+    int32_t var_dim[3];
+    uint64_t var_offset[3];     // in doubles from the start of the value area
+    uint64_t data_offset;
+};
+
 /**
  * @brief Read table & store table's data
+ * A compiled deck is used when the file itself is one, or when a compiled
+ * deck '<file_name>.bdeck' at least as recent as the text deck exists;
+ * otherwise the text deck is parsed.
  */
 Datadeck::Datadeck(const char *file_name) {
+    if (load_binary(file_name, false))
+        return;
+
+    std::string compiled = std::string(file_name) + ".bdeck";
+    struct stat text_stat, compiled_stat;
+    if (stat(file_name, &text_stat) == 0 && stat(compiled.c_str(), &compiled_stat) == 0
+        && compiled_stat.st_mtime >= text_stat.st_mtime
+        && load_binary(compiled.c_str(), true))
+        return;
+
+    load_text(file_name);
+}
+
+/**
+ * @brief Parse a text deck
+ */
+void Datadeck::load_text(const char *file_name) {
     char line_clear[CHARL];
     char temp[CHARN];   // buffer for table data
     std::string table_deck_title;
@@ -44,6 +124,8 @@ Datadeck::Datadeck(const char *file_name) {
     this->set_title(table_deck_title);
     this->set_capacity(table_count);
     this->alloc_mem();
+    storage = std::make_shared<DatadeckStorage>();
+    storage->tables.resize(table_count);
 
     // discarding all entries until first DIM
     do {
@@ -52,8 +134,8 @@ Datadeck::Datadeck(const char *file_name) {
 
     // loading tables one at a time
     for (int t=0; t < table_count; t++) {
-        // creating and allocating memory to object 'table'
-        table = new Table;
+        // table storage is owned by the deck, shared between its copies
+        table = &storage->tables[t];
 
         // extracting table dimension
         // at this point 'temp' is holding xDIM
@@ -126,6 +208,7 @@ Datadeck::Datadeck(const char *file_name) {
                 }
             }
         }  // end of reading data
+        table->bind_storage();
 
         // loading table into 'Datadeck' pointer array 'Table **tabel_ptr'
         this->set_counter(t);
@@ -134,6 +217,197 @@ Datadeck::Datadeck(const char *file_name) {
     }  // end of 'for' loop, finished loading all tables
 }
 
+/**
+ * @brief Map a compiled deck read-only and point the tables into it
+ * @param[in] fallback a damaged compiled deck only warns if a text deck can be used instead
+ * @return false if the file is not a usable compiled deck
+ */
+bool Datadeck::load_binary(const char *file_name, bool fallback) {
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    DeckFileHeader header;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(header)
+        || pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+        || memcmp(header.magic, DECK_MAGIC, sizeof(header.magic)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    const char *error = NULL;
+    const unsigned char *base = static_cast<const unsigned char *>(addr);
+    if (addr == MAP_FAILED) {
+        error = "mmap failed";
+    } else if (header.version != DECK_VERSION || header.byte_order != DECK_BYTE_ORDER) {
+        error = "unsupported version or byte order";
+    } else if (header.file_size != static_cast<uint64_t>(st.st_size)
+               || header.value_offset % sizeof(double) != 0
+               || header.value_offset < sizeof(header) + header.table_count * sizeof(DeckFileEntry)
+               || header.value_offset + header.value_count * sizeof(double) != header.file_size) {
+        error = "truncated file";
+    } else if (crc32_ieee(base + sizeof(header), st.st_size - sizeof(header)) != header.checksum) {
+        error = "checksum mismatch";
+    }
+
+    if (error) {
+        if (addr != MAP_FAILED)
+            munmap(addr, st.st_size);
+        std::cerr << "*** " << (fallback ? "Warning" : "Error") << ": compiled deck '" << file_name
+                  << "' is not usable (" << error << ") ***\n";
+        if (!fallback)
+            exit(1);
+        return false;
+    }
+
+    std::shared_ptr<DatadeckStorage> mapped = std::make_shared<DatadeckStorage>();
+    mapped->map_addr = addr;
+    mapped->map_len = st.st_size;
+    mapped->tables.resize(header.table_count);
+
+    const DeckFileEntry *entry = reinterpret_cast<const DeckFileEntry *>(base + sizeof(header));
+    const double *values = reinterpret_cast<const double *>(base + header.value_offset);
+
+    header.title[DECK_TITLE_LEN - 1] = '\0';
+    storage = mapped;
+    table_index.clear();
+    this->set_title(header.title);
+    this->set_capacity(header.table_count);
+    this->alloc_mem();
+
+    for (uint32_t t = 0; t < header.table_count; t++) {
+        const DeckFileEntry &e = entry[t];
+        uint64_t count = static_cast<uint64_t>(e.var_dim[0]) * e.var_dim[1] * e.var_dim[2];
+        if (e.var_offset[0] + e.var_dim[0] > header.value_count
+            || e.var_offset[1] + e.var_dim[1] > header.value_count
+            || e.var_offset[2] + e.var_dim[2] > header.value_count
+            || e.data_offset + count > header.value_count) {
+            std::cerr << "*** Error: compiled deck '" << file_name << "' has a bad table entry ***\n";
+            exit(1);
+        }
+
+        Table *table = &mapped->tables[t];
+        table->set_dim(e.dim);
+        table->set_name(std::string(e.name, strnlen(e.name, DECK_NAME_LEN)));
+        table->set_var1_dim(e.var_dim[0]);
+        table->set_var2_dim(e.var_dim[1]);
+        table->set_var3_dim(e.var_dim[2]);
+        table->bind_storage(values + e.var_offset[0], values + e.var_offset[1],
+                            values + e.var_offset[2], values + e.data_offset);
+
+        this->set_counter(t);
+        this->add_table(*table);
+    }
+    return true;
+}
+
+/**
+ * @brief Write the deck in the compiled format read by load_binary()
+ * @return 0 on success, -1 on failure
+ */
+int Datadeck::save_binary(const char *file_name) {
+    DeckFileHeader header;
+    std::vector<DeckFileEntry> entries(capacity);
+    std::vector<double> values;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DECK_MAGIC, sizeof(header.magic));
+    header.version = DECK_VERSION;
+    header.byte_order = DECK_BYTE_ORDER;
+    header.table_count = capacity;
+    if (title.size() >= DECK_TITLE_LEN) {
+        std::cerr << "*** Error: deck title too long for compiled deck ***\n";
+        return -1;
+    }
+    strncpy(header.title, title.c_str(), DECK_TITLE_LEN - 1);
+
+    for (int t = 0; t < capacity; t++) {
+        Table *table = get_tbl(t);
+        DeckFileEntry &e = entries[t];
+        memset(&e, 0, sizeof(e));
+        if (table->get_name().size() >= DECK_NAME_LEN) {
+            std::cerr << "*** Error: table name '" << table->get_name() << "' too long for compiled deck ***\n";
+            return -1;
+        }
+        strncpy(e.name, table->get_name().c_str(), DECK_NAME_LEN - 1);
+        e.dim = table->get_dim();
+        e.var_dim[0] = table->get_var1_dim();
+        e.var_dim[1] = table->get_var2_dim();
+        e.var_dim[2] = table->get_var3_dim();
+
+        const double *var[3] = {table->var1_ptr, table->var2_ptr, table->var3_ptr};
+        for (int v = 0; v < 3; v++) {
+            e.var_offset[v] = values.size();
+            values.insert(values.end(), var[v], var[v] + e.var_dim[v]);
+        }
+        e.data_offset = values.size();
+        values.insert(values.end(), table->data_ptr,
+                      table->data_ptr + e.var_dim[0] * e.var_dim[1] * e.var_dim[2]);
+    }
+
+    size_t entry_bytes = entries.size() * sizeof(DeckFileEntry);
+    size_t value_offset = sizeof(header) + entry_bytes;
+    value_offset = (value_offset + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+    header.value_offset = value_offset;
+    header.value_count = values.size();
+    header.file_size = value_offset + values.size() * sizeof(double);
+
+    std::vector<unsigned char> body(header.file_size - sizeof(header), 0);
+    if (entry_bytes)
+        memcpy(&body[0], &entries[0], entry_bytes);
+    if (!values.empty())
+        memcpy(&body[value_offset - sizeof(header)], &values[0], values.size() * sizeof(double));
+    header.checksum = crc32_ieee(body.data(), body.size());
+
+    FILE *fp = fopen(file_name, "wb");
+    if (!fp) {
+        std::cerr << "*** Error: cannot write compiled deck '" << file_name << "' ***\n";
+        return -1;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+              && (body.empty() || fwrite(body.data(), body.size(), 1, fp) == 1);
+    if (fclose(fp) != 0 || !ok) {
+        std::cerr << "*** Error: cannot write compiled deck '" << file_name << "' ***\n";
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Resolving a table name into a handle for repeated look-ups
+ * @return handle of the table, invalid handle if the deck has no such table
+ */
+TableHandle Datadeck::get_handle(const std::string &name) {
+    TableHandle tbl;
+    std::unordered_map<std::string, int>::const_iterator it = table_index.find(name);
+    if (it != table_index.end()) {
+        tbl.slot = it->second;
+        tbl.dim = get_tbl(tbl.slot)->get_dim();
+    }
+    return tbl;
+}
+
+TableHandle Datadeck::require_handle(const std::string &name) {
+    TableHandle tbl = get_handle(name);
+    if (!tbl.is_valid()) {
+        std::cerr << "*** Error: Table '" << name << "' not found in deck '" << title << "' ***\n";
+        exit(1);
+    }
+    return tbl;
+}
+
+void Datadeck::check_handle(const TableHandle &tbl) {
+    if (!tbl.is_valid() || tbl.slot >= capacity) {
+        std::cerr << "*** Error: Invalid table handle (slot " << tbl.slot << ") for deck '"
+                  << title << "' ***\n";
+        exit(1);
+    }
+}
+
 /**
  * @brief Single independent variable look-up
  * constant extrapolation at the upper end, slope extrapolation at the lower end
@@ -141,26 +415,25 @@ Datadeck::Datadeck(const char *file_name) {
  * @author 030717 Created by Peter H Zipfel
  */
 double Datadeck::look_up(std::string name, double value1, unsigned int flag) {
-    // finding slot of table in table pointer array (Table **table_ptr)
-    int slot(-1);
-    std::string tbl_name;
-    do {
-        slot++;
-        tbl_name = get_tbl(slot)->get_name();
-    }while (name != tbl_name);
+    return look_up(require_handle(name), value1, flag);
+}
+
+double Datadeck::look_up(const TableHandle &tbl, double value1, unsigned int flag) {
+    check_handle(tbl);
+    int slot = tbl.slot;
 
     // getting table index locater of discrete value just below of variable value
     int var1_dim = get_tbl(slot)->get_var1_dim();
-    int loc1 = find_index(var1_dim-1, value1, get_tbl(slot)->var1_values);
+    int loc1 = find_index(var1_dim-1, value1, get_tbl(slot)->var1_ptr, &var_hint[3 * slot + 0]);
     if (flag == 1) {
-        if (loc1 == (var1_dim - 1)) value1 = get_tbl(slot)->var1_values[loc1];
+        if (loc1 == (var1_dim - 1)) value1 = get_tbl(slot)->var1_ptr[loc1];
         if (loc1 == 0) {
-            if (value1 < get_tbl(slot)->var1_values[loc1]) value1 = get_tbl(slot)->var1_values[loc1];
+            if (value1 < get_tbl(slot)->var1_ptr[loc1]) value1 = get_tbl(slot)->var1_ptr[loc1];
         }
     }
 
     // using max discrete value if value is outside table
-    // if (loc1 == (var1_dim-1)) return get_tbl(slot)->data[loc1];
+    // if (loc1 == (var1_dim-1)) return get_tbl(slot)->data_ptr[loc1];
     if (loc1 == (var1_dim-1)) return interpolate(loc1-1, loc1, slot, value1);
 
     return interpolate(loc1, loc1+1, slot, value1);
@@ -173,30 +446,28 @@ double Datadeck::look_up(std::string name, double value1, unsigned int flag) {
  * @author 030717 Created by Peter H Zipfel
  */
 double Datadeck::look_up(std::string name, double value1, double value2, unsigned int flag) {
-    // finding slot of table in table pointer array (Table **table_ptr)
-    int slot(-1);
-    std::string tbl_name;
-    do {
-        slot++;
-        tbl_name = get_tbl(slot)->get_name();
-    }while (name != tbl_name);
+    return look_up(require_handle(name), value1, value2, flag);
+}
 
+double Datadeck::look_up(const TableHandle &tbl, double value1, double value2, unsigned int flag) {
+    check_handle(tbl);
+    int slot = tbl.slot;
 
     // getting table index (off-set) locater of discrete value just below or equal of the variable value
     int var1_dim = get_tbl(slot)->get_var1_dim();
-    int loc1 = find_index(var1_dim-1, value1, get_tbl(slot)->var1_values);
+    int loc1 = find_index(var1_dim-1, value1, get_tbl(slot)->var1_ptr, &var_hint[3 * slot + 0]);
 
     int var2_dim = get_tbl(slot)->get_var2_dim();
-    int loc2 = find_index(var2_dim-1, value2, get_tbl(slot)->var2_values);
+    int loc2 = find_index(var2_dim-1, value2, get_tbl(slot)->var2_ptr, &var_hint[3 * slot + 1]);
 
     if (flag == 1) {
-        if (loc1 == (var1_dim - 1)) value1 = get_tbl(slot)->var1_values[loc1];
-        if (loc2 == (var2_dim - 1)) value2 = get_tbl(slot)->var2_values[loc2];
+        if (loc1 == (var1_dim - 1)) value1 = get_tbl(slot)->var1_ptr[loc1];
+        if (loc2 == (var2_dim - 1)) value2 = get_tbl(slot)->var2_ptr[loc2];
         if (loc1 == 0) {
-            if (value1 < get_tbl(slot)->var1_values[loc1]) value1 = get_tbl(slot)->var1_values[loc1];
+            if (value1 < get_tbl(slot)->var1_ptr[loc1]) value1 = get_tbl(slot)->var1_ptr[loc1];
         }
         if (loc2 == 0) {
-            if (value2 < get_tbl(slot)->var2_values[loc2]) value2 = get_tbl(slot)->var2_values[loc2];
+            if (value2 < get_tbl(slot)->var2_ptr[loc2]) value2 = get_tbl(slot)->var2_ptr[loc2];
         }
     }
 
@@ -218,37 +489,36 @@ double Datadeck::look_up(std::string name, double value1, double value2, unsigne
  * @author 030723 Created by Peter H Zipfel
  */
 double Datadeck::look_up(std::string name, double value1, double value2, double value3, unsigned int flag) {
-    // finding slot of table in table pointer array (Table **table_ptr)
-    int slot(-1);
-    std::string tbl_name;
-    do {
-        slot++;
-        tbl_name = get_tbl(slot)->get_name();
-    }while (name != tbl_name);
+    return look_up(require_handle(name), value1, value2, value3, flag);
+}
 
+double Datadeck::look_up(const TableHandle &tbl, double value1, double value2, double value3,
+                         unsigned int flag) {
+    check_handle(tbl);
+    int slot = tbl.slot;
 
     // getting table index locater of discrete value just below of variable value
     int var1_dim = get_tbl(slot)->get_var1_dim();
-    int loc1 = find_index(var1_dim-1, value1, get_tbl(slot)->var1_values);
+    int loc1 = find_index(var1_dim-1, value1, get_tbl(slot)->var1_ptr, &var_hint[3 * slot + 0]);
 
     int var2_dim = get_tbl(slot)->get_var2_dim();
-    int loc2 = find_index(var2_dim-1, value2, get_tbl(slot)->var2_values);
+    int loc2 = find_index(var2_dim-1, value2, get_tbl(slot)->var2_ptr, &var_hint[3 * slot + 1]);
 
     int var3_dim = get_tbl(slot)->get_var3_dim();
-    int loc3 = find_index(var3_dim-1, value3, get_tbl(slot)->var3_values);
+    int loc3 = find_index(var3_dim-1, value3, get_tbl(slot)->var3_ptr, &var_hint[3 * slot + 2]);
 
     if (flag == 1) {
-        if (loc1 == (var1_dim - 1)) value1 = get_tbl(slot)->var1_values[loc1];
-        if (loc2 == (var2_dim - 1)) value2 = get_tbl(slot)->var2_values[loc2];
-        if (loc3 == (var3_dim - 1)) value3 = get_tbl(slot)->var3_values[loc3];
+        if (loc1 == (var1_dim - 1)) value1 = get_tbl(slot)->var1_ptr[loc1];
+        if (loc2 == (var2_dim - 1)) value2 = get_tbl(slot)->var2_ptr[loc2];
+        if (loc3 == (var3_dim - 1)) value3 = get_tbl(slot)->var3_ptr[loc3];
         if (loc1 == 0) {
-            if (value1 < get_tbl(slot)->var1_values[loc1]) value1 = get_tbl(slot)->var1_values[loc1];
+            if (value1 < get_tbl(slot)->var1_ptr[loc1]) value1 = get_tbl(slot)->var1_ptr[loc1];
         }
         if (loc2 == 0) {
-            if (value2 < get_tbl(slot)->var2_values[loc2]) value2 = get_tbl(slot)->var2_values[loc2];
+            if (value2 < get_tbl(slot)->var2_ptr[loc2]) value2 = get_tbl(slot)->var2_ptr[loc2];
         }
         if (loc3 == 0) {
-            if (value3 < get_tbl(slot)->var3_values[loc3]) value3 = get_tbl(slot)->var3_values[loc3];
+            if (value3 < get_tbl(slot)->var3_ptr[loc3]) value3 = get_tbl(slot)->var3_ptr[loc3];
         }
     }
 
@@ -280,7 +550,7 @@ double Datadeck::look_up(std::string name, double value1, double value2, double
  *
  * @author 010628 Created by Peter H Zipfel
  */
-int Datadeck::find_index(int max, double value, std::vector<double> list) {
+int Datadeck::find_index(int max, double value, const std::vector<double> &list) {
     if (value >= list[max]) {
         return max;
     } else if (value <= list[0]) {
@@ -301,6 +571,57 @@ int Datadeck::find_index(int max, double value, std::vector<double> list) {
     }
 }
 
+/**
+ * @brief Table index finder with bracket caching
+ * The breakpoints are strictly increasing, so the locater is the unique i
+ * with list[i] <= value < list[i+1]; the cached bracket and its neighbours are
+ * tested before falling back to the binary search.
+ */
+int Datadeck::find_index(int max, double value, const double *list, int *hint) {
+    if (value >= list[max]) {
+        *hint = max;
+        return max;
+    } else if (value <= list[0]) {
+        *hint = 0;
+        return 0;
+    }
+
+    int idx = *hint;
+    if (idx >= max) idx = max - 1;
+    if (idx < 0) idx = 0;
+
+    if (list[idx] <= value) {
+        // same bracket, or the next one up
+        if (value < list[idx + 1]) {
+            *hint = idx;
+            return idx;
+        }
+        if (idx + 2 <= max && value < list[idx + 2]) {
+            *hint = idx + 1;
+            return idx + 1;
+        }
+    } else if (idx > 0 && list[idx - 1] <= value) {
+        // next one down
+        *hint = idx - 1;
+        return idx - 1;
+    }
+
+    int index = 0;
+    int mid;
+    while (index <= max) {
+        mid = (index+max)/2;      // integer division
+        if (value < list[mid])
+            max = mid-1;
+        else if (value > list[mid])
+            index = mid+1;
+        else
+            break;
+    }
+    if (index <= max) max = mid;  // exact match on a breakpoint
+    *hint = max;
+    return max;
+}
+
 /**
  * @brief Linear one-dimensional interpolation
  * Data deck must contain table in the following format:
@@ -320,14 +641,14 @@ double Datadeck::interpolate(int ind1, int ind2, int slot, double val) {
     double dx(0), dy(0);
     double dumx(0);
 
-    double diff = val-get_tbl(slot)->var1_values[ind1];
-    dx = get_tbl(slot)->var1_values[ind2]-get_tbl(slot)->var1_values[ind1];
-    dy = get_tbl(slot)->data[ind2]-get_tbl(slot)->data[ind1];
+    double diff = val-get_tbl(slot)->var1_ptr[ind1];
+    dx = get_tbl(slot)->var1_ptr[ind2]-get_tbl(slot)->var1_ptr[ind1];
+    dy = get_tbl(slot)->data_ptr[ind2]-get_tbl(slot)->data_ptr[ind1];
 
     if (fabs(dx) > arma::datum::eps) dumx = diff/dx;
     dy = dumx*dy;
 
-    return get_tbl(slot)->data[ind1]+dy;
+    return get_tbl(slot)->data_ptr[ind1]+dy;
 }
 
 /**
@@ -354,26 +675,26 @@ double Datadeck::interpolate(int ind10, int ind11, int ind20, int ind21, int slo
     int var1_dim = get_tbl(slot)->get_var1_dim();
     int var2_dim = get_tbl(slot)->get_var2_dim();
 
-    double diff1 = value1-get_tbl(slot)->var1_values[ind10];
-    double diff2 = value2-get_tbl(slot)->var2_values[ind20];
+    double diff1 = value1-get_tbl(slot)->var1_ptr[ind10];
+    double diff2 = value2-get_tbl(slot)->var2_ptr[ind20];
 
     // if (ind10 == (var1_dim-1))  // Assures constant upper extrapolation of first variable
     //     ind11 = ind10;
     // else
-        dx1 = get_tbl(slot)->var1_values[ind11]-get_tbl(slot)->var1_values[ind10];
+        dx1 = get_tbl(slot)->var1_ptr[ind11]-get_tbl(slot)->var1_ptr[ind10];
 
     // if (ind20 == (var2_dim-1))  // Assures constant upper extrapolation of second variable
     //     ind21 = ind20;
     // else
-        dx2 = get_tbl(slot)->var2_values[ind21]-get_tbl(slot)->var2_values[ind20];
+        dx2 = get_tbl(slot)->var2_ptr[ind21]-get_tbl(slot)->var2_ptr[ind20];
 
     if (fabs(dx1) > arma::datum::eps) dumx1 = diff1/dx1;
     if (fabs(dx2) > arma::datum::eps) dumx2 = diff2/dx2;
 
-    double y11 = get_tbl(slot)->data[ind10*var2_dim+ind20];
-    double y12 = get_tbl(slot)->data[ind10*var2_dim+ind21];
-    double y21 = get_tbl(slot)->data[ind11*var2_dim+ind20];
-    double y22 = get_tbl(slot)->data[ind11*var2_dim+ind21];
+    double y11 = get_tbl(slot)->data_ptr[ind10*var2_dim+ind20];
+    double y12 = get_tbl(slot)->data_ptr[ind10*var2_dim+ind21];
+    double y21 = get_tbl(slot)->data_ptr[ind11*var2_dim+ind20];
+    double y22 = get_tbl(slot)->data_ptr[ind11*var2_dim+ind21];
     double y1 = dumx1*(y21-y11)+y11;
     double y2 = dumx1*(y22-y12)+y12;
 
@@ -407,22 +728,22 @@ double Datadeck::interpolate(int ind10, int ind11, int ind20, int ind21, int ind
     int var2_dim = get_tbl(slot)->get_var2_dim();
     int var3_dim = get_tbl(slot)->get_var3_dim();
 
-    double diff1 = value1-get_tbl(slot)->var1_values[ind10];
-    double diff2 = value2-get_tbl(slot)->var2_values[ind20];
-    double diff3 = value3-get_tbl(slot)->var3_values[ind30];
+    double diff1 = value1-get_tbl(slot)->var1_ptr[ind10];
+    double diff2 = value2-get_tbl(slot)->var2_ptr[ind20];
+    double diff3 = value3-get_tbl(slot)->var3_ptr[ind30];
 
     if (ind10 != (var1_dim-1))  // Assures constant upper extrapolation of first variable
-        dx1 = get_tbl(slot)->var1_values[ind11]-get_tbl(slot)->var1_values[ind10];
+        dx1 = get_tbl(slot)->var1_ptr[ind11]-get_tbl(slot)->var1_ptr[ind10];
 
     if (ind20 == (var2_dim-1))  // Assures constant upper extrapolation of second variable
         ind21 = ind20;
     else
-        dx2 = get_tbl(slot)->var2_values[ind21]-get_tbl(slot)->var2_values[ind20];
+        dx2 = get_tbl(slot)->var2_ptr[ind21]-get_tbl(slot)->var2_ptr[ind20];
 
     if (ind30 == (var3_dim-1))  // Assures constant upper extrapolation of third variable
         ind31 = ind30;
     else
-        dx3 = get_tbl(slot)->var3_values[ind31]-get_tbl(slot)->var3_values[ind30];
+        dx3 = get_tbl(slot)->var3_ptr[ind31]-get_tbl(slot)->var3_ptr[ind30];
 
     if (dx1 > arma::datum::eps) dumx1 = diff1/dx1;
     if (dx2 > arma::datum::eps) dumx2 = diff2/dx2;
@@ -431,20 +752,20 @@ double Datadeck::interpolate(int ind10, int ind11, int ind20, int ind21, int ind
     //      i        i+1        j         j+1       k        k+1
     // Use innner x1 and outer variable x3 for 2DIM interpolation, middle variable x2 is parameter
     // For parameter ind20
-    double y11 = get_tbl(slot)->data[ind10*var2_dim*var3_dim+ind20*var3_dim+ind30];
-    double y12 = get_tbl(slot)->data[ind10*var2_dim*var3_dim+ind20*var3_dim+ind30+var2_dim*var3_dim];
-    double y31 = get_tbl(slot)->data[ind10*var2_dim*var3_dim+ind20*var3_dim+ind31];
-    double y32 = get_tbl(slot)->data[ind10*var2_dim*var3_dim+ind20*var3_dim+ind31+var2_dim*var3_dim];
+    double y11 = get_tbl(slot)->data_ptr[ind10*var2_dim*var3_dim+ind20*var3_dim+ind30];
+    double y12 = get_tbl(slot)->data_ptr[ind10*var2_dim*var3_dim+ind20*var3_dim+ind30+var2_dim*var3_dim];
+    double y31 = get_tbl(slot)->data_ptr[ind10*var2_dim*var3_dim+ind20*var3_dim+ind31];
+    double y32 = get_tbl(slot)->data_ptr[ind10*var2_dim*var3_dim+ind20*var3_dim+ind31+var2_dim*var3_dim];
     // 2DIM interpolation
     double y1 = dumx1*(y12-y11)+y11;
     double y3 = dumx1*(y32-y31)+y31;
     double y21 = dumx3*(y3-y1)+y1;
 
     // For parameter ind21
-    y11 = get_tbl(slot)->data[ind10*var2_dim*var3_dim+ind21*var3_dim+ind30];
-    y12 = get_tbl(slot)->data[ind10*var2_dim*var3_dim+ind21*var3_dim+ind30+var2_dim*var3_dim];
-    y31 = get_tbl(slot)->data[ind10*var2_dim*var3_dim+ind21*var3_dim+ind31];
-    y32 = get_tbl(slot)->data[ind10*var2_dim*var3_dim+ind21*var3_dim+ind31+var2_dim*var3_dim];
+    y11 = get_tbl(slot)->data_ptr[ind10*var2_dim*var3_dim+ind21*var3_dim+ind30];
+    y12 = get_tbl(slot)->data_ptr[ind10*var2_dim*var3_dim+ind21*var3_dim+ind30+var2_dim*var3_dim];
+    y31 = get_tbl(slot)->data_ptr[ind10*var2_dim*var3_dim+ind21*var3_dim+ind31];
+    y32 = get_tbl(slot)->data_ptr[ind10*var2_dim*var3_dim+ind21*var3_dim+ind31+var2_dim*var3_dim];
     // 2DIM interpolation
     y1 = dumx1*(y12-y11)+y11;
     y3 = dumx1*(y32-y31)+y31;
@@ -19,6 +19,10 @@ cad::Atmosphere76::Atmosphere76() {
 cad::Atmosphere76::~Atmosphere76() {
 }
 
+cad::Atmosphere *cad::Atmosphere76::clone() const {
+    return new Atmosphere76(*this);
+}
+
 void cad::Atmosphere76::set_altitude(double altitude_in_meter) {
     altitude = altitude_in_meter;
 
@@ -30,6 +34,10 @@ void cad::Atmosphere76::set_altitude(double altitude_in_meter) {
 }
 
 void cad::Atmosphere76::update_values() {
+    evaluate(altitude, &tempk, &density, &pressure);
+}
+
+void cad::Atmosphere76::evaluate(double altitude, double *tempk, double *density, double *pressure) {
     double rearth(6369.0);   // radius of the earth - km
     double gmr(34.163195);   // gas constant
     double rhosl(1.22500);   // sea level density - kg/m^3
@@ -84,13 +92,13 @@ void cad::Atmosphere76::update_values() {
         double sigma = delta / theta;
 
         // output
-        density = rhosl * sigma;
-        pressure = pressl * delta;
-        tempk = tempksl * theta;
+        *density = rhosl * sigma;
+        *pressure = pressl * delta;
+        *tempk = tempksl * theta;
     } else {
         // beyond stratosphere
-        density = 0;
-        pressure = 0;
-        tempk = 186.946;
+        *density = 0;
+        *pressure = 0;
+        *tempk = 186.946;
     }
 }
@@ -18,6 +18,10 @@ cad::Atmosphere_nasa2002::Atmosphere_nasa2002() {
 cad::Atmosphere_nasa2002::~Atmosphere_nasa2002() {
 }
 
+cad::Atmosphere *cad::Atmosphere_nasa2002::clone() const {
+    return new Atmosphere_nasa2002(*this);
+}
+
 void cad::Atmosphere_nasa2002::set_altitude(double altitude_in_meter) {
     altitude = altitude_in_meter;
 
@@ -10,6 +10,10 @@ cad::Atmosphere_weatherdeck::Atmosphere_weatherdeck(char* filepath)
     :    weathertable(filepath) {
     snprintf(name, sizeof(name), "Atmosphere Weather Deck");
 
+    density_table = weathertable.require_handle("density");
+    pressure_table = weathertable.require_handle("pressure");
+    temperature_table = weathertable.require_handle("temperature");
+
     altitude = 0;
 
     update_values();
@@ -18,6 +22,10 @@ cad::Atmosphere_weatherdeck::Atmosphere_weatherdeck(char* filepath)
 cad::Atmosphere_weatherdeck::~Atmosphere_weatherdeck() {
 }
 
+cad::Atmosphere *cad::Atmosphere_weatherdeck::clone() const {
+    return new Atmosphere_weatherdeck(*this);
+}
+
 void cad::Atmosphere_weatherdeck::set_altitude(double altitude_in_meter) {
     altitude = altitude_in_meter;
 
@@ -25,9 +33,9 @@ void cad::Atmosphere_weatherdeck::set_altitude(double altitude_in_meter) {
 }
 
 void cad::Atmosphere_weatherdeck::update_values() {
-    density  = weathertable.look_up("density", altitude, 0);
-    pressure = weathertable.look_up("pressure", altitude, 0);
-    tempk    = weathertable.look_up("temperature", altitude, 0) + 273.16;
+    density  = weathertable.look_up(density_table, altitude, 0);
+    pressure = weathertable.look_up(pressure_table, altitude, 0);
+    tempk    = weathertable.look_up(temperature_table, altitude, 0) + 273.16;
 
     vsound = sqrt(1.4 * RGAS * tempk);
 }
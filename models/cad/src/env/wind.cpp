@@ -1,14 +1,16 @@
 #include "env/wind.hh"
 #include "global_constants.hh"
 #include "integrate.hh"
+#include "checkpoint.hh"
 
-#include <cstdlib>
+#include <cstring>
 
 cad::Wind::Wind(double twind, double vertical_wind)
     :   has_turbulance(false),
         VECTOR_INIT(VAED, 3),
         VECTOR_INIT(VAEDS, 3),
-        VECTOR_INIT(VAEDSD, 3) {
+        VECTOR_INIT(VAEDSD, 3),
+        turb_noise(0, DEFAULT_TURBULANCE_STREAM) {
     this->twind = twind;
     this->vertical_wind_speed = vertical_wind;
 
@@ -17,6 +19,39 @@ cad::Wind::Wind(double twind, double vertical_wind)
     VAEDSD.zeros();
 }
 
+/* The vectors are bound to this copy's own arrays; the turbulence stream continues where other's is */
+cad::Wind::Wind(const Wind &other)
+    :   has_turbulance(other.has_turbulance),
+        twind(other.twind),
+        altitude(other.altitude),
+        vertical_wind_speed(other.vertical_wind_speed),
+        vwind(other.vwind),
+        psiwdx(other.psiwdx),
+        VECTOR_INIT(VAED, 3),
+        VECTOR_INIT(VAEDS, 3),
+        VECTOR_INIT(VAEDSD, 3),
+        turb_length(other.turb_length),
+        turb_sigma(other.turb_sigma),
+        taux1(other.taux1),
+        taux1d(other.taux1d),
+        taux2(other.taux2),
+        taux2d(other.taux2d),
+        tau(other.tau),
+        gauss_value(other.gauss_value),
+        turb_noise(other.turb_noise) {
+    memcpy(name, other.name, sizeof(name));
+
+    VAED = other.VAED;
+    VAEDS = other.VAEDS;
+    VAEDSD = other.VAEDSD;
+}
+
+void cad::Wind::checkpoint(Checkpoint &cp) {
+    cp.section("WIND");
+    cp(has_turbulance, twind, altitude, vertical_wind_speed, vwind, psiwdx, VAED, VAEDS, VAEDSD);
+    cp(turb_length, turb_sigma, taux1, taux1d, taux2, taux2d, tau, gauss_value, turb_noise);
+}
+
 void cad::Wind::propagate_VAED(double int_step) {
     // wind components in geodetic coordinates
     arma::vec3 VAED_RAW;
@@ -35,15 +70,7 @@ void cad::Wind::apply_turbulance_if_have(double int_step, double dvba, arma::mat
     if (has_turbulance) {
         arma::vec3 VTAD;
 
-        double value1;
-        do {
-            unsigned int seed1 = static_cast<unsigned int>(time(NULL));
-            value1 = static_cast<double>(rand_r(&seed1)) / RAND_MAX;
-        }while (value1 == 0);
-
-        unsigned int seed2 = static_cast<unsigned int>(time(NULL));
-        double value2 = static_cast<double>(rand_r(&seed2)) / RAND_MAX;
-        gauss_value = (1/sqrt(int_step)) * sqrt(2 * log(1/value1)) * cos(2 * PI * value2);
+        gauss_value = (1/sqrt(int_step)) * turb_noise.gauss(0, 1);
 
         // filter, converting white gaussian noise into a time sequence of Dryden
         // turbulence velocity variable 'tau'  (One - dimensional cross - velocity Dryden spectrum)
@@ -15,6 +15,10 @@ cad::Wind_Constant::Wind_Constant(double dvba, double dir, double twind, double
 cad::Wind_Constant::~Wind_Constant() {
 }
 
+cad::Wind *cad::Wind_Constant::clone() const {
+    return new Wind_Constant(*this);
+}
+
 void cad::Wind_Constant::set_altitude(double altitude_in_meter) {
     altitude = altitude_in_meter;
 }
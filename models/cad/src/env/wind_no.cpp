@@ -15,6 +15,10 @@ cad::Wind_No::Wind_No()
 cad::Wind_No::~Wind_No() {
 }
 
+cad::Wind *cad::Wind_No::clone() const {
+    return new Wind_No(*this);
+}
+
 void cad::Wind_No::set_altitude(double altitude_in_meter) {
     altitude = altitude_in_meter;
 }
@@ -6,6 +6,9 @@ cad::Wind_Tabular::Wind_Tabular(char* filepath, double twind, double vertical_wi
     :   Wind(twind, vertical_wind), weathertable(filepath) {
     snprintf(name, sizeof(name), "Tabular Wind");
 
+    speed_table = weathertable.require_handle("speed");
+    direction_table = weathertable.require_handle("direction");
+
     altitude = 0;
 
     vwind = 0;
@@ -15,9 +18,13 @@ cad::Wind_Tabular::Wind_Tabular(char* filepath, double twind, double vertical_wi
 cad::Wind_Tabular::~Wind_Tabular() {
 }
 
+cad::Wind *cad::Wind_Tabular::clone() const {
+    return new Wind_Tabular(*this);
+}
+
 void cad::Wind_Tabular::set_altitude(double altitude_in_meter) {
     altitude = altitude_in_meter;
 
-    vwind = weathertable.look_up("speed", altitude, 0);
-    psiwdx = weathertable.look_up("direction", altitude, 0);
+    vwind = weathertable.look_up(speed_table, altitude, 0);
+    psiwdx = weathertable.look_up(direction_table, altitude, 0);
 }
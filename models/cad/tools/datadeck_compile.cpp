@@ -0,0 +1,33 @@
+#include "datadeck.hh"
+
+#include <cstdio>
+#include <string>
+
+/*
+ * Offline compiler of text table decks (aero, propulsion, weather) into the
+ * compiled deck format of Datadeck::save_binary().
+ *
+ * Usage: datadeck_compile <deck.txt> [<deck.txt> ...]
+ *
+ * Each deck is written next to its text source as '<deck.txt>.bdeck', which
+ * Datadeck(const char *) maps instead of parsing the text as long as the
+ * compiled deck is not older than the text deck.
+ */
+int main(int argc, char const *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <deck.txt> [<deck.txt> ...]\n", argv[0]);
+        return 1;
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string out = std::string(argv[i]) + ".bdeck";
+        Datadeck deck(argv[i]);
+        if (deck.save_binary(out.c_str()) != 0) {
+            failed++;
+            continue;
+        }
+        fprintf(stderr, "%s -> %s (%d tables)\n", argv[i], out.c_str(), deck.get_capacity());
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+#include "datadeck.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/*
+ * Micro-benchmark of the Datadeck look-up paths on the aero_table*.txt decks.
+ *
+ * legacy : table name search + breakpoint vectors copied by value into the
+ *          binary search, as Datadeck::look_up() did before table handles
+ * handle : pre-resolved TableHandle + bracket-cached index finder
+ *
+ * Both paths are fed the same monotonic Mach/alpha trajectory and must agree
+ * bit for bit.
+ */
+
+static const int N_STEPS = 200000;
+
+static int legacy_find_index(int max, double value, std::vector<double> list) {
+    if (value >= list[max]) {
+        return max;
+    } else if (value <= list[0]) {
+        return 0;
+    } else {
+        int index = 0;
+        int mid;
+        while (index <= max) {
+            mid = (index+max)/2;
+            if (value < list[mid])
+                max = mid-1;
+            else if (value > list[mid])
+                index = mid+1;
+            else
+                return mid;
+        }
+        return max;
+    }
+}
+
+static int legacy_slot(Datadeck &deck, std::string name) {
+    int slot(-1);
+    std::string tbl_name;
+    do {
+        slot++;
+        tbl_name = deck.get_tbl(slot)->get_name();
+    }while (name != tbl_name);
+    return slot;
+}
+
+static double legacy_look_up(Datadeck &deck, std::string name, double value1, unsigned int flag) {
+    int slot = legacy_slot(deck, name);
+    int var1_dim = deck.get_tbl(slot)->get_var1_dim();
+    int loc1 = legacy_find_index(var1_dim-1, value1, deck.get_tbl(slot)->var1_values);
+    if (flag == 1) {
+        if (loc1 == (var1_dim - 1)) value1 = deck.get_tbl(slot)->var1_values[loc1];
+        if (loc1 == 0 && value1 < deck.get_tbl(slot)->var1_values[loc1])
+            value1 = deck.get_tbl(slot)->var1_values[loc1];
+    }
+    if (loc1 == (var1_dim-1)) return deck.interpolate(loc1-1, loc1, slot, value1);
+    return deck.interpolate(loc1, loc1+1, slot, value1);
+}
+
+static double legacy_look_up(Datadeck &deck, std::string name, double value1, double value2,
+                             unsigned int flag) {
+    int slot = legacy_slot(deck, name);
+    int var1_dim = deck.get_tbl(slot)->get_var1_dim();
+    int loc1 = legacy_find_index(var1_dim-1, value1, deck.get_tbl(slot)->var1_values);
+    int var2_dim = deck.get_tbl(slot)->get_var2_dim();
+    int loc2 = legacy_find_index(var2_dim-1, value2, deck.get_tbl(slot)->var2_values);
+    if (flag == 1) {
+        if (loc1 == (var1_dim - 1)) value1 = deck.get_tbl(slot)->var1_values[loc1];
+        if (loc2 == (var2_dim - 1)) value2 = deck.get_tbl(slot)->var2_values[loc2];
+        if (loc1 == 0 && value1 < deck.get_tbl(slot)->var1_values[loc1])
+            value1 = deck.get_tbl(slot)->var1_values[loc1];
+        if (loc2 == 0 && value2 < deck.get_tbl(slot)->var2_values[loc2])
+            value2 = deck.get_tbl(slot)->var2_values[loc2];
+    }
+    if (loc1 == (var1_dim - 1) && loc2 == (var2_dim - 1)) {
+        return deck.interpolate(loc1 - 1, loc1, loc2 - 1, loc2, slot, value1, value2);
+    } else if (loc2 == (var2_dim - 1)) {
+        return deck.interpolate(loc1, loc1 + 1, loc2 - 1, loc2, slot, value1, value2);
+    } else if (loc1 == (var1_dim - 1)) {
+        return deck.interpolate(loc1 - 1, loc1, loc2, loc2 + 1, slot, value1, value2);
+    } else {
+        return deck.interpolate(loc1, loc1+1, loc2, loc2+1, slot, value1, value2);
+    }
+}
+
+/* Mach ramps 0 -> 26, alpha swings 0 -> 32 deg, both slowly varying */
+static void trajectory(int i, double *mach, double *alpha) {
+    double s = static_cast<double>(i) / N_STEPS;
+    *mach = 26.0 * s;
+    *alpha = 16.0 - 16.0 * cos(6.0 * s);
+}
+
+static int bench_deck(const char *path) {
+    Datadeck deck(path);
+    TableHandle ca0 = deck.get_handle("ca0_vs_mach");
+    TableHandle caa = deck.get_handle("caa_vs_mach");
+    TableHandle cn0 = deck.get_handle("cn0_vs_mach_alpha");
+    TableHandle clm0 = deck.get_handle("clm0_vs_mach_alpha");
+    int mismatch = 0;
+    double mach, alpha;
+    double sum_legacy = 0;
+    double sum_handle = 0;
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N_STEPS; i++) {
+        trajectory(i, &mach, &alpha);
+        sum_legacy += legacy_look_up(deck, "ca0_vs_mach", mach, 1);
+        sum_legacy += legacy_look_up(deck, "caa_vs_mach", mach, 0);
+        sum_legacy += legacy_look_up(deck, "cn0_vs_mach_alpha", mach, alpha, 1);
+        sum_legacy += legacy_look_up(deck, "clm0_vs_mach_alpha", mach, alpha, 0);
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N_STEPS; i++) {
+        trajectory(i, &mach, &alpha);
+        sum_handle += deck.look_up(ca0, mach, 1);
+        sum_handle += deck.look_up(caa, mach, 0);
+        sum_handle += deck.look_up(cn0, mach, alpha, 1);
+        sum_handle += deck.look_up(clm0, mach, alpha, 0);
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    // point-wise check, including jumps that defeat the bracket cache
+    for (int i = 0; i < N_STEPS; i += 97) {
+        int j = (i * 7919) % N_STEPS;
+        trajectory(j, &mach, &alpha);
+        double expect = legacy_look_up(deck, "cn0_vs_mach_alpha", mach, alpha, 1);
+        double actual = deck.look_up(cn0, mach, alpha, 1);
+        if (memcmp(&expect, &actual, sizeof(double)) != 0)
+            mismatch++;
+        expect = legacy_look_up(deck, "ca0_vs_mach", mach, 1);
+        actual = deck.look_up(ca0, mach, 1);
+        if (memcmp(&expect, &actual, sizeof(double)) != 0)
+            mismatch++;
+    }
+    if (sum_legacy != sum_handle)
+        mismatch++;
+
+    double ns_legacy = std::chrono::duration<double, std::nano>(t1 - t0).count() / (4.0 * N_STEPS);
+    double ns_handle = std::chrono::duration<double, std::nano>(t2 - t1).count() / (4.0 * N_STEPS);
+    fprintf(stderr, "%-40s legacy %8.1f ns/lookup  handle %8.1f ns/lookup  speedup %5.1fx  %s\n",
+            path, ns_legacy, ns_handle, ns_legacy / ns_handle, mismatch ? "MISMATCH" : "match");
+    return mismatch;
+}
+
+int main(int argc, char const *argv[]) {
+    std::string aux_dir = (argc > 1) ? argv[1] : "../../../auxiliary";
+    const char *decks[] = {"aero_table_slv1.txt", "aero_table_slv2.txt", "aero_table_slv3.txt"};
+    int failed = 0;
+
+    fprintf(stderr, "** Datadeck look-up benchmark **\n");
+    for (int i = 0; i < 3; i++)
+        failed += bench_deck((aux_dir + "/" + decks[i]).c_str());
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+#include "datadeck.hh"
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/*
+ * Round trip of the text decks through the compiled deck format:
+ * text -> save_binary() -> mapped deck, then every table and a sweep of
+ * look-ups (inside, on and beyond the breakpoints) must match bit for bit.
+ */
+
+static int same(double a, double b) {
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+static int same_array(const double *a, const double *b, int n) {
+    return memcmp(a, b, n * sizeof(double)) == 0;
+}
+
+/* sample points: every breakpoint, midpoints, and both sides of the range */
+static std::vector<double> samples(const double *var, int n) {
+    std::vector<double> s;
+    s.push_back(var[0] - 1.0);
+    for (int i = 0; i < n; i++) {
+        s.push_back(var[i]);
+        if (i + 1 < n)
+            s.push_back(0.5 * (var[i] + var[i + 1]));
+    }
+    s.push_back(var[n - 1] + 1.0);
+    return s;
+}
+
+static int compare_deck(const std::string &text_path, const std::string &bin_path) {
+    Datadeck text(text_path.c_str());
+    if (text.save_binary(bin_path.c_str()) != 0) {
+        fprintf(stderr, "FAIL %s: save_binary\n", text_path.c_str());
+        return 1;
+    }
+    Datadeck bin(bin_path.c_str());
+
+    int failed = 0;
+    long checked = 0;
+    if (text.get_capacity() != bin.get_capacity() || text.get_title() != bin.get_title()) {
+        fprintf(stderr, "FAIL %s: deck header differs\n", text_path.c_str());
+        return 1;
+    }
+
+    for (int t = 0; t < text.get_capacity(); t++) {
+        Table *a = text.get_tbl(t);
+        Table *b = bin.get_tbl(t);
+        int n1 = a->get_var1_dim(), n2 = a->get_var2_dim(), n3 = a->get_var3_dim();
+        if (a->get_name() != b->get_name() || a->get_dim() != b->get_dim()
+            || n1 != b->get_var1_dim() || n2 != b->get_var2_dim() || n3 != b->get_var3_dim()
+            || !same_array(a->var1_ptr, b->var1_ptr, n1)
+            || !same_array(a->var2_ptr, b->var2_ptr, n2)
+            || !same_array(a->var3_ptr, b->var3_ptr, n3)
+            || !same_array(a->data_ptr, b->data_ptr, n1 * n2 * n3)) {
+            fprintf(stderr, "FAIL %s: table '%s' differs\n", text_path.c_str(), a->get_name().c_str());
+            failed++;
+            continue;
+        }
+
+        TableHandle ha = text.get_handle(a->get_name());
+        TableHandle hb = bin.get_handle(b->get_name());
+        std::vector<double> s1 = samples(a->var1_ptr, n1);
+        std::vector<double> s2 = samples(a->var2_ptr, n2);
+        std::vector<double> s3 = samples(a->var3_ptr, n3);
+        for (unsigned int flag = 0; flag < 2; flag++) {
+            for (size_t i = 0; i < s1.size(); i++) {
+                if (a->get_dim() == 1) {
+                    failed += !same(text.look_up(ha, s1[i], flag), bin.look_up(hb, s1[i], flag));
+                    checked++;
+                    continue;
+                }
+                for (size_t j = 0; j < s2.size(); j++) {
+                    if (a->get_dim() == 2) {
+                        failed += !same(text.look_up(ha, s1[i], s2[j], flag),
+                                        bin.look_up(hb, s1[i], s2[j], flag));
+                        checked++;
+                        continue;
+                    }
+                    for (size_t k = 0; k < s3.size(); k++) {
+                        failed += !same(text.look_up(ha, s1[i], s2[j], s3[k], flag),
+                                        bin.look_up(hb, s1[i], s2[j], s3[k], flag));
+                        checked++;
+                    }
+                }
+            }
+        }
+    }
+
+    fprintf(stderr, "%s %s: %d tables, %ld look-ups\n", failed ? "FAIL" : "PASS",
+            text_path.c_str(), text.get_capacity(), checked);
+    unlink(bin_path.c_str());
+    return failed;
+}
+
+static int copy_file(const std::string &from, const std::string &to) {
+    FILE *in = fopen(from.c_str(), "rb");
+    if (!in)
+        return -1;
+    FILE *out = fopen(to.c_str(), "wb");
+    if (!out) {
+        fclose(in);
+        return -1;
+    }
+    char buf[65536];
+    size_t n;
+    int status = 0;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+        if (fwrite(buf, 1, n, out) != n)
+            status = -1;
+    fclose(in);
+    if (fclose(out) != 0)
+        status = -1;
+    return status;
+}
+
+/* every table value of 'a' is the one of 'b', bit for bit */
+static int same_values(Datadeck &a, Datadeck &b) {
+    if (a.get_capacity() != b.get_capacity())
+        return 0;
+    for (int t = 0; t < a.get_capacity(); t++) {
+        Table *ta = a.get_tbl(t);
+        Table *tb = b.get_tbl(t);
+        int n1 = ta->get_var1_dim(), n2 = ta->get_var2_dim(), n3 = ta->get_var3_dim();
+        if (n1 != tb->get_var1_dim() || n2 != tb->get_var2_dim() || n3 != tb->get_var3_dim()
+            || !same_array(ta->var1_ptr, tb->var1_ptr, n1)
+            || !same_array(ta->var2_ptr, tb->var2_ptr, n2)
+            || !same_array(ta->var3_ptr, tb->var3_ptr, n3)
+            || !same_array(ta->data_ptr, tb->data_ptr, n1 * n2 * n3))
+            return 0;
+    }
+    return 1;
+}
+
+static int corrupted_deck_is_rejected(const std::string &text_path, const std::string &bin_path) {
+    Datadeck text(text_path.c_str());
+    if (text.save_binary(bin_path.c_str()) != 0) {
+        fprintf(stderr, "FAIL %s: save_binary\n", text_path.c_str());
+        return 1;
+    }
+
+    // flip one byte of the last value; the checksum is all that can tell
+    FILE *fp = fopen(bin_path.c_str(), "r+b");
+    if (!fp) {
+        fprintf(stderr, "FAIL cannot open %s\n", bin_path.c_str());
+        return 1;
+    }
+    fseek(fp, -8, SEEK_END);
+    int c = fgetc(fp);
+    fseek(fp, -8, SEEK_END);
+    fputc(c ^ 0xFF, fp);
+    fclose(fp);
+
+    std::string sibling = text_path + ".bdeck";
+    rename(bin_path.c_str(), sibling.c_str());
+    Datadeck fallback(text_path.c_str());
+    unlink(sibling.c_str());
+
+    // a mapped corrupted deck would carry the flipped value
+    int failed = !same_values(fallback, text);
+    fprintf(stderr, "%s corrupted compiled deck falls back to text\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
+
+int main(int argc, char const *argv[]) {
+    std::string aux_dir = (argc > 1) ? argv[1] : "../../../auxiliary";
+    const char *decks[] = {
+        "Aero_20180629_S2+S3.txt", "Aero_20180629_S3.txt",
+        "Aero_20180510_S2+S3.txt", "Aero_20180510_S3.txt",
+        "Prop_0521_S2+S3.txt", "Prop_0521_S3.txt",
+        "weather_table.txt",
+        "aero_table.txt", "aero_table_slv1.txt", "aero_table_slv2.txt", "aero_table_slv3.txt"
+    };
+    std::string bin_path = "datadeck_binary_test.bdeck";
+    int failed = 0;
+
+    fprintf(stderr, "** Datadeck compiled deck round trip **\n");
+    for (size_t i = 0; i < sizeof(decks) / sizeof(decks[0]); i++)
+        failed += compare_deck(aux_dir + "/" + decks[i], bin_path);
+
+    // the sibling is written next to the text deck, so work on a copy
+    std::string copy = "datadeck_binary_test.txt";
+    if (copy_file(aux_dir + "/weather_table.txt", copy) != 0) {
+        fprintf(stderr, "FAIL cannot copy %s/weather_table.txt\n", aux_dir.c_str());
+        return 1;
+    }
+    failed += corrupted_deck_is_rejected(copy, bin_path);
+    unlink(copy.c_str());
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,65 @@
+#include "datadeck.hh"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/*
+ * A deck that lacks a requested table: get_handle() reports it through
+ * an invalid handle, require_handle() and a look-up through the invalid
+ * handle stop the program instead of reading outside the table array.
+ */
+
+/* runs 'fn' in a child, returns its exit status, -1 if it did not exit */
+static int exit_status_of(void (*fn)(Datadeck &), Datadeck &deck) {
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        fn(deck);
+        _exit(0);
+    }
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+        return -1;
+    return WEXITSTATUS(status);
+}
+
+static void require_missing(Datadeck &deck) {
+    deck.require_handle("CN_vs_mach_alpha");
+}
+
+static void look_up_missing(Datadeck &deck) {
+    TableHandle tbl = deck.get_handle("CN_vs_mach_alpha");
+    deck.look_up(tbl, 0.0, 0.5, 1);
+}
+
+static void look_up_unresolved(Datadeck &deck) {
+    TableHandle tbl;
+    deck.look_up(tbl, 1000.0, 0);
+}
+
+static int check(const char *what, int ok) {
+    fprintf(stderr, "%s %s\n", ok ? "PASS" : "FAIL", what);
+    return !ok;
+}
+
+int main(int argc, char const *argv[]) {
+    std::string aux_dir = (argc > 1) ? argv[1] : "../../../auxiliary";
+    Datadeck deck((aux_dir + "/weather_table.txt").c_str());
+    int failed = 0;
+
+    fprintf(stderr, "** Datadeck missing table handling **\n");
+    TableHandle density = deck.get_handle("density");
+    failed += check("present table resolves", density.is_valid() && density.dim == 1);
+    failed += check("present table looks up", deck.look_up(density, 1000.0, 0)
+                                              == deck.look_up(std::string("density"), 1000.0, 0));
+    failed += check("missing table gives invalid handle", !deck.get_handle("CN_vs_mach_alpha").is_valid());
+    failed += check("require_handle on missing table exits", exit_status_of(require_missing, deck) == 1);
+    failed += check("look-up through missing table exits", exit_status_of(look_up_missing, deck) == 1);
+    failed += check("look-up through unresolved handle exits", exit_status_of(look_up_unresolved, deck) == 1);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include "env/gravity_harmonic.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+/*
+ * Per-call cost of gravity_harmonic_accel() at degree/order 2, 8 and 20.
+ *
+ * legacy : the AccelHarmonic() body the kernel replaced (zero-initialized
+ *          V/W arrays, divisions in the recursion)
+ * plain  : kernel, plain recursion; must agree with legacy bit for bit
+ * coef   : kernel, Cunningham recursion with precomputed coefficients
+ */
+
+static const double GM_WGS84 = 3.9860044e14;
+static const double R_WGS84 = 6378137;
+static const int N_CALLS = 200000;
+
+static void legacy_accel(const double r_bf[3], const double CS[][GRAVITY_N_JGM3+1],
+                         int n_max, int m_max, double a_bf[3]) {
+    int    n, m;
+    double r_sqr, rho, Fac;
+    double x0, y0, z0;
+    double ax, ay, az;
+    double C, S;
+    double V[GRAVITY_N_JGM3+2][GRAVITY_N_JGM3+2] = {{0.0}};
+    double W[GRAVITY_N_JGM3+2][GRAVITY_N_JGM3+2] = {{0.0}};
+
+    r_sqr = r_bf[0] * r_bf[0] + r_bf[1] * r_bf[1] + r_bf[2] * r_bf[2];
+    rho   = R_WGS84 * R_WGS84 / r_sqr;
+    x0 = R_WGS84 * r_bf[0] / r_sqr;
+    y0 = R_WGS84 * r_bf[1] / r_sqr;
+    z0 = R_WGS84 * r_bf[2] / r_sqr;
+
+    V[0][0] = R_WGS84 / sqrt(r_sqr);
+    W[0][0] = 0.0;
+    V[1][0] = z0 * V[0][0];
+    W[1][0] = 0.0;
+    for (n = 2; n <= n_max+1; n++) {
+        V[n][0] = ((2*n-1) * z0 * V[n-1][0] - (n-1) * rho * V[n-2][0]) / n;
+        W[n][0] = 0.0;
+    }
+    for (m = 1; m <= m_max+1; m++) {
+        V[m][m] = (2*m-1) * (x0 * V[m-1][m-1] - y0 * W[m-1][m-1]);
+        W[m][m] = (2*m-1) * (x0 * W[m-1][m-1] + y0 * V[m-1][m-1]);
+        if (m <= n_max) {
+            V[m+1][m] = (2*m+1) * z0 * V[m][m];
+            W[m+1][m] = (2*m+1) * z0 * W[m][m];
+        }
+        for (n = m+2; n <= n_max+1; n++) {
+            V[n][m] = ((2*n-1) * z0 * V[n-1][m] - (n+m-1) * rho * V[n-2][m]) / (n-m);
+            W[n][m] = ((2*n-1) * z0 * W[n-1][m] - (n+m-1) * rho * W[n-2][m]) / (n-m);
+        }
+    }
+
+    ax = ay = az = 0.0;
+    for (m = 0; m <= m_max; m++) {
+        for (n = m; n <= n_max ; n++) {
+            if (m == 0) {
+                C = CS[n][0];
+                ax -=       C * V[n+1][1];
+                ay -=       C * W[n+1][1];
+                az -= (n+1)*C * V[n+1][0];
+            } else {
+                C = CS[n][m];
+                S = CS[m-1][n];
+                Fac = 0.5 * (n-m+1) * (n-m+2);
+                ax +=   + 0.5 * (- C * V[n+1][m+1] - S * W[n+1][m+1])
+                        + Fac * (+ C * V[n+1][m-1] + S * W[n+1][m-1]);
+                ay +=   + 0.5 * (- C * W[n+1][m+1] + S * V[n+1][m+1])
+                        + Fac * (- C * W[n+1][m-1] + S * V[n+1][m-1]);
+                az += (n-m+1) * (- C * V[n+1][m]   - S * W[n+1][m]);
+            }
+        }
+    }
+    a_bf[0] = (GM_WGS84/(R_WGS84 * R_WGS84)) * ax;
+    a_bf[1] = (GM_WGS84/(R_WGS84 * R_WGS84)) * ay;
+    a_bf[2] = (GM_WGS84/(R_WGS84 * R_WGS84)) * az;
+}
+
+/* ascent-like track: 0 -> 300 km altitude while sweeping latitude/longitude */
+static void position(int i, double r[3]) {
+    double s = static_cast<double>(i) / N_CALLS;
+    double rad = R_WGS84 + 3.0e5 * s;
+    double lat = 0.4 + 0.3 * s;
+    double lon = 2.1 + 0.5 * s;
+    r[0] = rad * cos(lat) * cos(lon);
+    r[1] = rad * cos(lat) * sin(lon);
+    r[2] = rad * sin(lat);
+}
+
+int main() {
+    const int degrees[] = {2, 8, 20};
+    gravity_harmonic_coef coef;
+    gravity_harmonic_work work;
+    int failed = 0;
+
+    gravity_harmonic_coef_init(&coef);
+    fprintf(stderr, "** Harmonic gravity kernel benchmark **\n");
+
+    for (int d = 0; d < 3; d++) {
+        int n = degrees[d];
+        double r[3], a[3], b[3];
+        double sum[3] = {0.0, 0.0, 0.0};
+        double max_rel = 0.0;
+        int mismatch = 0;
+
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < N_CALLS; i++) {
+            position(i, r);
+            legacy_accel(r, GRAVITY_CS_JGM3, n, n, a);
+            sum[0] += a[0] + a[1] + a[2];
+        }
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        for (int i = 0; i < N_CALLS; i++) {
+            position(i, r);
+            gravity_harmonic_accel(r, GRAVITY_CS_JGM3, n, n, GM_WGS84, R_WGS84, NULL, &work, a);
+            sum[1] += a[0] + a[1] + a[2];
+        }
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+        for (int i = 0; i < N_CALLS; i++) {
+            position(i, r);
+            gravity_harmonic_accel(r, GRAVITY_CS_JGM3, n, n, GM_WGS84, R_WGS84, &coef, &work, a);
+            sum[2] += a[0] + a[1] + a[2];
+        }
+        std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < N_CALLS; i += 101) {
+            position(i, r);
+            legacy_accel(r, GRAVITY_CS_JGM3, n, n, a);
+            gravity_harmonic_accel(r, GRAVITY_CS_JGM3, n, n, GM_WGS84, R_WGS84, NULL, &work, b);
+            if (memcmp(a, b, sizeof(a)) != 0)
+                mismatch++;
+            gravity_harmonic_accel(r, GRAVITY_CS_JGM3, n, n, GM_WGS84, R_WGS84, &coef, &work, b);
+            double norm = sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+            for (int k = 0; k < 3; k++)
+                max_rel = fmax(max_rel, fabs(a[k] - b[k]) / norm);
+        }
+        if (sum[0] != sum[1] || max_rel > 1e-14)
+            mismatch++;
+
+        double ns_legacy = std::chrono::duration<double, std::nano>(t1 - t0).count() / N_CALLS;
+        double ns_plain = std::chrono::duration<double, std::nano>(t2 - t1).count() / N_CALLS;
+        double ns_coef = std::chrono::duration<double, std::nano>(t3 - t2).count() / N_CALLS;
+        fprintf(stderr, "degree %2d  legacy %7.1f ns  plain %7.1f ns  coef %7.1f ns  coef rel err %.1e  %s\n",
+                n, ns_legacy, ns_plain, ns_coef, max_rel, mismatch ? "MISMATCH" : "match");
+        failed += mismatch;
+    }
+    return failed ? 1 : 0;
+}
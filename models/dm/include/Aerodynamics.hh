@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the AERODYNAMICS Module On Board)
 LIBRARY DEPENDENCY:
-      ((../src/Aerodynamics.cpp))
+      ((../src/Aerodynamics.cpp)
+       (../../aux/src/checkpoint.cpp))
 PROGRAMMERS:
       (((Jun-Xu Lai) () () () ))
 *******************************************************************************/
@@ -16,6 +17,7 @@ PROGRAMMERS:
 #include "global_constants.hh"
 
 class Propulsion;
+class Checkpoint;
 
 class AeroDynamics{
     TRICK_INTERFACE(AeroDynamics);
@@ -30,6 +32,8 @@ class AeroDynamics{
 
     void initialize();
     void calculate_aero(double int_step);
+    /* Coefficients and derivatives, the deck is left to load_aerotable(), see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
 
     double get_dyb();
     double get_dma();
@@ -85,6 +89,14 @@ class AeroDynamics{
 
     Datadeck aerotable; /* ** (--) Aero Deck */
 
+    /* Table handles, resolved when the aero deck is loaded */
+    TableHandle cn_table;       /* ** (--) CN_vs_mach_alpha */
+    TableHandle ca_off_table;   /* ** (--) CA_off_vs_mach_alpha_alt */
+    TableHandle ca_on_table;    /* ** (--) CA_on_vs_mach_alpha_alt */
+    TableHandle xcp_table;      /* ** (--) Xcp_vs_mach_alpha */
+    TableHandle cmq_table;      /* ** (--) CMq_vs_mach */
+    TableHandle cnq_table;      /* ** (--) CNq_vs_mach */
+
     double xcg_ref;     /* *io (m)      Reference cg location from nose - m*/
     double alplimx;     /* *io (d)      Alpha limiter for vehicle - deg*/
     double alimitx;     /* *io (--)     Structural  limiter for vehicle*/
@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the Environment Module Variables and Algorithm)
 LIBRARY DEPENDENCY:
-      ((../src/Environment.cpp))
+      ((../src/Environment.cpp)
+       (../../aux/src/checkpoint.cpp))
 PROGRAMMERS:
       (((Lai Jun Xu) () () () ))
 *******************************************************************************/
@@ -23,10 +24,13 @@ PROGRAMMERS:
 #include "env/wind_tabular.hh"
 #include "env/wind_constant.hh"
 
+#include "env/gravity_harmonic.h"
+
 #include "Time_management.hh"
 #include "dm_delta_ut.hh"
 
 class time_management;
+class Checkpoint;
 
 class Environment{
     TRICK_INTERFACE(Environment);
@@ -57,6 +61,10 @@ class Environment{
     void propagate(double int_step);
     void update_diagnostic_attributes(double int_step);
     void dm_RNP();
+    void set_RNP_update_interval(double interval, int interpolate);
+    void set_gravity_harmonic(int n_max, int m_max, int use_coef_table);
+    /* Dynamic state with the atmosphere and wind models, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
 
     double get_rho();
     double get_vmach();
@@ -84,7 +92,7 @@ class Environment{
 
 
  private:
-    arma::vec AccelHarmonic(arma::vec3 SBII, double CS[21][21],
+    arma::vec AccelHarmonic(arma::vec3 SBII, const double CS[][GRAVITY_N_JGM3+1],
                 int n_max, int m_max);
     /* Internal Getter */
 
@@ -94,6 +102,8 @@ class Environment{
     /* Internal Propagator / Calculators */
 
     /* Internal Calculators */
+    void dm_nut_n_pre(double t, arma::mat33 *M_nut_n_pre, double *eq_equinox);
+    void dm_cached_nut_n_pre(double t, double *eq_equinox);
 
     /* Routing references */
 
@@ -101,6 +111,11 @@ class Environment{
     time_management *time;
 
     /* Constants */
+    int grav_n_max;     /* *io (--)  Degree of the harmonic gravity model */
+    int grav_m_max;     /* *io (--)  Order of the harmonic gravity model */
+    int grav_use_coef;  /* *io (--)  1 = Cunningham recursion with precomputed coefficients */
+    gravity_harmonic_coef grav_coef;  /* ** (--) Recursion coefficient table */
+
     cad::Atmosphere * atmosphere;
     cad::Wind       * wind;
 
@@ -127,6 +142,17 @@ class Environment{
 
     arma::mat M_nut_n_pre; /* *o (--)   Nutation-Precession Matrix */
     double _M_nut_n_pre[3][3];    /* *o (--)   Nutation-Precession Matrix */
+
+    /* Nutation-Precession cache, see dm_cached_nut_n_pre() */
+    double rnp_update_interval; /* *io (s)   PN matrix update interval, 0 = every dm_RNP() call */
+    int rnp_interpolate;        /* *io (--)  1 = interpolate PN linearly between updates */
+    int rnp_cache_valid;        /* *io (--)  PN cache nodes hold valid data */
+    double rnp_node_t[2];       /* *io (--)  Julian century of the PN cache nodes */
+    double rnp_node_eqeq[2];    /* *io (r)   Equation of the equinoxes at the PN cache nodes */
+    arma::mat PN_node0;         /* *io (--)  PN matrix at cache node 0 */
+    double _PN_node0[3][3];     /* *io (--)  PN matrix at cache node 0 */
+    arma::mat PN_node1;         /* *io (--)  PN matrix at cache node 1 */
+    double _PN_node1[3][3];     /* *io (--)  PN matrix at cache node 1 */
     arma::vec VBAB;
     double _VBAB[3];
 };
@@ -5,6 +5,8 @@ PURPOSE:
       (Describe the forces Module Variables and Algorithm)
 LIBRARY DEPENDENCY:
       ((../src/Forces.cpp))
+      ((../../math/src/broydn.cpp))
+      ((../../aux/src/checkpoint.cpp))
       ((../../math/src/nrutil.cpp))
 PROGRAMMERS:
       ((Lai Jun Xu))
@@ -15,9 +17,11 @@ PROGRAMMERS:
 #include <functional>
 #include "aux.hh"
 #include <armadillo>
+#include "broydn.hh"
 
 class Propulsion;
 class TVC;
+class Checkpoint;
 
 class Forces {
     TRICK_INTERFACE(Forces);
@@ -37,6 +41,10 @@ class Forces {
     void set_Slosh_flag(unsigned int flag);
     void set_TWD_flag(unsigned int flag);
     void set_DOF(int ndof);
+    void set_broydn_warm_start(unsigned int flag);
+    void set_jacobian_mode(unsigned int mode);
+    /* Dynamic state and the solver warm start, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
     void set_damping_ratio(double damping);
     void set_aero_flag(unsigned int in);
     void set_e1_d(double in1, double in2, double in3);
@@ -58,6 +66,10 @@ class Forces {
     double get_ddang_slosh_theta();
     double get_ddang_slosh_psi();
     double get_slosh_mass();
+    int get_broydn_its();
+    int get_broydn_fcalls();
+    double get_broydn_wall_time();
+    double get_jacobian_error();
     arma::vec get_e1_XCG();
     arma::vec get_e2_XCG();
     arma::vec get_e3_XCG();
@@ -136,15 +148,8 @@ class Forces {
     void AeroDynamics_Q();
     void calculate_I1();
     void funcv(int n, double *x, double *ff);
-    void broydn(double x[], int n, int *check);
-    void rsolv(double **a, int n, double d[], double b[]);
-    void fdjac(int n, double x[], double fvec[], double **df);
-    double f_min(double x[]);
-    void lnsrch(int n, double xold[], double fold, double g[], double p[], double x[],
-    double *f, double stpmax, int *check);
-    void qrdcmp(double **a, int n, double *c, double *d, int *sing);
-    void qrupdt(double **r, double **qt, int n, double u[], double v[]);
-    void rotate(double **r, double **qt, int n, int i, double a, double b);
+    void jacobian(int n, double *x, double *fvec, double **df);
+    void analytic_jacobian(int n, double **df);
     void slosh();
     void S2_TWD();
     void calculate_I_E();
@@ -514,7 +519,12 @@ class Forces {
     arma::vec e4_XCG;
     double _e4_XCG[3];
 
-    int its;
+    BroydnSolver solver;        /* ** Generalized acceleration solver and its workspace */
+    int broydn_its;             /* *o (--)  Broyden iterations of the last step */
+    int broydn_fcalls;          /* *o (--)  Function evaluations of the last step */
+    double broydn_wall_time;    /* *o (s)   Solver wall time of the last step */
+    unsigned int jacobian_mode; /* *i (--)  Solver Jacobian: 0 finite difference, 1 analytic, 2 analytic checked against finite difference */
+    double jacobian_error;      /* *o (--)  Largest analytic - finite difference Jacobian entry over the largest entry, mode 2 */
     int DOF;
     unsigned int Slosh_flag;
     unsigned int TWD_flag;
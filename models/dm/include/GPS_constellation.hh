@@ -5,7 +5,8 @@
 PURPOSE:
       (Describe the GPS Receiver model)
 LIBRARY DEPENDENCY:
-      ((../src/GPS_constellation.cpp))
+      ((../src/GPS_constellation.cpp)
+       (../../aux/src/checkpoint.cpp))
 PROGRAMMERS:
       (((Lai Jun Xu) () () () ))
 *******************************************************************************/
@@ -100,6 +101,8 @@ struct channel_t {
     range_t rho0;
 };
 
+class Checkpoint;
+
 class GPS_constellation {
     TRICK_INTERFACE(GPS_constellation);
     friend class GPS_FSW;
@@ -110,8 +113,12 @@ class GPS_constellation {
     GPS_constellation& operator= (const GPS_constellation& other);
 
     void readfile(const char *fname);
+    /* ephemeris and ionosphere of one that read the RINEX file already */
+    void load_ephemeris(const GPS_constellation &other);
     void initialize();
     void compute();
+    /* Channels and visibility, the ephemerides are left to load_ephemeris(), see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
     void show();
     channel_t* get_channel();
     transmit_channel* get_transmit_data();
@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the propulsion Module Variables and Algorithm)
 LIBRARY DEPENDENCY:
-      ((../src/Propulsion.cpp))
+      ((../src/Propulsion.cpp)
+       (../../aux/src/checkpoint.cpp))
 PROGRAMMERS:
       (((Lai Jun Xu) () () () ))
 *******************************************************************************/
@@ -15,6 +16,8 @@ PROGRAMMERS:
 #include "datadeck.hh"
 #include "sim_services/include/simtime.h"
 
+class Checkpoint;
+
 class Propulsion{
     TRICK_INTERFACE(Propulsion);
 
@@ -27,6 +30,8 @@ class Propulsion{
     void initialize();
     void propagate(double int_step);
     void load_proptable(const char* filename);
+    /* Mass properties and staging state, the deck is left to load_proptable(), see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
 
     enum THRUST_TYPE {
         NO_THRUST = 0,
@@ -130,6 +135,11 @@ class Propulsion{
  private:
     Datadeck proptable;
 
+    /* Table handles, resolved when the propulsion deck is loaded */
+    TableHandle S2_thrust_table;    /* ** (--) S2_time_vs_thrust */
+    TableHandle S3_thrust_table;    /* ** (--) S3_time_vs_thrust */
+    TableHandle thrust_table;       /* ** (--) time_vs_thrust */
+
     /* Internal Getter */
     arma::mat33 get_IBBB0();
     arma::mat33 get_IBBB1();
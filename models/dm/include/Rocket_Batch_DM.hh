@@ -0,0 +1,144 @@
+#ifndef __Rocket_Batch_DM_HH__
+#define __Rocket_Batch_DM_HH__
+/********************************* TRICK HEADER *******************************
+PURPOSE:
+      (Structure-of-arrays rigid body 6DOF propagation of a batch of trajectories)
+LIBRARY DEPENDENCY:
+      ((../src/Rocket_Batch_DM.cpp)
+       (../../cad/src/cad_utility.cpp)
+       (../../cad/src/env/atmosphere76.cpp))
+ICG: (No)
+*******************************************************************************/
+#include "simd_double.hh"
+#include "env/gravity_harmonic.h"
+
+/**
+ * \brief Rocket_Flight_DM::RK4() for many trajectories at once.
+ *
+ * Every field of the batch is stored as one array over the trajectories
+ * (structure of arrays), so one simd_double operation advances WIDTH
+ * trajectories. The state is the rigid body part of the RK4 state vector,
+ * VBIIP, SBIIP, WBIB and TBI_Q, in the RK4_* layout of Rocket_Flight_DM;
+ * the reference point is the center of mass and the vehicle has lifted off.
+ *
+ * A DM frame is environment() then propagate(), as Environment::propagate()
+ * in P1 and Rocket_Flight_DM::propagate() in P3:
+ *   environment(TEI)  GRAVG (gravity_harmonic_recursion() on the lanes, TEI
+ *                     shared by the batch), geodetic altitude
+ *                     (cad::geo84_lat_alt() per lane), US 1976 atmosphere,
+ *                     dvba, vmach, pdynmc
+ *   propagate(h)      one RK4 step; the body force FAPB less the axial drag
+ *                     pdynmc * CA_REFA and the moment FMB are held over the
+ *                     step, the stages evaluate the Euler equations of the
+ *                     principal inertia IBBB.
+ * Like RK4F(), the position rate of the stages is the VBII of the previous
+ * step.
+ *
+ * The lane arithmetic is rocket_batch_rates<simd_double>(); the scalar
+ * instance rocket_batch_rates<double>() driven by rk4_step() is the same
+ * trajectory bit for bit (see simd_double.hh).
+ */
+class Rocket_Batch_DM {
+ public:
+    static const int WIDTH = simd_double::WIDTH;
+
+    /* Fields of the batch, field(f)[i] is field f of trajectory i */
+    enum {
+        VBIIP = 0,      /* (m/s)    Inertial velocity, 3 */
+        SBIIP = 3,      /* (m)      Inertial position, 3 */
+        WBIB = 6,       /* (r/s)    Body rate wrt inertial frame, 3 */
+        TBI_Q = 9,      /* (--)     Quaternion of TBI, 4 */
+        N_STATE = 13,
+        VBII = 13,      /* (m/s)    Inertial velocity of the previous step, 3 */
+        VMASS = 16,     /* (kg)     Vehicle mass */
+        IBBB = 17,      /* (kg*m2)  Principal moments of inertia, 3 */
+        FAPB = 20,      /* (N)      Propulsion and aerodynamic force in body frame, 3 */
+        CA_REFA = 23,   /* (m2)     Axial force coefficient times reference area */
+        FMB = 24,       /* (N*m)    Moment in body frame, 3 */
+        GRAVG = 27,     /* (m/s2)   Gravity acceleration in inertial frame, 3 */
+        ALT = 30,       /* (m)      Geodetic altitude */
+        RHO = 31,       /* (kg/m3)  Atmospheric density */
+        VSOUND = 32,    /* (m/s)    Speed of sound */
+        DVBA = 33,      /* (m/s)    Vehicle speed wrt air */
+        VMACH = 34,     /* (--)     Mach number */
+        PDYNMC = 35,    /* (pa)     Dynamic pressure */
+        N_FIELD = 36
+    };
+
+    explicit Rocket_Batch_DM(int n);
+    ~Rocket_Batch_DM();
+
+    int size() const { return n; }
+    double *field(int f) { return buf + f * stride; }
+    const double *field(int f) const { return buf + f * stride; }
+
+    void load_state(int i, const double SBII[3], const double VBII[3], const double WBIB[3], const double TBI_Q[4]);
+    void save_state(int i, double SBII[3], double VBII[3], double WBIB[3], double TBI_Q[4]) const;
+    void load_mass_properties(int i, double vmass, const double IBBB[3]);
+    void load_loads(int i, const double FAPB[3], double ca_refa, const double FMB[3]);
+
+    void set_gravity_harmonic(int n_max, int m_max, int use_coef_table);
+
+    void environment(const double TEI[3][3]);
+    void propagate(double int_step);
+
+ private:
+    int n;              /* Trajectories */
+    int stride;         /* Field length, n padded to WIDTH */
+    double *buf;        /* N_FIELD fields of stride doubles */
+
+    int grav_n_max;     /* Max degree of the harmonic gravity */
+    int grav_m_max;     /* Max order of the harmonic gravity */
+    int grav_use_coef;  /* Use the precomputed recursion coefficients */
+    gravity_harmonic_coef grav_coef;
+
+    Rocket_Batch_DM(const Rocket_Batch_DM &);
+    Rocket_Batch_DM &operator=(const Rocket_Batch_DM &);
+};
+
+/**
+ * \brief RK4 state rates of one lane (T = double) or WIDTH lanes (T = simd_double).
+ *
+ * y is the state in the RK4_* layout, FSPB the specific force in body frame
+ * held over the step. The rates follow RK4F(): NEXT_ACC = TBI^T FSPB + GRAVG
+ * (Strapdown Analytics 4.3-11), WBIBD = IBBB^-1 (FMB - WBIB x IBBB WBIB) and
+ * the quaternion derivative with the normalization term (Zipfel p.141).
+ */
+template <class T>
+inline void rocket_batch_rates(const T y[], const T VBII[3], const T FSPB[3], const T IBBB[3],
+                               const T FMB[3], const T GRAVG[3], T dy[]) {
+    const T *WBIB = y + Rocket_Batch_DM::WBIB;
+    const T *Q = y + Rocket_Batch_DM::TBI_Q;
+    T TBI[3][3], IW[3];
+
+    /* Quaternion2Matrix() */
+    TBI[0][0] = 2. * (Q[0] * Q[0] + Q[1] * Q[1]) - 1.;
+    TBI[0][1] = 2. * (Q[1] * Q[2] + Q[0] * Q[3]);
+    TBI[0][2] = 2. * (Q[1] * Q[3] - Q[0] * Q[2]);
+    TBI[1][0] = 2. * (Q[1] * Q[2] - Q[0] * Q[3]);
+    TBI[1][1] = 2. * (Q[0] * Q[0] + Q[2] * Q[2]) - 1.;
+    TBI[1][2] = 2. * (Q[2] * Q[3] + Q[0] * Q[1]);
+    TBI[2][0] = 2. * (Q[1] * Q[3] + Q[0] * Q[2]);
+    TBI[2][1] = 2. * (Q[2] * Q[3] - Q[0] * Q[1]);
+    TBI[2][2] = 2. * (Q[0] * Q[0] + Q[3] * Q[3]) - 1.;
+
+    for (int i = 0; i < 3; i++) {
+        dy[Rocket_Batch_DM::VBIIP + i] = TBI[0][i] * FSPB[0] + TBI[1][i] * FSPB[1] + TBI[2][i] * FSPB[2] + GRAVG[i];
+        dy[Rocket_Batch_DM::SBIIP + i] = VBII[i];
+        IW[i] = IBBB[i] * WBIB[i];
+    }
+    dy[Rocket_Batch_DM::WBIB + 0] = (FMB[0] - (WBIB[1] * IW[2] - WBIB[2] * IW[1])) / IBBB[0];
+    dy[Rocket_Batch_DM::WBIB + 1] = (FMB[1] - (WBIB[2] * IW[0] - WBIB[0] * IW[2])) / IBBB[1];
+    dy[Rocket_Batch_DM::WBIB + 2] = (FMB[2] - (WBIB[0] * IW[1] - WBIB[1] * IW[0])) / IBBB[2];
+
+    T quat_metric = Q[0] * Q[0] + Q[1] * Q[1] + Q[2] * Q[2] + Q[3] * Q[3];
+    T erq = 1. - quat_metric;
+
+    T *dq = dy + Rocket_Batch_DM::TBI_Q;
+    dq[0] = 0.5 * (-WBIB[0] * Q[1] - WBIB[1] * Q[2] - WBIB[2] * Q[3]) + 50. * erq * Q[0];
+    dq[1] = 0.5 * (WBIB[0] * Q[0] + WBIB[2] * Q[2] - WBIB[1] * Q[3]) + 50. * erq * Q[1];
+    dq[2] = 0.5 * (WBIB[1] * Q[0] - WBIB[2] * Q[1] + WBIB[0] * Q[3]) + 50. * erq * Q[2];
+    dq[3] = 0.5 * (WBIB[2] * Q[0] + WBIB[1] * Q[1] - WBIB[0] * Q[2]) + 50. * erq * Q[3];
+}
+
+#endif  // __Rocket_Batch_DM_HH__
@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the Rocket Flgiht Dynamics Module Variables and Algorithm)
 LIBRARY DEPENDENCY:
-      ((../src/Rocket_Flight_DM.cpp))
+      ((../src/Rocket_Flight_DM.cpp)
+       (../../aux/src/checkpoint.cpp))
 PROGRAMMERS:
       (((Lai Jun Xu) () () () ))
 *******************************************************************************/
@@ -17,9 +18,11 @@ PROGRAMMERS:
 #include "aux.hh"
 #include "icf_trx_ctrl.h"
 #include "simgen_remote.h"
+#include "simgen_sender.h"
 class Environment;
 class Propulsion;
 class Forces;
+class Checkpoint;
 
 class Rocket_Flight_DM {
     TRICK_INTERFACE(Rocket_Flight_DM);
@@ -30,6 +33,7 @@ class Rocket_Flight_DM {
     Rocket_Flight_DM& operator=(const Rocket_Flight_DM& other);
     struct icf_ctrlblk_t *dm_icf_info_hook;
     int enqueue_to_simgen_buffer(struct icf_ctrlblk_t* C, double ext_porlation);
+    int push_to_simgen_sender(struct simgen_sender_t *S, double ext_porlation);
     int stand_still_motion_data(struct icf_ctrlblk_t* C, double ext_porlation);
     double get_ppx();
     double get_qqx();
@@ -61,6 +65,8 @@ class Rocket_Flight_DM {
     void update_diagnostic_attributes(double int_step);
     void Interpolation_Extrapolation(double T, double int_step, double ext_porlation);
     void set_reference_point(double rp);
+    /* Dynamic state, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
 
     arma::mat get_TGI();
     arma::mat get_TDE();
@@ -139,6 +145,8 @@ class Rocket_Flight_DM {
  private:
     Propulsion *propulsion;
 
+    void fill_simgen_motion(struct simgen_motion_data_t *motion_info, double ext_porlation);
+
     void propagate_position_speed_acceleration(double int_step);
     void propagate_aeroloss(double int_step);
     void propagate_gravityloss(double int_step);
@@ -150,10 +158,22 @@ class Rocket_Flight_DM {
     void orbital(arma::vec3 SBII, arma::vec3 VBII, double dbi);
     void build_WEII();
     void aux_calulate(arma::mat33 TEI, arma::mat33 TBI);
-    void RK4F(arma::vec3 GRAVG, arma::mat33 TEI, double int_step,
-                arma::vec3 &K1, arma::vec3 &K2, arma::vec3 &K3, arma::vec4 &K4,
-                double &K5, double &K6, double &K7, double &K8);
+    /* RK4 state vector layout */
+    enum {
+        RK4_VBIIP = 0,
+        RK4_SBIIP = 3,
+        RK4_WBIB = 6,
+        RK4_TBI_Q = 9,
+        RK4_DANG_SLOSH_THETA = 13,
+        RK4_ANG_SLOSH_THETA = 14,
+        RK4_DANG_SLOSH_PSI = 15,
+        RK4_ANG_SLOSH_PSI = 16,
+        RK4_N = 17
+    };
+    void RK4F(const arma::vec3 &GRAVG, const arma::mat33 &TEI, double *dy);
     void RK4(arma::vec3 GRAVG, arma::mat33 TEI, double int_step);
+    void save_rk4_state(double *y);
+    void load_rk4_state(const double *y);
 
     double calculate_alphaix(arma::vec3 VBIB);
     double calculate_betaix(arma::vec3 VBIB);
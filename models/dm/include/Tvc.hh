@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the TVC Module On Board)
 LIBRARY DEPENDENCY:
-      ((../src/Tvc.cpp))
+      ((../src/Tvc.cpp)
+       (../../aux/src/checkpoint.cpp))
 *******************************************************************************/
 #include <tuple>
 #include <functional>
@@ -19,6 +20,8 @@ struct tvc_param_t {
     int16_t yaw_count;
 };
 
+class Checkpoint;
+
 class TVC {
     TRICK_INTERFACE(TVC);
 
@@ -29,6 +32,8 @@ class TVC {
     TVC& operator=(const TVC& other);
 
     void initialize();
+    /* Actuator states and commands, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
 
     void actuate(double int_step, struct icf_ctrlblk_t* C);
 
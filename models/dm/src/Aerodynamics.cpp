@@ -1,13 +1,23 @@
 #include "Aerodynamics.hh"
+#include "checkpoint.hh"
 
 AeroDynamics::AeroDynamics(Propulsion &prop)
     :   propulsion(&prop),
     VECTOR_INIT(xcp, 3) {
+    this->xcp.zeros();
 }
 
 AeroDynamics::AeroDynamics(const AeroDynamics& other)
-    :   propulsion(other.propulsion) {
+    :   propulsion(other.propulsion),
+    VECTOR_INIT(xcp, 3) {
+    this->xcp = other.xcp;
     this->aerotable = other.aerotable;
+    this->cn_table = other.cn_table;
+    this->ca_off_table = other.ca_off_table;
+    this->ca_on_table = other.ca_on_table;
+    this->xcp_table = other.xcp_table;
+    this->cmq_table = other.cmq_table;
+    this->cnq_table = other.cnq_table;
 
     this->xcg_ref = other.xcg_ref;
     this->alplimx = other.alplimx;
@@ -81,6 +91,13 @@ AeroDynamics& AeroDynamics::operator=(const AeroDynamics& other) {
     // this->tvc = other.tvc;
 
     this->aerotable = other.aerotable;
+    this->cn_table = other.cn_table;
+    this->ca_off_table = other.ca_off_table;
+    this->ca_on_table = other.ca_on_table;
+    this->xcp_table = other.xcp_table;
+    this->cmq_table = other.cmq_table;
+    this->cnq_table = other.cnq_table;
+    this->xcp = other.xcp;
 
     this->xcg_ref = other.xcg_ref;
     this->alplimx = other.alplimx;
@@ -150,6 +167,22 @@ void AeroDynamics::initialize() {
 
 void AeroDynamics::load_aerotable(const char* filename) {
     aerotable = Datadeck(filename);
+
+    cn_table = aerotable.require_handle("CN_vs_mach_alpha");
+    ca_off_table = aerotable.require_handle("CA_off_vs_mach_alpha_alt");
+    ca_on_table = aerotable.require_handle("CA_on_vs_mach_alpha_alt");
+    xcp_table = aerotable.require_handle("Xcp_vs_mach_alpha");
+    cmq_table = aerotable.require_handle("CMq_vs_mach");
+    cnq_table = aerotable.require_handle("CNq_vs_mach");
+}
+
+void AeroDynamics::checkpoint(Checkpoint &cp) {
+    cp.section("AERO");
+    cp(xcg_ref, alplimx, alimitx, refa, refd, dyb, dma, dnb, dnd, dmq, dnr, dmde, dndr, gymax, dla, cy,
+       cll, clm, cln, cx, cz, ca0, caa, cn0, clm0, clmq, cla, clde, cyb, cydr, cllda, cllp, cma, cmde, cmq,
+       cnb, cndr, cnr, stmarg_yaw, stmarg_pitch, dlde, dydr, dllp, dllda, realp1, realp2, wnp, zetp,
+       rpreal, realy1, realy2, wny, zety, ryreal, gnavail, gyavail, gnmax, cn, ca, ca_on, cl, cnq, clp,
+       xcp);
 }
 
 void AeroDynamics::set_xcg_ref(double in) { xcg_ref = in; }
@@ -195,13 +228,13 @@ void AeroDynamics::calculate_aero(double int_step) {
         double qqax  = RAD * (qqx * cphip - rrx * sphip);
         double rrax  = RAD * (qqx * sphip + rrx * cphip);
 
-        cn = aerotable.look_up("CN_vs_mach_alpha", alppx, vmach, 1);
-        ca = aerotable.look_up("CA_off_vs_mach_alpha_alt", alppx, alt, vmach, 1);
-        ca_on = aerotable.look_up("CA_on_vs_mach_alpha_alt", alppx, alt, vmach, 1);
+        cn = aerotable.look_up(cn_table, alppx, vmach, 1);
+        ca = aerotable.look_up(ca_off_table, alppx, alt, vmach, 1);
+        ca_on = aerotable.look_up(ca_on_table, alppx, alt, vmach, 1);
         // cl = aerotable.look_up("CL_vs_mach_alpha", alppx, vmach);
-        xcp(0) = aerotable.look_up("Xcp_vs_mach_alpha", alppx, vmach, 1);
-        cmq = aerotable.look_up("CMq_vs_mach", vmach, 1);
-        cnq = aerotable.look_up("CNq_vs_mach", vmach, 1);
+        xcp(0) = aerotable.look_up(xcp_table, alppx, vmach, 1);
+        cmq = aerotable.look_up(cmq_table, vmach, 1);
+        cnq = aerotable.look_up(cnq_table, vmach, 1);
 
         if (thrust_state = Propulsion::NO_THRUST) {
             cx = -ca;
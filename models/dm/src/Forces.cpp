@@ -1,33 +1,9 @@
 #include "Force.hh"
+#include "checkpoint.hh"
 #include "sim_services/include/simtime.h"
 #include "aux.hh"
+#include <algorithm>
 #include <cmath>
-#define NRANSI
-#include "nrutil.h"
-#define MAXITS 20000000
-#define ALF 1.0e-4
-#define EPS 1.0e-7  // 1.0e-7
-#define TOLF 1.0e-8  // 1.0e-4
-#define TOLX 1.0e-9
-#define STPMX 100.0
-#define TOLMIN 1.0e-10  // 1.0e-6
-#define FREERETURN do { free_dvector(fvec, 1, n);\
-                        free_dvector(xold, 1, n);\
-                        free_dvector(w, 1, n);\
-                        free_dvector(t, 1, n);\
-                        free_dvector(s, 1, n);\
-                        free_dmatrix(r, 1, n, 1, n);\
-                        free_dmatrix(qt, 1, n, 1, n);\
-                        free_dvector(p, 1, n);\
-                        free_dvector(g, 1, n);\
-                        free_dvector(fvcold, 1, n);\
-                        free_dvector(d, 1, n);\
-                        free_dvector(c, 1, n);\
-                        return;\
-} while (0);
-
-double *fvec;
-int nn;
 
 Forces::Forces(Propulsion& prop, TVC& tvc)
     :   propulsion(&prop), tvc(&tvc),
@@ -260,6 +236,21 @@ Forces::Forces(const Forces& other)
     this->FAP = other.FAP;
     this->FAPB = other.FAPB;
     this->FMB = other.FMB;
+
+    /* configuration of the input file, a copy must solve the same system */
+    this->DOF = other.DOF;
+    this->Slosh_flag = other.Slosh_flag;
+    this->TWD_flag = other.TWD_flag;
+    this->Aero_flag = other.Aero_flag;
+    this->damping_ratio = other.damping_ratio;
+    this->jacobian_mode = other.jacobian_mode;
+    this->xp = other.xp;
+    this->e1_d = other.e1_d;
+    this->e2_d = other.e2_d;
+    this->e3_d = other.e3_d;
+    this->e4_d = other.e4_d;
+
+    this->solver = other.solver;
 }
 
 Forces& Forces::operator=(const Forces& other) {
@@ -273,10 +264,30 @@ Forces& Forces::operator=(const Forces& other) {
     this->FAPB = other.FAPB;
     this->FMB = other.FMB;
 
+    this->DOF = other.DOF;
+    this->Slosh_flag = other.Slosh_flag;
+    this->TWD_flag = other.TWD_flag;
+    this->Aero_flag = other.Aero_flag;
+    this->damping_ratio = other.damping_ratio;
+    this->jacobian_mode = other.jacobian_mode;
+    this->xp = other.xp;
+    this->e1_d = other.e1_d;
+    this->e2_d = other.e2_d;
+    this->e3_d = other.e3_d;
+    this->e4_d = other.e4_d;
+
+    this->solver = other.solver;
+
     return *this;
 }
 
 void Forces::default_data() {
+    solver.set_warm_start(true);
+    broydn_its = 0;
+    broydn_fcalls = 0;
+    broydn_wall_time = 0.0;
+    jacobian_mode = 0;
+    jacobian_error = 0.0;
 }
 
 
@@ -285,8 +296,33 @@ void Forces::initialize() {
     // Gravity_Q();
 }
 
+void Forces::checkpoint(Checkpoint &cp) {
+    cp.section("FORCES");
+    cp(FAPB, FAP, FMB, FMAB, Q_G, Q_Aero, rhoC_1, I1, ddrP_1, ddang_1, dang_1, ddrhoC_1, p_b1_ga, p_b1_be,
+       f, gamma_b1_q1, gamma_b1_q2, gamma_b1_q3, gamma_b1_q4, gamma_b1_q5, gamma_b1_q6, beta_b1_q1,
+       beta_b1_q2, beta_b1_q3, beta_b1_q4, beta_b1_q5, beta_b1_q6, beta_slosh_q4, beta_slosh_q5,
+       beta_slosh_q6, beta_slosh_q7, beta_slosh_q8, beta_S2_e1_q4, beta_S2_e1_q5, beta_S2_e1_q6,
+       beta_S2_e1_q_theta, beta_S2_e2_q4, beta_S2_e2_q5, beta_S2_e2_q6, beta_S2_e2_q_psi, beta_S2_e3_q4,
+       beta_S2_e3_q5, beta_S2_e3_q6, beta_S2_e3_q_theta, beta_S2_e4_q4, beta_S2_e4_q5, beta_S2_e4_q6,
+       beta_S2_e4_q_psi, ddrP_e1, ddrP_e2, ddrP_e3, ddrP_e4, ddrhoC_e1, ddrhoC_e2, ddrhoC_e3, ddrhoC_e4,
+       xp, slosh_mass, pendulum_L, ddang_slosh_theta, ddang_slosh_psi, Q_slosh1, Q_slosh2, ddang_e1_theta,
+       ddang_e2_psi, ddang_e3_theta, ddang_e4_psi, Q_e1, Q_e2, Q_e3, Q_e4, f_slosh, f_S2_TWD, ddang_slosh,
+       ddrP_slosh, ddrP_sloshB, ddrhoC_slosh, rhoC_slosh, r_slosh, Q_G_slosh, Q_G_S2_E, Q1, Q2, TBSLOSH_I,
+       dang_slosh1, dang_slosh2, omega_slosh1_B, omega_slosh2_slosh1, TSLOSHB1_B, TSLOSHB2_SLOSHB1,
+       SLOSH_CG, TE1_B, TE2_B, TE3_B, TE4_B, TE1_I, TE2_I, TE3_I, TE4_I, omega_e1_B, omega_e2_B,
+       omega_e3_B, omega_e4_B, domega_e1, domega_e2, domega_e3, domega_e4, e1_d, e2_d, e3_d, e4_d, dang_e1,
+       dang_e2, dang_e3, dang_e4, rhoC_e1, rhoC_e2, rhoC_e3, rhoC_e4, I_E1, I_E2, I_E3, I_E4, e1_XCG,
+       e2_XCG, e3_XCG, e4_XCG, broydn_its, broydn_fcalls, broydn_wall_time, jacobian_mode, jacobian_error,
+       DOF, Slosh_flag, TWD_flag, Aero_flag, h, Wn, C_c, C_1, damping_ratio, Q_E1, Q_E2, Q_E3, Q_E4,
+       Q_slosh_7, Q_slosh_8);
+    cp.section("BROYDN");
+    solver.checkpoint(cp);
+}
+
 void Forces::set_Slosh_flag(unsigned int flag) { Slosh_flag = flag; }
 void Forces::set_DOF(int ndof) { DOF = ndof ;}
+void Forces::set_broydn_warm_start(unsigned int flag) { solver.set_warm_start(flag == 1); }
+void Forces::set_jacobian_mode(unsigned int mode) { jacobian_mode = mode; }
 void Forces::set_damping_ratio(double damping) { damping_ratio = damping; }
 void Forces::set_aero_flag(unsigned int in) { Aero_flag = in; }
 void Forces::set_e1_d(double in1, double in2, double in3) {
@@ -310,10 +346,7 @@ void Forces::set_e4_d(double in1, double in2, double in3) {
     e4_d(2) = in3;
 }
 void Forces::collect_forces_and_propagate() {
-    double *ff, *x;
-    int check(0);
-    ff = new double[13];
-    x = new double[13];
+    double ff[BroydnSolver::MAX_N + 1], x[BroydnSolver::MAX_N + 1];
     /*****************input from another module*******************/
     rhoC_1 = grab_structure_XCG();
     dang_1 = grab_WBIB();
@@ -460,7 +493,12 @@ void Forces::collect_forces_and_propagate() {
         x[i + 1] = 0.0;
     }
 
-    broydn(x, DOF, &check);
+    if (jacobian_mode == 0) {
+        solver.solve(x, DOF, [this](int n, double *xv, double *fv) { funcv(n, xv, fv); });
+    } else {
+        solver.solve(x, DOF, [this](int n, double *xv, double *fv) { funcv(n, xv, fv); },
+                     [this](int n, double *xv, double *fv, double **df) { jacobian(n, xv, fv, df); });
+    }
 
     funcv(DOF, x, ff);
     for (int i = 0; i < 3; i++) {
@@ -491,8 +529,9 @@ void Forces::collect_forces_and_propagate() {
 
     ddrhoC_1 = cross(ddang_1, rhoC_1) + cross(dang_1, cross(dang_1, rhoC_1));  // Eq.(5-12)
 
-    delete [] ff;
-    delete [] x;
+    broydn_its = solver.get_iterations();
+    broydn_fcalls = solver.get_function_calls();
+    broydn_wall_time = solver.get_wall_time();
 }
 
 void Forces::gamma_beta() {
@@ -1007,6 +1046,115 @@ void Forces::funcv(int n, double *x, double *ff) {
     }
 }
 
+void Forces::jacobian(int n, double *x, double *fvec, double **df) {
+    analytic_jacobian(n, df);
+    if (jacobian_mode != 2)
+        return;
+
+    double fd_mem[BroydnSolver::MAX_N + 1][BroydnSolver::MAX_N + 1];
+    double *fd[BroydnSolver::MAX_N + 1];
+    double diff = 0.0, scale = 1.0;
+    for (int i = 0; i <= n; i++) fd[i] = fd_mem[i];
+
+    solver.fdjac(n, x, fvec, fd);
+    for (int i = 1; i <= n; i++) {
+        for (int j = 1; j <= n; j++) {
+            diff = std::max(diff, fabs(df[i][j] - fd[i][j]));
+            scale = std::max(scale, fabs(df[i][j]));
+        }
+    }
+    jacobian_error = diff / scale;
+}
+
+/* funcv() is affine in the generalized accelerations and Q_E, every term
+   below is the coefficient of x in the matching line of funcv(), slosh()
+   and S2_TWD(). */
+void Forces::analytic_jacobian(int n, double **df) {
+    arma::mat33 TBI = grab_TBI();
+    double m1 = grab_vmass();
+    arma::mat::fixed<12, 12> J;
+    arma::mat33 E, G, B, dp_ga, dp_be;
+    int i_slosh = 6;
+    int i_twd = (Slosh_flag == 1) ? 8 : 6;
+
+    J.zeros();
+    E.eye();
+    G.col(0) = gamma_b1_q1;
+    G.col(1) = gamma_b1_q2;
+    G.col(2) = gamma_b1_q3;
+    B.col(0) = beta_b1_q4;
+    B.col(1) = beta_b1_q5;
+    B.col(2) = beta_b1_q6;
+
+    if (Slosh_flag == 1) {
+        arma::mat33 A_rc = -trans(TBSLOSH_I) * cross_matrix(rhoC_slosh);
+        arma::mat33 L_be;
+        // d(p_slosh_ga)/dx, Eq.(5-64)
+        arma::mat::fixed<3, 12> dp;
+        dp.zeros();
+        dp.cols(0, 2) = slosh_mass * E;
+        dp.cols(3, 5) = slosh_mass * (-trans(TBI) * cross_matrix(r_slosh) + A_rc * TSLOSHB2_SLOSHB1 * TSLOSHB1_B);
+        dp.col(i_slosh) = slosh_mass * A_rc * TSLOSHB2_SLOSHB1.col(1);
+        dp.col(i_slosh + 1) = slosh_mass * A_rc.col(2);
+
+        L_be.col(0) = -trans(TBI) * cross_matrix(r_slosh) * beta_b1_q4 + A_rc * beta_slosh_q4;
+        L_be.col(1) = -trans(TBI) * cross_matrix(r_slosh) * beta_b1_q5 + A_rc * beta_slosh_q5;
+        L_be.col(2) = -trans(TBI) * cross_matrix(r_slosh) * beta_b1_q6 + A_rc * beta_slosh_q6;
+
+        J.rows(0, 2) += trans(G) * dp;
+        J.rows(3, 5) += trans(L_be) * dp;
+        J.row(i_slosh) += trans(A_rc * beta_slosh_q7) * dp;
+        J.row(i_slosh + 1) += trans(A_rc * beta_slosh_q8) * dp;
+        m1 = m1 - slosh_mass;
+    }
+
+    if (TWD_flag == 1) {
+        double e_mass[4] = {grab_e1_mass(), grab_e2_mass(), grab_e3_mass(), grab_e4_mass()};
+        const arma::vec *e_d[4] = {&e1_d, &e2_d, &e3_d, &e4_d};
+        const arma::vec *rhoC_e[4] = {&rhoC_e1, &rhoC_e2, &rhoC_e3, &rhoC_e4};
+        const arma::mat *TE_B[4] = {&TE1_B, &TE2_B, &TE3_B, &TE4_B};
+        const arma::mat *TE_I[4] = {&TE1_I, &TE2_I, &TE3_I, &TE4_I};
+        const arma::mat *I_E[4] = {&I_E1, &I_E2, &I_E3, &I_E4};
+        const arma::vec *beta_e[4][4] = {
+            {&beta_S2_e1_q4, &beta_S2_e1_q5, &beta_S2_e1_q6, &beta_S2_e1_q_theta},
+            {&beta_S2_e2_q4, &beta_S2_e2_q5, &beta_S2_e2_q6, &beta_S2_e2_q_psi},
+            {&beta_S2_e3_q4, &beta_S2_e3_q5, &beta_S2_e3_q6, &beta_S2_e3_q_theta},
+            {&beta_S2_e4_q4, &beta_S2_e4_q5, &beta_S2_e4_q6, &beta_S2_e4_q_psi}};
+
+        for (int k = 0; k < 4; k++) {
+            arma::mat33 A_d = -trans(TBI) * cross_matrix(*e_d[k]);
+            arma::mat33 C_rc = cross_matrix(*rhoC_e[k]);
+            arma::mat33 B_e;
+            B_e.col(0) = *beta_e[k][0];
+            B_e.col(1) = *beta_e[k][1];
+            B_e.col(2) = *beta_e[k][2];
+            // d(ddrP_e)/dx = [E, A_d], d(domega_e)/d(ddang_1) = TE_B
+            dp_ga = e_mass[k] * (A_d - trans(*TE_I[k]) * C_rc * *TE_B[k]);
+            dp_be = *I_E[k] * *TE_B[k] + e_mass[k] * C_rc * *TE_I[k] * A_d;
+
+            J.submat(0, 0, 2, 2) += e_mass[k] * trans(G);
+            J.submat(0, 3, 2, 5) += trans(G) * dp_ga;
+            J.submat(3, 0, 5, 2) += trans(A_d * B) * (e_mass[k] * E)
+                                    + trans(B_e) * (e_mass[k] * C_rc * *TE_I[k]);
+            J.submat(3, 3, 5, 5) += trans(A_d * B) * dp_ga + trans(B_e) * dp_be;
+            J.submat(i_twd + k, 0, i_twd + k, 2) += trans(*beta_e[k][3]) * (e_mass[k] * C_rc * *TE_I[k]);
+            J.submat(i_twd + k, 3, i_twd + k, 5) += trans(*beta_e[k][3]) * dp_be;
+            J(i_twd + k, i_twd + k) = -1.0;
+            m1 = m1 - e_mass[k];
+        }
+    }
+
+    // Eq.(5-19)
+    J.submat(0, 0, 2, 2) += m1 * trans(G);
+    J.submat(0, 3, 2, 5) += -m1 * trans(G) * trans(TBI) * cross_matrix(rhoC_1);
+    J.submat(3, 0, 5, 2) += m1 * trans(B) * cross_matrix(rhoC_1) * TBI;
+    J.submat(3, 3, 5, 5) += trans(B) * I1;
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) df[i + 1][j + 1] = J(i, j);
+    }
+}
+
 void Forces::slosh() {
     arma::vec3 p_slosh_ga, p_slosh_be, domega_slosh1_B, domega_slosh2_slosh1;
     arma::mat33 TBI = grab_TBI();
@@ -1125,329 +1273,6 @@ void Forces::S2_TWD() {
     f_S2_TWD(9) = dot(p_e4_be, beta_S2_e4_q_psi) - Q_E4;
 }
 
-void Forces::broydn(double x[], int n, int *check) {
-    int i, j, k, restrt, sing, skip;
-    double den, fff, fold, stpmax, sum, temp, test, *c, *d, *fvcold;
-    double *g, *p, **qt, **r, *s, *t, *w, *xold;
-    c = dvector(1, n);
-    d = dvector(1, n);
-    fvcold = dvector(1, n);
-    g = dvector(1, n);
-    p = dvector(1, n);
-    qt = dmatrix(1, n, 1, n);
-    r = dmatrix(1, n, 1, n);
-    s = dvector(1, n);
-    t = dvector(1, n);
-    w = dvector(1, n);
-    xold = dvector(1, n);
-    fvec = dvector(1, n);
-    nn = n;
-    fff = f_min(x);
-    test = 0.0;
-    for (i = 1; i <= n; i++)
-        if (fabs(fvec[i]) > test)test = fabs(fvec[i]);
-    if (test < 0.01 * TOLF) {
-        *check = 0;
-        FREERETURN
-    }
-    for (sum = 0.0, i = 1; i <= n; i++) sum += DSQR(x[i]);
-    stpmax = STPMX * DMAX(sqrt(sum), (double)n);
-    restrt = 1;
-    for (its = 1; its <= MAXITS; its++) {
-        if (restrt) {
-            fdjac(n, x, fvec, r);
-            qrdcmp(r, n, c, d, &sing);
-            if (sing) nrerror("singular Jacobian in broydn : qrdcmp");
-            for (i = 1; i <= n; i++) {
-                for (j = 1; j <= n; j++) qt[i][j] = 0.0;
-                qt[i][i] = 1.0;
-            }
-            for (k = 1; k < n; k++) {
-                if (c[k]) {
-                    for (j = 1; j <= n; j++) {
-                        sum = 0.0;
-                        for (i = k; i <= n; i++)
-                            sum += r[i][k] * qt[i][j];
-                        sum /= c[k];
-                        for (i = k; i <= n; i++)
-                            qt[i][j] -= sum * r[i][k];
-                    }
-                }
-            }
-            for (i = 1; i <= n; i++) {
-                r[i][i] = d[i];
-                for (j = 1; j < i; j++) r[i][j] = 0.0;
-            }
-        } else {
-            for (i = 1; i <= n; i++) s[i] = x[i] - xold[i];
-            for (i = 1; i <= n; i++) {
-                for (sum = 0.0, j = i; j <= n; j++) sum += r[i][j] * s[j];
-                t[i] = sum;
-            }
-            skip = 1;
-            for (i = 1; i <= n; i++) {
-                for (sum = 0.0, j = 1; j <= n; j++) sum += qt[j][i] * t[j];
-                w[i] = fvec[i] - fvcold[i] - sum;
-                if (fabs(w[i]) >= EPS * (fabs(fvec[i]) + fabs(fvcold[i]))) {
-                    skip = 0;
-                } else {
-                    w[i] = 0.0;
-                }
-            }
-            if (!skip) {
-                for (i = 1; i <= n; i++) {
-                    for (sum = 0.0, j = 1; j <= n; j++) sum += qt[i][j] * w[j];
-                    t[i] = sum;
-                }
-                for (den = 0.0, i = 1; i <= n; i++) den += DSQR(s[i]);
-                for (i = 1; i <= n; i++) s[i] /= den;
-                qrupdt(r, qt, n, t, s);
-                for (i = 1; i <= n; i++) {
-                    if (r[i][i] == 0.0) nrerror("r singular in broydn : qrupdt");
-                    d[i] = r[i][i];
-                }
-            }
-        }
-        for (i = 1; i <= n; i++) {
-            for (sum = 0.0, j = 1; j <= n; j++) sum += qt[i][j] * fvec[j];
-            p[i] = -sum;
-        }
-        for (i = n; i >= 1; i--) {
-            for (sum = 0.0, j = 1; j <= i; j++) sum -= r[j][i] * p[j];
-            g[i] = sum;
-        }
-        for (i = 1; i <= n; i++) {
-            xold[i] = x[i];
-            fvcold[i] = fvec[i];
-        }
-        fold = fff;
-        rsolv(r, n, d, p);
-        lnsrch(n, xold, fold, g, p, x, &fff, stpmax, check);
-        test = 0.0;
-        for (i = 1; i <= n; i++)
-            if (fabs(fvec[i]) > test) test = fabs(fvec[i]);
-        if (test < TOLF) {
-            *check = 0;
-            FREERETURN
-        }
-        if (*check) {
-            if (restrt) {
-                FREERETURN
-            } else {
-                    test = 0.0;
-                    den = DMAX(fff, 0.5 * n);
-                    for (i = 1; i <= n; i++) {
-                        temp = fabs(g[i]) * DMAX(fabs(x[i]), 1.0) / den;
-                        if (temp > test) {
-                            test = temp;
-                        }
-                    }
-                    if (test < TOLMIN) {
-                        FREERETURN
-                    } else {
-                        restrt = 1;
-                    }
-                }
-        } else {
-            restrt = 0;
-            test = 0.0;
-            for (i = 1; i <= n; i++) {
-                temp = (fabs(x[i] - xold[i])) / DMAX(fabs(x[i]), 1.0);
-                if (temp > test) test = temp;
-            }
-            if (test < EPS) FREERETURN
-            }
-    }
-    nrerror("MAXITS exceeded in broydn");
-    FREERETURN
-}
-
-void Forces::rsolv(double **a, int n, double d[], double b[]) {
-    int i, j;
-    double sum;
-
-    b[n] /= d[n];
-    for (i = n - 1; i >= 1; i--) {
-        for (sum = 0.0, j = i + 1; j <= n; j++) sum += a[i][j] * b[j];
-        b[i] = (b[i] - sum) / d[i];
-    }
-}
-
-void Forces::fdjac(int n, double x[], double fvec[], double **df) {
-    int i, j;
-    double h, temp, *ff;
-
-    ff = dvector(1, n);
-    for (j = 1; j <= n; j++) {
-        temp = x[j];
-        h = EPS * fabs(temp);
-        if (h == 0.0) h = EPS;
-        x[j] = temp + h;
-        h = x[j] - temp;
-        funcv(n, x, ff);
-        x[j] = temp;
-        for (i = 1; i <= n; i++) {
-            df[i][j] = (ff[i] - fvec[i]) / h;
-        }
-    }
-    free_dvector(ff, 1, n);
-}
-
-double Forces::f_min(double x[]) {
-    int i;
-    double sum;
-
-    funcv(nn, x, fvec);
-    for (sum = 0.0, i = 1; i <= nn; i++) sum += DSQR(fvec[i]);
-    return 0.5 * sum;
-}
-
-void Forces::lnsrch(int n, double xold[], double fold, double g[], double p[], double x[],
-                    double *f, double stpmax, int *check) {
-    int i;
-    double a, alam, alam2, alamin, b, disc, f2, rhs1, rhs2, slope, sum, temp,
-           test, tmplam;
-
-    *check = 0;
-    for (sum = 0.0, i = 1; i <= n; i++) sum += p[i] * p[i];
-    sum = sqrt(sum);
-    if (sum > stpmax) {
-        for (i = 1; i <= n; i++) p[i] *= stpmax / sum;
-    }
-    for (slope = 0.0, i = 1; i <= n; i++)
-        slope += g[i] * p[i];
-    if (slope >= 0.0) {
-        nrerror("Roundoff problem in lnsrch.");
-    }
-    test = 0.0;
-    for (i = 1; i <= n; i++) {
-        temp = fabs(p[i]) / DMAX(fabs(xold[i]), 1.0);
-        if (temp > test) {
-            test = temp;
-        }
-    }
-    alamin = TOLX / test;
-    alam = 1.0;
-    for (;;) {
-        for (i = 1; i <= n; i++) x[i] = xold[i] + alam * p[i];
-        *f = f_min(x);
-        if (alam < alamin) {
-            for (i = 1; i <= n; i++) x[i] = xold[i];
-            *check = 1;
-            return;
-        } else if (*f <= fold + ALF * alam * slope) {
-            return;
-        } else {
-            if (alam == 1.0) {
-                tmplam = -slope / (2.0 * (*f - fold - slope));
-            } else {
-                rhs1 = *f - fold - alam * slope;
-                rhs2 = f2 - fold - alam2 * slope;
-                a = (rhs1 / (alam * alam) - rhs2 / (alam2 * alam2)) / (alam - alam2);
-                b = (-alam2 * rhs1 / (alam * alam) + alam * rhs2 / (alam2 * alam2)) / (alam - alam2);
-                if (a == 0.0) {
-                    tmplam = -slope / (2.0 * b);
-                } else {
-                    disc = b * b - 3.0 * a * slope;
-                    if (disc < 0.0) {
-                        tmplam = 0.5 * alam;
-                    } else if (b <= 0.0) {
-                        tmplam = (-b + sqrt(disc)) / (3.0 * a);
-                    } else {
-                    tmplam = -slope / (b + sqrt(disc));
-                    }
-                }
-                if (tmplam > 0.5 * alam) {
-                    tmplam = 0.5 * alam;
-                }
-            }
-        }
-        alam2 = alam;
-        f2 = *f;
-        alam = DMAX(tmplam, 0.1 * alam);
-    }
-}
-
-void Forces::qrdcmp(double **a, int n, double *c, double *d, int *sing) {
-    int i, j, k;
-    double scale, sigma, sum, tau;
-
-    *sing = 0;
-    for (k = 1; k < n; k++) {
-        scale = 0.0;
-        for (i = k; i <= n; i++) scale = DMAX(scale, fabs(a[i][k]));
-        if (scale == 0.0) {
-            *sing = 1;
-            c[k] = d[k] = 0.0;
-        } else {
-            for (i = k; i <= n; i++) a[i][k] /= scale;
-            for (sum = 0.0, i = k; i <= n; i++) sum += DSQR(a[i][k]);
-            sigma = SIGN(sqrt(sum), a[k][k]);
-            a[k][k] += sigma;
-            c[k] = sigma * a[k][k];
-            d[k] = -scale * sigma;
-            for (j = k + 1; j <= n; j++) {
-                for (sum = 0.0, i = k; i <= n; i++) sum += a[i][k] * a[i][j];
-                tau = sum / c[k];
-                for (i = k; i <= n; i++) a[i][j] -= tau * a[i][k];
-            }
-        }
-    }
-    d[n] = a[n][n];
-    if (d[n] == 0.0) *sing = 1;
-}
-
-void Forces::qrupdt(double **r, double **qt, int n, double u[], double v[]) {
-    int i, j, k;
-
-    for (k = n; k >= 1; k--) {
-        if (u[k]) break;
-    }
-    if (k < 1) k = 1;
-    for (i = k - 1; i >= 1; i--) {
-        rotate(r, qt, n, i, u[i], -u[i + 1]);
-        if (u[i] == 0.0) {
-            u[i] = fabs(u[i + 1]);
-        } else if (fabs(u[i]) > fabs(u[i + 1])) {
-            u[i] = fabs(u[i]) * sqrt(1.0 + DSQR(u[i + 1] / u[i]));
-        } else {
-            u[i] = fabs(u[i + 1]) * sqrt(1.0 + DSQR(u[i] / u[i + 1]));
-        }
-    }
-    for (j = 1; j <= n; j++) r[1][j] += u[1] * v[j];
-    for (i = 1; i < k; i++)
-        rotate(r, qt, n, i, r[i][i], -r[i + 1][i]);
-}
-
-void Forces::rotate(double **r, double **qt, int n, int i, double a, double b) {
-    int j;
-    double c, fact, s, w, y;
-
-    if (a == 0.0) {
-        c = 0.0;
-        s = (b >= 0.0 ? 1.0 : -1.0);
-    } else if (fabs(a) > fabs(b)) {
-        fact = b / a;
-        c = SIGN(1.0 / sqrt(1.0 + (fact * fact)), a);
-        s = fact * c;
-    } else {
-        fact = a / b;
-        s = SIGN(1.0 / sqrt(1.0 + (fact * fact)), b);
-        c = fact * s;
-    }
-    for (j = i; j <= n; j++) {
-        y = r[i][j];
-        w = r[i + 1][j];
-        r[i][j] = c * y - s * w;
-        r[i + 1][j] = s * y + c * w;
-    }
-    for (j = 1; j <= n; j++) {
-        y = qt[i][j];
-        w = qt[i + 1][j];
-        qt[i][j] = c * y - s * w;
-        qt[i + 1][j] = s * y + c * w;
-    }
-}
 arma::vec Forces::get_e1_XCG() { return e1_XCG; }
 arma::vec Forces::get_e2_XCG() { return e2_XCG; }
 arma::vec Forces::get_e3_XCG() { return e3_XCG; }
@@ -1463,6 +1288,10 @@ arma::vec Forces::get_SLOSH_CG() { return SLOSH_CG; }
 double Forces::get_slosh_mass() { return slosh_mass; }
 double Forces::get_ddang_slosh_theta() { return ddang_slosh_theta; }
 double Forces::get_ddang_slosh_psi() { return ddang_slosh_psi; }
+int Forces::get_broydn_its() { return broydn_its; }
+int Forces::get_broydn_fcalls() { return broydn_fcalls; }
+double Forces::get_broydn_wall_time() { return broydn_wall_time; }
+double Forces::get_jacobian_error() { return jacobian_error; }
 void Forces::set_reference_point(double refp) { xp = refp; }
 void Forces::set_TWD_flag(unsigned int flag) { TWD_flag = flag; }
 
@@ -1513,12 +1342,3 @@ arma::mat33 Forces::TMZ(double ang) {
 
     return TM;
 }
-
-#undef MAXITS
-#undef EPS
-#undef TOLF
-#undef TOLMIN
-#undef TOLX
-#undef STPMX
-#undef FREERETURN
-#undef NRANSI
@@ -1,4 +1,5 @@
 #include "GPS_constellation.hh"
+#include "checkpoint.hh"
 
 GPS_constellation::GPS_constellation()
 :   time(time_management::get_instance()) {
@@ -32,6 +33,14 @@ void GPS_constellation::readfile(const char *fname) {
     }
 }
 
+void GPS_constellation::load_ephemeris(const GPS_constellation &other) {
+    neph = other.neph;
+    ionoutc = other.ionoutc;
+    for (int i = 0; i < neph; i++)
+        for (int sv = 0; sv < MAX_SAT; sv++)
+            eph[i][sv] = other.eph[i][sv];
+}
+
 void GPS_constellation::initialize() {
     ieph = -1;
     int sv(0);
@@ -593,6 +602,19 @@ int GPS_constellation::checkSatVisibility(ephem_t eph, time_util::GPS_TIME g, ar
  *  \param[in] g GPS time at time of receiving the signal
  *  \param[in] xyz position of the receiver
  */
+/* The C/A code and navigation message buffers of a channel are not generated, see allocateChannel() */
+void GPS_constellation::checkpoint(Checkpoint &cp) {
+    cp.section("GPSCON");
+    cp(ieph, nsat, allocatedSat, gdop, gps_update, trans_chan);
+    for (int i = 0; i < MAX_CHAN; i++) {
+        channel_t &c = chan[i];
+        cp(c.prn, c.f_carr, c.f_code, c.carr_phase, c.carr_phasestep, c.code_phase, c.g0);
+        cp(c.iword, c.ibit, c.icode, c.dataBit, c.codeCA, c.azel);
+        cp(c.rho0.g, c.rho0.range, c.rho0.rate, c.rho0.d, c.rho0.azel, c.rho0.iono_delay,
+           c.rho0.pos, c.rho0.vel, c.rho0.clk);
+    }
+}
+
 void GPS_constellation::computeRange(range_t *rho, ephem_t eph, ionoutc_t *ionoutc, time_util::GPS_TIME g, arma::vec3 xyz) {
     arma::vec3 pos;
     arma::vec3 vel;
@@ -1,6 +1,7 @@
 #include "integrate.hh"
 
 #include "Propulsion.hh"
+#include "checkpoint.hh"
 #include "sim_services/include/simtime.h"
 
 Propulsion::Propulsion()
@@ -209,6 +210,25 @@ void Propulsion::set_S3_spi(double in) { S3_spi = in; }
 void Propulsion::set_S3_remaining_fuel_mass(double in) { S3_remaining_fuel_mass = in; }
 void Propulsion::set_faring_mass(double in) { faring_mass = in; }
 
+void Propulsion::checkpoint(Checkpoint &cp) {
+    cp.section("PROP");
+    cp(xcg_0, xcg_1, moi_roll_0, moi_roll_1, moi_pitch_0, moi_pitch_1, moi_yaw_0, moi_yaw_1,
+       fuel_flow_rate, spi, aexit, payload, vmass0, fmass0, thrust_state, stage, fmasse, fmassed,
+       thrust_delta_v, fmassr, thrust, vmass, IBBB, mass_ratio, fuel_mass, oxidizer_mass, xcg, CG_OFFSET,
+       TWD, S2_E1_mass, S2_E1_mass_0, S2_E1_mass_1, S2_E1_fuel_mass, S2_E1_roll_0, S2_E1_roll_1,
+       S2_E1_pitch_0, S2_E1_pitch_1, S2_E1_yaw_0, S2_E1_yaw_1, I_S2_E1, I_S2_E1_0, I_S2_E1_1, S2_E1_xcg_0,
+       S2_E1_xcg_1, S2_E1_xcg, S2_E2_mass, S2_E2_mass_0, S2_E2_mass_1, S2_E2_fuel_mass, S2_E2_roll_0,
+       S2_E2_roll_1, S2_E2_pitch_0, S2_E2_pitch_1, S2_E2_yaw_0, S2_E2_yaw_1, I_S2_E2, I_S2_E2_0, I_S2_E2_1,
+       S2_E2_xcg_0, S2_E2_xcg_1, S2_E2_xcg, S2_E3_mass, S2_E3_mass_0, S2_E3_mass_1, S2_E3_fuel_mass,
+       S2_E3_roll_0, S2_E3_roll_1, S2_E3_pitch_0, S2_E3_pitch_1, S2_E3_yaw_0, S2_E3_yaw_1, I_S2_E3,
+       I_S2_E3_0, I_S2_E3_1, S2_E3_xcg_0, S2_E3_xcg_1, S2_E3_xcg, S2_E4_mass, S2_E4_mass_0, S2_E4_mass_1,
+       S2_E4_fuel_mass, S2_E4_roll_0, S2_E4_roll_1, S2_E4_pitch_0, S2_E4_pitch_1, S2_E4_yaw_0, S2_E4_yaw_1,
+       I_S2_E4, I_S2_E4_0, I_S2_E4_1, S2_E4_xcg_0, S2_E4_xcg_1, S2_E4_xcg, structure_XCG, S2_spi,
+       S2_structure_mass, S2_propellant_mass, S2_remaining_fuel_mass, S2_fmasse, S3_spi, S3_structure_mass,
+       S3_propellant_mass, S3_remaining_fuel_mass, S3_fmasse, faring_mass, ignition_time, S2_timer,
+       S3_timer);
+}
+
 void Propulsion::propagate(double int_step) {
     double psl(101300);  // chamber pressure - Pa
     arma::mat33 IBBB0;
@@ -251,8 +271,8 @@ void Propulsion::propagate(double int_step) {
         case INPUT_THRUST:
             switch (this->stage) {
                 case STAGE_2:
-                    thrust = proptable.look_up("S2_time_vs_thrust", S2_timer, 0) * AGRAV + (- press) * this->aexit;
-                    fuel_flow_rate = proptable.look_up("S2_time_vs_thrust", S2_timer, 0) / S2_spi;
+                    thrust = proptable.look_up(S2_thrust_table, S2_timer, 0) * AGRAV + (- press) * this->aexit;
+                    fuel_flow_rate = proptable.look_up(S2_thrust_table, S2_timer, 0) / S2_spi;
                     // S2_fmasse += fuel_flow_rate * int_step;
                     fuel_expend_integrator(int_step, 2);
                     mass_ratio = S2_fmasse / fmass0;
@@ -269,8 +289,8 @@ void Propulsion::propagate(double int_step) {
                 break;
 
                 case FARING_SEP:
-                    thrust = proptable.look_up("S3_time_vs_thrust", S3_timer, 0) * AGRAV + (- press) * this->aexit;
-                    fuel_flow_rate = proptable.look_up("S3_time_vs_thrust", S3_timer, 0) / S3_spi;
+                    thrust = proptable.look_up(S3_thrust_table, S3_timer, 0) * AGRAV + (- press) * this->aexit;
+                    fuel_flow_rate = proptable.look_up(S3_thrust_table, S3_timer, 0) / S3_spi;
                     // S3_fmasse += fuel_flow_rate * int_step;
                     fuel_expend_integrator(int_step, 3);
                     mass_ratio = S3_fmasse / fmass0;
@@ -286,8 +306,8 @@ void Propulsion::propagate(double int_step) {
                 break;
 
                 case STAGE_3:
-                    thrust = proptable.look_up("S3_time_vs_thrust", S3_timer, 0) * AGRAV + (- press) * this->aexit;
-                    fuel_flow_rate = proptable.look_up("S3_time_vs_thrust", S3_timer, 0) / S3_spi;
+                    thrust = proptable.look_up(S3_thrust_table, S3_timer, 0) * AGRAV + (- press) * this->aexit;
+                    fuel_flow_rate = proptable.look_up(S3_thrust_table, S3_timer, 0) / S3_spi;
                     // S3_fmasse += fuel_flow_rate * int_step;
                     fuel_expend_integrator(int_step, 3);
                     mass_ratio = S3_fmasse / fmass0;
@@ -308,9 +328,9 @@ void Propulsion::propagate(double int_step) {
         case HOT_STAGE :
                 vmass = payload + faring_mass + S2_structure_mass + S2_propellant_mass + S2_remaining_fuel_mass
                             + S3_structure_mass + S3_propellant_mass + S3_remaining_fuel_mass;
-                thrust = proptable.look_up("S2_time_vs_thrust", S2_timer, 0) * AGRAV + (- press) * this->aexit;
-                fuel_flow_rate = proptable.look_up("S2_time_vs_thrust", S2_timer, 0) / S2_spi;
-                double fuel_flow_rate_hs = proptable.look_up("S3_time_vs_thrust", S3_timer, 0) / S3_spi;
+                thrust = proptable.look_up(S2_thrust_table, S2_timer, 0) * AGRAV + (- press) * this->aexit;
+                fuel_flow_rate = proptable.look_up(S2_thrust_table, S2_timer, 0) / S2_spi;
+                double fuel_flow_rate_hs = proptable.look_up(S3_thrust_table, S3_timer, 0) / S3_spi;
                 if (mass_ratio <= 1.0) {
                     fuel_expend_integrator(int_step, 2);
                 } else {
@@ -343,19 +363,19 @@ void Propulsion::fuel_expend_integrator(double int_step, unsigned int flag) {
     double K1, K2, K3, K4;
     switch (flag) {
         case 2 :
-            K1 = proptable.look_up("S2_time_vs_thrust", S2_timer, 0) / S2_spi;
-            K2 = proptable.look_up("S2_time_vs_thrust", S2_timer + 0.5 * int_step, 0) / S2_spi;
-            K3 = proptable.look_up("S2_time_vs_thrust", S2_timer + 0.5 * int_step, 0) / S2_spi;
-            K4 = proptable.look_up("S2_time_vs_thrust", S2_timer + int_step, 0) / S2_spi;
+            K1 = proptable.look_up(S2_thrust_table, S2_timer, 0) / S2_spi;
+            K2 = proptable.look_up(S2_thrust_table, S2_timer + 0.5 * int_step, 0) / S2_spi;
+            K3 = proptable.look_up(S2_thrust_table, S2_timer + 0.5 * int_step, 0) / S2_spi;
+            K4 = proptable.look_up(S2_thrust_table, S2_timer + int_step, 0) / S2_spi;
 
             S2_fmasse = S2_fmasse + (int_step / 6.0) * (K1 + 2.0 * K2 + 2.0 * K3 + K4);
         break;
 
         case 3 :
-            K1 = proptable.look_up("S3_time_vs_thrust", S3_timer, 0) / S3_spi;
-            K2 = proptable.look_up("S3_time_vs_thrust", S3_timer + 0.5 * int_step, 0) / S3_spi;
-            K3 = proptable.look_up("S3_time_vs_thrust", S3_timer + 0.5 * int_step, 0) / S3_spi;
-            K4 = proptable.look_up("S3_time_vs_thrust", S3_timer + int_step, 0) / S3_spi;
+            K1 = proptable.look_up(S3_thrust_table, S3_timer, 0) / S3_spi;
+            K2 = proptable.look_up(S3_thrust_table, S3_timer + 0.5 * int_step, 0) / S3_spi;
+            K3 = proptable.look_up(S3_thrust_table, S3_timer + 0.5 * int_step, 0) / S3_spi;
+            K4 = proptable.look_up(S3_thrust_table, S3_timer + int_step, 0) / S3_spi;
 
             S3_fmasse = S3_fmasse + (int_step / 6.0) * (K1 + 2.0 * K2 + 2.0 * K3 + K4);
         break;
@@ -375,7 +395,7 @@ void Propulsion::propagate_fmasse(double int_step) {
 double Propulsion::calculate_thrust(double press) {
     // return this->spi * this->fuel_flow_rate * AGRAV + (- press) * this->aexit;
     // return this->spi * this->fuel_flow_rate * 9.8 + (psl - press) * this->aexit;
-    return proptable.look_up("time_vs_thrust", get_rettime(), 0) * AGRAV + (- press) * this->aexit;
+    return proptable.look_up(thrust_table, get_rettime(), 0) * AGRAV + (- press) * this->aexit;
 }
 
 double Propulsion::calculate_fmassr() {
@@ -439,6 +459,11 @@ void Propulsion::calcuate_engine_variable() {
 
 void Propulsion::load_proptable(const char* filename) {
     proptable = Datadeck(filename);
+
+    // which thrust tables exist depends on the deck, look_up() rejects a missing one
+    S2_thrust_table = proptable.get_handle("S2_time_vs_thrust");
+    S3_thrust_table = proptable.get_handle("S3_time_vs_thrust");
+    thrust_table = proptable.get_handle("time_vs_thrust");
 }
 
 double Propulsion::get_S2_E1_xcg() { return S2_E1_xcg; }
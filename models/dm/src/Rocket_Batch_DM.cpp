@@ -0,0 +1,188 @@
+#include "Rocket_Batch_DM.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "global_constants.hh"
+#include "cad_utility.hh"
+#include "env/atmosphere76.hh"
+
+Rocket_Batch_DM::Rocket_Batch_DM(int n)
+    : n(n), stride((n + WIDTH - 1) / WIDTH * WIDTH), buf(NULL),
+      grav_n_max(GRAVITY_N_JGM3), grav_m_max(GRAVITY_N_JGM3), grav_use_coef(0) {
+    void *p;
+
+    if (stride == 0)
+        stride = WIDTH;
+    if (posix_memalign(&p, 64, sizeof(double) * N_FIELD * stride) != 0) {
+        fprintf(stderr, "[%s:%d] Cannot allocate a batch of %d trajectories\n", __FUNCTION__, __LINE__, n);
+        abort();
+    }
+    buf = static_cast<double *>(p);
+    memset(buf, 0, sizeof(double) * N_FIELD * stride);
+    gravity_harmonic_coef_init(&grav_coef);
+
+    /* any finite vehicle, so that the padding lanes stay finite */
+    for (int i = 0; i < stride; i++) {
+        field(SBIIP)[i] = SMAJOR_AXIS;
+        field(TBI_Q)[i] = 1.0;
+        field(VMASS)[i] = 1.0;
+        for (int k = 0; k < 3; k++)
+            field(IBBB + k)[i] = 1.0;
+    }
+}
+
+Rocket_Batch_DM::~Rocket_Batch_DM() {
+    free(buf);
+}
+
+void Rocket_Batch_DM::load_state(int i, const double SBII[3], const double VBII[3], const double WBIB[3],
+                                 const double TBI_Q[4]) {
+    for (int k = 0; k < 3; k++) {
+        field(SBIIP + k)[i] = SBII[k];
+        field(VBIIP + k)[i] = VBII[k];
+        field(Rocket_Batch_DM::VBII + k)[i] = VBII[k];
+        field(Rocket_Batch_DM::WBIB + k)[i] = WBIB[k];
+    }
+    for (int k = 0; k < 4; k++)
+        field(Rocket_Batch_DM::TBI_Q + k)[i] = TBI_Q[k];
+}
+
+void Rocket_Batch_DM::save_state(int i, double SBII[3], double VBII[3], double WBIB[3], double TBI_Q[4]) const {
+    for (int k = 0; k < 3; k++) {
+        SBII[k] = field(SBIIP + k)[i];
+        VBII[k] = field(VBIIP + k)[i];
+        WBIB[k] = field(Rocket_Batch_DM::WBIB + k)[i];
+    }
+    for (int k = 0; k < 4; k++)
+        TBI_Q[k] = field(Rocket_Batch_DM::TBI_Q + k)[i];
+}
+
+void Rocket_Batch_DM::load_mass_properties(int i, double vmass, const double IBBB[3]) {
+    field(VMASS)[i] = vmass;
+    for (int k = 0; k < 3; k++)
+        field(Rocket_Batch_DM::IBBB + k)[i] = IBBB[k];
+}
+
+void Rocket_Batch_DM::load_loads(int i, const double FAPB[3], double ca_refa, const double FMB[3]) {
+    for (int k = 0; k < 3; k++) {
+        field(Rocket_Batch_DM::FAPB + k)[i] = FAPB[k];
+        field(Rocket_Batch_DM::FMB + k)[i] = FMB[k];
+    }
+    field(CA_REFA)[i] = ca_refa;
+}
+
+void Rocket_Batch_DM::set_gravity_harmonic(int n_max, int m_max, int use_coef_table) {
+    grav_n_max = n_max;
+    grav_m_max = m_max;
+    grav_use_coef = use_coef_table;
+}
+
+void Rocket_Batch_DM::environment(const double TEI[3][3]) {
+    double r_lane[3][WIDTH], tempk_lane[WIDTH];
+
+    for (int j = 0; j < stride; j += WIDTH) {
+        simd_double S[3], VB[3], r_bf[3], a_bf[3];
+        simd_double V[GRAVITY_N_JGM3+2][GRAVITY_N_JGM3+2], W[GRAVITY_N_JGM3+2][GRAVITY_N_JGM3+2];
+
+        for (int k = 0; k < 3; k++) {
+            S[k] = simd_double::load(field(SBIIP + k) + j);
+            VB[k] = simd_double::load(field(VBII + k) + j);
+        }
+
+        /* Environment::AccelHarmonic() */
+        for (int k = 0; k < 3; k++)
+            r_bf[k] = TEI[k][0] * S[0] + TEI[k][1] * S[1] + TEI[k][2] * S[2];
+        gravity_harmonic_recursion(r_bf, GRAVITY_CS_JGM3, grav_n_max, grav_m_max, GM, SMAJOR_AXIS,
+                                   grav_use_coef ? &grav_coef : NULL, V, W, a_bf);
+        for (int k = 0; k < 3; k++) {
+            simd_double g = TEI[0][k] * a_bf[0] + TEI[1][k] * a_bf[1] + TEI[2][k] * a_bf[2];
+            g.store(field(GRAVG + k) + j);
+            r_bf[k].store(r_lane[k]);
+        }
+
+        /* altitude and table look-up are branchy and transcendental, one lane at a time */
+        for (int l = 0; l < WIDTH; l++) {
+            double SBEE[3] = { r_lane[0][l], r_lane[1][l], r_lane[2][l] };
+            double lat, alt, pressure;
+            std::tie(lat, alt) = cad::geo84_lat_alt(SBEE);
+            field(ALT)[j + l] = alt;
+            cad::Atmosphere76::evaluate(alt, &tempk_lane[l], field(RHO) + j + l, &pressure);
+        }
+
+        simd_double tempk = simd_double::load(tempk_lane);
+        simd_double vsound = sqrt(1.4 * RGAS * tempk);
+        vsound.store(field(VSOUND) + j);
+
+        /* speed wrt the air at rest on the earth: VBII - WEII x SBII */
+        simd_double VBA[3];
+        VBA[0] = VB[0] + WEII3 * S[1];
+        VBA[1] = VB[1] - WEII3 * S[0];
+        VBA[2] = VB[2];
+        simd_double dvba = sqrt(VBA[0] * VBA[0] + VBA[1] * VBA[1] + VBA[2] * VBA[2]);
+        dvba.store(field(DVBA) + j);
+        (dvba / vsound).store(field(VMACH) + j);
+        simd_double rho = simd_double::load(field(RHO) + j);
+        (0.5 * rho * dvba * dvba).store(field(PDYNMC) + j);
+    }
+}
+
+void Rocket_Batch_DM::propagate(double int_step) {
+    const double half_h = 0.5 * int_step;
+    const double sixth_h = int_step / 6.0;
+
+    for (int j = 0; j < stride; j += WIDTH) {
+        simd_double y[N_STATE], y0[N_STATE], k[N_STATE], sum[N_STATE];
+        simd_double VB[3], FSPB[3], I[3], M[3], G[3];
+        int i;
+
+        simd_double vmass = simd_double::load(field(VMASS) + j);
+        simd_double drag = simd_double::load(field(PDYNMC) + j) * simd_double::load(field(CA_REFA) + j);
+        for (i = 0; i < 3; i++) {
+            VB[i] = simd_double::load(field(VBII + i) + j);
+            FSPB[i] = simd_double::load(field(FAPB + i) + j);
+            I[i] = simd_double::load(field(IBBB + i) + j);
+            M[i] = simd_double::load(field(FMB + i) + j);
+            G[i] = simd_double::load(field(GRAVG + i) + j);
+        }
+        FSPB[0] = FSPB[0] - drag;
+        for (i = 0; i < 3; i++)
+            FSPB[i] = FSPB[i] / vmass;
+
+        for (i = 0; i < N_STATE; i++)
+            y0[i] = y[i] = simd_double::load(field(i) + j);
+
+        /* rk4_step() */
+        rocket_batch_rates(y, VB, FSPB, I, M, G, k);
+        for (i = 0; i < N_STATE; i++) {
+            sum[i] = k[i];
+            y[i] = y0[i] + half_h * k[i];
+        }
+
+        rocket_batch_rates(y, VB, FSPB, I, M, G, k);
+        for (i = 0; i < N_STATE; i++) {
+            sum[i] += 2.0 * k[i];
+            y[i] = y0[i] + half_h * k[i];
+        }
+
+        rocket_batch_rates(y, VB, FSPB, I, M, G, k);
+        for (i = 0; i < N_STATE; i++) {
+            sum[i] += 2.0 * k[i];
+            y[i] = y0[i] + int_step * k[i];
+        }
+
+        rocket_batch_rates(y, VB, FSPB, I, M, G, k);
+        for (i = 0; i < N_STATE; i++) {
+            sum[i] += k[i];
+            y[i] = y0[i] + sixth_h * sum[i];
+        }
+
+        for (i = 0; i < N_STATE; i++)
+            y[i].store(field(i) + j);
+        /* the reference point is the center of mass: VBII = VBIIP */
+        for (i = 0; i < 3; i++)
+            y[VBIIP + i].store(field(VBII + i) + j);
+    }
+}
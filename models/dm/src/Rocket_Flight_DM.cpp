@@ -1,9 +1,12 @@
+#include <cstring>
 #include <iomanip>
 #include "cad_utility.hh"
 #include "math_utility.hh"
 #include "integrate.hh"
+#include "rk4.hh"
 #include "matrix/utility.hh"
 #include "Rocket_Flight_DM.hh"
+#include "checkpoint.hh"
 #include "sim_services/include/simtime.h"
 #include "aux.hh"
 #include <tuple>
@@ -228,6 +231,21 @@ void Rocket_Flight_DM::set_reference_point(double rp) {
     reference_point = rp;
 }
 
+void Rocket_Flight_DM::checkpoint(Checkpoint &cp) {
+    cp.section("DM");
+    cp(TBI, TBID, TBI_Q, TBID_Q, TBD, TBDQ, VBAB, WEII_skew,
+       SBIIP, VBIIP, SBII, VBII, ABII, ABIB, SBEE, VBEE, ABEE, SBEE_old, VBEE_old, ABEE_old, JBII, JBEE,
+       TDI, TGI, VBED, FSPB, CONING, NEXT_ACC, TDE, VBII_old, WEII, WBII, WBEB, WBIB, WBIBD, TVD,
+       SBEE_test, VBEE_test, ABEE_test, TLI, LT_euler, TBLQ, ABID);
+    cp(dang_slosh_theta, ang_slosh_theta, dang_slosh_psi, ang_slosh_psi, ortho_error, alphax, betax, alppx,
+       phipx, alphaix, betaix, psibdx, thtbdx, phibdx, psibd, thtbd, phibd, alt, lonx, latx, _aero_loss,
+       gravity_loss, t, con_ang, con_w, _grndtrck, _gndtrkmx, _gndtrnmx, _ayx, _anx, _dbi, _dvbi, _dvbe,
+       _thtvdx, _psivdx, liftoff, ppx, qqx, rrx, control_loss, _inclination, _eccentricity, _semi_major,
+       _ha, _hp, _lon_anodex, _arg_perix, _true_anomx, _ref_alt, reference_point, Roll, Pitch, Yaw,
+       Interpolation_Extrapolation_flag);
+    cp(TX_data_forward);
+}
+
 void Rocket_Flight_DM::propagate(double int_step) {
     double dvba = grab_dvba();
     double vmass = grab_vmass();
@@ -579,15 +597,12 @@ void Rocket_Flight_DM::aux_calulate(arma::mat33 TEI, arma::mat33 TBI) {
     VBED = TDE * VBEE;
 }
 
-void Rocket_Flight_DM::RK4F(arma::vec3 GRAVG, arma::mat33 TEI, double int_step,
-                            arma::vec3 &K1, arma::vec3 &K2, arma::vec3 &K3, arma::vec4 &K4,
-                            double &K5, double &K6, double &K7, double &K8) {
+void Rocket_Flight_DM::RK4F(const arma::vec3 &GRAVG, const arma::mat33 &TEI, double *dy) {
     double vmass = grab_vmass();
     double thrust = grab_thrust();
     // arma::vec3 FMB = grab_FMB();
     // arma::vec3 FAPB = grab_FAPB();
     // arma::mat33 IBBB = grab_IBBB();
-    arma::vec4 TBID_Q_NEW;
     arma::vec3 rhoC_IMU;
 
     collect_forces_and_propagate();
@@ -632,33 +647,49 @@ void Rocket_Flight_DM::RK4F(arma::vec3 GRAVG, arma::mat33 TEI, double int_step,
     double erq = 1. - quat_metric;
 
     /* Calculate Previous states */  //  Zipfel p.141
-    TBID_Q_NEW(0) = 0.5 * (-WBIB(0) * TBI_Q(1) - WBIB(1) * TBI_Q(2) - WBIB(2) * TBI_Q(3)) + 50. * erq * TBI_Q(0);
-    TBID_Q_NEW(1) = 0.5 * (WBIB(0) * TBI_Q(0) + WBIB(2) * TBI_Q(2) - WBIB(1) * TBI_Q(3)) + 50. * erq * TBI_Q(1);
-    TBID_Q_NEW(2) = 0.5 * (WBIB(1) * TBI_Q(0) - WBIB(2) * TBI_Q(1) + WBIB(0) * TBI_Q(3)) + 50. * erq * TBI_Q(2);
-    TBID_Q_NEW(3) = 0.5 * (WBIB(2) * TBI_Q(0) + WBIB(1) * TBI_Q(1) - WBIB(0) * TBI_Q(2)) + 50. * erq * TBI_Q(3);
-
-    K1 = NEXT_ACC;
-    K2 = VBII;
-    K3 = WBIBD_new;
-    K4 = TBID_Q_NEW;
-    K5 = ddang_slosh_theta;
-    K6 = dang_slosh_theta;
-    K7 = ddang_slosh_psi;
-    K8 = dang_slosh_psi;
+    double *dq = dy + RK4_TBI_Q;
+    dq[0] = 0.5 * (-WBIB(0) * TBI_Q(1) - WBIB(1) * TBI_Q(2) - WBIB(2) * TBI_Q(3)) + 50. * erq * TBI_Q(0);
+    dq[1] = 0.5 * (WBIB(0) * TBI_Q(0) + WBIB(2) * TBI_Q(2) - WBIB(1) * TBI_Q(3)) + 50. * erq * TBI_Q(1);
+    dq[2] = 0.5 * (WBIB(1) * TBI_Q(0) - WBIB(2) * TBI_Q(1) + WBIB(0) * TBI_Q(3)) + 50. * erq * TBI_Q(2);
+    dq[3] = 0.5 * (WBIB(2) * TBI_Q(0) + WBIB(1) * TBI_Q(1) - WBIB(0) * TBI_Q(2)) + 50. * erq * TBI_Q(3);
+
+    for (int i = 0; i < 3; i++) {
+        dy[RK4_VBIIP + i] = NEXT_ACC(i);
+        dy[RK4_SBIIP + i] = VBII(i);
+        dy[RK4_WBIB + i] = WBIBD_new(i);
+    }
+    dy[RK4_DANG_SLOSH_THETA] = ddang_slosh_theta;
+    dy[RK4_ANG_SLOSH_THETA] = dang_slosh_theta;
+    dy[RK4_DANG_SLOSH_PSI] = ddang_slosh_psi;
+    dy[RK4_ANG_SLOSH_PSI] = dang_slosh_psi;
     ABII = NEXT_ACC;
 }
+
+void Rocket_Flight_DM::save_rk4_state(double *y) {
+    memcpy(y + RK4_VBIIP, _VBIIP, sizeof(_VBIIP));
+    memcpy(y + RK4_SBIIP, _SBIIP, sizeof(_SBIIP));
+    memcpy(y + RK4_WBIB, _WBIB, sizeof(_WBIB));
+    memcpy(y + RK4_TBI_Q, _TBI_Q, sizeof(_TBI_Q));
+    y[RK4_DANG_SLOSH_THETA] = dang_slosh_theta;
+    y[RK4_ANG_SLOSH_THETA] = ang_slosh_theta;
+    y[RK4_DANG_SLOSH_PSI] = dang_slosh_psi;
+    y[RK4_ANG_SLOSH_PSI] = ang_slosh_psi;
+}
+
+void Rocket_Flight_DM::load_rk4_state(const double *y) {
+    memcpy(_VBIIP, y + RK4_VBIIP, sizeof(_VBIIP));
+    memcpy(_SBIIP, y + RK4_SBIIP, sizeof(_SBIIP));
+    memcpy(_WBIB, y + RK4_WBIB, sizeof(_WBIB));
+    memcpy(_TBI_Q, y + RK4_TBI_Q, sizeof(_TBI_Q));
+    dang_slosh_theta = y[RK4_DANG_SLOSH_THETA];
+    ang_slosh_theta = y[RK4_ANG_SLOSH_THETA];
+    dang_slosh_psi = y[RK4_DANG_SLOSH_PSI];
+    ang_slosh_psi = y[RK4_ANG_SLOSH_PSI];
+    this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
+}
+
 void Rocket_Flight_DM::RK4(arma::vec3 GRAVG, arma::mat33 TEI, double int_step) {
-    arma::vec3 K11, K21, K31, K41;
-    arma::vec3 K12, K22, K32, K42;
-    arma::vec3 K13, K23, K33, K43;
-    arma::vec4 K14, K24, K34, K44;
-    double K15, K25, K35, K45;
-    double K16, K26, K36, K46;
-    double K17, K27, K37, K47;
-    double K18, K28, K38, K48;
-    arma::vec4 TBI_Q_post;
-    arma::vec3 VBIIP_post, SBIIP_post, WBIB_post;
-    double dang_slosh_theta_post, ang_slosh_theta_post, dang_slosh_psi_post, ang_slosh_psi_post;
+    double y[RK4_N];
 
     arma::vec3 ddang_1 = grab_ddang_1();
     arma::vec3 rhoC_1;
@@ -667,97 +698,14 @@ void Rocket_Flight_DM::RK4(arma::vec3 GRAVG, arma::mat33 TEI, double int_step) {
     rhoC_1(1) = 0.0;
     rhoC_1(2) = 0.0;
 
-    SBIIP_post = SBIIP;  // - trans(TBI) * rhoC_1;
-    VBIIP_post = VBIIP;  // - trans(TBI) * cross(WBIB, rhoC_1);
-    WBIB_post = WBIB;
-    TBI_Q_post = TBI_Q;
-    dang_slosh_theta_post = dang_slosh_theta;
-    ang_slosh_theta_post = ang_slosh_theta;
-    dang_slosh_psi_post = dang_slosh_psi;
-    ang_slosh_psi_post = ang_slosh_psi;
-
-    RK4F(GRAVG, TEI, int_step, K11, K12, K13, K14, K15, K16, K17, K18);
-    VBIIP = VBIIP_post + K11 * 0.5 * int_step;
-    SBIIP = SBIIP_post + K12 * 0.5 * int_step;
-    WBIB = WBIB_post + K13 * 0.5 * int_step;
-    TBI_Q = TBI_Q_post + K14 * 0.5 *int_step;
-    ang_slosh_theta = ang_slosh_theta_post + K16 * 0.5 * int_step;
-    ang_slosh_psi = ang_slosh_psi_post + K18 * 0.5 * int_step;
-    dang_slosh_theta = dang_slosh_theta_post + K15 * 0.5 * int_step;
-    dang_slosh_psi = dang_slosh_psi_post + K17 * 0.5 * int_step;
-    this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
-
-    RK4F(GRAVG, TEI, int_step, K21, K22, K23, K24, K25, K26, K27, K28);
-    VBIIP = VBIIP_post + K21 * 0.5 * int_step;
-    SBIIP = SBIIP_post + K22 * 0.5 * int_step;
-    WBIB = WBIB_post + K23 * 0.5 * int_step;
-    TBI_Q = TBI_Q_post + K24 * 0.5 *int_step;
-    ang_slosh_theta = ang_slosh_theta_post + K26 * 0.5 * int_step;
-    ang_slosh_psi = ang_slosh_psi_post + K28 * 0.5 * int_step;
-    dang_slosh_theta = dang_slosh_theta_post + K25 * 0.5 * int_step;
-    dang_slosh_psi = dang_slosh_psi_post + K27 * 0.5 * int_step;
-    this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
-
-    RK4F(GRAVG, TEI, int_step, K31, K32, K33, K34, K35, K36, K37, K38);
-    VBIIP = VBIIP_post + K31 * int_step;
-    SBIIP = SBIIP_post + K32 * int_step;
-    WBIB = WBIB_post + K33 * int_step;
-    TBI_Q = TBI_Q_post + K34 *int_step;
-    ang_slosh_theta = ang_slosh_theta_post + K36 * int_step;
-    ang_slosh_psi = ang_slosh_psi_post + K38 * int_step;
-    dang_slosh_theta = dang_slosh_theta_post + K35 * int_step;
-    dang_slosh_psi = dang_slosh_psi_post + K37 * int_step;
-    this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
-
-    RK4F(GRAVG, TEI, int_step, K41, K42, K43, K44, K45, K46, K47, K48);
-    VBIIP = VBIIP_post + (int_step / 6.0) * (K11 + 2.0 * K21 + 2.0 * K31 + K41);
-    SBIIP = SBIIP_post + (int_step / 6.0) * (K12 + 2.0 * K22 + 2.0 * K32 + K42);
-    WBIB = WBIB_post + (int_step / 6.0) * (K13 + 2.0 * K23 + 2.0 * K33 + K43);
-    TBI_Q = TBI_Q_post + (int_step / 6.0) * (K14 + 2.0 * K24 + 2.0 * K34 + K44);
-    ang_slosh_theta = ang_slosh_theta_post + (int_step / 6.0) * (K16 + 2.0 * K26 + 2.0 * K36 + K46);
-    ang_slosh_psi = ang_slosh_psi_post + (int_step / 6.0) * (K18 + 2.0 * K28 + 2.0 * K38 + K48);
-    dang_slosh_theta = dang_slosh_theta_post + (int_step / 6.0) * (K15 + 2.0 * K25 + 2.0 * K35 + K45);
-    dang_slosh_psi = dang_slosh_psi_post + (int_step / 6.0) * (K17 + 2.0 * K27 + 2.0 * K37 + K47);
-    this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
+    save_rk4_state(y);
+    rk4_step<RK4_N>(y, int_step,
+                    [&](double *dy) { RK4F(GRAVG, TEI, dy); },
+                    [this](const double *ys) { load_rk4_state(ys); });
 
     WBIBD = ddang_1;
     SBII = SBIIP + trans(TBI) * rhoC_1;
     VBII = VBIIP + trans(TBI) * cross(WBIB, rhoC_1);
-    /********************************************************************************/
-    // arma::vec3 VBII_post, SBII_post;
-
-    // SBII_post = SBII;// - trans(TBI) * rhoC_1;
-    // VBII_post = VBII;// - trans(TBI) * cross(WBIB, rhoC_1);
-    // WBIB_post = WBIB;
-    // TBI_Q_post = TBI_Q;
-
-    // RK4F(GRAVG, TEI, int_step, K11, K12, K13, K14);
-    // VBII = VBII_post + K11 * 0.5 * int_step;
-    // SBII = SBII_post + K12 * 0.5 * int_step;
-    // WBIB = WBIB_post + K13 * 0.5 * int_step;
-    // TBI_Q = TBI_Q_post + K14 * 0.5 *int_step;
-    // this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
-
-    // RK4F(GRAVG, TEI, int_step, K21, K22, K23, K24);
-    // VBII = VBII_post + K21 * 0.5 * int_step;
-    // SBII = SBII_post + K22 * 0.5 * int_step;
-    // WBIB = WBIB_post + K23 * 0.5 * int_step;
-    // TBI_Q = TBI_Q_post + K24 * 0.5 *int_step;
-    // this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
-
-    // RK4F(GRAVG, TEI, int_step, K31, K32, K33, K34);
-    // VBII = VBII_post + K31 * int_step;
-    // SBII = SBII_post + K32 * int_step;
-    // WBIB = WBIB_post + K33 * int_step;
-    // TBI_Q = TBI_Q_post + K34 *int_step;
-    // this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
-
-    // RK4F(GRAVG, TEI, int_step, K41, K42, K43, K44);
-    // VBII = VBII_post + (int_step / 6.0) * (K11 + 2.0 * K21 + 2.0 * K31 + K41);
-    // SBII = SBII_post + (int_step / 6.0) * (K12 + 2.0 * K22 + 2.0 * K32 + K42);
-    // WBIB = WBIB_post + (int_step / 6.0) * (K13 + 2.0 * K23 + 2.0 * K33 + K43);
-    // TBI_Q = TBI_Q_post + (int_step / 6.0) * (K14 + 2.0 * K24 + 2.0 * K34 + K44);
-    // this->TBI = Quaternion2Matrix(this->TBI_Q);  // Convert Quaternion to Matrix
 }
 double Rocket_Flight_DM::get_alppx() { return alppx; }
 double Rocket_Flight_DM::get_phipx() { return phipx; }
@@ -815,37 +763,48 @@ double Rocket_Flight_DM::get_double_phibd() { return phibd; }
 
 unsigned int Rocket_Flight_DM::get_liftoff() { return liftoff; }
 
-int Rocket_Flight_DM::enqueue_to_simgen_buffer(struct icf_ctrlblk_t* C, double ext_porlation) {
-    struct simgen_motion_data_t motion_info;
+void Rocket_Flight_DM::fill_simgen_motion(struct simgen_motion_data_t *motion_info, double ext_porlation) {
     double (*pos)[3];
     double (*vel)[3];
     double (*accel)[3];
     pos = (ext_porlation == 0.0) ? &_SBEE : &_SBEE_test;
     vel = (ext_porlation == 0.0) ? &_VBEE : &_VBEE_test;
     accel = (ext_porlation == 0.0) ? &_ABEE : &_ABEE_test;
-    motion_info.sim_time.second = exec_get_sim_time() + ext_porlation;
-    motion_info.cmd_idx = REMOTE_MOTION_CMD_MOT;
-    motion_info.vehicle_id = 1;
-    memcpy(&motion_info.position_xyz, pos, sizeof(double) * 3);
-    memcpy(&motion_info.velocity_xyz, vel, sizeof(double) * 3);
-    memcpy(&motion_info.acceleration_xyz, accel, sizeof(double) * 3);
-    motion_info.jerk_xyz[0] = 0.0;
-    motion_info.jerk_xyz[1] = 0.0;
-    motion_info.jerk_xyz[2] = 0.0;
-    motion_info.heb[0] = psibd;
-    motion_info.heb[1] = thtbd;
-    motion_info.heb[2] = phibd;
-    memcpy(&motion_info.angular_velocity, &_WBEB, sizeof(double) * 3);
-    motion_info.angular_acceleration[0] = 0.0;
-    motion_info.angular_acceleration[1] = 0.0;
-    motion_info.angular_acceleration[2] = 0.0;
-    motion_info.angular_jerk[0] = 0.0;
-    motion_info.angular_jerk[1] = 0.0;
-    motion_info.angular_jerk[2] = 0.0;
+    motion_info->sim_time.second = exec_get_sim_time() + ext_porlation;
+    motion_info->cmd_idx = REMOTE_MOTION_CMD_MOT;
+    motion_info->vehicle_id = 1;
+    memcpy(&motion_info->position_xyz, pos, sizeof(double) * 3);
+    memcpy(&motion_info->velocity_xyz, vel, sizeof(double) * 3);
+    memcpy(&motion_info->acceleration_xyz, accel, sizeof(double) * 3);
+    motion_info->jerk_xyz[0] = 0.0;
+    motion_info->jerk_xyz[1] = 0.0;
+    motion_info->jerk_xyz[2] = 0.0;
+    motion_info->heb[0] = psibd;
+    motion_info->heb[1] = thtbd;
+    motion_info->heb[2] = phibd;
+    memcpy(&motion_info->angular_velocity, &_WBEB, sizeof(double) * 3);
+    motion_info->angular_acceleration[0] = 0.0;
+    motion_info->angular_acceleration[1] = 0.0;
+    motion_info->angular_acceleration[2] = 0.0;
+    motion_info->angular_jerk[0] = 0.0;
+    motion_info->angular_jerk[1] = 0.0;
+    motion_info->angular_jerk[2] = 0.0;
+}
+
+int Rocket_Flight_DM::enqueue_to_simgen_buffer(struct icf_ctrlblk_t* C, double ext_porlation) {
+    struct simgen_motion_data_t motion_info;
+    fill_simgen_motion(&motion_info, ext_porlation);
     icf_tx_enqueue(C, EGSE_TX_GPSRF_EMU_QIDX, &motion_info, sizeof(struct simgen_motion_data_t));
     return 0;
 }
 
+/* never blocks: the sender thread owns the socket, a full ring drops the sample */
+int Rocket_Flight_DM::push_to_simgen_sender(struct simgen_sender_t *S, double ext_porlation) {
+    struct simgen_motion_data_t motion_info;
+    fill_simgen_motion(&motion_info, ext_porlation);
+    return simgen_sender_push(S, &motion_info);
+}
+
 int  Rocket_Flight_DM::stand_still_motion_data(struct icf_ctrlblk_t* C, double ext_porlation) {
     struct simgen_motion_data_t motion_info;
     double (*pos)[3];
@@ -2,6 +2,7 @@
 #include "integrate.hh"
 
 #include "Tvc.hh"
+#include "checkpoint.hh"
 #include "sim_services/include/simtime.h"
 #include "dsp_can_interfaces.h"
 
@@ -235,6 +236,33 @@ empty_frame:
         return;
 }
 
+void TVC::checkpoint(Checkpoint &cp) {
+    cp.section("TVC");
+    cp(mtvc, gtvc, tvclimx, dtvclimx, wntvc, zettvc, factgtvc, etas, etasd, zeta,
+       zetad, detas, detasd, dzeta, dzetad, parm, FPB, FMPB, etax, zetx, etacx, zetcx, s2_tau1, s2_tau2,
+       s2_tau3, s2_tau4, s2_act1_y1, s2_act2_y1, s2_act3_y1, s2_act4_y1, s2_act1_y1_saturation,
+       s2_act2_y1_saturation, s2_act3_y1_saturation, s2_act4_y1_saturation, s2_act1_y2, s2_act2_y2,
+       s2_act3_y2, s2_act4_y2, s2_act1_y2_saturation, s2_act2_y2_saturation, s2_act3_y2_saturation,
+       s2_act4_y2_saturation, s2_act1_rate, s2_act2_rate, s2_act3_rate, s2_act4_rate,
+       s2_act1_rate_saturation, s2_act2_rate_saturation, s2_act3_rate_saturation, s2_act4_rate_saturation,
+       s2_act1_rate_saturation_old, s2_act2_rate_saturation_old, s2_act3_rate_saturation_old,
+       s2_act4_rate_saturation_old, s2_act1_rate_old, s2_act2_rate_old, s2_act3_rate_old, s2_act4_rate_old,
+       s2_act1_acc, s2_act2_acc, s2_act3_acc, s2_act4_acc, s3_act1_acc, s3_act2_acc, s3_act3_acc,
+       s3_act4_acc, s2_ratelim, s2_tvclim, s2_acclim, s3_tau1, s3_tau2, s3_tau3, s3_tau4, s3_act1_y1,
+       s3_act2_y1, s3_act3_y1, s3_act4_y1, s3_act1_y1_saturation, s3_act2_y1_saturation,
+       s3_act3_y1_saturation, s3_act4_y1_saturation, s3_act1_y2, s3_act2_y2, s3_act3_y2, s3_act4_y2,
+       s3_act1_y2_saturation, s3_act2_y2_saturation, s3_act3_y2_saturation, s3_act4_y2_saturation,
+       s3_act1_rate, s3_act2_rate, s3_act3_rate, s3_act4_rate, s3_act1_rate_saturation,
+       s3_act2_rate_saturation, s3_act3_rate_saturation, s3_act4_rate_saturation,
+       s3_act1_rate_saturation_old, s3_act2_rate_saturation_old, s3_act3_rate_saturation_old,
+       s3_act4_rate_saturation_old, s3_act1_rate_old, s3_act2_rate_old, s3_act3_rate_old, s3_act4_rate_old,
+       s3_ratelim, s3_tvclim, s3_acclim, theta_a_cmd, theta_b_cmd, theta_c_cmd, theta_d_cmd, TS2_N1_B,
+       TS2_N2_B, TS2_N3_B, TS2_N4_B, TS3_N1_B, TS3_N2_B, r_N1, r_N2, r_N3, r_N4, Q_TVC, S2_FPB1, S2_FPB2,
+       S2_FPB3, S2_FPB4, S2_FMPB1, S2_FMPB2, S2_FMPB3, S2_FMPB4, lx, s2_d, s3_d, s2_reference_p,
+       s3_reference_p);
+    cp(tvc_no1, tvc_no2);
+}
+
 void TVC::actuate(double int_step, struct icf_ctrlblk_t* C) {
     // local variables
     double eta(0), zet(0);
@@ -0,0 +1,300 @@
+#include "Environment.hh"
+#include "Aerodynamics.hh"
+#include "Propulsion.hh"
+#include "Tvc.hh"
+#include "Force.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Several Environment + Forces instances in one process.
+ *
+ * The instances are copies of one configured prototype: harmonic gravity,
+ * an aero deck, slosh + TWD Forces with Broyden warm start, and either the
+ * US 1976 atmosphere with a constant, turbulent wind or the weather deck
+ * atmosphere and tabular wind (odd instances). Copies share the decks and
+ * keep their own look-up hints. Each is driven through its own flight
+ * state, first one after the other, then N_INSTANCES at once on their own
+ * threads. The concurrent outputs must be the serial ones bit for bit.
+ *
+ * make environment_forces_mt_test_tsan builds it with ThreadSanitizer.
+ *
+ * Usage: environment_forces_mt_test [aux_dir]
+ */
+
+static const int N_INSTANCES = 4;
+static const int N_STEPS = 400;
+static const double INT_STEP = 0.005;
+
+/* hooks Propulsion and TVC link against, neither is propagated here */
+extern "C" double get_rettime(void) { return 0.0; }
+extern "C" int icf_rx_dequeue(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t size) { return 0; }
+
+struct FlightState {
+    arma::mat33 TBI, TBD, TDE, TGI, IBBB, I_E;
+    arma::vec3 SBII, VBED, VBEE, WBIB, GRAVG, NEXT_ACC, FSPB, XCG;
+    arma::vec6 Q_TVC;
+    double alt, dvbe, vmass, oxidizer_mass, pdynmc, alppx, phipx;
+    double ang[6], dang[6], act_acc[4];
+};
+
+/* Instance k at step n: a vehicle climbing through 5 km, tumbling slowly */
+static void advance(FlightState &s, int k, int n) {
+    double t = n * INT_STEP;
+    double w = 0.3 + 0.05 * k;
+
+    s.alt = 5000.0 + 300.0 * k + (400.0 + 10.0 * k) * t;
+    s.TBI = arma::mat33(arma::fill::eye);
+    s.TBI(0, 0) = s.TBI(1, 1) = cos(w * t);
+    s.TBI(0, 1) = sin(w * t);
+    s.TBI(1, 0) = -sin(w * t);
+    s.TBD = s.TBI;
+    s.TDE = arma::mat33(arma::fill::eye);
+    s.TGI = arma::mat33(arma::fill::eye);
+    for (int i = 0; i < 3; i++) {
+        s.SBII(i) = (i == 2 ? SMAJOR_AXIS + s.alt : 1.0e3 * (k + 1));
+        s.VBED(i) = (i == 2 ? -(400.0 + 10.0 * k) : 20.0 * (i + 1));
+        s.WBIB(i) = 0.01 * (i + 1) * sin(w * t + k);
+        s.NEXT_ACC(i) = 5.0 * cos(0.7 * t + i + k);
+        s.XCG(i) = (i == 0) ? 6.2 - 0.01 * t : 0.0;
+    }
+    s.VBEE = s.VBED;
+    s.dvbe = norm(s.VBED);
+    s.FSPB(0) = -25.0 - k;
+    s.FSPB(1) = 0.2 * sin(t);
+    s.FSPB(2) = -0.2 * cos(t);
+    for (int i = 0; i < 6; i++)
+        s.Q_TVC(i) = 1.0e3 * sin(0.5 * t + i);
+    s.vmass = 3500.0 - 10.0 * t;
+    s.oxidizer_mass = 800.0 - 5.0 * t;
+    s.IBBB = arma::mat33(arma::fill::zeros);
+    s.IBBB(0, 0) = 600.0;
+    s.IBBB(1, 1) = s.IBBB(2, 2) = 18000.0;
+    s.I_E = arma::mat33(arma::fill::zeros);
+    s.I_E(0, 0) = 1.5;
+    s.I_E(1, 1) = s.I_E(2, 2) = 45.0;
+    for (int i = 0; i < 6; i++) {
+        s.ang[i] = 0.05 * sin(1.3 * t + i + k);
+        s.dang[i] = 0.1 * cos(1.3 * t + i + k);
+    }
+    for (int i = 0; i < 4; i++)
+        s.act_acc[i] = 2.0 * sin(2.0 * t + i);
+    s.alppx = 4.0 + 3.0 * sin(w * t + k);
+    s.phipx = 30.0 * cos(w * t);
+}
+
+static void connect(Environment &env, const FlightState &s) {
+    env.grab_dvbe = [&s]() { return s.dvbe; };
+    env.grab_SBII = [&s]() { return s.SBII; };
+    env.grab_VBED = [&s]() { return s.VBED; };
+    env.grab_alt = [&s]() { return s.alt; };
+    env.grab_TGI = [&s]() { return s.TGI; };
+    env.grab_TBI = [&s]() { return s.TBI; };
+    env.grab_TBD = [&s]() { return s.TBD; };
+    env.grab_alppx = [&s]() { return s.alppx; };
+    env.grab_phipx = [&s]() { return s.phipx; };
+    env.grab_VBEE = [&s]() { return s.VBEE; };
+    env.grab_TDE = [&s]() { return s.TDE; };
+}
+
+static void connect(AeroDynamics &aero, Environment &env, const FlightState &s) {
+    aero.grab_alppx = [&s]() { return s.alppx; };
+    aero.grab_phipx = [&s]() { return s.phipx; };
+    aero.grab_alphax = [&s]() { return s.alppx * cos(s.phipx * RAD); };
+    aero.grab_betax = [&s]() { return s.alppx * sin(s.phipx * RAD); };
+    aero.grab_rho = [&env]() { return env.get_rho(); };
+    aero.grab_vmach = [&env]() { return env.get_vmach(); };
+    aero.grab_pdynmc = [&env]() { return env.get_pdynmc(); };
+    aero.grab_tempk = [&env]() { return env.get_tempk(); };
+    aero.grab_dvba = [&env]() { return env.get_dvba(); };
+    aero.grab_ppx = [&s]() { return s.WBIB(0) * DEG; };
+    aero.grab_qqx = [&s]() { return s.WBIB(1) * DEG; };
+    aero.grab_rrx = [&s]() { return s.WBIB(2) * DEG; };
+    aero.grab_WBIB = [&s]() { return s.WBIB; };
+    aero.grab_alt = [&s]() { return s.alt; };
+    aero.grab_xcg = [&s]() { return s.XCG; };
+    aero.grab_liftoff = []() { return 1u; };
+}
+
+static void connect(Forces &forces, AeroDynamics &aero, const FlightState &s) {
+    forces.grab_TBI = [&s]() { return s.TBI; };
+    forces.grab_IBBB = [&s]() { return s.IBBB; };
+    forces.grab_vmass = [&s]() { return s.vmass; };
+    forces.grab_WBIB = [&s]() { return s.WBIB; };
+    forces.grab_GRAVG = [&s]() { return s.GRAVG; };
+    forces.grab_NEXT_ACC = [&s]() { return s.NEXT_ACC; };
+    forces.grab_FSPB = [&s]() { return s.FSPB; };
+    forces.grab_structure_XCG = [&s]() { return s.XCG; };
+    forces.grab_xcp = [&aero]() { return aero.get_xcp(); };
+    forces.grab_Q_TVC = [&s]() { return s.Q_TVC; };
+    forces.grab_liftoff = []() { return 1u; };
+    forces.grab_thrust = []() { return 0.0; };
+    forces.grab_pdynmc = [&s]() { return s.pdynmc; };
+    forces.grab_refa = [&aero]() { return aero.get_refa(); };
+    forces.grab_refd = [&aero]() { return aero.get_refd(); };
+    forces.grab_cx = [&aero]() { return aero.get_cx(); };
+    forces.grab_cy = [&aero]() { return aero.get_cy(); };
+    forces.grab_cz = [&aero]() { return aero.get_cz(); };
+    forces.grab_cll = [&aero]() { return aero.get_cll(); };
+    forces.grab_clm = [&aero]() { return aero.get_clm(); };
+    forces.grab_cln = [&aero]() { return aero.get_cln(); };
+    forces.grab_oxidizer_mass = [&s]() { return s.oxidizer_mass; };
+    forces.grab_ang_slosh_theta = [&s]() { return s.ang[0]; };
+    forces.grab_ang_slosh_psi = [&s]() { return s.ang[1]; };
+    forces.grab_dang_slosh_theta = [&s]() { return s.dang[0]; };
+    forces.grab_dang_slosh_psi = [&s]() { return s.dang[1]; };
+    forces.grab_ang_e1_theta = [&s]() { return s.ang[2]; };
+    forces.grab_ang_e2_psi = [&s]() { return s.ang[3]; };
+    forces.grab_ang_e3_theta = [&s]() { return s.ang[4]; };
+    forces.grab_ang_e4_psi = [&s]() { return s.ang[5]; };
+    forces.grab_dang_e1_B = [&s]() { return s.dang[2]; };
+    forces.grab_dang_e2_B = [&s]() { return s.dang[3]; };
+    forces.grab_dang_e3_B = [&s]() { return s.dang[4]; };
+    forces.grab_dang_e4_B = [&s]() { return s.dang[5]; };
+    forces.grab_s2_act1_acc = [&s]() { return s.act_acc[0]; };
+    forces.grab_s2_act2_acc = [&s]() { return s.act_acc[1]; };
+    forces.grab_s2_act3_acc = [&s]() { return s.act_acc[2]; };
+    forces.grab_s2_act4_acc = [&s]() { return s.act_acc[3]; };
+    forces.grab_e1_mass = []() { return 10.0; };
+    forces.grab_e2_mass = []() { return 10.0; };
+    forces.grab_e3_mass = []() { return 10.0; };
+    forces.grab_e4_mass = []() { return 10.0; };
+    forces.grab_e1_XCG = []() { return 0.7; };
+    forces.grab_e2_XCG = []() { return 0.7; };
+    forces.grab_e3_XCG = []() { return 0.7; };
+    forces.grab_e4_XCG = []() { return 0.7; };
+    forces.grab_I_S2_E1 = [&s]() { return s.I_E; };
+    forces.grab_I_S2_E2 = [&s]() { return s.I_E; };
+    forces.grab_I_S2_E3 = [&s]() { return s.I_E; };
+    forces.grab_I_S2_E4 = [&s]() { return s.I_E; };
+}
+
+struct Prototype {
+    Propulsion propulsion;
+    TVC tvc;
+    Environment env[2];     //  [0] US 1976 + constant wind, [1] weather deck
+    AeroDynamics aero;
+    Forces forces;
+
+    explicit Prototype(const std::string &aux_dir)
+        :   aero(propulsion),
+            forces(propulsion, tvc) {
+        std::string weather_deck = aux_dir + "/weather_table.txt";
+
+        env[0].atmosphere_use_public();
+        env[0].set_constant_wind(8.0, 45.0, 5.0, 0.0);
+        env[0].set_wind_turbulunce(300.0, 1.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+        env[1].atmosphere_use_weather_deck(&weather_deck[0]);
+        env[1].set_tabular_wind(&weather_deck[0], 5.0, 0.0);
+        for (int i = 0; i < 2; i++) {
+            env[i].set_gravity_harmonic(8, 8, 1);
+            env[i].set_RNP_update_interval(1.0, 1);
+        }
+
+        propulsion.set_no_thrust();
+        aero.load_aerotable((aux_dir + "/Aero_20180629_S2+S3.txt").c_str());
+        aero.set_refa(1.65046);
+        aero.set_refd(1.45);
+
+        forces.set_Slosh_flag(1);
+        forces.set_TWD_flag(1);
+        forces.set_DOF(12);
+        forces.set_aero_flag(1);
+        forces.set_damping_ratio(0.005);
+        forces.set_reference_point(-8.55);
+        forces.set_e1_d(0.0, 0.0, -0.425);
+        forces.set_e2_d(0.0, 0.425, 0.0);
+        forces.set_e3_d(0.0, 0.0, 0.425);
+        forces.set_e4_d(0.0, -0.425, 0.0);
+        forces.set_jacobian_mode(1);
+        forces.set_broydn_warm_start(1);
+    }
+};
+
+static void append(std::vector<double> &out, const arma::vec &v) {
+    for (unsigned i = 0; i < v.n_elem; i++)
+        out.push_back(v(i));
+}
+
+/* Instance k: copies of the prototype on the clock of the calling thread */
+static void run_instance(const Prototype *proto, int k, std::vector<double> *out) {
+    time_management *clock = time_management::create();
+    time_management::set_thread_instance(clock);
+    clock->load_start_time(2018, 290, 3, 0, 0.0);
+
+    Environment env(proto->env[k % 2]);
+    AeroDynamics aero(proto->aero);
+    Forces forces(proto->forces);
+    FlightState s;
+
+    connect(env, s);
+    connect(aero, env, s);
+    connect(forces, aero, s);
+    advance(s, k, 0);
+    env.initialize();
+
+    for (int n = 0; n < N_STEPS; n++) {
+        advance(s, k, n);
+        env.propagate(INT_STEP);
+        s.GRAVG = env.get_GRAVG();
+        s.pdynmc = env.get_pdynmc();
+        aero.calculate_aero(INT_STEP);
+        forces.collect_forces_and_propagate();
+        clock->dm_time(INT_STEP);
+
+        append(*out, env.get_GRAVG());
+        append(*out, env.get_VAED());
+        out->push_back(env.get_rho());
+        out->push_back(env.get_vmach());
+        out->push_back(env.get_pdynmc());
+        out->push_back(aero.get_cx());
+        out->push_back(aero.get_cz());
+        out->push_back(aero.get_clm());
+        out->push_back(aero.get_xcp()(0));
+        append(*out, forces.get_FAPB());
+        append(*out, forces.get_FMB());
+        append(*out, forces.get_ddrP_1());
+        append(*out, forces.get_ddang_1());
+    }
+
+    time_management::set_thread_instance(NULL);
+    delete clock;
+}
+
+int main(int argc, char *argv[]) {
+    Prototype proto(argc > 1 ? argv[1] : "../../../auxiliary");
+    std::vector<double> serial[N_INSTANCES], concurrent[N_INSTANCES];
+    std::vector<std::thread> threads;
+    int failed = 0;
+
+    fprintf(stderr, "** Environment + Forces, %d concurrent instances **\n", N_INSTANCES);
+    for (int k = 0; k < N_INSTANCES; k++)
+        run_instance(&proto, k, &serial[k]);
+    for (int k = 0; k < N_INSTANCES; k++)
+        threads.push_back(std::thread(run_instance, &proto, k, &concurrent[k]));
+    for (int k = 0; k < N_INSTANCES; k++)
+        threads[k].join();
+
+    for (int k = 0; k < N_INSTANCES; k++) {
+        size_t stride = serial[k].size() / N_STEPS;
+        int ok = serial[k].size() == concurrent[k].size()
+                 && memcmp(serial[k].data(), concurrent[k].data(), serial[k].size() * sizeof(double)) == 0;
+        fprintf(stderr, "%s instance %d (%s): %zu outputs over %d steps, pdynmc %.1f pa, cx %.4f\n",
+                ok ? "PASS" : "FAIL", k, k % 2 ? "weather deck" : "US 1976", serial[k].size(), N_STEPS,
+                serial[k].empty() ? 0.0 : serial[k][serial[k].size() - stride + 8],
+                serial[k].empty() ? 0.0 : serial[k][serial[k].size() - stride + 9]);
+        failed += !ok;
+    }
+    /* distinct instances must not have collapsed onto one trajectory */
+    if (serial[0] == serial[1]) {
+        fprintf(stderr, "FAIL instances 0 and 1 are identical\n");
+        failed++;
+    }
+    fprintf(stderr, "%s\n", failed ? "FAILED" : "PASSED");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+#include "Rocket_Flight_DM.hh"
+
+#include <cmath>
+#include <cstdio>
+
+/*
+ * Rocket_Flight_DM::propagate() against the RK4 of the DM before the
+ * integrated state moved onto a flat array (rk4_step()).
+ *
+ * The DM is wired to a small closed-form force model whose outputs depend
+ * on the stage state (attitude, body rates, slosh angles), so that every
+ * stage update and the TBI refresh between stages show in the result.
+ * The reference values were produced by the same program built against
+ * the former stage-by-stage RK4() and RK4F().
+ */
+
+static const int N_STEPS = 200;
+static const double INT_STEP = 0.005;
+static const double TOLERANCE = 1.0e-10;  // relative, far below the ci_test threshold of 5e-5
+
+/* DM hooks not exercised by propagate() */
+extern "C" double exec_get_sim_time(void) { return 0.0; }
+extern "C" int icf_tx_enqueue(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t size) { return 0; }
+extern "C" int simgen_sender_push(struct simgen_sender_t *S, const struct simgen_motion_data_t *m) { return 0; }
+
+struct Reference {
+    const char *name;
+    double value;
+};
+
+/* propagate() over N_STEPS with the former RK4 */
+static const Reference reference[] = {
+    {"SBII(0)", -3032490.0351932966},
+    {"SBII(1)", 5068072.7098291153},
+    {"SBII(2)", 2400146.9949528347},
+    {"VBII(0)", -376.81917917733165},
+    {"VBII(1)", -203.83926120345976},
+    {"VBII(2)", 7.6781655306532111},
+    {"WBIB(0)", 0.013779135751221283},
+    {"WBIB(1)", -0.0068594113276996705},
+    {"WBIB(2)", 0.010314604209718322},
+    {"TBI(0,0)", -0.39394826766935387},
+    {"TBI(1,2)", 0.92302528813153406},
+    {"TBI(2,1)", 0.44154068413559211},
+    {"ang_slosh_theta", -5.3531667638853192e-05},
+    {"dang_slosh_theta", -0.00012749413674150752},
+    {"ang_slosh_psi", 7.7278675743555595e-05},
+    {"dang_slosh_psi", 0.00017353369737028657},
+};
+
+static void wire(Rocket_Flight_DM &dm) {
+    static const double VMASS = 1000.0;
+    static const double THRUST = 30000.0;
+    Rocket_Flight_DM *d = &dm;
+
+    dm.grab_TEI = [] { return arma::mat33(arma::fill::eye); };
+    dm.grab_GRAVG = [d] {
+        arma::vec3 SBII = d->get_SBII();
+        return arma::vec3(-9.80665 * SBII / norm(SBII));
+    };
+    dm.grab_vmass = [] { return VMASS; };
+    dm.grab_thrust = [] { return THRUST; };
+    dm.grab_ddrP_1 = [d] {
+        arma::vec3 FB(arma::fill::zeros);
+        FB(0) = THRUST / VMASS;
+        FB(1) = 0.3 * d->get_ang_slosh_theta();
+        FB(2) = -0.3 * d->get_ang_slosh_psi();
+        arma::vec3 SBII = d->get_SBII();
+        return arma::vec3(trans(d->get_TBI()) * FB - 9.80665 * SBII / norm(SBII));
+    };
+    dm.grab_ddang_1 = [d] {
+        arma::vec3 WBIB = d->get_WBIB();
+        arma::vec3 torque;
+        torque(0) = 0.02;
+        torque(1) = -0.01 + 0.5 * d->get_ang_slosh_theta();
+        torque(2) = 0.015 - 0.5 * d->get_ang_slosh_psi();
+        return arma::vec3(torque - 0.8 * WBIB);
+    };
+    dm.grab_ddang_slosh_theta = [d] {
+        return -4.0 * d->get_ang_slosh_theta() - 0.1 * d->get_dang_slosh_theta() + 0.05 * d->get_WBIB()(1);
+    };
+    dm.grab_ddang_slosh_psi = [d] {
+        return -5.0 * d->get_ang_slosh_psi() - 0.1 * d->get_dang_slosh_psi() + 0.05 * d->get_WBIB()(2);
+    };
+    dm.grab_xcg_0 = [] {
+        arma::vec3 xcg(arma::fill::zeros);
+        xcg(0) = 8.0;
+        return xcg;
+    };
+    dm.collect_forces_and_propagate = [] {};
+    dm.grab_dvba = [] { return 0.0; };
+    dm.grab_grav = [] { return 9.80665; };
+    dm.grab_VAED = [] { return arma::vec3(arma::fill::zeros); };
+    dm.grab_FAPB = [] { return arma::vec3(arma::fill::zeros); };
+    dm.grab_Q_TVC = [] { return arma::vec6(arma::fill::zeros); };
+}
+
+int main() {
+    Rocket_Flight_DM dm;
+    wire(dm);
+    dm.load_location(120.8901, 22.2508, 10.0);
+    dm.load_angle(-90.0, 0.0, 85.0);
+    dm.load_geodetic_velocity(0.0, 0.0, 0.0);
+    dm.load_angular_velocity(0.0, 0.0, 0.0);
+    dm.load_coning_var(0.0, 0.0);
+    dm.set_reference_point(-8.436);
+    dm.initialize();
+
+    for (int n = 0; n < N_STEPS; n++)
+        dm.propagate(INT_STEP);
+
+    arma::vec3 SBII = dm.get_SBII(), VBII = dm.get_VBII(), WBIB = dm.get_WBIB();
+    arma::mat TBI = dm.get_TBI();
+    const double result[] = {
+        SBII(0), SBII(1), SBII(2), VBII(0), VBII(1), VBII(2), WBIB(0), WBIB(1), WBIB(2),
+        TBI(0, 0), TBI(1, 2), TBI(2, 1),
+        dm.get_ang_slosh_theta(), dm.get_dang_slosh_theta(), dm.get_ang_slosh_psi(), dm.get_dang_slosh_psi()
+    };
+
+    int failed = 0;
+    fprintf(stderr, "** Rocket_Flight_DM RK4 against the former stage-by-stage RK4, %d steps **\n", N_STEPS);
+    for (size_t i = 0; i < sizeof(reference) / sizeof(reference[0]); i++) {
+        double err = fabs(result[i] - reference[i].value) / fabs(reference[i].value);
+        int ok = err <= TOLERANCE;
+        failed += !ok;
+        fprintf(stderr, "%s %-16s %.17g (reference %.17g)\n", ok ? "PASS" : "FAIL",
+                reference[i].name, result[i], reference[i].value);
+    }
+    return failed ? 1 : 0;
+}
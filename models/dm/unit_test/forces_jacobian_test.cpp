@@ -0,0 +1,215 @@
+#include "Force.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+ * Analytic against finite difference Jacobian of the Forces generalized
+ * acceleration equations, for the rigid body, slosh, TWD and slosh + TWD
+ * configurations at randomly sampled flight states.
+ *
+ * For each state the solve is run in jacobian mode 2 (analytic, checked
+ * against fdjac()), mode 1 (analytic) and mode 0 (finite difference); the
+ * Jacobians and the solutions must agree.
+ */
+
+static const int N_SAMPLES = 200;
+
+/* Forces only keeps the Propulsion / TVC references, it never calls them here */
+alignas(Propulsion) static char propulsion_mem[sizeof(Propulsion)];
+alignas(TVC) static char tvc_mem[sizeof(TVC)];
+
+struct FlightState {
+    arma::mat33 TBI, IBBB, I_E[4];
+    arma::vec3 WBIB, GRAVG, NEXT_ACC, FSPB, XCG, xcp;
+    arma::vec6 Q_TVC;
+    double vmass, oxidizer_mass, pdynmc, coef[6];
+    double ang_slosh[2], dang_slosh[2];
+    double ang_e[4], dang_e[4], act_acc[4], e_mass[4], e_xcg[4];
+    unsigned int liftoff;
+};
+
+static double uniform(double lo, double hi) {
+    return lo + (hi - lo) * (rand() / static_cast<double>(RAND_MAX));
+}
+
+static arma::mat33 rotation(double phi, double tht, double psi) {
+    arma::mat33 T;
+    T(0, 0) = cos(psi) * cos(tht);
+    T(0, 1) = sin(psi) * cos(tht);
+    T(0, 2) = -sin(tht);
+    T(1, 0) = cos(psi) * sin(tht) * sin(phi) - sin(psi) * cos(phi);
+    T(1, 1) = sin(psi) * sin(tht) * sin(phi) + cos(psi) * cos(phi);
+    T(1, 2) = cos(tht) * sin(phi);
+    T(2, 0) = cos(psi) * sin(tht) * cos(phi) + sin(psi) * sin(phi);
+    T(2, 1) = sin(psi) * sin(tht) * cos(phi) - cos(psi) * sin(phi);
+    T(2, 2) = cos(tht) * cos(phi);
+    return T;
+}
+
+static arma::mat33 inertia(double roll, double pitch, double yaw) {
+    arma::mat33 I;
+    I.zeros();
+    I(0, 0) = roll;
+    I(1, 1) = pitch;
+    I(2, 2) = yaw;
+    I(0, 1) = I(1, 0) = uniform(-0.01, 0.01) * roll;
+    return I;
+}
+
+/* S2 burn: stage mass, MOI, actuator and slosh ranges of the flight decks */
+static void sample(FlightState &s) {
+    s.TBI = rotation(uniform(-M_PI, M_PI), uniform(-M_PI / 2, M_PI / 2), uniform(-M_PI, M_PI));
+    s.vmass = uniform(2000.0, 5000.0);
+    s.IBBB = inertia(uniform(300.0, 1000.0), uniform(14000.0, 22000.0), uniform(14000.0, 22000.0));
+    for (int i = 0; i < 3; i++) {
+        s.WBIB(i) = uniform(-0.2, 0.2);
+        s.GRAVG(i) = uniform(-9.8, 9.8);
+        s.NEXT_ACC(i) = uniform(-30.0, 30.0);
+        s.XCG(i) = (i == 0) ? uniform(5.5, 7.0) : uniform(-0.01, 0.01);
+    }
+    s.FSPB(0) = uniform(-60.0, -5.0);
+    s.FSPB(1) = uniform(-1.0, 1.0);
+    s.FSPB(2) = uniform(-1.0, 1.0);
+    s.xcp(0) = uniform(3.0, 8.0);
+    s.xcp(1) = s.xcp(2) = 0.0;
+    for (int i = 0; i < 6; i++) {
+        s.Q_TVC(i) = uniform(-2.0e4, 2.0e4);
+        s.coef[i] = uniform(-0.5, 0.5);
+    }
+    s.pdynmc = uniform(0.0, 5.0e4);
+    s.oxidizer_mass = uniform(200.0, 1500.0);
+    for (int i = 0; i < 2; i++) {
+        s.ang_slosh[i] = uniform(-0.2, 0.2);
+        s.dang_slosh[i] = uniform(-0.5, 0.5);
+    }
+    for (int k = 0; k < 4; k++) {
+        s.ang_e[k] = uniform(-0.12, 0.12);
+        s.dang_e[k] = uniform(-0.3, 0.3);
+        s.act_acc[k] = uniform(-6.0, 6.0);
+        s.e_mass[k] = uniform(8.0, 12.0);
+        s.e_xcg[k] = uniform(0.6, 0.8);
+        s.I_E[k] = inertia(uniform(1.0, 2.0), uniform(20.0, 70.0), uniform(20.0, 70.0));
+    }
+    s.liftoff = rand() % 2;
+}
+
+static void connect(Forces &forces, const FlightState &s) {
+    forces.grab_TBI = [&s]() { return s.TBI; };
+    forces.grab_IBBB = [&s]() { return s.IBBB; };
+    forces.grab_vmass = [&s]() { return s.vmass; };
+    forces.grab_WBIB = [&s]() { return s.WBIB; };
+    forces.grab_GRAVG = [&s]() { return s.GRAVG; };
+    forces.grab_NEXT_ACC = [&s]() { return s.NEXT_ACC; };
+    forces.grab_FSPB = [&s]() { return s.FSPB; };
+    forces.grab_structure_XCG = [&s]() { return s.XCG; };
+    forces.grab_xcp = [&s]() { return s.xcp; };
+    forces.grab_Q_TVC = [&s]() { return s.Q_TVC; };
+    forces.grab_liftoff = [&s]() { return s.liftoff; };
+    forces.grab_thrust = []() { return 0.0; };
+    forces.grab_pdynmc = [&s]() { return s.pdynmc; };
+    forces.grab_refa = []() { return 0.8659; };
+    forces.grab_refd = []() { return 1.05; };
+    forces.grab_cx = [&s]() { return s.coef[0]; };
+    forces.grab_cy = [&s]() { return s.coef[1]; };
+    forces.grab_cz = [&s]() { return s.coef[2]; };
+    forces.grab_cll = [&s]() { return s.coef[3]; };
+    forces.grab_clm = [&s]() { return s.coef[4]; };
+    forces.grab_cln = [&s]() { return s.coef[5]; };
+    forces.grab_oxidizer_mass = [&s]() { return s.oxidizer_mass; };
+    forces.grab_ang_slosh_theta = [&s]() { return s.ang_slosh[0]; };
+    forces.grab_ang_slosh_psi = [&s]() { return s.ang_slosh[1]; };
+    forces.grab_dang_slosh_theta = [&s]() { return s.dang_slosh[0]; };
+    forces.grab_dang_slosh_psi = [&s]() { return s.dang_slosh[1]; };
+    forces.grab_ang_e1_theta = [&s]() { return s.ang_e[0]; };
+    forces.grab_ang_e2_psi = [&s]() { return s.ang_e[1]; };
+    forces.grab_ang_e3_theta = [&s]() { return s.ang_e[2]; };
+    forces.grab_ang_e4_psi = [&s]() { return s.ang_e[3]; };
+    forces.grab_dang_e1_B = [&s]() { return s.dang_e[0]; };
+    forces.grab_dang_e2_B = [&s]() { return s.dang_e[1]; };
+    forces.grab_dang_e3_B = [&s]() { return s.dang_e[2]; };
+    forces.grab_dang_e4_B = [&s]() { return s.dang_e[3]; };
+    forces.grab_s2_act1_acc = [&s]() { return s.act_acc[0]; };
+    forces.grab_s2_act2_acc = [&s]() { return s.act_acc[1]; };
+    forces.grab_s2_act3_acc = [&s]() { return s.act_acc[2]; };
+    forces.grab_s2_act4_acc = [&s]() { return s.act_acc[3]; };
+    forces.grab_e1_mass = [&s]() { return s.e_mass[0]; };
+    forces.grab_e2_mass = [&s]() { return s.e_mass[1]; };
+    forces.grab_e3_mass = [&s]() { return s.e_mass[2]; };
+    forces.grab_e4_mass = [&s]() { return s.e_mass[3]; };
+    forces.grab_e1_XCG = [&s]() { return s.e_xcg[0]; };
+    forces.grab_e2_XCG = [&s]() { return s.e_xcg[1]; };
+    forces.grab_e3_XCG = [&s]() { return s.e_xcg[2]; };
+    forces.grab_e4_XCG = [&s]() { return s.e_xcg[3]; };
+    forces.grab_I_S2_E1 = [&s]() { return s.I_E[0]; };
+    forces.grab_I_S2_E2 = [&s]() { return s.I_E[1]; };
+    forces.grab_I_S2_E3 = [&s]() { return s.I_E[2]; };
+    forces.grab_I_S2_E4 = [&s]() { return s.I_E[3]; };
+}
+
+static double max_diff(const arma::vec &a, const arma::vec &b) {
+    double d = 0.0;
+    for (int i = 0; i < 3; i++)
+        d = fmax(d, fabs(a(i) - b(i)) / fmax(1.0, fabs(a(i))));
+    return d;
+}
+
+static int check_configuration(const char *name, unsigned int slosh, unsigned int twd, int dof) {
+    Forces forces(*reinterpret_cast<Propulsion *>(propulsion_mem), *reinterpret_cast<TVC *>(tvc_mem));
+    FlightState s;
+    double jac_err = 0.0, sol_err = 0.0;
+    long fcalls_fd = 0, fcalls_analytic = 0;
+
+    connect(forces, s);
+    forces.set_Slosh_flag(slosh);
+    forces.set_TWD_flag(twd);
+    forces.set_DOF(dof);
+    forces.set_aero_flag(1);
+    forces.set_damping_ratio(0.005);
+    forces.set_reference_point(-8.55);
+    forces.set_e1_d(0.0, 0.0, -0.425);
+    forces.set_e2_d(0.0, 0.425, 0.0);
+    forces.set_e3_d(0.0, 0.0, 0.425);
+    forces.set_e4_d(0.0, -0.425, 0.0);
+    forces.set_broydn_warm_start(0);
+
+    for (int i = 0; i < N_SAMPLES; i++) {
+        sample(s);
+
+        forces.set_jacobian_mode(2);
+        forces.collect_forces_and_propagate();
+        jac_err = fmax(jac_err, forces.get_jacobian_error());
+
+        forces.set_jacobian_mode(1);
+        forces.collect_forces_and_propagate();
+        fcalls_analytic += forces.get_broydn_fcalls();
+        arma::vec ddrP = forces.get_ddrP_1();
+        arma::vec ddang = forces.get_ddang_1();
+
+        forces.set_jacobian_mode(0);
+        forces.collect_forces_and_propagate();
+        fcalls_fd += forces.get_broydn_fcalls();
+        sol_err = fmax(sol_err, max_diff(forces.get_ddrP_1(), ddrP));
+        sol_err = fmax(sol_err, max_diff(forces.get_ddang_1(), ddang));
+    }
+
+    int ok = (jac_err < 1e-6) && (sol_err < 1e-6);
+    fprintf(stderr, "%s %-12s DOF %2d: Jacobian error %.1e, solution error %.1e, function calls %.1f -> %.1f\n",
+            ok ? "PASS" : "FAIL", name, dof, jac_err, sol_err,
+            static_cast<double>(fcalls_fd) / N_SAMPLES, static_cast<double>(fcalls_analytic) / N_SAMPLES);
+    return !ok;
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = 0;
+
+    srand(20181017);
+    fprintf(stderr, "** Forces analytic Jacobian test **\n");
+    failed += check_configuration("rigid body", 0, 0, 6);
+    failed += check_configuration("slosh", 1, 0, 8);
+    failed += check_configuration("TWD", 0, 1, 10);
+    failed += check_configuration("slosh + TWD", 1, 1, 12);
+
+    return failed ? 1 : 0;
+}
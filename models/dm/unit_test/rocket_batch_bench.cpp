@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "rocket_batch_scalar.hh"
+
+/*
+ * Throughput of a dispersion batch in trajectories x steps per second:
+ *
+ * scalar : one trajectory after the other, Environment/Rocket_Flight_DM
+ *          style (scalar kernels, rk4_step())
+ * batch  : Rocket_Batch_DM, simd_double::WIDTH trajectories per operation
+ *
+ * Both include the environment (gravity, altitude, atmosphere) of every
+ * frame. Harmonic gravity at degree 2 and at the full 20 x 20 field.
+ */
+
+static const int N_TRAJ = 1024;
+static const int N_STEPS = 200;
+static const double INT_STEP = 0.005;
+
+int main() {
+    const int degrees[] = { 2, 20 };
+    gravity_harmonic_work work;
+    cad::Atmosphere76 atmosphere;
+    double TEI[3][3];
+    int failed = 0;
+
+    fprintf(stderr, "** Rocket_Batch_DM benchmark, %d trajectories x %d steps, %d lanes **\n",
+            N_TRAJ, N_STEPS, Rocket_Batch_DM::WIDTH);
+
+    for (int d = 0; d < 2; d++) {
+        int n = degrees[d];
+        std::vector<scalar_trajectory> scalar(N_TRAJ);
+        Rocket_Batch_DM batch(N_TRAJ);
+
+        batch.set_gravity_harmonic(n, n, 0);
+        for (int i = 0; i < N_TRAJ; i++) {
+            scalar_trajectory_init(&scalar[i], i);
+            scalar_trajectory_load(&batch, i, &scalar[i]);
+        }
+
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (int step = 0; step < N_STEPS; step++) {
+            scalar_trajectory_TEI(step * INT_STEP, TEI);
+            for (int i = 0; i < N_TRAJ; i++)
+                scalar_trajectory_step(&scalar[i], TEI, INT_STEP, n, n, NULL, &work, &atmosphere);
+        }
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        for (int step = 0; step < N_STEPS; step++) {
+            scalar_trajectory_TEI(step * INT_STEP, TEI);
+            batch.environment(TEI);
+            batch.propagate(INT_STEP);
+        }
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+        int mismatch = 0;
+        for (int i = 0; i < N_TRAJ; i++) {
+            for (int f = 0; f < Rocket_Batch_DM::N_STATE; f++) {
+                if (batch.field(f)[i] != scalar[i].y[f])
+                    mismatch++;
+            }
+        }
+
+        double work_units = static_cast<double>(N_TRAJ) * N_STEPS;
+        double s_scalar = std::chrono::duration<double>(t1 - t0).count();
+        double s_batch = std::chrono::duration<double>(t2 - t1).count();
+        fprintf(stderr, "degree %2d  scalar %10.0f traj*steps/s  batch %10.0f traj*steps/s  x%.2f  %s\n",
+                n, work_units / s_scalar, work_units / s_batch, s_scalar / s_batch,
+                mismatch ? "MISMATCH" : "match");
+        failed += mismatch;
+    }
+    return failed ? 1 : 0;
+}
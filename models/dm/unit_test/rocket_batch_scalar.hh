@@ -0,0 +1,121 @@
+#ifndef __ROCKET_BATCH_SCALAR_HH__
+#define __ROCKET_BATCH_SCALAR_HH__
+/*
+ * One trajectory of Rocket_Batch_DM built from the scalar models: the
+ * gravity_harmonic_accel() kernel of Environment::AccelHarmonic(),
+ * cad::geo84_lat_alt(), cad::Atmosphere76 and rk4_step() of
+ * Rocket_Flight_DM::RK4(). Shared by rocket_batch_test and
+ * rocket_batch_bench.
+ */
+#include <cmath>
+#include <cstring>
+
+#include "Rocket_Batch_DM.hh"
+#include "global_constants.hh"
+#include "cad_utility.hh"
+#include "env/atmosphere76.hh"
+#include "env/gravity_harmonic.h"
+#include "rk4.hh"
+
+struct scalar_trajectory {
+    double y[Rocket_Batch_DM::N_STATE];
+    double VBII[3];
+    double vmass, IBBB[3], FAPB[3], ca_refa, FMB[3];
+    double GRAVG[3], alt, rho, vsound, dvba, vmach, pdynmc;
+};
+
+/* Trajectory i of a dispersed batch: a vehicle climbing through 10 km */
+static void scalar_trajectory_init(scalar_trajectory *t, int i) {
+    double s = sin(1.7 * i + 0.3), c = cos(0.9 * i + 1.1);
+    double lat = 0.4 + 0.05 * s, lon = 2.1 + 0.05 * c;
+    double rad = SMAJOR_AXIS + 1.0e4 + 500.0 * s;
+    double u[3] = { cos(lat) * cos(lon), cos(lat) * sin(lon), sin(lat) };
+    double q_norm;
+
+    memset(t, 0, sizeof(*t));
+    for (int k = 0; k < 3; k++) {
+        t->y[Rocket_Batch_DM::SBIIP + k] = rad * u[k];
+        t->y[Rocket_Batch_DM::VBIIP + k] = (600.0 + 20.0 * c) * u[k];
+        t->y[Rocket_Batch_DM::WBIB + k] = 1.0e-3 * (k + 1) * s;
+        t->VBII[k] = t->y[Rocket_Batch_DM::VBIIP + k];
+    }
+    t->y[Rocket_Batch_DM::TBI_Q + 0] = 0.5 + 0.1 * s;
+    t->y[Rocket_Batch_DM::TBI_Q + 1] = 0.5 - 0.1 * c;
+    t->y[Rocket_Batch_DM::TBI_Q + 2] = 0.5;
+    t->y[Rocket_Batch_DM::TBI_Q + 3] = -0.5 + 0.05 * c;
+    q_norm = 0.0;
+    for (int k = 0; k < 4; k++)
+        q_norm += t->y[Rocket_Batch_DM::TBI_Q + k] * t->y[Rocket_Batch_DM::TBI_Q + k];
+    for (int k = 0; k < 4; k++)
+        t->y[Rocket_Batch_DM::TBI_Q + k] /= sqrt(q_norm);
+
+    t->vmass = 3000.0 + 100.0 * s;
+    t->IBBB[0] = 400.0 + 10.0 * c;
+    t->IBBB[1] = 9000.0 + 300.0 * s;
+    t->IBBB[2] = 9100.0 - 200.0 * c;
+    t->FAPB[0] = 9.0e4 + 2.0e3 * s;
+    t->FAPB[1] = 150.0 * c;
+    t->FAPB[2] = -80.0 * s;
+    t->ca_refa = 0.3 + 0.02 * c;
+    t->FMB[0] = 5.0 * s;
+    t->FMB[1] = 120.0 * c;
+    t->FMB[2] = -90.0 * s;
+}
+
+/* ECI to ECEF, the earth rotation only */
+static void scalar_trajectory_TEI(double t, double TEI[3][3]) {
+    double a = WEII3 * t;
+    memset(TEI, 0, 9 * sizeof(double));
+    TEI[0][0] = cos(a);
+    TEI[0][1] = sin(a);
+    TEI[1][0] = -sin(a);
+    TEI[1][1] = cos(a);
+    TEI[2][2] = 1.0;
+}
+
+/* Environment::propagate() followed by Rocket_Flight_DM::RK4() */
+static void scalar_trajectory_step(scalar_trajectory *t, const double TEI[3][3], double int_step,
+                                   int n_max, int m_max, const gravity_harmonic_coef *coef,
+                                   gravity_harmonic_work *work, cad::Atmosphere76 *atmosphere) {
+    const double *S = t->y + Rocket_Batch_DM::SBIIP;
+    double r_bf[3], a_bf[3], FSPB[3], cur[Rocket_Batch_DM::N_STATE];
+
+    for (int k = 0; k < 3; k++)
+        r_bf[k] = TEI[k][0] * S[0] + TEI[k][1] * S[1] + TEI[k][2] * S[2];
+    gravity_harmonic_accel(r_bf, GRAVITY_CS_JGM3, n_max, m_max, GM, SMAJOR_AXIS, coef, work, a_bf);
+    for (int k = 0; k < 3; k++)
+        t->GRAVG[k] = TEI[0][k] * a_bf[0] + TEI[1][k] * a_bf[1] + TEI[2][k] * a_bf[2];
+
+    double lat;
+    std::tie(lat, t->alt) = cad::geo84_lat_alt(r_bf);
+    atmosphere->set_altitude(t->alt);
+    t->rho = atmosphere->get_density();
+    t->vsound = atmosphere->get_speed_of_sound();
+    double VBA[3] = { t->VBII[0] + WEII3 * S[1], t->VBII[1] - WEII3 * S[0], t->VBII[2] };
+    t->dvba = sqrt(VBA[0] * VBA[0] + VBA[1] * VBA[1] + VBA[2] * VBA[2]);
+    t->vmach = t->dvba / t->vsound;
+    t->pdynmc = 0.5 * t->rho * t->dvba * t->dvba;
+
+    FSPB[0] = t->FAPB[0] - t->pdynmc * t->ca_refa;
+    FSPB[1] = t->FAPB[1];
+    FSPB[2] = t->FAPB[2];
+    for (int k = 0; k < 3; k++)
+        FSPB[k] = FSPB[k] / t->vmass;
+
+    memcpy(cur, t->y, sizeof(cur));
+    rk4_step<Rocket_Batch_DM::N_STATE>(t->y, int_step,
+        [&](double *dy) { rocket_batch_rates(cur, t->VBII, FSPB, t->IBBB, t->FMB, t->GRAVG, dy); },
+        [&](const double *ys) { memcpy(cur, ys, sizeof(cur)); });
+    for (int k = 0; k < 3; k++)
+        t->VBII[k] = t->y[Rocket_Batch_DM::VBIIP + k];
+}
+
+/* Load scalar trajectory i into the batch */
+static void scalar_trajectory_load(Rocket_Batch_DM *batch, int i, const scalar_trajectory *t) {
+    batch->load_state(i, t->y + Rocket_Batch_DM::SBIIP, t->y + Rocket_Batch_DM::VBIIP,
+                      t->y + Rocket_Batch_DM::WBIB, t->y + Rocket_Batch_DM::TBI_Q);
+    batch->load_mass_properties(i, t->vmass, t->IBBB);
+    batch->load_loads(i, t->FAPB, t->ca_refa, t->FMB);
+}
+
+#endif  // __ROCKET_BATCH_SCALAR_HH__
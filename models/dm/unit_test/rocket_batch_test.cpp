@@ -0,0 +1,278 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "rocket_batch_scalar.hh"
+#include "Rocket_Flight_DM.hh"
+
+/*
+ * Rocket_Batch_DM against N independent scalar trajectories.
+ *
+ * N is not a multiple of the lane width, so the last block carries padding
+ * lanes. Every frame the environment and the RK4 state of each trajectory
+ * must match its scalar run bit for bit.
+ *
+ * Then a few trajectories against Rocket_Flight_DM::RK4F() and RK4() over
+ * N_DM_STEPS frames: the rates at the start of every frame and the state
+ * after it, to DM_TOLERANCE.
+ */
+
+static const int N_TRAJ = 37;
+static const int N_STEPS = 4000;      /* 20 s */
+static const double INT_STEP = 0.005;
+static const int N_DM_STEPS = 200;    /* 1 s */
+static const double DM_TOLERANCE = 1.0e-12;  /* relative; arma and the quaternion matrix round differently */
+
+/* DM hooks not exercised by RK4() */
+extern "C" double exec_get_sim_time(void) { return 0.0; }
+extern "C" int icf_tx_enqueue(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t size) { return 0; }
+extern "C" int simgen_sender_push(struct simgen_sender_t *S, const struct simgen_motion_data_t *m) { return 0; }
+
+/* Loads of a batch trajectory held over the frame, as propagate() holds them */
+struct dm_loads {
+    double FSPB[3];
+    double IBBB[3];
+    double FMB[3];
+    double GRAVG[3];
+};
+
+/* The private RK4 of the DM, reached through the friend of TRICK_INTERFACE */
+class InputProcessor {
+ public:
+    static const int RK4_N = Rocket_Flight_DM::RK4_N;
+
+    static void load(Rocket_Flight_DM &dm, const double y[], const double VBII[3]) {
+        double y_dm[RK4_N] = { 0.0 };
+        memcpy(y_dm, y, Rocket_Batch_DM::N_STATE * sizeof(double));
+        dm.load_rk4_state(y_dm);
+        for (int k = 0; k < 3; k++) {
+            dm.VBII(k) = VBII[k];
+            dm.SBII(k) = y[Rocket_Batch_DM::SBIIP + k];
+        }
+        dm.set_liftoff(1);
+        dm.set_reference_point(0.0);
+    }
+
+    static void rates(Rocket_Flight_DM &dm, const double GRAVG[3], const double TEI[3][3], double dy[]) {
+        double y_dm[RK4_N];
+        dm.save_rk4_state(y_dm);
+        dm.RK4F(gravg(GRAVG), tei(TEI), dy);
+        dm.load_rk4_state(y_dm);
+    }
+
+    static void step(Rocket_Flight_DM &dm, const double GRAVG[3], const double TEI[3][3], double int_step) {
+        dm.RK4(gravg(GRAVG), tei(TEI), int_step);
+    }
+
+    static void save(Rocket_Flight_DM &dm, double y[], double VBII[3]) {
+        double y_dm[RK4_N];
+        dm.save_rk4_state(y_dm);
+        memcpy(y, y_dm, Rocket_Batch_DM::N_STATE * sizeof(double));
+        for (int k = 0; k < 3; k++)
+            VBII[k] = dm.VBII(k);
+    }
+
+ private:
+    static arma::vec3 gravg(const double GRAVG[3]) {
+        arma::vec3 G;
+        for (int k = 0; k < 3; k++)
+            G(k) = GRAVG[k];
+        return G;
+    }
+
+    static arma::mat33 tei(const double TEI[3][3]) {
+        arma::mat33 T;
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 3; c++)
+                T(r, c) = TEI[r][c];
+        return T;
+    }
+};
+
+/* Forces of the DM from the held loads: ddrP_1 = TBI^T FSPB + GRAVG, ddang_1 the Euler equations */
+static void wire(Rocket_Flight_DM &dm, const dm_loads &L) {
+    Rocket_Flight_DM *d = &dm;
+
+    dm.grab_ddrP_1 = [d, &L] {
+        arma::vec3 FSPB, GRAVG;
+        for (int k = 0; k < 3; k++) {
+            FSPB(k) = L.FSPB[k];
+            GRAVG(k) = L.GRAVG[k];
+        }
+        return arma::vec3(trans(d->get_TBI()) * FSPB + GRAVG);
+    };
+    dm.grab_ddang_1 = [d, &L] {
+        arma::vec3 WBIB = d->get_WBIB(), IW, WBIBD;
+        for (int k = 0; k < 3; k++)
+            IW(k) = L.IBBB[k] * WBIB(k);
+        arma::vec3 gyro = cross(WBIB, IW);
+        for (int k = 0; k < 3; k++)
+            WBIBD(k) = (L.FMB[k] - gyro(k)) / L.IBBB[k];
+        return WBIBD;
+    };
+    dm.grab_xcg_0 = [] { return arma::vec3(arma::fill::zeros); };
+    dm.grab_vmass = [] { return 1.0; };
+    dm.grab_thrust = [] { return 0.0; };
+    dm.grab_ddang_slosh_theta = [] { return 0.0; };
+    dm.grab_ddang_slosh_psi = [] { return 0.0; };
+    dm.collect_forces_and_propagate = [] {};
+}
+
+static int dm_close(const char *what, int step, int i, int f, double batch, double dm) {
+    double scale = fmax(fabs(batch), fabs(dm));
+    if (fabs(batch - dm) <= DM_TOLERANCE * scale)
+        return 1;
+    fprintf(stderr, "step %d trajectory %d %s %d: batch %.17g Rocket_Flight_DM %.17g\n",
+            step, i, what, f, batch, dm);
+    return 0;
+}
+
+struct gravity_case {
+    int n_max;
+    int m_max;
+    int use_coef;
+};
+
+static int check(const Rocket_Batch_DM &batch, int i, const scalar_trajectory &t, int step) {
+    static const int fields[] = { Rocket_Batch_DM::GRAVG, Rocket_Batch_DM::GRAVG + 1, Rocket_Batch_DM::GRAVG + 2,
+                                  Rocket_Batch_DM::ALT, Rocket_Batch_DM::RHO, Rocket_Batch_DM::VSOUND,
+                                  Rocket_Batch_DM::DVBA, Rocket_Batch_DM::VMACH, Rocket_Batch_DM::PDYNMC };
+    const double expect[] = { t.GRAVG[0], t.GRAVG[1], t.GRAVG[2], t.alt, t.rho, t.vsound,
+                              t.dvba, t.vmach, t.pdynmc };
+
+    for (int f = 0; f < Rocket_Batch_DM::N_STATE; f++) {
+        if (memcmp(&batch.field(f)[i], &t.y[f], sizeof(double)) != 0) {
+            fprintf(stderr, "step %d trajectory %d state %d: batch %.17g scalar %.17g\n",
+                    step, i, f, batch.field(f)[i], t.y[f]);
+            return 1;
+        }
+    }
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        if (memcmp(&batch.field(fields[f])[i], &expect[f], sizeof(double)) != 0) {
+            fprintf(stderr, "step %d trajectory %d field %d: batch %.17g scalar %.17g\n",
+                    step, i, fields[f], batch.field(fields[f])[i], expect[f]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int run_case(const gravity_case &g) {
+    std::vector<scalar_trajectory> scalar(N_TRAJ);
+    Rocket_Batch_DM batch(N_TRAJ);
+    gravity_harmonic_coef coef;
+    gravity_harmonic_work work;
+    cad::Atmosphere76 atmosphere;
+    double TEI[3][3];
+    double max_alt = 0.0;
+
+    gravity_harmonic_coef_init(&coef);
+    batch.set_gravity_harmonic(g.n_max, g.m_max, g.use_coef);
+    for (int i = 0; i < N_TRAJ; i++) {
+        scalar_trajectory_init(&scalar[i], i);
+        scalar_trajectory_load(&batch, i, &scalar[i]);
+    }
+
+    for (int step = 0; step < N_STEPS; step++) {
+        scalar_trajectory_TEI(step * INT_STEP, TEI);
+
+        batch.environment(TEI);
+        batch.propagate(INT_STEP);
+        for (int i = 0; i < N_TRAJ; i++) {
+            scalar_trajectory_step(&scalar[i], TEI, INT_STEP, g.n_max, g.m_max,
+                                   g.use_coef ? &coef : NULL, &work, &atmosphere);
+            if (check(batch, i, scalar[i], step) != 0)
+                return 1;
+        }
+    }
+    for (int i = 0; i < N_TRAJ; i++)
+        max_alt = fmax(max_alt, scalar[i].alt);
+    fprintf(stderr, "gravity %2d x %2d %s: %d trajectories x %d steps match, top altitude %.0f m\n",
+            g.n_max, g.m_max, g.use_coef ? "coef " : "plain", N_TRAJ, N_STEPS, max_alt);
+    return 0;
+}
+
+static int run_flight_dm() {
+    static const int traj[] = { 0, 5, N_TRAJ - 1 };
+    static const int N_DM = sizeof(traj) / sizeof(traj[0]);
+    Rocket_Batch_DM batch(N_TRAJ);
+    std::vector<Rocket_Flight_DM> dm(N_DM);
+    dm_loads loads[N_DM];
+    double TEI[3][3];
+
+    for (int i = 0; i < N_TRAJ; i++) {
+        scalar_trajectory t;
+        scalar_trajectory_init(&t, i);
+        scalar_trajectory_load(&batch, i, &t);
+        for (int d = 0; d < N_DM; d++) {
+            if (traj[d] != i)
+                continue;
+            wire(dm[d], loads[d]);
+            InputProcessor::load(dm[d], t.y, t.VBII);
+        }
+    }
+
+    for (int step = 0; step < N_DM_STEPS; step++) {
+        scalar_trajectory_TEI(step * INT_STEP, TEI);
+        batch.environment(TEI);
+
+        for (int d = 0; d < N_DM; d++) {
+            const int i = traj[d];
+            dm_loads &L = loads[d];
+            double y[Rocket_Batch_DM::N_STATE], VBII[3], dy_batch[Rocket_Batch_DM::N_STATE];
+            double dy_dm[InputProcessor::RK4_N];
+            double vmass = batch.field(Rocket_Batch_DM::VMASS)[i];
+
+            for (int k = 0; k < 3; k++) {
+                L.FSPB[k] = batch.field(Rocket_Batch_DM::FAPB + k)[i];
+                L.IBBB[k] = batch.field(Rocket_Batch_DM::IBBB + k)[i];
+                L.FMB[k] = batch.field(Rocket_Batch_DM::FMB + k)[i];
+                L.GRAVG[k] = batch.field(Rocket_Batch_DM::GRAVG + k)[i];
+                VBII[k] = batch.field(Rocket_Batch_DM::VBII + k)[i];
+            }
+            L.FSPB[0] -= batch.field(Rocket_Batch_DM::PDYNMC)[i] * batch.field(Rocket_Batch_DM::CA_REFA)[i];
+            for (int k = 0; k < 3; k++)
+                L.FSPB[k] /= vmass;
+            for (int f = 0; f < Rocket_Batch_DM::N_STATE; f++)
+                y[f] = batch.field(f)[i];
+
+            rocket_batch_rates(y, VBII, L.FSPB, L.IBBB, L.FMB, L.GRAVG, dy_batch);
+            InputProcessor::rates(dm[d], L.GRAVG, TEI, dy_dm);
+            for (int f = 0; f < Rocket_Batch_DM::N_STATE; f++)
+                if (!dm_close("rate", step, i, f, dy_batch[f], dy_dm[f]))
+                    return 1;
+
+            InputProcessor::step(dm[d], L.GRAVG, TEI, INT_STEP);
+        }
+        batch.propagate(INT_STEP);
+
+        for (int d = 0; d < N_DM; d++) {
+            const int i = traj[d];
+            double y[Rocket_Batch_DM::N_STATE], VBII[3];
+
+            InputProcessor::save(dm[d], y, VBII);
+            for (int f = 0; f < Rocket_Batch_DM::N_STATE; f++)
+                if (!dm_close("state", step, i, f, batch.field(f)[i], y[f]))
+                    return 1;
+            for (int k = 0; k < 3; k++)
+                if (!dm_close("VBII", step, i, k, batch.field(Rocket_Batch_DM::VBII + k)[i], VBII[k]))
+                    return 1;
+        }
+    }
+    fprintf(stderr, "Rocket_Flight_DM RK4F/RK4: %d trajectories x %d steps within %.0e\n",
+            N_DM, N_DM_STEPS, DM_TOLERANCE);
+    return 0;
+}
+
+int main() {
+    const gravity_case cases[] = { { 20, 20, 0 }, { 8, 8, 1 }, { 2, 0, 0 } };
+    int failed = 0;
+
+    fprintf(stderr, "** Rocket_Batch_DM test, %d lanes **\n", Rocket_Batch_DM::WIDTH);
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+        failed += run_case(cases[c]);
+    failed += run_flight_dm();
+    fprintf(stderr, "%s\n", failed ? "FAILED" : "PASSED");
+    return failed ? 1 : 0;
+}
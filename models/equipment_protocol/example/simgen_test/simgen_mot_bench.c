@@ -0,0 +1,161 @@
+#include "simgen_remote.h"
+#include <math.h>
+#include <time.h>
+
+/*
+ * MOT encode cost per sample, as the HIL master pays it every int_step:
+ * the snprintf text command it used to build, the locale free text
+ * encoder and the binary frame. The text encoder must match snprintf byte
+ * for byte on random samples and on rounding corner cases, and both
+ * formats must decode back to the sample.
+ */
+
+#define N_SAMPLES   20000
+#define N_ROUNDS    20
+
+static const char *g_cmd_name[3] = {"MOT", "MOTB", "AIDING_OFFSET"};
+
+/* the snprintf encoder the fast one replaces */
+static int reference_encode(struct simgen_motion_data_t *m, char *buf, int size) {
+    const double *vec[8] = {m->position_xyz, m->velocity_xyz, m->acceleration_xyz, m->jerk_xyz,
+                            m->heb, m->angular_velocity, m->angular_acceleration, m->angular_jerk};
+    int offset, idx;
+
+    snprintf(buf, size, "%07.3f,", m->sim_time.second);
+    offset = strlen(buf);
+    snprintf(buf + offset, size - offset, "%s,%s,", g_cmd_name[m->cmd_idx], VEH_MOT(1));
+    offset = strlen(buf);
+    for (idx = 0; idx < 8; idx++) {
+        snprintf(buf + offset, size - offset, "%20.10f,%20.10f,%20.10f%s",
+                 vec[idx][0], vec[idx][1], vec[idx][2], idx < 7 ? "," : "\n");
+        offset = strlen(buf);
+    }
+    return offset;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double uniform(double lo, double hi) {
+    return lo + (hi - lo) * (rand() / (double)RAND_MAX);
+}
+
+/* magnitudes of a launch: ECEF metres, m/s, m/s^2, radians */
+static void random_sample(struct simgen_motion_data_t *m, int idx) {
+    double *all = m->position_xyz;
+    int k;
+
+    memset(m, 0, sizeof(*m));
+    m->sim_time.second = idx * 0.005;
+    m->cmd_idx = REMOTE_MOTION_CMD_MOT;
+    m->vehicle_id = 1;
+    for (k = 0; k < 3; k++) {
+        m->position_xyz[k] = uniform(-6.5e6, 6.5e6);
+        m->velocity_xyz[k] = uniform(-8e3, 8e3);
+        m->acceleration_xyz[k] = uniform(-60.0, 60.0);
+        m->heb[k] = uniform(-M_PI, M_PI);
+        m->angular_velocity[k] = uniform(-1.0, 1.0);
+    }
+    /* some fields tiny, some exactly on a rounding tie */
+    if (idx % 7 == 0)
+        all[3 + idx % 21] = ldexp(uniform(-1.0, 1.0), -(idx % 60));
+    if (idx % 11 == 0)
+        all[idx % 24] = (idx % 2 ? -1.0 : 1.0) * (floor(uniform(0, 1e6)) + 0.5) * 1e-10;
+}
+
+static int check(const char *what, int ok) {
+    fprintf(stderr, "%s %s\n", ok ? "PASS" : "FAIL", what);
+    return !ok;
+}
+
+static int same_sample(struct simgen_motion_data_t *a, struct simgen_motion_data_t *b, double tol) {
+    const double *x = a->position_xyz, *y = b->position_xyz;
+    int k;
+    if (fabs(a->sim_time.second - b->sim_time.second) > 5e-4 || a->cmd_idx != b->cmd_idx || a->vehicle_id != b->vehicle_id)
+        return 0;
+    for (k = 0; k < 24; k++)
+        if (fabs(x[k] - y[k]) > tol)
+            return 0;
+    return 1;
+}
+
+int main(int argc, char const *argv[]) {
+    static struct simgen_motion_data_t samples[N_SAMPLES];
+    static const double corner[] = {0.0, -0.0, 0.5e-10, -0.5e-10, 1.5e-10, 2.5e-10, 0.99999999995,
+                                    -0.99999999995, 123456.00000000005, 1e-300, -1e-300, 999999999.9999999999,
+                                    1.7e9, -2.5e12, 1e20, INFINITY, -INFINITY, NAN};
+    struct simgen_motion_data_t m, back;
+    struct simgen_mot_bin_frame_t frame;
+    char ref[SIMGEN_MOT_CMD_SIZE], fast[SIMGEN_MOT_CMD_SIZE];
+    double t0, t_ref, t_fast, t_bin;
+    volatile int sink = 0;
+    int idx, round, mismatch = 0, bad_text = 0, bad_bin = 0, failed = 0;
+
+    fprintf(stderr, "** SimGen MOT encode benchmark, %d samples **\n", N_SAMPLES);
+    srand(20180921);
+    for (idx = 0; idx < N_SAMPLES; idx++)
+        random_sample(&samples[idx], idx);
+
+    for (idx = 0; idx < N_SAMPLES; idx++) {
+        reference_encode(&samples[idx], ref, sizeof(ref));
+        simgen_remote_motion_cmd_encode(&samples[idx], fast, sizeof(fast));
+        if (strcmp(ref, fast) != 0) {
+            if (mismatch++ == 0)
+                fprintf(stderr, "     snprintf: %s     encoder:  %s", ref, fast);
+        }
+        if (simgen_remote_motion_cmd_decode(fast, &back) != 0 || !same_sample(&samples[idx], &back, 1e-10))
+            bad_text++;
+        simgen_remote_motion_bin_encode(&samples[idx], &frame);
+        if (simgen_remote_motion_bin_decode(&frame, sizeof(frame), &back) != 0 || !same_sample(&samples[idx], &back, 0.0))
+            bad_bin++;
+    }
+    for (idx = 0; idx < (int)(sizeof(corner) / sizeof(corner[0])); idx++) {
+        memset(&m, 0, sizeof(m));
+        m.sim_time.second = fabs(corner[idx]) < 1e6 ? corner[idx] : 1.0;
+        m.position_xyz[idx % 3] = corner[idx];
+        m.angular_jerk[2] = -corner[idx];
+        reference_encode(&m, ref, sizeof(ref));
+        simgen_remote_motion_cmd_encode(&m, fast, sizeof(fast));
+        if (strcmp(ref, fast) != 0) {
+            if (mismatch++ == 0)
+                fprintf(stderr, "     snprintf: %s     encoder:  %s", ref, fast);
+        }
+    }
+    failed += check("text encoder matches snprintf byte for byte", mismatch == 0);
+    failed += check("text commands decode back within the printed precision", bad_text == 0);
+    failed += check("binary frames decode back exactly", bad_bin == 0);
+
+    m = samples[0];
+    simgen_remote_motion_bin_encode(&m, &frame);
+    frame.cmd_idx = REMOTE_MOTION_CMD_MAX_NUM;
+    m.cmd_idx = REMOTE_MOTION_CMD_MAX_NUM;
+    failed += check("command index out of the command table rejected",
+                    simgen_remote_motion_cmd_encode(&m, fast, sizeof(fast)) == -1
+                    && simgen_remote_motion_bin_encode(&m, &frame) == -1
+                    && simgen_remote_motion_bin_decode(&frame, sizeof(frame), &back) == -1);
+
+    t0 = now_sec();
+    for (round = 0; round < N_ROUNDS; round++)
+        for (idx = 0; idx < N_SAMPLES; idx++)
+            sink += reference_encode(&samples[idx], ref, sizeof(ref));
+    t_ref = (now_sec() - t0) / ((double)N_ROUNDS * N_SAMPLES) * 1e9;
+    t0 = now_sec();
+    for (round = 0; round < N_ROUNDS; round++)
+        for (idx = 0; idx < N_SAMPLES; idx++)
+            sink += simgen_remote_motion_cmd_encode(&samples[idx], fast, sizeof(fast));
+    t_fast = (now_sec() - t0) / ((double)N_ROUNDS * N_SAMPLES) * 1e9;
+    t0 = now_sec();
+    for (round = 0; round < N_ROUNDS; round++)
+        for (idx = 0; idx < N_SAMPLES; idx++)
+            sink += simgen_remote_motion_bin_encode(&samples[idx], &frame);
+    t_bin = (now_sec() - t0) / ((double)N_ROUNDS * N_SAMPLES) * 1e9;
+
+    fprintf(stderr, "     snprintf text  %8.1f ns/sample  %zu bytes\n", t_ref, strlen(ref));
+    fprintf(stderr, "     encoder text   %8.1f ns/sample\n", t_fast);
+    fprintf(stderr, "     binary frame   %8.1f ns/sample  %zu bytes\n", t_bin, sizeof(frame));
+    failed += check("encoder faster than snprintf", t_fast < t_ref);
+    return failed ? 1 : 0;
+}
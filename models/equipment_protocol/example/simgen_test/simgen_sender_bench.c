@@ -0,0 +1,250 @@
+#include "simgen_sender.h"
+#include <math.h>
+
+/*
+ * The motion stream of the HIL master against a local UDP stand-in for
+ * SimGen, which timestamps every binary MOT frame it gets. The producer
+ * runs a PERIOD frame like the DM job, starting up to FRAME_JITTER late as
+ * a loaded Trick frame does; the link stalls STALL_SEC on every
+ * STALL_EVERY-th send, the way a full socket buffer does.
+ *   - inline: the frame job sends itself, as transfer_simgen_motdata() did,
+ *     so the stalls land in the frame and the frame jitter on the wire
+ *   - sender: the frame job only pushes, the sender thread sends on the
+ *     sample timestamps; a stall still delays its own sample
+ * Then a frozen producer (underrun, new time base) and a dead link
+ * (overflow, the producer still never blocks).
+ */
+
+#define PERIOD          0.002
+#define N_SAMPLES       1500
+#define STALL_EVERY     100
+#define STALL_SEC       0.006
+#define FREEZE_AT       700
+#define FREEZE_SEC      0.05
+#define FRAME_JITTER    0.0015
+#define LOOKAHEAD       6
+
+struct standin_t {
+    int tx_fd;
+    int rx_fd;
+    int n_send;
+    int stall_every;
+    double stall;
+    pthread_t thread;
+    int running;
+    int n_rx;
+    double arrival[N_SAMPLES];
+    double sim_time[N_SAMPLES];
+};
+
+struct run_result_t {
+    double job_max;         //  s, worst frame job of the producer
+    double jitter_p50;      //  s, inter-arrival at the stand-in against the timestamps
+    double jitter_p99;
+    double jitter_max;
+    int received;
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void sleep_until(double deadline) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)deadline;
+    ts.tv_nsec = (long)((deadline - ts.tv_sec) * 1e9);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static int check(const char *what, int ok) {
+    fprintf(stderr, "%s %s\n", ok ? "PASS" : "FAIL", what);
+    return !ok;
+}
+
+/* the SimGen side: stamp every frame as it lands */
+static void *standin_rx(void *arg) {
+    struct standin_t *sd = (struct standin_t *)arg;
+    struct simgen_mot_bin_frame_t frame;
+    struct simgen_motion_data_t motion;
+
+    while (__atomic_load_n(&sd->running, __ATOMIC_RELAXED)) {
+        if (recv(sd->rx_fd, &frame, sizeof(frame), 0) != sizeof(frame))
+            continue;
+        if (simgen_remote_motion_bin_decode(&frame, sizeof(frame), &motion) != 0 || sd->n_rx >= N_SAMPLES)
+            continue;
+        sd->arrival[sd->n_rx] = now_sec();
+        sd->sim_time[sd->n_rx] = motion.sim_time.second;
+        sd->n_rx++;
+    }
+    return NULL;
+}
+
+static int standin_open(struct standin_t *sd, int stall_every, double stall) {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    struct timeval tmo = {0, 20000};
+
+    memset(sd, 0, sizeof(*sd));
+    sd->stall_every = stall_every;
+    sd->stall = stall;
+    sd->rx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sd->tx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(sd->rx_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0
+        || getsockname(sd->rx_fd, (struct sockaddr *)&addr, &len) < 0
+        || connect(sd->tx_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("stand-in socket");
+        return -1;
+    }
+    setsockopt(sd->rx_fd, SOL_SOCKET, SO_RCVTIMEO, &tmo, sizeof(tmo));
+    sd->running = 1;
+    return pthread_create(&sd->thread, NULL, standin_rx, sd);
+}
+
+static void standin_close(struct standin_t *sd) {
+    usleep(50000);
+    __atomic_store_n(&sd->running, 0, __ATOMIC_RELAXED);
+    pthread_join(sd->thread, NULL);
+    close(sd->rx_fd);
+    close(sd->tx_fd);
+}
+
+/* simgen_sender_fn: the binary MOT frame over UDP, stalling now and then */
+static int standin_send(void *ctx, struct simgen_motion_data_t *motion) {
+    struct standin_t *sd = (struct standin_t *)ctx;
+    struct simgen_mot_bin_frame_t frame;
+
+    if (sd->stall_every && ++sd->n_send % sd->stall_every == 0)
+        sleep_until(now_sec() + sd->stall);
+    simgen_remote_motion_bin_encode(motion, &frame);
+    return send(sd->tx_fd, &frame, sizeof(frame), 0) == sizeof(frame) ? 0 : -1;
+}
+
+static void motion_fill(struct simgen_motion_data_t *motion, int idx) {
+    simgen_default_remote_data(motion);
+    motion->sim_time.second = idx * PERIOD;
+    motion->position_xyz[0] = -2956196.0 + idx;
+    motion->velocity_xyz[0] = idx * 0.5;
+}
+
+/* inter-arrival at the stand-in against the sim_time steps; freeze gaps left out */
+static void jitter(struct standin_t *sd, struct run_result_t *res) {
+    static double err_sorted[N_SAMPLES];
+    double err;
+    int idx, n = 0;
+
+    res->received = sd->n_rx;
+    res->jitter_max = 0.0;
+    for (idx = 1; idx < sd->n_rx; idx++) {
+        if (sd->arrival[idx] - sd->arrival[idx - 1] > FREEZE_SEC * 0.8)
+            continue;
+        err = fabs((sd->arrival[idx] - sd->arrival[idx - 1]) - (sd->sim_time[idx] - sd->sim_time[idx - 1]));
+        err_sorted[n++] = err;
+        if (err > res->jitter_max)
+            res->jitter_max = err;
+    }
+    qsort(err_sorted, n, sizeof(double), cmp_double);
+    res->jitter_p50 = n ? err_sorted[n / 2] : 0.0;
+    res->jitter_p99 = n ? err_sorted[n * 99 / 100] : 0.0;
+}
+
+/* the DM frame: one sample per PERIOD, inline send or push */
+static struct run_result_t produce(struct standin_t *sd, struct simgen_sender_t *S, int freeze) {
+    struct simgen_motion_data_t motion;
+    struct run_result_t res;
+    double tick = now_sec(), t0, job;
+    int idx;
+
+    memset(&res, 0, sizeof(res));
+    for (idx = 0; idx < N_SAMPLES; idx++) {
+        tick += PERIOD;
+        if (freeze && idx == FREEZE_AT)
+            tick += FREEZE_SEC;
+        sleep_until(tick + FRAME_JITTER * (rand() / (double)RAND_MAX));
+        t0 = now_sec();
+        motion_fill(&motion, idx);
+        if (S)
+            simgen_sender_push(S, &motion);
+        else
+            standin_send(sd, &motion);
+        job = now_sec() - t0;
+        if (job > res.job_max)
+            res.job_max = job;
+    }
+    return res;
+}
+
+static void report(const char *name, struct run_result_t *res) {
+    fprintf(stderr, "     %-7s frame job max %7.3f ms, %4d received, arrival jitter p50 %6.3f p99 %6.3f max %6.3f ms\n",
+            name, res->job_max * 1e3, res->received, res->jitter_p50 * 1e3, res->jitter_p99 * 1e3,
+            res->jitter_max * 1e3);
+}
+
+int main(int argc, char const *argv[]) {
+    static struct simgen_sender_t sender;
+    struct simgen_sender_cfg_t cfg = {LOOKAHEAD, PERIOD, -1, 0};
+    struct simgen_sender_stats_t stats;
+    struct simgen_motion_data_t motion;
+    struct run_result_t inline_res, thread_res;
+    struct standin_t sd;
+    int idx, failed = 0;
+
+    fprintf(stderr, "** SimGen sender benchmark, %d samples every %.0f ms, %.0f ms stall every %d sends **\n",
+            N_SAMPLES, PERIOD * 1e3, STALL_SEC * 1e3, STALL_EVERY);
+
+    standin_open(&sd, STALL_EVERY, STALL_SEC);
+    inline_res = produce(&sd, NULL, 0);
+    standin_close(&sd);
+    jitter(&sd, &inline_res);
+    report("inline", &inline_res);
+
+    standin_open(&sd, STALL_EVERY, STALL_SEC);
+    simgen_sender_start(&sender, &cfg, standin_send, &sd);
+    thread_res = produce(&sd, &sender, 1);
+    usleep(LOOKAHEAD * PERIOD * 2e6);
+    simgen_sender_stats(&sender, &stats);
+    simgen_sender_stop(&sender);
+    standin_close(&sd);
+    jitter(&sd, &thread_res);
+    report("sender", &thread_res);
+
+    failed += check("frame job no longer waits for the link", thread_res.job_max < STALL_SEC * 0.5
+                    && inline_res.job_max >= STALL_SEC);
+    failed += check("every sample sent and received", stats.sent == N_SAMPLES && stats.overflow == 0
+                    && thread_res.received == N_SAMPLES);
+    failed += check("frozen producer: underrun, new time base", stats.underrun >= 1 && stats.rebase >= 2);
+    failed += check("paced on the timestamps: frame jitter off the wire",
+                    thread_res.jitter_p50 < inline_res.jitter_p50 * 0.5);
+
+    /* dead link: the producer fills the ring and drops, never blocks */
+    standin_open(&sd, 1, 0.3);
+    cfg.lookahead = 1;
+    simgen_sender_start(&sender, &cfg, standin_send, &sd);
+    thread_res.job_max = 0.0;
+    for (idx = 0; idx < 2 * SIMGEN_SENDER_RING_SIZE; idx++) {
+        double t0 = now_sec();
+        motion_fill(&motion, idx);
+        simgen_sender_push(&sender, &motion);
+        if (now_sec() - t0 > thread_res.job_max)
+            thread_res.job_max = now_sec() - t0;
+        usleep(1000);
+    }
+    simgen_sender_stats(&sender, &stats);
+    simgen_sender_stop(&sender);
+    standin_close(&sd);
+    fprintf(stderr, "     stalled link: %lu pushed, %lu overflow, push max %.3f ms\n",
+            (unsigned long)stats.pushed, (unsigned long)stats.overflow, thread_res.job_max * 1e3);
+    failed += check("stalled link: overflow counted, push never blocks",
+                    stats.overflow > 0 && stats.pushed + stats.overflow == 2 * SIMGEN_SENDER_RING_SIZE
+                    && thread_res.job_max < 0.01);
+    return failed ? 1 : 0;
+}
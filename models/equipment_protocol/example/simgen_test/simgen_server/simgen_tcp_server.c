@@ -9,8 +9,17 @@
 #include <unistd.h> // for close
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include "simgen_remote.h"
 #define SERV_PORT 15650
 #define MAXNAME 1024
+#define MAX_CONN 64
+
+/* bytes of a connection not yet made into a whole command */
+struct conn_buff_t {
+    char data[2 * MAXNAME];
+    int len;
+};
+static struct conn_buff_t g_conn_buff[MAX_CONN];
 
 int tcp_data_recv(int client_fd, uint8_t *rx_buff, uint32_t buff_size) {
     uint32_t offset = 0;
@@ -31,11 +40,60 @@ int tcp_data_recv(int client_fd, uint8_t *rx_buff, uint32_t buff_size) {
 }
 
 
+static void show_motion(const char *fmt, struct simgen_motion_data_t *motion) {
+    printf("%s MOT t=%.3f v%d pos %.3f %.3f %.3f vel %.3f %.3f %.3f\n", fmt, motion->sim_time.second,
+           motion->vehicle_id, motion->position_xyz[0], motion->position_xyz[1], motion->position_xyz[2],
+           motion->velocity_xyz[0], motion->velocity_xyz[1], motion->velocity_xyz[2]);
+}
+
+/*
+ * Take the whole commands out of the connection buffer: binary MOT frames,
+ * told apart by their magic, and '\n' terminated text lines. Each one is
+ * answered with an ACK. Returns -1 when the ACK cannot be sent.
+ */
+static int conn_commands(int fd, struct conn_buff_t *conn, const char *ack, int ack_len) {
+    struct simgen_motion_data_t motion;
+    uint32_t magic = 0;
+    char *eol;
+    int used;
+
+    while (conn->len > 0) {
+        if (conn->len >= (int)sizeof(magic))
+            memcpy(&magic, conn->data, sizeof(magic));
+        if (magic == SIMGEN_MOT_BIN_MAGIC) {
+            if (conn->len < (int)sizeof(struct simgen_mot_bin_frame_t))
+                break;
+            used = sizeof(struct simgen_mot_bin_frame_t);
+            if (simgen_remote_motion_bin_decode(conn->data, used, &motion) == 0)
+                show_motion("bin ", &motion);
+            else
+                printf("Bad binary MOT frame\n");
+        } else {
+            if ((eol = memchr(conn->data, '\n', conn->len)) == NULL) {
+                if (conn->len < (int)sizeof(conn->data))
+                    break;
+                eol = conn->data + conn->len - 1;   /* no newline in a full buffer, flush it */
+            }
+            used = eol - conn->data + 1;
+            *eol = '\0';
+            if (simgen_remote_motion_cmd_decode(conn->data, &motion) == 0)
+                show_motion("text", &motion);
+            else
+                printf("%s\n", conn->data);
+        }
+        memmove(conn->data, conn->data + used, conn->len - used);
+        conn->len -= used;
+        magic = 0;
+        if (send(fd, ack, ack_len, 0) < 0)
+            return -1;
+    }
+    return 0;
+}
+
 int main(int argc, char const *argv[]) {
     int tcp_serv_fd;   /* file description into transport */
     int tcp_client_fd;   /* file description into transport */
     int length; /* length of address structure      */
-    char buf[MAXNAME];
     int optval = 1; /* prevent from address being taken */
     struct sockaddr_in tcpaddr; /* address of this service */
     struct sockaddr_in tcp_client_addr; /* address of client    */
@@ -122,6 +180,12 @@ int main(int argc, char const *argv[]) {
                         }
 
                         printf("  New incoming connection - %d\n", tcp_client_fd);
+                        if (tcp_client_fd >= MAX_CONN) {
+                            fprintf(stderr, "  Too many connections\n");
+                            close(tcp_client_fd);
+                            continue;
+                        }
+                        g_conn_buff[tcp_client_fd].len = 0;
                         FD_SET(tcp_client_fd, &master_set);
                         if (tcp_client_fd > max_sd)
                             max_sd = tcp_client_fd;
@@ -131,8 +195,8 @@ int main(int argc, char const *argv[]) {
                     close_conn = 0;
 
                     do {
-                        memset(buf, 0, MAXNAME);
-                        err = recv(i, (uint8_t *)&buf, MAXNAME, 0);
+                        struct conn_buff_t *conn = &g_conn_buff[i];
+                        err = recv(i, (uint8_t *)conn->data + conn->len, sizeof(conn->data) - conn->len, 0);
                         if (err < 0) {
                             if (errno != EWOULDBLOCK) {
                                 perror("  recv() failed");
@@ -145,16 +209,14 @@ int main(int argc, char const *argv[]) {
                             close_conn = 1;
                             break;
                         }
+                        conn->len += err;
                         printf("Received data form %s : %d\n", inet_ntoa(tcp_client_addr.sin_addr), htons(tcp_client_addr.sin_port));
-                        printf("%s", (char *)&buf);
-                        err = send(i, message, sizeof(message), 0);
-                        printf("Send resp ...\n\n");
-                        if (err < 0) {
+                        if (conn_commands(i, conn, message, sizeof(message)) < 0) {
                             perror("  send() failed");
                             close_conn = 1;
                             break;
                         }
-
+                        printf("Send resp ...\n\n");
                     } while (1);
                     if (close_conn) {
                         close(i);
@@ -13,10 +13,10 @@ PROGRAMMERS:
 #include "icf_trx_ctrl.h"
 #include "dsp_can_interfaces.h"
 
-#define FC_CAN_HASHTBL_SIZE 256
-#define GET_BYTE(value, shift_bit) (((value >> shift_bit) & 0xFF))
-#define CANID_TASKCMD_HASH(canid, taskcmd)  (GET_BYTE(canid, 24) ^ GET_BYTE(canid, 16) ^ GET_BYTE(canid, 8) ^ GET_BYTE(canid, 0) ^ (uint8_t)taskcmd)
-#define FLIGHT_EVENT_HASH_INDEX(canid, taskcmd) (CANID_TASKCMD_HASH(canid, taskcmd)  & (FC_CAN_HASHTBL_SIZE - 1))
+#define FC_CAN_HASHTBL_BITS  8
+#define FC_CAN_HASHTBL_SIZE  (1 << FC_CAN_HASHTBL_BITS)  //  a few times the command count
+#define FC_CAN_HASH_TRIES    4096 //  multipliers tried for a collision free table
+#define FC_CAN_HASH_KEY(canid, taskcmd)  ((((uint64_t)(canid) << 8) & 0xFFFFFFFF00) | ((uint64_t)(taskcmd) & 0xFF))
 
 
 
@@ -26,15 +26,22 @@ struct fc_can_info_t {
     int sw_queue_idx;
 };
 
-struct fc_can_hash_entry {
+struct fc_can_hash_slot {
     uint64_t key;
-    struct fc_can_info_t *data;
-    struct fc_can_hash_entry *next;
+    const struct fc_can_info_t *data;   //  NULL: empty slot
 };
 
+/*
+ * Open addressing on a multiplicative hash of (CAN ID, task command).
+ * fc_can_hashtbl_init() picks the multiplier that leaves no two commands
+ * in one slot, so a lookup is a single probe; max_probe covers the case
+ * where no such multiplier turns up.
+ */
 struct fc_can_hash_table {
     int size;
-    struct fc_can_hash_entry *bucket[FC_CAN_HASHTBL_SIZE];
+    uint64_t mult;
+    uint32_t max_probe;
+    struct fc_can_hash_slot slot[FC_CAN_HASHTBL_SIZE];
 };
 
 #ifdef __cplusplus
@@ -42,6 +49,7 @@ extern "C" {
 #endif
 int fc_can_cmd_dispatch(void *rxframe);
 int fc_can_hashtbl_init(void);
+const struct fc_can_info_t *fc_can_cmd_table(int *count);
 int fc_can_cmd_record_init(FILE **output_file);
 int fc_can_cmd_record_deinit(FILE *output_file);
 int fc_can_cmd_record_to_file(FILE *output_file, struct can_frame *event_can);
@@ -24,6 +24,9 @@ PROGRAMMERS:
 //  #define SIMGEN_IP "192.168.0.8"
 #define SIMGEN_PORT 15650
 #define VEH_MOT(id) "v"#id"_m1"
+#define SIMGEN_MOT_CMD_SIZE     1024        //  one text MOT command, newline included
+#define SIMGEN_MOT_BIN_MAGIC    0x424D4753  //  "SGMB" on the wire
+#define SIMGEN_MOT_BIN_VERSION  1
 
 typedef enum _REMOTE_MOTION_CMD_ENUM {
     REMOTE_MOTION_CMD_MOT = 0,
@@ -32,6 +35,11 @@ typedef enum _REMOTE_MOTION_CMD_ENUM {
     REMOTE_MOTION_CMD_MAX_NUM
 } REMOTE_MOTION_CMD_ENUM;
 
+typedef enum _SIMGEN_MOTION_FORMAT_ENUM {
+    SIMGEN_MOTION_FORMAT_TEXT = 0,      //  remote command MOT line, what SimGen itself accepts
+    SIMGEN_MOTION_FORMAT_BINARY = 1     //  simgen_mot_bin_frame_t, receivers that decode it
+} SIMGEN_MOTION_FORMAT_ENUM;
+
 struct simgen_timestamp_t {
     uint8_t day;
     uint8_t hour;
@@ -69,6 +77,23 @@ struct simgen_motion_data_t {
     double angular_jerk[3];          //  uint: rad/s^3
 };
 
+/*
+ * Binary MOT frame on the remote command channel, host byte order (little
+ * endian on every HIL host). motion[] holds the eight vectors in the order
+ * of simgen_motion_data_t.
+ */
+#pragma pack(push, 8)
+struct simgen_mot_bin_frame_t {
+    uint32_t magic;         //  SIMGEN_MOT_BIN_MAGIC
+    uint16_t version;       //  SIMGEN_MOT_BIN_VERSION
+    uint16_t length;        //  bytes after this header, the frame is 8 + length
+    double sim_time;
+    uint32_t cmd_idx;
+    uint32_t vehicle_id;
+    double motion[24];
+};
+#pragma pack(pop)
+
 struct simgen_eqmt_info_t {
     int remote_cmd_channel_fd;
     int udp_cmd_channel_fd;
@@ -77,6 +102,7 @@ struct simgen_eqmt_info_t {
     struct simgen_motion_data_t motion_data;
     struct simgen_gps_start_time_t gps_start_time;
     uint8_t udp_motion_enable;
+    uint8_t motion_format;      //  SIMGEN_MOTION_FORMAT_ENUM of the TCP MOT commands
 };
 
 #ifdef __cplusplus
@@ -84,6 +110,10 @@ extern "C" {
 #endif
 int simgen_remote_cmd_init(struct simgen_eqmt_info_t *eqmt_info, void *data);
 int simgen_udp_motion_cmd_gen(void *data, struct simgen_udp_command_t *udp_cmd);
+int simgen_remote_motion_cmd_encode(const struct simgen_motion_data_t *motion_info, char *cmdbuff, int buf_size);
+int simgen_remote_motion_bin_encode(const struct simgen_motion_data_t *motion_info, struct simgen_mot_bin_frame_t *frame);
+int simgen_remote_motion_cmd_decode(const char *cmdbuff, struct simgen_motion_data_t *motion_info);
+int simgen_remote_motion_bin_decode(const void *buff, uint32_t buf_size, struct simgen_motion_data_t *motion_info);
 int simgen_default_remote_data(struct simgen_motion_data_t *motion_info);
 int simgen_remote_tn_motion_send(struct simgen_eqmt_info_t *eqmt_info, void *data);
 void simgen_remote_end_scenario_now(struct simgen_eqmt_info_t *eqmt_info);
@@ -0,0 +1,100 @@
+#ifndef MODELS_EQUIPMENT_PROTOCOL_INCLUDE_SIMGEN_SENDER_H_
+#define MODELS_EQUIPMENT_PROTOCOL_INCLUDE_SIMGEN_SENDER_H_
+/********************************* TRICK HEADER *******************************
+PURPOSE:
+      simgen motion sender thread
+LIBRARY DEPENDENCY:
+      (
+        (../src/simgen_sender.c)
+      )
+PROGRAMMERS:
+      (((Dung-Ru Tsai) () () () ))
+*******************************************************************************/
+#include <pthread.h>
+#include <time.h>
+#include "simgen_remote.h"
+#define SIMGEN_SENDER_RING_SIZE     64      //  samples, power of 2
+#define SIMGEN_SENDER_LOOKAHEAD     4       //  default samples held before sending starts
+#define SIMGEN_SENDER_MAX_WAIT      1.0     //  s, a sample due later than this rebases the clock
+#define SIMGEN_SENDER_CACHELINE     64
+#define SIMGEN_SENDER_ALIGNED __attribute__((aligned(SIMGEN_SENDER_CACHELINE)))
+
+/*
+ * The DM job pushes timestamped motion samples into a single producer /
+ * single consumer ring; a sender thread takes them out and hands them to
+ * send() at the pace of their sim_time, so a slow socket stalls the sender
+ * and never the real-time frame.
+ *
+ * The sender waits for lookahead samples before it maps sim_time onto
+ * CLOCK_MONOTONIC; after that sample k leaves at base + (t_k - t_0). The
+ * lookahead samples in hand absorb producer jitter and send stalls. A ring
+ * found empty (underrun, e.g. the sim was frozen) starts the prebuffering
+ * over with a new time base.
+ */
+typedef int (*simgen_sender_fn)(void *ctx, struct simgen_motion_data_t *motion);
+
+struct simgen_sender_cfg_t {
+    uint32_t lookahead;         //  samples buffered before the first send, < SIMGEN_SENDER_RING_SIZE
+    double period;              //  s, sample interval, int_step of the producer
+    int cpu;                    //  sender CPU affinity, -1 for none
+    int priority;               //  SCHED_FIFO priority, 0 for the default policy
+};
+
+struct simgen_sender_stats_t {
+    uint64_t pushed;            //  samples taken by simgen_sender_push()
+    uint64_t overflow;          //  samples dropped, ring full
+    uint64_t sent;
+    uint64_t send_err;          //  send() returned non zero
+    uint64_t underrun;          //  ring empty when a sample was due
+    uint64_t rebase;            //  time base set, prebuffer fills included
+    uint32_t depth_max;         //  most samples seen in the ring
+    double latency_max;         //  s, push to send() return
+    double latency_mean;
+    double jitter_max;          //  s, |send() call - deadline|
+    double jitter_mean;
+};
+
+struct simgen_sender_slot_t {
+    struct simgen_motion_data_t motion;
+    struct timespec push_ts;
+};
+
+struct simgen_sender_t {
+    /* producer */
+    uint32_t writer_idx SIMGEN_SENDER_ALIGNED;
+    uint32_t reader_cache;
+    uint64_t pushed;
+    uint64_t overflow;
+    /* sender thread */
+    uint32_t reader_idx SIMGEN_SENDER_ALIGNED;
+    uint32_t writer_cache;
+    uint64_t sent;
+    uint64_t send_err;
+    uint64_t underrun;
+    uint64_t rebase;
+    uint32_t depth_max;
+    uint64_t latency_max_ns;
+    uint64_t latency_sum_ns;
+    uint64_t jitter_max_ns;
+    uint64_t jitter_sum_ns;
+    /* fixed after simgen_sender_start() */
+    struct simgen_sender_cfg_t cfg SIMGEN_SENDER_ALIGNED;
+    simgen_sender_fn send;
+    void *ctx;
+    pthread_t thread;
+    int running;
+    struct simgen_sender_slot_t slot[SIMGEN_SENDER_RING_SIZE];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int simgen_sender_start(struct simgen_sender_t *S, const struct simgen_sender_cfg_t *cfg,
+                        simgen_sender_fn send, void *ctx);
+int simgen_sender_push(struct simgen_sender_t *S, const struct simgen_motion_data_t *motion);
+void simgen_sender_stats(struct simgen_sender_t *S, struct simgen_sender_stats_t *stats);
+void simgen_sender_stop(struct simgen_sender_t *S);
+#ifdef __cplusplus
+}
+#endif
+#endif  //  MODELS_EQUIPMENT_PROTOCOL_INCLUDE_SIMGEN_SENDER_H_
@@ -74,93 +74,110 @@ static const  struct fc_can_info_t cmd_dispatch_map[] = {
 
 static struct fc_can_hash_table *p_fc_can_hash_object;
 
+static uint32_t fc_can_hash_index(const struct fc_can_hash_table *object, uint64_t key) {
+    return (uint32_t)((key * object->mult) >> (64 - FC_CAN_HASHTBL_BITS));
+}
+
 struct fc_can_hash_table *fc_can_hash_table_create(void) {
     struct fc_can_hash_table *object;
-    int idx = 0;
-    object = malloc(sizeof(struct fc_can_hash_table));
-    if (object == NULL)
-        goto fail;
-    for (idx = 0; idx < FC_CAN_HASHTBL_SIZE; idx++) {
-        object->bucket[idx] = malloc(sizeof(struct fc_can_hash_entry));
-        memset(object->bucket[idx], 0 , sizeof(struct fc_can_hash_entry));
-    }
-    if (object->bucket == NULL) {
-            fprintf(stderr, "[%s:%d] Memory allocate fail !!\n", __FUNCTION__, __LINE__);
-            goto fail;
+    object = calloc(1, sizeof(struct fc_can_hash_table));
+    if (object == NULL) {
+        fprintf(stderr, "[%s:%d] Memory allocate fail !!\n", __FUNCTION__, __LINE__);
+        return NULL;
     }
     object->size = FC_CAN_HASHTBL_SIZE;
+    object->mult = 0x9E3779B97F4A7C15ULL;
+    object->max_probe = 0;
     return object;
-fail:
-    if (object->bucket)
-        free(object->bucket[idx]);
-    if (object)
-        free(object);
-    return NULL;
 }
 
 void fc_can_hash_table_dump(struct fc_can_hash_table *object) {
     int idx = 0;
-    struct fc_can_hash_entry *curr;
+    printf("fc_can hash: multiplier 0x%llx, max probe %u\n", (unsigned long long)object->mult, object->max_probe);
     for (idx = 0; idx < FC_CAN_HASHTBL_SIZE; idx++) {
-        curr = object->bucket[idx];
-        printf("[%d]:", idx);
-        while (curr != NULL) {
-            printf("0x%x, ", curr->key);
-            curr = curr->next;
-        }
-        printf("\n");
+        if (object->slot[idx].data)
+            printf("[%d]: 0x%llx\n", idx, (unsigned long long)object->slot[idx].key);
     }
 }
 
 struct fc_can_info_t *fc_can_hash_entry_find(struct fc_can_hash_table *object, uint32_t canid, uint8_t taskcmd) {
-    struct fc_can_hash_entry *curr;
-    uint8_t hash_idx;
-    uint64_t find_key;
-    hash_idx = FLIGHT_EVENT_HASH_INDEX(canid, taskcmd);
-    find_key = (((uint64_t)canid << 8) & 0xFFFFFFFF00) | ((uint64_t)taskcmd & 0xFF);
-    curr = object->bucket[hash_idx];
-    while (curr->next != NULL) {
-        if (curr->key == find_key) {
-            return curr->data;
-        }
-        curr = curr->next;
+    uint64_t find_key = FC_CAN_HASH_KEY(canid, taskcmd);
+    uint32_t hash_idx = fc_can_hash_index(object, find_key);
+    uint32_t probe;
+
+    for (probe = 0; probe < object->max_probe; probe++) {
+        if (object->slot[hash_idx].data == NULL)
+            break;
+        if (object->slot[hash_idx].key == find_key)
+            return (struct fc_can_info_t *)object->slot[hash_idx].data;
+        hash_idx = (hash_idx + 1) & (FC_CAN_HASHTBL_SIZE - 1);
     }
     return NULL;
 }
 
-int fc_can_hash_entry_add(struct fc_can_hash_table *object, struct fc_can_info_t *info) {
-    struct fc_can_hash_entry *curr;
-    uint8_t hash_idx;
-    hash_idx = FLIGHT_EVENT_HASH_INDEX(info->canid, info->taskcmd);
-
-    curr = object->bucket[hash_idx];
-    while (curr->next != NULL) {
-        curr = curr->next;
-    }
-    curr->next = malloc(sizeof(struct fc_can_hash_entry));
-    if (curr->next == NULL) {
-            fprintf(stderr, "[%s:%d] Memory allocate fail !!\n", __FUNCTION__, __LINE__);
-            return -1;
+int fc_can_hash_entry_add(struct fc_can_hash_table *object, const struct fc_can_info_t *info) {
+    uint64_t key = FC_CAN_HASH_KEY(info->canid, info->taskcmd);
+    uint32_t hash_idx = fc_can_hash_index(object, key);
+    uint32_t probe;
+
+    for (probe = 0; probe < FC_CAN_HASHTBL_SIZE; probe++) {
+        if (object->slot[hash_idx].data == NULL || object->slot[hash_idx].key == key) {
+            object->slot[hash_idx].key = key;
+            object->slot[hash_idx].data = info;
+            if (probe + 1 > object->max_probe)
+                object->max_probe = probe + 1;
+            return hash_idx;
+        }
+        hash_idx = (hash_idx + 1) & (FC_CAN_HASHTBL_SIZE - 1);
     }
-    memset(curr->next, 0 , sizeof(struct fc_can_hash_entry));
-    curr->key = (((uint64_t)info->canid << 8) & 0xFFFFFFFF00) | ((uint64_t)info->taskcmd & 0xFF);
-    curr->data = info;
-    curr->next->next = NULL;
-    return hash_idx;
+    fprintf(stderr, "[%s:%d] Hash table full !!\n", __FUNCTION__, __LINE__);
+    return -1;
+}
+
+/* fill the table with one multiplier, returns the longest probe it needed */
+static uint32_t fc_can_hash_table_fill(struct fc_can_hash_table *object, uint64_t mult,
+                                       const struct fc_can_info_t *map, int count) {
+    int idx;
+    memset(object->slot, 0, sizeof(object->slot));
+    object->mult = mult | 1;
+    object->max_probe = 0;
+    for (idx = 0; idx < count; idx++)
+        fc_can_hash_entry_add(object, &map[idx]);
+    return object->max_probe;
 }
 
 int fc_can_hashtbl_init(void) {
-    p_fc_can_hash_object = fc_can_hash_table_create();
-    int idx = 0;
-    uint8_t hash_idx;
     int cmd_count = sizeof(cmd_dispatch_map) /sizeof(struct fc_can_info_t);
-    for (idx = 0; idx < cmd_count; idx++) {
-        hash_idx = fc_can_hash_entry_add(p_fc_can_hash_object, &cmd_dispatch_map[idx]);
+    uint64_t mult = 0x9E3779B97F4A7C15ULL, best_mult = mult;
+    uint32_t best_probe = UINT32_MAX, probe;
+    int tries;
+
+    if (p_fc_can_hash_object == NULL)
+        p_fc_can_hash_object = fc_can_hash_table_create();
+    if (p_fc_can_hash_object == NULL)
+        return -1;
+    /* splitmix64 steps through candidate multipliers until one is perfect */
+    for (tries = 0; tries < FC_CAN_HASH_TRIES && best_probe > 1; tries++) {
+        probe = fc_can_hash_table_fill(p_fc_can_hash_object, mult, cmd_dispatch_map, cmd_count);
+        if (probe < best_probe) {
+            best_probe = probe;
+            best_mult = mult;
+        }
+        mult += 0x9E3779B97F4A7C15ULL;
+        mult = (mult ^ (mult >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        mult = (mult ^ (mult >> 27)) * 0x94D049BB133111EBULL;
+        mult ^= mult >> 31;
     }
+    fc_can_hash_table_fill(p_fc_can_hash_object, best_mult, cmd_dispatch_map, cmd_count);
     fc_can_hash_table_dump(p_fc_can_hash_object);
     return 0;
 }
 
+const struct fc_can_info_t *fc_can_cmd_table(int *count) {
+    *count = sizeof(cmd_dispatch_map) / sizeof(struct fc_can_info_t);
+    return cmd_dispatch_map;
+}
+
 
 int fc_can_cmd_dispatch(void *rxframe) {
     int qidx = EGSE_EMPTY_SW_QIDX;
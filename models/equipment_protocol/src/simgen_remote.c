@@ -12,40 +12,206 @@ static const char cmd_SCENARIO_ITERATION_RATE[] = "SCENARIO_ITERATION_RATE\n";
 static const char *MONTH_TBL[13] = {"", "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
                                     "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
 
-static int simgen_remote_motion_cmd_gen(void *data, char *cmdbuff, int buf_size) {
-    struct simgen_motion_data_t *motion_info = (struct simgen_motion_data_t *)data;
-    char veh_mot_str[32];
-    int offset;
-    strncpy(veh_mot_str, VEH_MOT(1), 32);
-    //  snprintf(cmdbuff, buf_size,"%1d %02d:%02d:%07.3f,", motion_info->sim_time.ts.day, motion_info->sim_time.ts.hour, motion_info->sim_time.ts.minute, motion_info->sim_time.ts.second);
-    snprintf(cmdbuff, buf_size, "%07.3f,", motion_info->sim_time.second);
-    offset = strlen(cmdbuff);
+static const uint64_t POW10_TBL[11] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+                                        10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL};
 
-    snprintf(cmdbuff + offset, buf_size - offset, "%s,%s,", g_remote_motion_cmd_list[motion_info->cmd_idx], veh_mot_str);
-    offset = strlen(cmdbuff);
-
-    snprintf(cmdbuff + offset, buf_size - offset, "%20.10f,%20.10f,%20.10f,", motion_info->position_xyz[0], motion_info->position_xyz[1], motion_info->position_xyz[2]);
-    offset = strlen(cmdbuff);
+#define SIMGEN_FMT_FALLBACK_MAX  40
 
-    snprintf(cmdbuff + offset, buf_size - offset, "%20.10f,%20.10f,%20.10f,", motion_info->velocity_xyz[0], motion_info->velocity_xyz[1], motion_info->velocity_xyz[2]);
-    offset = strlen(cmdbuff);
+static int simgen_fmt_fallback(char *out, double value, int width, int prec, char pad) {
+    snprintf(out, SIMGEN_FMT_FALLBACK_MAX + 1, pad == '0' ? "%0*.*f" : "%*.*f", width, prec, value);
+    return strlen(out);
+}
 
-    snprintf(cmdbuff + offset, buf_size - offset, "%20.10f,%20.10f,%20.10f,", motion_info->acceleration_xyz[0], motion_info->acceleration_xyz[1], motion_info->acceleration_xyz[2]);
-    offset = strlen(cmdbuff);
+/*
+ * printf("%<width>.<prec>f") without stdio or the locale, prec up to 10.
+ * The double is taken apart into mantissa and exponent and rounded half to
+ * even on its exact value, as glibc does, so the output matches byte for
+ * byte. Values whose scaled magnitude does not fit 64 bits go to snprintf,
+ * cut at SIMGEN_FMT_FALLBACK_MAX characters.
+ */
+static int simgen_fmt_fixed(char *out, double value, int width, int prec, char pad) {
+    char digits[24];
+    uint64_t bits, mant, q64, ipart, fpart;
+    unsigned __int128 n, q, r, half;
+    int biased, shift, neg, ndigits = 0, len, body, idx;
+
+    memcpy(&bits, &value, sizeof(bits));
+    neg = (int)(bits >> 63);
+    biased = (int)((bits >> 52) & 0x7ff);
+    mant = bits & ((1ULL << 52) - 1);
+    if (biased == 0x7ff)
+        return simgen_fmt_fallback(out, value, width, prec, pad);
+    if (biased)
+        mant |= 1ULL << 52;
+    shift = 1075 - (biased ? biased : 1);   //  value = mant / 2^shift
+
+    n = (unsigned __int128)mant * POW10_TBL[prec];
+    if (shift <= 0) {
+        if (-shift > 10 || (n >> (64 + shift)) != 0)
+            return simgen_fmt_fallback(out, value, width, prec, pad);
+        q = n << -shift;
+    } else if (shift >= 128) {
+        q = 0;
+    } else {
+        q = n >> shift;
+        r = n - (q << shift);
+        half = (unsigned __int128)1 << (shift - 1);
+        if (r > half || (r == half && (q & 1)))
+            q++;
+    }
+    if ((q >> 64) != 0)
+        return simgen_fmt_fallback(out, value, width, prec, pad);
+    q64 = (uint64_t)q;
+    ipart = q64 / POW10_TBL[prec];
+    fpart = q64 % POW10_TBL[prec];
+    do {
+        digits[ndigits++] = '0' + ipart % 10;
+        ipart /= 10;
+    } while (ipart);
+
+    body = neg + ndigits + (prec ? prec + 1 : 0);
+    len = 0;
+    if (pad != '0') {
+        for (; body + len < width; len++)
+            out[len] = ' ';
+    }
+    if (neg)
+        out[len++] = '-';
+    if (pad == '0') {
+        for (idx = body; idx < width; idx++)
+            out[len++] = '0';
+    }
+    while (ndigits)
+        out[len++] = digits[--ndigits];
+    if (prec) {
+        out[len++] = '.';
+        for (idx = prec - 1; idx >= 0; idx--) {
+            out[len + idx] = '0' + fpart % 10;
+            fpart /= 10;
+        }
+        len += prec;
+    }
+    out[len] = '\0';
+    return len;
+}
 
-    snprintf(cmdbuff + offset, buf_size - offset, "%20.10f,%20.10f,%20.10f,", motion_info->jerk_xyz[0], motion_info->jerk_xyz[1], motion_info->jerk_xyz[2]);
-    offset = strlen(cmdbuff);
+static int simgen_fmt_vec3(char *out, const double *vec, char last) {
+    int len = 0, idx;
+    for (idx = 0; idx < 3; idx++) {
+        len += simgen_fmt_fixed(out + len, vec[idx], 20, 10, ' ');
+        out[len++] = (idx < 2) ? ',' : last;
+    }
+    return len;
+}
 
-    snprintf(cmdbuff + offset, buf_size - offset, "%20.10f,%20.10f,%20.10f,", motion_info->heb[0], motion_info->heb[1], motion_info->heb[2]);
-    offset = strlen(cmdbuff);
+/*
+ * The MOT command line, as
+ *   "%07.3f,MOT,v1_m1," followed by 24 x "%20.10f" separated by ','
+ * with no allocation and no stdio on the way. Returns the length, or -1
+ * when buf_size is below SIMGEN_MOT_CMD_SIZE or cmd_idx is not a command.
+ */
+int simgen_remote_motion_cmd_encode(const struct simgen_motion_data_t *motion_info, char *cmdbuff, int buf_size) {
+    const char *cmd;
+    const char *veh = VEH_MOT(1);
+    int len;
+
+    if (buf_size < SIMGEN_MOT_CMD_SIZE || motion_info->cmd_idx >= REMOTE_MOTION_CMD_MAX_NUM)
+        return -1;
+    cmd = g_remote_motion_cmd_list[motion_info->cmd_idx];
+    len = simgen_fmt_fixed(cmdbuff, motion_info->sim_time.second, 7, 3, '0');
+    cmdbuff[len++] = ',';
+    while (*cmd)
+        cmdbuff[len++] = *cmd++;
+    cmdbuff[len++] = ',';
+    while (*veh)
+        cmdbuff[len++] = *veh++;
+    cmdbuff[len++] = ',';
+    len += simgen_fmt_vec3(cmdbuff + len, motion_info->position_xyz, ',');
+    len += simgen_fmt_vec3(cmdbuff + len, motion_info->velocity_xyz, ',');
+    len += simgen_fmt_vec3(cmdbuff + len, motion_info->acceleration_xyz, ',');
+    len += simgen_fmt_vec3(cmdbuff + len, motion_info->jerk_xyz, ',');
+    len += simgen_fmt_vec3(cmdbuff + len, motion_info->heb, ',');
+    len += simgen_fmt_vec3(cmdbuff + len, motion_info->angular_velocity, ',');
+    len += simgen_fmt_vec3(cmdbuff + len, motion_info->angular_acceleration, ',');
+    len += simgen_fmt_vec3(cmdbuff + len, motion_info->angular_jerk, '\n');
+    cmdbuff[len] = '\0';
+    return len;
+}
 
-    snprintf(cmdbuff + offset, buf_size - offset, "%20.10f,%20.10f,%20.10f,", motion_info->angular_velocity[0], motion_info->angular_velocity[1], motion_info->angular_velocity[2]);
-    offset = strlen(cmdbuff);
+int simgen_remote_motion_bin_encode(const struct simgen_motion_data_t *motion_info, struct simgen_mot_bin_frame_t *frame) {
+    if (motion_info->cmd_idx >= REMOTE_MOTION_CMD_MAX_NUM)
+        return -1;
+    frame->magic = SIMGEN_MOT_BIN_MAGIC;
+    frame->version = SIMGEN_MOT_BIN_VERSION;
+    frame->length = sizeof(struct simgen_mot_bin_frame_t) - 8;
+    frame->sim_time = motion_info->sim_time.second;
+    frame->cmd_idx = motion_info->cmd_idx;
+    frame->vehicle_id = motion_info->vehicle_id;
+    memcpy(&frame->motion[0], motion_info->position_xyz, sizeof(double) * 3);
+    memcpy(&frame->motion[3], motion_info->velocity_xyz, sizeof(double) * 3);
+    memcpy(&frame->motion[6], motion_info->acceleration_xyz, sizeof(double) * 3);
+    memcpy(&frame->motion[9], motion_info->jerk_xyz, sizeof(double) * 3);
+    memcpy(&frame->motion[12], motion_info->heb, sizeof(double) * 3);
+    memcpy(&frame->motion[15], motion_info->angular_velocity, sizeof(double) * 3);
+    memcpy(&frame->motion[18], motion_info->angular_acceleration, sizeof(double) * 3);
+    memcpy(&frame->motion[21], motion_info->angular_jerk, sizeof(double) * 3);
+    return sizeof(struct simgen_mot_bin_frame_t);
+}
 
-    snprintf(cmdbuff + offset, buf_size - offset, "%20.10f,%20.10f,%20.10f,", motion_info->angular_acceleration[0], motion_info->angular_acceleration[1], motion_info->angular_acceleration[2]);
-    offset = strlen(cmdbuff);
+/* Receiver side of the two: returns 0, or -1 on a malformed command */
+int simgen_remote_motion_cmd_decode(const char *cmdbuff, struct simgen_motion_data_t *motion_info) {
+    double *field[8] = {motion_info->position_xyz, motion_info->velocity_xyz, motion_info->acceleration_xyz,
+                        motion_info->jerk_xyz, motion_info->heb, motion_info->angular_velocity,
+                        motion_info->angular_acceleration, motion_info->angular_jerk};
+    const char *pos = cmdbuff;
+    char *end;
+    int idx;
+
+    motion_info->sim_time.second = strtod(pos, &end);
+    if (end == pos || *end != ',')
+        return -1;
+    pos = end + 1;
+    for (idx = 0; idx < REMOTE_MOTION_CMD_MAX_NUM; idx++) {
+        if (strncmp(pos, g_remote_motion_cmd_list[idx], strlen(g_remote_motion_cmd_list[idx])) == 0
+            && pos[strlen(g_remote_motion_cmd_list[idx])] == ',')
+            break;
+    }
+    if (idx == REMOTE_MOTION_CMD_MAX_NUM)
+        return -1;
+    motion_info->cmd_idx = idx;
+    pos += strlen(g_remote_motion_cmd_list[idx]) + 1;
+    if (sscanf(pos, "v%hhu_m", &motion_info->vehicle_id) != 1 || (pos = strchr(pos, ',')) == NULL)
+        return -1;
+    for (idx = 0; idx < 24; idx++) {
+        pos++;
+        field[idx / 3][idx % 3] = strtod(pos, &end);
+        if (end == pos || (*end != ',' && idx < 23))
+            return -1;
+        pos = end;
+    }
+    return 0;
+}
 
-    snprintf(cmdbuff + offset, buf_size - offset, "%20.10f,%20.10f,%20.10f\n", motion_info->angular_jerk[0], motion_info->angular_jerk[1], motion_info->angular_jerk[2]);
+int simgen_remote_motion_bin_decode(const void *buff, uint32_t buf_size, struct simgen_motion_data_t *motion_info) {
+    struct simgen_mot_bin_frame_t frame;
+
+    if (buf_size < sizeof(frame))
+        return -1;
+    memcpy(&frame, buff, sizeof(frame));
+    if (frame.magic != SIMGEN_MOT_BIN_MAGIC || frame.version != SIMGEN_MOT_BIN_VERSION
+        || frame.length != sizeof(frame) - 8 || frame.cmd_idx >= REMOTE_MOTION_CMD_MAX_NUM)
+        return -1;
+    motion_info->sim_time.second = frame.sim_time;
+    motion_info->cmd_idx = frame.cmd_idx;
+    motion_info->vehicle_id = frame.vehicle_id;
+    memcpy(motion_info->position_xyz, &frame.motion[0], sizeof(double) * 3);
+    memcpy(motion_info->velocity_xyz, &frame.motion[3], sizeof(double) * 3);
+    memcpy(motion_info->acceleration_xyz, &frame.motion[6], sizeof(double) * 3);
+    memcpy(motion_info->jerk_xyz, &frame.motion[9], sizeof(double) * 3);
+    memcpy(motion_info->heb, &frame.motion[12], sizeof(double) * 3);
+    memcpy(motion_info->angular_velocity, &frame.motion[15], sizeof(double) * 3);
+    memcpy(motion_info->angular_acceleration, &frame.motion[18], sizeof(double) * 3);
+    memcpy(motion_info->angular_jerk, &frame.motion[21], sizeof(double) * 3);
     return 0;
 }
 
@@ -200,10 +366,13 @@ int simgen_remote_cmd_init(struct simgen_eqmt_info_t *eqmt_info, void *data) {
     simgen_remote_wait_cmd_resp(eqmt_info, cmd_SCENARIO_ITERATION_RATE, cmd_resp, 1);
 
     /* Send t0 mot by TCP*/
-    cmd_mot_t0 = (char *)malloc(1024);
+    cmd_mot_t0 = (char *)malloc(SIMGEN_MOT_CMD_SIZE);
     if (cmd_mot_t0 == NULL)
         goto CMD_INIT_FAIL;
-    simgen_remote_motion_cmd_gen(motion_info, cmd_mot_t0, 1023);
+    if (simgen_remote_motion_cmd_encode(motion_info, cmd_mot_t0, SIMGEN_MOT_CMD_SIZE) < 0) {
+        fprintf(stderr, "[%s:%d] Invalid motion command %d !!\n", __FUNCTION__, __LINE__, motion_info->cmd_idx);
+        goto CMD_INIT_FAIL;
+    }
     cmd_payload = (uint8_t *)cmd_mot_t0;
     cmd_len = strlen(cmd_mot_t0);
     if (remote_cmd_send(eqmt_info, cmd_payload, cmd_len) < cmd_len) {
@@ -265,34 +434,32 @@ CMD_INIT_FAIL:
     return EXIT_FAILURE;
 }
 
+/* Called every int_step: the command is built on the stack, nothing allocated */
 int simgen_remote_tn_motion_send(struct simgen_eqmt_info_t *eqmt_info, void *data) {
-    uint8_t *cmd_payload = NULL;
-    char *cmd_mot_tn = NULL;
-    uint32_t cmd_len;
-
     struct simgen_motion_data_t *motion_info = (struct simgen_motion_data_t *)data;
+    struct simgen_mot_bin_frame_t bin_frame;
+    char cmd_mot_tn[SIMGEN_MOT_CMD_SIZE];
+    uint8_t *cmd_payload;
+    int cmd_len;
+
     /* Send tn mot by TCP*/
-    cmd_mot_tn = (char *)malloc(1024);
-    if (cmd_mot_tn == NULL)
-        goto CMD_Tn_FAIL;
-    simgen_remote_motion_cmd_gen(motion_info, cmd_mot_tn, 1023);
-    cmd_payload = (uint8_t *)cmd_mot_tn;
-    cmd_len = strlen(cmd_mot_tn);
+    if (eqmt_info->motion_format == SIMGEN_MOTION_FORMAT_BINARY) {
+        cmd_len = simgen_remote_motion_bin_encode(motion_info, &bin_frame);
+        cmd_payload = (uint8_t *)&bin_frame;
+    } else {
+        cmd_len = simgen_remote_motion_cmd_encode(motion_info, cmd_mot_tn, sizeof(cmd_mot_tn));
+        cmd_payload = (uint8_t *)cmd_mot_tn;
+    }
+    if (cmd_len < 0) {
+        fprintf(stderr, "[%s:%d] Invalid motion command %d !!\n", __FUNCTION__, __LINE__, motion_info->cmd_idx);
+        return EXIT_FAILURE;
+    }
     if (remote_cmd_send(eqmt_info, cmd_payload, cmd_len) < cmd_len) {
         fprintf(stderr, "[%s:%d] Error cmd send !!\n", __FUNCTION__, __LINE__);
-        goto CMD_Tn_FAIL;
-    }
-    simgen_remote_wait_cmd_resp(eqmt_info, cmd_mot_tn, cmd_resp, 0);
-    if (cmd_mot_tn != NULL) {
-        free(cmd_mot_tn);
-        cmd_mot_tn = NULL;
-    }
-CMD_Tn_FAIL:
-    if (cmd_mot_tn != NULL) {
-        free(cmd_mot_tn);
-        cmd_mot_tn = NULL;
+        return EXIT_FAILURE;
     }
-    return EXIT_FAILURE;
+    simgen_remote_wait_cmd_resp(eqmt_info, (const char *)cmd_payload, cmd_resp, 0);
+    return EXIT_SUCCESS;
 }
 
 void simgen_remote_end_scenario_now(struct simgen_eqmt_info_t *eqmt_info) {
@@ -0,0 +1,194 @@
+#define _GNU_SOURCE
+#include "simgen_sender.h"
+#include <sched.h>
+
+#define SS_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SS_LOAD_RELAXED(p)      __atomic_load_n((p), __ATOMIC_RELAXED)
+#define SS_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SS_STORE_RELAXED(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+static double ts_sec(const struct timespec *ts) {
+    return ts->tv_sec + ts->tv_nsec * 1e-9;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts_sec(&ts);
+}
+
+/* max / sum of a sender thread statistic, kept in ns for the atomic ops */
+static void stat_add(uint64_t *max_ns, uint64_t *sum_ns, double sec) {
+    uint64_t ns = (uint64_t)(sec * 1e9);
+    if (ns > *max_ns)
+        SS_STORE_RELAXED(max_ns, ns);
+    SS_STORE_RELAXED(sum_ns, *sum_ns + ns);
+}
+
+static void sleep_until(double deadline) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)deadline;
+    ts.tv_nsec = (long)((deadline - ts.tv_sec) * 1e9);
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+}
+
+static void *simgen_sender_thread(void *arg) {
+    struct simgen_sender_t *S = (struct simgen_sender_t *)arg;
+    struct simgen_sender_slot_t *slot;
+    double base = 0.0, t0 = 0.0, deadline, now, lateness, latency;
+    uint32_t reader, depth;
+    int prebuffer = 1;
+
+    while (SS_LOAD_RELAXED(&S->running)) {
+        reader = SS_LOAD_RELAXED(&S->reader_idx);
+        S->writer_cache = SS_LOAD_ACQUIRE(&S->writer_idx);
+        depth = S->writer_cache - reader;
+        if (depth > S->depth_max)
+            SS_STORE_RELAXED(&S->depth_max, depth);
+
+        if (prebuffer) {
+            if (depth < S->cfg.lookahead) {
+                sleep_until(now_sec() + S->cfg.period * 0.5);
+                continue;
+            }
+            slot = &S->slot[reader & (SIMGEN_SENDER_RING_SIZE - 1)];
+            base = now_sec();
+            t0 = slot->motion.sim_time.second;
+            prebuffer = 0;
+            SS_STORE_RELAXED(&S->rebase, S->rebase + 1);
+        }
+        if (depth == 0) {
+            SS_STORE_RELAXED(&S->underrun, S->underrun + 1);
+            prebuffer = 1;
+            continue;
+        }
+
+        slot = &S->slot[reader & (SIMGEN_SENDER_RING_SIZE - 1)];
+        deadline = base + (slot->motion.sim_time.second - t0);
+        now = now_sec();
+        if (deadline - now > SIMGEN_SENDER_MAX_WAIT) {
+            /* sim_time jumped ahead, follow it */
+            base = now;
+            t0 = slot->motion.sim_time.second;
+            deadline = now;
+            SS_STORE_RELAXED(&S->rebase, S->rebase + 1);
+        } else if (deadline > now) {
+            sleep_until(deadline);
+            now = now_sec();
+        }
+        lateness = now - deadline;
+        if (lateness < 0.0)
+            lateness = -lateness;
+
+        if (S->send(S->ctx, &slot->motion) != 0)
+            SS_STORE_RELAXED(&S->send_err, S->send_err + 1);
+        latency = now_sec() - ts_sec(&slot->push_ts);
+        SS_STORE_RELEASE(&S->reader_idx, reader + 1);
+
+        stat_add(&S->jitter_max_ns, &S->jitter_sum_ns, lateness);
+        stat_add(&S->latency_max_ns, &S->latency_sum_ns, latency);
+        SS_STORE_RELAXED(&S->sent, S->sent + 1);
+    }
+    return NULL;
+}
+
+int simgen_sender_start(struct simgen_sender_t *S, const struct simgen_sender_cfg_t *cfg,
+                        simgen_sender_fn send, void *ctx) {
+    struct sched_param param;
+    pthread_attr_t attr;
+    cpu_set_t cpus;
+    int err;
+
+    if (cfg->lookahead == 0 || cfg->lookahead >= SIMGEN_SENDER_RING_SIZE || cfg->period <= 0.0) {
+        fprintf(stderr, "[%s] lookahead %u must be in 1..%d, period %f > 0\n", __FUNCTION__,
+                cfg->lookahead, SIMGEN_SENDER_RING_SIZE - 1, cfg->period);
+        return -1;
+    }
+    memset(S, 0, sizeof(*S));
+    S->cfg = *cfg;
+    S->send = send;
+    S->ctx = ctx;
+    S->running = 1;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    pthread_attr_init(&attr);
+    if (cfg->priority > 0) {
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        param.sched_priority = cfg->priority;
+        pthread_attr_setschedparam(&attr, &param);
+    }
+    if (cfg->cpu >= 0) {
+        CPU_ZERO(&cpus);
+        CPU_SET(cfg->cpu, &cpus);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    }
+    err = pthread_create(&S->thread, &attr, simgen_sender_thread, S);
+    if (err == EPERM && cfg->priority > 0) {
+        fprintf(stderr, "[%s] SCHED_FIFO %d not permitted, default policy\n", __FUNCTION__, cfg->priority);
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        err = pthread_create(&S->thread, &attr, simgen_sender_thread, S);
+    }
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        fprintf(stderr, "[%s] pthread_create: %s\n", __FUNCTION__, strerror(err));
+        S->running = 0;
+        return -1;
+    }
+    return 0;
+}
+
+/* producer side only, never blocks: a full ring drops the sample */
+int simgen_sender_push(struct simgen_sender_t *S, const struct simgen_motion_data_t *motion) {
+    struct simgen_sender_slot_t *slot;
+    uint32_t writer = SS_LOAD_RELAXED(&S->writer_idx);
+
+    if (writer - S->reader_cache == SIMGEN_SENDER_RING_SIZE) {
+        S->reader_cache = SS_LOAD_ACQUIRE(&S->reader_idx);
+        if (writer - S->reader_cache == SIMGEN_SENDER_RING_SIZE) {
+            SS_STORE_RELAXED(&S->overflow, S->overflow + 1);
+            return -1;
+        }
+    }
+    slot = &S->slot[writer & (SIMGEN_SENDER_RING_SIZE - 1)];
+    memcpy(&slot->motion, motion, sizeof(slot->motion));
+    clock_gettime(CLOCK_MONOTONIC, &slot->push_ts);
+    SS_STORE_RELEASE(&S->writer_idx, writer + 1);
+    SS_STORE_RELAXED(&S->pushed, S->pushed + 1);
+    return 0;
+}
+
+/* snapshot from any thread, each counter read atomically */
+void simgen_sender_stats(struct simgen_sender_t *S, struct simgen_sender_stats_t *stats) {
+    stats->pushed = SS_LOAD_RELAXED(&S->pushed);
+    stats->overflow = SS_LOAD_RELAXED(&S->overflow);
+    stats->sent = SS_LOAD_RELAXED(&S->sent);
+    stats->send_err = SS_LOAD_RELAXED(&S->send_err);
+    stats->underrun = SS_LOAD_RELAXED(&S->underrun);
+    stats->rebase = SS_LOAD_RELAXED(&S->rebase);
+    stats->depth_max = SS_LOAD_RELAXED(&S->depth_max);
+    stats->latency_max = SS_LOAD_RELAXED(&S->latency_max_ns) * 1e-9;
+    stats->jitter_max = SS_LOAD_RELAXED(&S->jitter_max_ns) * 1e-9;
+    stats->latency_mean = stats->sent ? SS_LOAD_RELAXED(&S->latency_sum_ns) * 1e-9 / stats->sent : 0.0;
+    stats->jitter_mean = stats->sent ? SS_LOAD_RELAXED(&S->jitter_sum_ns) * 1e-9 / stats->sent : 0.0;
+}
+
+/* samples still in the ring are dropped */
+void simgen_sender_stop(struct simgen_sender_t *S) {
+    struct simgen_sender_stats_t stats;
+
+    if (!SS_LOAD_RELAXED(&S->running))
+        return;
+    SS_STORE_RELAXED(&S->running, 0);
+    pthread_join(S->thread, NULL);
+    simgen_sender_stats(S, &stats);
+    fprintf(stderr, "[%s] pushed %lu sent %lu overflow %lu underrun %lu send_err %lu depth_max %u\n",
+            __FUNCTION__, (unsigned long)stats.pushed, (unsigned long)stats.sent, (unsigned long)stats.overflow,
+            (unsigned long)stats.underrun, (unsigned long)stats.send_err, stats.depth_max);
+    fprintf(stderr, "[%s] latency mean %.3f max %.3f ms, jitter mean %.3f max %.3f ms\n", __FUNCTION__,
+            stats.latency_mean * 1e3, stats.latency_max * 1e3, stats.jitter_mean * 1e3, stats.jitter_max * 1e3);
+}
@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the CONTROL Module On Board)
 LIBRARY DEPENDENCY:
-      ((../src/Control.cpp))
+      ((../src/Control.cpp)
+       (../../aux/src/checkpoint.cpp))
 PROGRAMMERS:
       (((Chung-Fan Yang) () () () ))
 *******************************************************************************/
@@ -13,6 +14,8 @@ PROGRAMMERS:
 #include "matrix/utility.hh"
 #include "math_utility.hh"
 
+class Checkpoint;
+
 class Control {
     TRICK_INTERFACE(Control);
 
@@ -23,6 +26,8 @@ class Control {
         Control& operator=(const Control& other);
 
         void initialize();
+        /* Controller integrators, gains and commands, see checkpoint.hh */
+        void checkpoint(Checkpoint &cp);
 
         void control(double int_step);
         // double control_normal_accel(double ancomx, double int_step);
@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the GPS compute unit On Board)
 LIBRARY DEPENDENCY:
-      ((../src/GPS.cpp))
+      ((../src/GPS.cpp)
+       (../../aux/src/checkpoint.cpp))
 PROGRAMMERS:
       (((Lai Chun Hsu) () () () ))
 *******************************************************************************/
@@ -13,6 +14,8 @@ PROGRAMMERS:
 #include <armadillo>
 #include "Transmit_channel.hh"
 
+class Checkpoint;
+
 class GPS_FSW{
     TRICK_INTERFACE(GPS_FSW);
 
@@ -31,6 +34,8 @@ class GPS_FSW{
     std::function<transmit_channel*()> grab_transmit_data;
 
     void initialize(double int_step);
+    /* Filter states and covariance, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
 
     arma::vec3 get_SXH();
     arma::vec3 get_VXH();
@@ -4,13 +4,16 @@
 PURPOSE:
       (Describe the GUIDANCE Module On Board)
 LIBRARY DEPENDENCY:
-      ((../src/Guidance.cpp))
+      ((../src/Guidance.cpp)
+       (../../aux/src/checkpoint.cpp))
 PROGRAMMERS:
       (((Chung-Fan Yang) () () () ))
 *******************************************************************************/
 #include <armadillo>
 #include "aux.hh"
 
+class Checkpoint;
+
 class Guidance {
     TRICK_INTERFACE(Guidance);
 
@@ -22,6 +25,8 @@ class Guidance {
 
     void default_data();
     void initialize();
+    /* Guidance flags and LTG iteration state, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
 
     void guidance(double int_step);
 
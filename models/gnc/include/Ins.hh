@@ -4,7 +4,8 @@
 PURPOSE:
       (Describe the INS Module On Board, Error equations based on Zipfel, Figure 10.27, space stabilized INS with GPS updates)
 LIBRARY DEPENDENCY:
-      ((../src/Ins.cpp))
+      ((../src/Ins.cpp)
+       (../../aux/src/checkpoint.cpp))
 *******************************************************************************/
 #include <functional>
 #include <armadillo>
@@ -17,6 +18,7 @@ LIBRARY DEPENDENCY:
 #include <cassert>
 #include "aux.hh"
 #include "cad_utility.hh"
+#include "env/gravity_harmonic.h"
 #include "matrix/utility.hh"
 #include "dm_delta_ut.hh"
 #include <fstream>
@@ -24,6 +26,8 @@ LIBRARY DEPENDENCY:
 
 class time_management;
 
+class Checkpoint;
+
 class INS {
     TRICK_INTERFACE(INS);
 
@@ -35,6 +39,8 @@ class INS {
     INS& operator=(const INS& other);
 
     void initialize();
+    /* Navigation error states and solution, see checkpoint.hh */
+    void checkpoint(Checkpoint &cp);
 
     /* Internal Getter */
     arma::mat build_WEII();
@@ -141,7 +147,7 @@ class INS {
     arma::vec3 euler_angle(arma::mat33 TBD);
     arma::mat33 build_321_rotation_matrix(arma::vec3 angle);
 
-    arma::vec AccelHarmonic(arma::vec3 SBII, double CS[21][21], int n_max, int m_max, arma::mat33 TEIC);
+    arma::vec AccelHarmonic(arma::vec3 SBII, const double CS[][GRAVITY_N_JGM3+1], int n_max, int m_max, arma::mat33 TEIC);
 
 
 
@@ -16,6 +16,7 @@ LIBRARY DEPENDENCY:
 #include <math.h>
 #include <stdio.h>
 #include "cad_utility_c.h"
+#include "env/gravity_harmonic.h"
 #include "math_utility_c.h"
 #include "time_utility_c.h"
 
@@ -107,7 +108,7 @@ extern "C" {
     int load_angle(double yaw, double roll, double pitch, GPS_TIME gps_time);
     int load_geodetic_velocity(double alpha0x, double beta0x, double dvbe);
     int calculate_INS_derived_TEI(GPS_TIME gps, gsl_matrix *TEIC);
-    int AccelHarmonic(const gsl_vector *SBII, double CS[21][21], int n_max, int m_max, const gsl_matrix *TEIC, gsl_vector *acc_out);
+    int AccelHarmonic(const gsl_vector *SBII, const double CS[][GRAVITY_N_JGM3+1], int n_max, int m_max, const gsl_matrix *TEIC, gsl_vector *acc_out);
     int DCM_2_Euler_angle(const gsl_matrix *TBD, double *phibdc, double *thtbdc, double *psibdc);
     int calculate_INS_derived_phip(gsl_vector *VBECB, double *phipc);
     int calculate_INS_derived_thtvd(gsl_vector *VBECD, double *thtvd);
@@ -1,4 +1,5 @@
 #include "Control.hh"
+#include "checkpoint.hh"
 
 #include "integrate.hh"
 #include "math_utility.hh"
@@ -92,6 +93,22 @@ void Control::initialize() {
 // 091214 Modified for ROCKET6, PZi
 ///////////////////////////////////////////////////////////////////////////////
 
+void Control::checkpoint(Checkpoint &cp) {
+    cp.section("CONTROL");
+    cp(delecx, delrcx, maut, mfreeze, waclp, zaclp, paclp, delimx, drlimx, yyd, yy, zzd, zz, alcomx_actual,
+       ancomx_actual, GAINFP, gainp, gainl, gkp, gkphi, isetc2, wacly, zacly, pacly, gainy, GAINFY,
+       factwaclp, factwacly, alcomx, ancomx, qqdx, grate, gainff, thtvdcomx, GAINGAM, pgam, wgam, zgam,
+       fmasse, mdot, fmass0, xcg_0, xcg_1, isp, IBBB0, IBBB1, IBBB2, CONTROLCMD, CMDQ, TCMDQ, thterror,
+       perrori, perrorp, perror_old, pitchiout_old, pN, pdout_old, kpp, kpi, kpd, kppp, thterrort,
+       perrorit, perrorpt, perror_oldt, pitchiout_oldt, pdout_oldt, rollerror, rerrori, rerrorp,
+       rerror_old, rolliout_old, rN, rdout_old, krp, kri, krd, krpp, yawerror, yerrori, yerrorp,
+       yerror_old, yawiout_old, yN, ydout_old, kyp, kyi, kyd, kypp, aoaerror, aoaerrori, aoaerrorp,
+       aoaerror_old, aoaiout_old, aoaN, aoadout_old, kaoap, kaoai, kaoad, kaoapp, aoaerror_smooth_old,
+       aoaerror_new, aoaerror_out_old, theta_a_cmd, theta_b_cmd, theta_c_cmd, theta_d_cmd, lx, rollcmd,
+       pitchcmd, yawcmd, aoacmd, pitchcmd_new, pitchcmd_old, pitchcmd_out_old, delta_euler, euler, xcg,
+       thrust, mass_ratio, WBICBT, CMDG, reference_point, d);
+}
+
 void Control::control(double int_step) {
     arma::mat33 TLI = grab_TBICI();
     arma::mat33 TBIC = grab_TBIC();
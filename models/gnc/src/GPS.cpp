@@ -10,6 +10,7 @@
 
 #include "Ins.hh"
 #include "GPS.hh"
+#include "checkpoint.hh"
 GPS_FSW::GPS_FSW()
 :   time(time_management::get_instance()),
     MATRIX_INIT(FF, 8, 8),
@@ -91,6 +92,14 @@ void GPS_FSW::initialize(double int_step) {
 
 
 
+void GPS_FSW::checkpoint(Checkpoint &cp) {
+    /* The clock and range error inputs (ucfreq_noise, PR_*, DR_*) are left to the run */
+    cp.section("GPSFSW");
+    cp(ucfreq_error, ucfreqm, std_pos, std_vel, std_ucbias, gps_pos_meas, gps_vel_meas, state_pos,
+       state_vel, ucbias_error, ppos, pvel, qpos, qvel, rpos, rvel, factr, gps_acq, gps_epoch, time_gps,
+       FF, PHI, PP, PP0, factq, qclockb, qclockf, SXH, VXH, CXH, ZZ, WEII, gps_step);
+}
+
 void GPS_FSW::filter_extrapolation(double int_step) {
     arma::mat88 QQ(arma::fill::zeros);  // local
 
@@ -1,4 +1,5 @@
 #include "Guidance.hh"
+#include "checkpoint.hh"
 
 #include "cad_utility.hh"
 
@@ -73,6 +74,15 @@ void Guidance::initialize() {
 // 091214 Modified for ROCKET6, PZi
 //////////////////////////////////////////////////////////////////////////////
 
+void Guidance::checkpoint(Checkpoint &cp) {
+    cp.section("GUIDANCE");
+    cp(UTBC, UTIC, alphacomx, betacomx, init_flag, inisw_flag, skip_flag, ipas_flag, ipas2_flag,
+       print_flag, time_ltg, ltg_count, mguide, ltg_step, RBIAS, beco_flag, dbi_desired, dvbi_desired,
+       thtvdx_desired, num_stages, delay_ignition, amin, char_time1, char_time2, char_time3, exhaust_vel1,
+       exhaust_vel2, exhaust_vel3, burnout_epoch1, burnout_epoch2, burnout_epoch3, lamd_limit, RGRAV, RGO,
+       VGO, SDII, UD, UY, UZ, vgom, tgo, nst, ULAM, LAMD, nstmax, lamd, dpd, dbd, ddb, dvdb, thtvddbx);
+}
+
 void Guidance::guidance(double int_step) {
     // local module variable
 
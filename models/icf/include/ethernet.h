@@ -13,8 +13,15 @@ struct ethernet_device_info_t {
     int client_addr_len;
     uint32_t header_size;
     int sock_type;
+    int link_state;         //  ENUM_ICF_LINK_STATE
+    uint32_t backoff_ms;    //  next reconnect delay
+    double retry_at_ms;     //  CLOCK_MONOTONIC time of the next connect()
+    int retry_cnt;
 };
 
+#define ETHERNET_BACKOFF_MIN_MS  10
+#define ETHERNET_BACKOFF_MAX_MS  1000
+
 #ifdef __cplusplus
 extern "C" {
 #endif
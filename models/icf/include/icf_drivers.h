@@ -1,6 +1,14 @@
 #ifndef MODELS_ICF_INCLUDE_ICF_DRIVERS_H_
 #define MODELS_ICF_INCLUDE_ICF_DRIVERS_H_
 #include "icf_export.h"
+#define ICF_BATCH_MAX  64  //  frames per send_batch / recv_batch call
+
+typedef enum _ENUM_ICF_LINK_STATE {
+    ICF_LINK_DOWN = 0,      //  waiting out a reconnect backoff
+    ICF_LINK_CONNECTING,    //  connect() in flight, or listening for the peer
+    ICF_LINK_UP
+}ENUM_ICF_LINK_STATE;
+
 struct icf_driver_ops {
     int (*open_interface)(void **priv_data, char *ifname, int netport);
     int (*recv_data)(void *priv_data, uint8_t *rx_buff, uint32_t buff_size);
@@ -17,6 +25,12 @@ struct icf_driver_ops {
     int (*close_interface)(void **priv_data);
     int (*get_client_fd)(void *priv_data);
     int (*accept)(void *priv_data);
+    int (*get_fd)(void *priv_data);
+    /* frames[i] is one frame; recv_batch sets iov_len to the received size */
+    int (*send_batch)(void *priv_data, struct iovec *frames, uint32_t nframes);
+    int (*recv_batch)(void *priv_data, struct iovec *frames, uint32_t nframes);
+    /* advance connect / accept without blocking, returns ENUM_ICF_LINK_STATE */
+    int (*link_poll)(void *priv_data);
 };
 
 extern struct icf_driver_ops *icf_drivers[];
@@ -16,11 +16,14 @@
 #include <net/if.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/ioctl.h>
 #include <time.h>
 #include <arpa/inet.h>
 #include <pthread.h>
 #include <sys/select.h>
+#include <sys/epoll.h>
+#include <poll.h>
 #include <endian.h>
 #include <limits.h>
 
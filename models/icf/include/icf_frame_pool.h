@@ -0,0 +1,41 @@
+/********************************* TRICK HEADER *******************************
+PURPOSE:
+      Fixed capacity frame pool for the ICF RX/TX rings
+LIBRARY DEPENDENCY:
+      (
+        (../src/icf_frame_pool.c)
+      )
+PROGRAMMERS:
+      (((Dung-Ru Tsai) () () () ))
+*******************************************************************************/
+#ifndef MODELS_ICF_INCLUDE_ICF_FRAME_POOL_H_
+#define MODELS_ICF_INCLUDE_ICF_FRAME_POOL_H_
+#include "icf_utility.h"
+#include "ringbuffer.h"
+#define ICF_FRAME_POOL_CELLS  64    //  one bit of free_mask per cell
+#define ICF_FRAME_SIZE        2048  //  largest L2 frame, header included
+
+/*
+ * Cells are taken and given back with atomic ops on free_mask, so any
+ * thread may return a cell to the pool it was borrowed from.
+ */
+struct icf_frame_pool {
+    uint64_t free_mask;
+    uint32_t exhaust_cnt;
+    uint32_t oversize_cnt;
+    struct ringbuffer_cell_t cell[ICF_FRAME_POOL_CELLS];
+    uint8_t frame[ICF_FRAME_POOL_CELLS][ICF_FRAME_SIZE];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+struct icf_frame_pool *icf_frame_pool_create(void);
+void icf_frame_pool_destroy(struct icf_frame_pool **pool);
+struct ringbuffer_cell_t *icf_frame_get(struct icf_frame_pool *pool, uint32_t size);
+void icf_frame_put(struct ringbuffer_cell_t *cell);
+uint32_t icf_frame_pool_available(struct icf_frame_pool *pool);
+#ifdef __cplusplus
+}
+#endif
+#endif   //  MODELS_ICF_INCLUDE_ICF_FRAME_POOL_H_
@@ -9,8 +9,10 @@ LIBRARY DEPENDENCY:
       	(../src/socket_can.c)
       	(../src/icf_trx_ctrl.c)
         (../src/ringbuffer.c)
+        (../src/icf_frame_pool.c)
         (../src/rs422_serialport.c)
         (../src/ethernet.c)
+        (../src/shm_channel.c)
         (../src/icf_drivers.c)
       )
 PROGRAMMERS:
@@ -19,12 +21,16 @@ PROGRAMMERS:
 
 #include "icf_utility.h"
 #include "ringbuffer.h"
+#include "icf_frame_pool.h"
 #include "icf_drivers.h"
 #include "trick/exec_proto.h"
 #include "flight_computer_eqpt.h"
 #define ICF_CTRLBLK_MAXQUEUE_NUMBER  20
 #define ICF_CTRLBLK_MAXPORT_NUMBER  16
+#define ICF_RX_DRAIN_MAX  ICF_FRAME_POOL_CELLS  //  frames per port per RX job
+#define ICF_LINK_WAIT_MS  15000  //  bring-up barrier, as long as the old 5 x 3 s connect retry
 #define ICF_EGSE_CONNECT_IP "127.0.0.1"
+#define ICF_RX_QIDX_BY_CANID  (-2)  //  port carries several RX queues, fc_can_cmd_dispatch() picks one
 
 #if defined(CONFIG_HIL_ENABLE)
 #define CAN_PORT_EN             1
@@ -147,8 +153,14 @@ typedef enum _ENUM_ICF_DRIVERS_ID {
     ICF_DRIVERS_ID1,
     ICF_DRIVERS_ID2,
     ICF_DRIVERS_ID3,
+    ICF_DRIVERS_ID4,
 }ENUM_ICF_DRIVERS_ID;
 
+typedef enum _ENUM_ICF_TRANSPORT {
+    ICF_TRANSPORT_SOCKET = 0,   //  Ethernet TCP links as mapped
+    ICF_TRANSPORT_SHM = 1       //  TCP links swapped for shared memory, co-located peers only
+}ENUM_ICF_TRANSPORT;
+
 typedef enum _ENUM_ICF_SYSTEM_TYPE {
     ICF_SYSTEM_TYPE_EGSE = 0,
     ICF_SYSTEM_TYPE_ESPS = 1,
@@ -171,6 +183,11 @@ struct icf_ctrl_port {
     uint8_t dev_type;
     void *drv_priv_data;
     struct icf_driver_ops *drv_priv_ops;
+    struct icf_frame_pool *rx_pool;
+    struct icf_frame_pool *tx_pool;
+    uint8_t rx_polled;  //  fd is in the control block epoll set
+    uint8_t rx_ready;   //  edge seen, not drained yet
+    uint8_t link_state; //  ENUM_ICF_LINK_STATE
 };
 
 struct icf_ctrl_queue {
@@ -184,8 +201,16 @@ struct icf_ctrl_queue {
 
 struct icf_ctrlblk_t {
     int system_type;
+    int epoll_fd;
+    int link_pending;   //  enabled ports whose link is not up yet, atomic
+    int transport;      //  ENUM_ICF_TRANSPORT, set before icf_ctrlblk_init
     struct icf_ctrl_queue *ctrlqueue[ICF_CTRLBLK_MAXQUEUE_NUMBER];
     struct icf_ctrl_port *ctrlport[ICF_CTRLBLK_MAXPORT_NUMBER];
+    /* direct indexed from the mapping tables by icf_ctrlblk_map_init, -1 where unmapped */
+    int8_t qidx_to_pidx[ICF_CTRLBLK_MAXQUEUE_NUMBER];
+    int8_t pidx_to_drivers_id[ICF_CTRLBLK_MAXPORT_NUMBER];
+    int8_t pidx_to_tblidx[ICF_CTRLBLK_MAXPORT_NUMBER];
+    int8_t pidx_to_rx_qidx[ICF_CTRLBLK_MAXPORT_NUMBER];    //  or ICF_RX_QIDX_BY_CANID, system fallback where no RX queue
 };
 
 #ifdef __cplusplus
@@ -195,14 +220,25 @@ extern "C" {
 void *icf_alloc_mem(size_t size);
 void icf_free_mem(void **ptr);
 int icf_ctrlblk_init(struct icf_ctrlblk_t* C, int system_type);
+int icf_ctrlblk_map_init(struct icf_ctrlblk_t* C, int system_type);
+const struct icf_mapping *icf_mapping_table(int system_type, int *nentries);
+int icf_dispatch_rx_frame(struct icf_ctrlblk_t* C, void *rxframe, int hw_port_idx);
+int icf_ctrlblk_set_transport(struct icf_ctrlblk_t* C, int transport);
 int icf_ctrlblk_deinit(struct icf_ctrlblk_t* C, int system_type);
 int icf_rx_dequeue(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t size);
 int icf_rx_ctrl_job(struct icf_ctrlblk_t* C, int pidx, int rx_buff_size);
+int icf_rx_poll_add(struct icf_ctrlblk_t* C, struct icf_ctrl_port *ctrlport);
+int icf_rx_poll(struct icf_ctrlblk_t* C);
+int icf_port_open(struct icf_ctrlblk_t* C, struct icf_ctrl_port *ctrlport);
+int icf_link_poll(struct icf_ctrlblk_t* C);
+int icf_link_state(struct icf_ctrlblk_t* C, int pidx);
+int icf_ctrlblk_wait_links(struct icf_ctrlblk_t* C, int timeout_ms);
 
 int icf_tx_direct(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t size);
 int icf_tx_enqueue(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t size);
 int icf_tx_dequeue(struct icf_ctrlblk_t* C, int qidx, void *payload);
 int icf_tx_ctrl_job(struct icf_ctrlblk_t* C, int qidx);
+int icf_tx_port_job(struct icf_ctrlblk_t* C, int pidx);
 void icf_heartbeat(void);
 
 #ifdef __cplusplus
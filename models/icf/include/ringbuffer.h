@@ -12,21 +12,35 @@ PROGRAMMERS:
 #define MODELS_ICF_INCLUDE_RINGBUFFER_H_
 #include "icf_utility.h"
 #define NUM_OF_CELL  256  //  power of 2
-#define GET_RINGCELL_IDX(idx)      ((idx) & (NUM_OF_CELL - 1))
+#define RB_CACHELINE_SIZE  64
+#define RB_CACHELINE_ALIGNED __attribute__((aligned(RB_CACHELINE_SIZE)))
 
+/*
+ * Single producer / single consumer ring, no lock.
+ * writer_idx is only stored by rb_push(), reader_idx only by rb_pop();
+ * each side keeps its own line and a cached copy of the other index, so
+ * the shared lines are only read when the ring looks full / empty.
+ */
 struct ringbuffer_t {
-        volatile uint32_t writer_idx;
-        volatile uint32_t reader_idx;
-        volatile uint32_t elem_num;
-        uint32_t ring_size;
+        /* producer */
+        uint32_t writer_idx RB_CACHELINE_ALIGNED;
+        uint32_t reader_cache;
         uint32_t full_cnt;
-        pthread_mutex_t ring_lock;
+        /* consumer */
+        uint32_t reader_idx RB_CACHELINE_ALIGNED;
+        uint32_t writer_cache;
+        /* fixed after rb_init() */
+        uint32_t ring_size RB_CACHELINE_ALIGNED;
+        uint32_t ring_mask;
         void *pCell[NUM_OF_CELL];
 };
 
+struct icf_frame_pool;
+
 struct ringbuffer_cell_t {
     uint32_t frame_full_size;
     void *l2frame;
+    struct icf_frame_pool *pool;  //  owner, see icf_frame_pool.h
 };
 
 #ifdef __cplusplus
@@ -34,8 +48,9 @@ extern "C" {
 #endif
 int32_t rb_init(struct ringbuffer_t *rb, uint32_t size);
 void rb_deinit(struct ringbuffer_t *rb);
-void rb_push(struct ringbuffer_t *rb, void *payload);
+int32_t rb_push(struct ringbuffer_t *rb, void *payload);
 void *rb_pop(struct ringbuffer_t *rb);
+uint32_t rb_count(struct ringbuffer_t *rb);
 #ifdef __cplusplus
 }
 #endif
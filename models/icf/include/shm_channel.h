@@ -0,0 +1,55 @@
+#ifndef MODELS_ICF_INCLUDE_SHM_CHANNEL_H_
+#define MODELS_ICF_INCLUDE_SHM_CHANNEL_H_
+#include "icf_utility.h"
+#include "icf_drivers.h"
+
+/*
+ * Point-to-point byte stream between two processes on one host, over a
+ * POSIX shared memory segment: one single-producer / single-consumer ring
+ * per direction, readers and writers sleep on a futex once a short spin
+ * runs out. Stream semantics are those of the TCP link it stands in for.
+ *
+ * A ring rather than a seqlock or double buffer: the Transceiver legacy
+ * and schema streams and the ICF frames are in-order byte streams in both
+ * directions, and a latest-value slot would drop or tear every frame the
+ * reader has not consumed before the next write.
+ */
+#define SHM_CHANNEL_RING_SIZE  (256 * 1024)  //  bytes per direction, power of two
+#define SHM_CHANNEL_SPIN       4000          //  polls before sleeping, SMP only
+#define SHM_CHANNEL_WAIT_MS    100           //  futex timeout, peer liveness re-check
+
+typedef enum _ENUM_SHM_CHANNEL_ROLE {
+    SHM_CHANNEL_SERVER = 0,     //  creates the segment, replaces a stale one
+    SHM_CHANNEL_CLIENT = 1,     //  attaches once the server is up
+    SHM_CHANNEL_ANY = 2         //  first one in creates, as tc_multiconnect pairs its peers
+}ENUM_SHM_CHANNEL_ROLE;
+
+struct shm_segment_t;
+struct shm_ring_t;
+
+struct shm_channel_t {
+    char name[NAME_MAX];
+    int want_role;              //  ENUM_SHM_CHANNEL_ROLE as opened
+    int role;                   //  SHM_CHANNEL_SERVER or SHM_CHANNEL_CLIENT once mapped
+    int link_state;             //  ENUM_ICF_LINK_STATE
+    int spin;
+    struct shm_segment_t *seg;
+    struct shm_ring_t *tx;
+    struct shm_ring_t *rx;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int shm_channel_open(struct shm_channel_t **ch, const char *name, int role);
+int shm_channel_poll(struct shm_channel_t *ch);
+int shm_channel_write(struct shm_channel_t *ch, const void *buf, uint32_t size);
+int shm_channel_writev(struct shm_channel_t *ch, const struct iovec *iov, uint32_t iovcnt);
+int shm_channel_read(struct shm_channel_t *ch, void *buf, uint32_t size);
+int shm_channel_close(struct shm_channel_t **ch);
+int shm_icf_init(void **priv_data, char *ifname, int netport);
+int shm_icf_deinit(void **priv_data);
+#ifdef __cplusplus
+}
+#endif
+#endif  // MODELS_ICF_INCLUDE_SHM_CHANNEL_H_
@@ -2,6 +2,7 @@
 #define MODELS_ICF_INCLUDE_SOCKET_CAN_H_
 
 #include "icf_utility.h"
+#include "icf_drivers.h"
 
 #define CAN_MAX_DLEN  8
 
@@ -11,6 +12,10 @@ struct can_device_info_t {
     struct ifreq ifr;
     struct sockaddr_can addr;
     fd_set *set;
+    int stamping;                               //  SO_TIMESTAMPING flags in effect, 0 when off
+    uint32_t rx_stamp_cnt;                      //  frames of the last recv_batch
+    struct timespec rx_stamp[ICF_BATCH_MAX];    //  per frame, zero when the kernel gave none
+    uint8_t rx_stamp_hw[ICF_BATCH_MAX];         //  1 when rx_stamp came from the controller clock
 };
 
 
@@ -21,6 +26,9 @@ int socket_can_init(void **priv_data, char *ifname, int netport);
 int can_data_recv_gather(void *priv_data, uint8_t *rx_buff, uint32_t buff_size);
 int can_data_recv(void *priv_data, uint8_t *rx_buff, uint32_t buff_size);
 int can_frame_recv(void *priv_data, uint8_t *rx_buff, uint32_t buff_size);
+int can_frame_send_batch(void *priv_data, struct iovec *frames, uint32_t nframes);
+int can_frame_recv_batch(void *priv_data, struct iovec *frames, uint32_t nframes);
+int socketcan_rx_timestamps(void *priv_data, struct timespec *stamps, uint8_t *hw, uint32_t nstamps);
 #ifdef __cplusplus
 }
 #endif
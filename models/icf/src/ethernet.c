@@ -1,5 +1,58 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  /* sendmmsg, recvmmsg */
+#endif
 #include "ethernet.h"
 
+static double ethernet_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+static int ethernet_set_nonblock(int fd, int enable) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0)
+        return -1;
+    flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(fd, F_SETFL, flags);
+}
+
+/* data path stays blocking, it paces the SIL/PIL lockstep */
+static void ethernet_link_up(struct ethernet_device_info_t *dev_info) {
+    ethernet_set_nonblock(dev_info->client_fd, 0);
+    dev_info->link_state = ICF_LINK_UP;
+    dev_info->backoff_ms = ETHERNET_BACKOFF_MIN_MS;
+    dev_info->retry_cnt = 0;
+    fprintf(stderr, "%s: link up %s:%d\n", __FUNCTION__, dev_info->ifname, ntohs(dev_info->client_addr.sin_port));
+}
+
+static void ethernet_link_backoff(struct ethernet_device_info_t *dev_info) {
+    if (dev_info->client_fd >= 0)
+        close(dev_info->client_fd);
+    dev_info->client_fd = -1;
+    dev_info->link_state = ICF_LINK_DOWN;
+    dev_info->retry_at_ms = ethernet_now_ms() + dev_info->backoff_ms;
+    dev_info->retry_cnt++;
+    fprintf(stderr, "ethernet_tcp_socket_client: Connection error retry...%d in %u ms\n",
+            dev_info->retry_cnt, dev_info->backoff_ms);
+    dev_info->backoff_ms *= 2;
+    if (dev_info->backoff_ms > ETHERNET_BACKOFF_MAX_MS)
+        dev_info->backoff_ms = ETHERNET_BACKOFF_MAX_MS;
+}
+
+/* non-blocking connect(), completion is picked up by ethernet_link_poll() */
+static void ethernet_tcp_connect_start(struct ethernet_device_info_t *dev_info) {
+    if ((dev_info->client_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0)) < 0)
+        errExit("Error while opening socket");
+    if (connect(dev_info->client_fd, (struct sockaddr *)&dev_info->client_addr, sizeof(dev_info->client_addr)) == 0) {
+        ethernet_link_up(dev_info);
+    } else if (errno == EINPROGRESS) {
+        dev_info->link_state = ICF_LINK_CONNECTING;
+    } else {
+        ethernet_link_backoff(dev_info);
+    }
+}
+
 static int ethernet_tcp_socket_server(struct ethernet_device_info_t *dev_info, char *ifname, int net_port) {
     int err;
     int optval = 1; /* prevent from address being taken */
@@ -29,17 +82,12 @@ static int ethernet_tcp_socket_server(struct ethernet_device_info_t *dev_info, c
         errExit("ethernet_tcp_socket_server: listen() failed");
     }
 
+    /* the client is accepted by ethernet_link_poll() */
+    ethernet_set_nonblock(dev_info->server_fd, 1);
     dev_info->client_addr_len = sizeof(dev_info->client_addr);
-    fprintf(stderr, "ethernet_tcp_socket_server: Waiting for the client ...\n");
-    dev_info->client_fd = accept(dev_info->server_fd, (struct sockaddr*) &(dev_info->client_addr), (socklen_t*)&dev_info->client_addr_len);
-    if (dev_info->client_fd < 0) {
-        fprintf(stderr, "ethernet_tcp_socket_server: Accept Fail ... %s:%d\n", ifname, net_port);
-        goto error;
-    }
-    fprintf(stderr, "ethernet_tcp_socket_server: Accept on ... %s:%d\n", ifname, net_port);
+    dev_info->link_state = ICF_LINK_CONNECTING;
+    fprintf(stderr, "ethernet_tcp_socket_server: Waiting for the client on %s:%d ...\n", ifname, net_port);
     return 0;
-error:
-    return -1;
 }
 
 static int ethernet_udp_socket_server(struct ethernet_device_info_t *dev_info, char *ifname, int net_port) {
@@ -86,31 +134,13 @@ static int ethernet_create_server(struct ethernet_device_info_t *dev_info, char
 }
 
 static int ethernet_tcp_socket_client(struct ethernet_device_info_t *dev_info, char *ifname, int net_port) {
-    int err;
-    int retry_cnt = 0;
-    if ((dev_info->client_fd = socket(AF_INET , SOCK_STREAM , 0)) < 0) {
-        errExit("Error while opening socket");
-        return -1;
-    }
     dev_info->client_addr.sin_family = AF_INET;
     dev_info->client_addr.sin_addr.s_addr = inet_addr(ifname);
     dev_info->client_addr.sin_port = htons(net_port);
     dev_info->client_addr_len = sizeof(dev_info->client_addr);
-    while (retry_cnt < 5) {
-        err = connect(dev_info->client_fd, (struct sockaddr *)&dev_info->client_addr, sizeof(dev_info->client_addr));
-        if (err == 0)
-            break;
-        if (err < 0) {
-            sleep(3);
-            retry_cnt++;
-            fprintf(stderr, "ethernet_tcp_socket_client: Connection error retry...%d\n", retry_cnt);
-        }
-    }
-    if (err < 0) {
-        fprintf(stderr, "ethernet_tcp_socket_client: Connection error !!\n");
-        return -1;
-    }
-    fprintf(stderr, "ethernet_tcp_socket_client: Connection %s:%d\n", ifname, net_port);
+    dev_info->backoff_ms = ETHERNET_BACKOFF_MIN_MS;
+    ethernet_tcp_connect_start(dev_info);
+    fprintf(stderr, "ethernet_tcp_socket_client: Connecting %s:%d\n", ifname, net_port);
     return 0;
 }
 
@@ -167,6 +197,9 @@ int ethernet_init(void **priv_data, char *ifname, int netport) {
     }
      /* TCP Blocking Socket*/
     dev_info->sock_type = SOCK_STREAM;
+    dev_info->server_fd = -1;
+    dev_info->client_fd = -1;
+    dev_info->link_state = ICF_LINK_DOWN;
     strncpy(dev_info->ifname, ifname, IFNAMSIZ);
     if (strstr(ifname, "_server")) {
         if (ethernet_create_server(dev_info, ifname, netport) < 0)
@@ -212,6 +245,9 @@ int ethernet_udp_init(void **priv_data, char *ifname, int netport) {
     }
      /* TCP Blocking Socket*/
     dev_info->sock_type = SOCK_DGRAM;
+    dev_info->server_fd = -1;
+    dev_info->client_fd = -1;
+    dev_info->link_state = ICF_LINK_UP;  /* connectionless */
     strncpy(dev_info->ifname, ifname, IFNAMSIZ);
     if (strstr(ifname, "_server")) {
         if (ethernet_create_server(dev_info, ifname, netport) < 0)
@@ -316,6 +352,125 @@ int ethernet_udp_data_sendto(void *priv_data, uint8_t *payload, uint32_t frame_l
     return offset;
 }
 
+/* TCP: all frames coalesced into writev() calls */
+int ethernet_data_send_batch(void *priv_data, struct iovec *frames, uint32_t nframes) {
+    struct iovec iov[ICF_BATCH_MAX];
+    struct ethernet_device_info_t *dev_info = priv_data;
+    uint32_t idx = 0;
+    ssize_t wdlen;
+
+    if (nframes > ICF_BATCH_MAX)
+        nframes = ICF_BATCH_MAX;
+    memcpy(iov, frames, sizeof(struct iovec) * nframes);
+    while (idx < nframes) {
+        if ((wdlen = writev(dev_info->client_fd, iov + idx, nframes - idx)) < 0) {
+            if (errno == EINTR)
+                continue;
+            fprintf(stderr, "%s: %s\n", __FUNCTION__, strerror(errno));
+            return -1;
+        }
+        while (idx < nframes && (size_t)wdlen >= iov[idx].iov_len) {
+            wdlen -= iov[idx].iov_len;
+            idx++;
+        }
+        if (idx < nframes) {
+            iov[idx].iov_base = (uint8_t *)iov[idx].iov_base + wdlen;
+            iov[idx].iov_len -= wdlen;
+        }
+    }
+    return nframes;
+}
+
+/*
+ * TCP: fill as many whole frames as the socket already holds with one
+ * recvmsg(); a frame cut in half is completed with a blocking receive.
+ */
+int ethernet_data_recv_batch(void *priv_data, struct iovec *frames, uint32_t nframes) {
+    struct msghdr msg;
+    struct ethernet_device_info_t *dev_info = priv_data;
+    uint32_t idx = 0;
+    ssize_t rdlen;
+    int rest;
+
+    if (nframes > ICF_BATCH_MAX)
+        nframes = ICF_BATCH_MAX;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = frames;
+    msg.msg_iovlen = nframes;
+    if ((rdlen = recvmsg(dev_info->client_fd, &msg, MSG_DONTWAIT)) < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return 0;
+        fprintf(stderr, "%s: %s\n", __FUNCTION__, strerror(errno));
+        return -1;
+    }
+    while (idx < nframes && (size_t)rdlen >= frames[idx].iov_len) {
+        rdlen -= frames[idx].iov_len;
+        idx++;
+    }
+    if (idx < nframes && rdlen > 0) {
+        rest = ethernet_data_recv(priv_data, (uint8_t *)frames[idx].iov_base + rdlen, frames[idx].iov_len - rdlen);
+        if (rest == (int)(frames[idx].iov_len - rdlen))
+            idx++;
+    }
+    return idx;
+}
+
+/* UDP: one datagram per frame, one sendmmsg() per batch */
+int ethernet_udp_data_sendto_batch(void *priv_data, struct iovec *frames, uint32_t nframes) {
+    struct mmsghdr msgs[ICF_BATCH_MAX];
+    struct ethernet_device_info_t *dev_info = priv_data;
+    uint32_t idx, sent = 0;
+    int source_fd, ret;
+    source_fd = dev_info->server_enable ? dev_info->server_fd : dev_info->client_fd;
+
+    if (nframes > ICF_BATCH_MAX)
+        nframes = ICF_BATCH_MAX;
+    memset(msgs, 0, sizeof(struct mmsghdr) * nframes);
+    for (idx = 0; idx < nframes; idx++) {
+        msgs[idx].msg_hdr.msg_name = &dev_info->client_addr;
+        msgs[idx].msg_hdr.msg_namelen = sizeof(dev_info->client_addr);
+        msgs[idx].msg_hdr.msg_iov = &frames[idx];
+        msgs[idx].msg_hdr.msg_iovlen = 1;
+    }
+    while (sent < nframes) {
+        if ((ret = sendmmsg(source_fd, msgs + sent, nframes - sent, 0)) < 0) {
+            if (errno == EINTR)
+                continue;
+            fprintf(stderr, "%s: %s\n", __FUNCTION__, strerror(errno));
+            return sent ? (int)sent : -1;
+        }
+        sent += ret;
+    }
+    return sent;
+}
+
+/* UDP: whatever datagrams are queued, up to nframes, with one recvmmsg() */
+int ethernet_udp_data_recvfrom_batch(void *priv_data, struct iovec *frames, uint32_t nframes) {
+    struct mmsghdr msgs[ICF_BATCH_MAX];
+    struct ethernet_device_info_t *dev_info = priv_data;
+    int idx, ret;
+    int source_fd;
+    source_fd = dev_info->server_enable ? dev_info->server_fd : dev_info->client_fd;
+
+    if (nframes > ICF_BATCH_MAX)
+        nframes = ICF_BATCH_MAX;
+    memset(msgs, 0, sizeof(struct mmsghdr) * nframes);
+    for (idx = 0; idx < (int)nframes; idx++) {
+        msgs[idx].msg_hdr.msg_name = &dev_info->client_addr;
+        msgs[idx].msg_hdr.msg_namelen = sizeof(dev_info->client_addr);
+        msgs[idx].msg_hdr.msg_iov = &frames[idx];
+        msgs[idx].msg_hdr.msg_iovlen = 1;
+    }
+    if ((ret = recvmmsg(source_fd, msgs, nframes, MSG_DONTWAIT, NULL)) < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return 0;
+        fprintf(stderr, "%s: %s\n", __FUNCTION__, strerror(errno));
+        return -1;
+    }
+    for (idx = 0; idx < ret; idx++)
+        frames[idx].iov_len = msgs[idx].msg_len;
+    return ret;
+}
 
 uint32_t ethernet_get_header_size(void *priv_data) {
     struct ethernet_device_info_t *dev_info = priv_data;
@@ -331,12 +486,55 @@ int ethernet_get_client_fd(void *priv_data) {
     return dev_info->client_fd;
 }
 
+int ethernet_get_fd(void *priv_data) {
+    struct ethernet_device_info_t *dev_info = priv_data;
+    if (dev_info->sock_type == SOCK_DGRAM && dev_info->server_enable)
+        return dev_info->server_fd;
+    return dev_info->client_fd;
+}
+
 int ethernet_accept(void *priv_data) {
     struct ethernet_device_info_t *dev_info = priv_data;
     dev_info->client_fd = accept(dev_info->server_fd, (struct sockaddr*) &(dev_info->client_addr), &(dev_info->client_addr_len));
     return dev_info->client_fd;
 }
 
+int ethernet_link_poll(void *priv_data) {
+    struct ethernet_device_info_t *dev_info = priv_data;
+    struct pollfd pfd;
+    int err = 0;
+    socklen_t len = sizeof(err);
+
+    if (dev_info->link_state == ICF_LINK_UP)
+        return ICF_LINK_UP;
+    if (dev_info->server_enable) {
+        dev_info->client_addr_len = sizeof(dev_info->client_addr);
+        dev_info->client_fd = accept(dev_info->server_fd, (struct sockaddr*) &(dev_info->client_addr),
+                                     (socklen_t*)&dev_info->client_addr_len);
+        if (dev_info->client_fd >= 0) {
+            fprintf(stderr, "ethernet_tcp_socket_server: Accept on ... %s\n", dev_info->ifname);
+            ethernet_link_up(dev_info);
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            fprintf(stderr, "ethernet_tcp_socket_server: Accept Fail ... %s: %s\n", dev_info->ifname, strerror(errno));
+        }
+        return dev_info->link_state;
+    }
+    if (dev_info->link_state == ICF_LINK_DOWN) {
+        if (ethernet_now_ms() >= dev_info->retry_at_ms)
+            ethernet_tcp_connect_start(dev_info);
+        return dev_info->link_state;
+    }
+    pfd.fd = dev_info->client_fd;
+    pfd.events = POLLOUT;
+    if (poll(&pfd, 1, 0) <= 0)
+        return dev_info->link_state;
+    if (getsockopt(dev_info->client_fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0)
+        ethernet_link_backoff(dev_info);
+    else
+        ethernet_link_up(dev_info);
+    return dev_info->link_state;
+}
+
 struct icf_driver_ops icf_driver_ethernet_ops = {
     .open_interface = ethernet_init,
     .recv_data = ethernet_data_recv,
@@ -349,6 +547,10 @@ struct icf_driver_ops icf_driver_ethernet_ops = {
     .get_client_fd = ethernet_get_client_fd,
     .accept = ethernet_accept,
     .close_interface = ethernet_deinit,
+    .get_fd = ethernet_get_fd,
+    .send_batch = ethernet_data_send_batch,
+    .recv_batch = ethernet_data_recv_batch,
+    .link_poll = ethernet_link_poll,
 };
 
 struct icf_driver_ops icf_driver_ethernet_udp_ops = {
@@ -363,4 +565,8 @@ struct icf_driver_ops icf_driver_ethernet_udp_ops = {
     .get_client_fd = ethernet_get_client_fd,
     .accept = ethernet_accept,
     .close_interface = ethernet_deinit,
+    .get_fd = ethernet_get_fd,
+    .send_batch = ethernet_udp_data_sendto_batch,
+    .recv_batch = ethernet_udp_data_recvfrom_batch,
+    .link_poll = ethernet_link_poll,
 };
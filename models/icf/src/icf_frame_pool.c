@@ -0,0 +1,66 @@
+#include "icf_frame_pool.h"
+
+struct icf_frame_pool *icf_frame_pool_create(void) {
+    struct icf_frame_pool *pool;
+    int idx;
+
+    pool = calloc(1, sizeof(struct icf_frame_pool));
+    if (pool == NULL) {
+        fprintf(stderr, "[%s] frame pool allocate fail!!\n", __FUNCTION__);
+        return NULL;
+    }
+    for (idx = 0; idx < ICF_FRAME_POOL_CELLS; idx++) {
+        pool->cell[idx].l2frame = pool->frame[idx];
+        pool->cell[idx].pool = pool;
+    }
+    pool->free_mask = ~0ULL;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return pool;
+}
+
+void icf_frame_pool_destroy(struct icf_frame_pool **pool) {
+    if (*pool == NULL)
+        return;
+    fprintf(stderr, "[%s] Exhaust count: %d Oversize count: %d In use: %d\n", __FUNCTION__,
+            (*pool)->exhaust_cnt, (*pool)->oversize_cnt,
+            ICF_FRAME_POOL_CELLS - icf_frame_pool_available(*pool));
+    free(*pool);
+    *pool = NULL;
+}
+
+struct ringbuffer_cell_t *icf_frame_get(struct icf_frame_pool *pool, uint32_t size) {
+    uint64_t mask, bit;
+    struct ringbuffer_cell_t *cell;
+
+    if (pool == NULL)
+        return NULL;
+    if (size > ICF_FRAME_SIZE) {
+        __atomic_fetch_add(&pool->oversize_cnt, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    mask = __atomic_load_n(&pool->free_mask, __ATOMIC_RELAXED);
+    do {
+        if (mask == 0) {
+            __atomic_fetch_add(&pool->exhaust_cnt, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        bit = mask & (~mask + 1);  //  lowest free cell
+    } while (!__atomic_compare_exchange_n(&pool->free_mask, &mask, mask & ~bit, 1,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+    cell = &pool->cell[__builtin_ctzll(bit)];
+    cell->frame_full_size = size;
+    return cell;
+}
+
+void icf_frame_put(struct ringbuffer_cell_t *cell) {
+    struct icf_frame_pool *pool;
+
+    if (cell == NULL)
+        return;
+    pool = cell->pool;
+    __atomic_fetch_or(&pool->free_mask, 1ULL << (cell - pool->cell), __ATOMIC_RELEASE);
+}
+
+uint32_t icf_frame_pool_available(struct icf_frame_pool *pool) {
+    return __builtin_popcountll(__atomic_load_n(&pool->free_mask, __ATOMIC_RELAXED));
+}
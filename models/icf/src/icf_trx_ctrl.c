@@ -100,8 +100,8 @@ static struct icf_ctrl_queue g_esps_sil_queue[] = {
     {1, ESPS_GNC_SW_QIDX,                  ICF_DIRECTION_RX, NULL, {}}
 };
 
-static struct icf_mapping *icf_choose_map_tbl(int system_type, int *tbl_size) {
-    struct icf_mapping *table = NULL;
+static const struct icf_mapping *icf_choose_map_tbl(int system_type, int *tbl_size) {
+    const struct icf_mapping *table = NULL;
 
     switch (system_type) {
         case ICF_SYSTEM_TYPE_EGSE:
@@ -181,80 +181,114 @@ static struct icf_ctrl_port *icf_choose_hw_port_tbl(int system_type, int *tbl_si
     return table;
 }
 
-static int icf_qidx_to_drivers_id(int qidx, int system_type) {
-    int idx = 0;
-    struct icf_mapping *which_map_tbl = NULL;
-    int    map_tbl_size;
+const struct icf_mapping *icf_mapping_table(int system_type, int *nentries) {
+    const struct icf_mapping *table;
+    int tbl_size;
 
-    which_map_tbl = icf_choose_map_tbl(system_type, &map_tbl_size);
-    while (idx < get_arr_num(map_tbl_size, sizeof(struct icf_mapping))) {
-        if (which_map_tbl[idx].sw_queue == qidx)
-            break;
-        idx++;
-    }
-    return which_map_tbl[idx].driver_id;
+    table = icf_choose_map_tbl(system_type, &tbl_size);
+    *nentries = get_arr_num(tbl_size, sizeof(struct icf_mapping));
+    return table;
 }
 
-static int icf_pidx_to_drivers_id(int pidx, int system_type) {
-    int idx = 0;
-    struct icf_mapping *which_map_tbl = NULL;
-    int    map_tbl_size;
-
-    which_map_tbl = icf_choose_map_tbl(system_type, &map_tbl_size);
-    while (idx < get_arr_num(map_tbl_size, sizeof(struct icf_mapping))) {
-        if (which_map_tbl[idx].hw_port_idx == pidx)
-            break;
-        idx++;
+static int icf_rx_fallback_qidx(int system_type) {
+    switch (system_type) {
+        case ICF_SYSTEM_TYPE_EGSE:
+            return ICF_RX_QIDX_BY_CANID;
+        case ICF_SYSTEM_TYPE_ESPS:
+        case ICF_SYSTEM_TYPE_SIL_ESPS:
+            return ESPS_GNC_SW_QIDX;
+        case ICF_SYSTEM_TYPE_SIL_EGSE:
+            return EGSE_SIL_DOWNLINK_SW_QIDX;
+        default:
+            return EGSE_EMPTY_SW_QIDX;
     }
-    return which_map_tbl[idx].driver_id;
 }
 
-static int icf_pidx_to_qidx(int pidx, int system_type) {
-    int idx = 0;
-    struct icf_mapping *which_map_tbl = NULL;
-    int    map_tbl_size;
+/*
+ * Resolve the static tables of the system once, into arrays indexed by
+ * queue and port, so neither the init nor the per-frame paths scan them.
+ * The first mapping entry of a queue or port wins, as the scans did.
+ */
+int icf_ctrlblk_map_init(struct icf_ctrlblk_t* C, int system_type) {
+    const struct icf_mapping *which_map_tbl;
+    struct icf_ctrl_queue *which_que_tbl;
+    struct icf_ctrl_port *which_port_tbl;
+    int map_num, que_tbl_size, port_tbl_size;
+    int idx, qidx, pidx, fallback;
+    int status = ICF_STATUS_SUCCESS;
+
+    memset(C->qidx_to_pidx, EMPTY_HW_PORT, sizeof(C->qidx_to_pidx));
+    memset(C->pidx_to_drivers_id, -1, sizeof(C->pidx_to_drivers_id));
+    memset(C->pidx_to_tblidx, -1, sizeof(C->pidx_to_tblidx));
+    memset(C->pidx_to_rx_qidx, EGSE_EMPTY_SW_QIDX, sizeof(C->pidx_to_rx_qidx));
+
+    which_map_tbl = icf_mapping_table(system_type, &map_num);
+    for (idx = 0; idx < map_num; idx++) {
+        qidx = which_map_tbl[idx].sw_queue;
+        pidx = which_map_tbl[idx].hw_port_idx;
+        if (qidx < 0 || qidx >= ICF_CTRLBLK_MAXQUEUE_NUMBER || pidx < 0 || pidx >= ICF_CTRLBLK_MAXPORT_NUMBER) {
+            fprintf(stderr, "[%s] mapping %d out of range: queue %d port %d\n", __FUNCTION__, idx, qidx, pidx);
+            status = ICF_STATUS_FAIL;
+            continue;
+        }
+        if (C->qidx_to_pidx[qidx] < 0)
+            C->qidx_to_pidx[qidx] = pidx;
+        if (C->pidx_to_drivers_id[pidx] < 0)
+            C->pidx_to_drivers_id[pidx] = which_map_tbl[idx].driver_id;
+    }
 
-    which_map_tbl = icf_choose_map_tbl(system_type, &map_tbl_size);
-    while (idx < get_arr_num(map_tbl_size, sizeof(struct icf_mapping))) {
-        if (which_map_tbl[idx].hw_port_idx == pidx)
-            break;
-        idx++;
+    which_port_tbl = icf_choose_hw_port_tbl(system_type, &port_tbl_size);
+    for (idx = 0; idx < get_arr_num(port_tbl_size, sizeof(struct icf_ctrl_port)); idx++) {
+        pidx = which_port_tbl[idx].hw_port_idx;
+        if (pidx >= 0 && pidx < ICF_CTRLBLK_MAXPORT_NUMBER && C->pidx_to_tblidx[pidx] < 0)
+            C->pidx_to_tblidx[pidx] = idx;
     }
-    return which_map_tbl[idx].sw_queue;
-}
 
-static int icf_qidx_to_pidx(int qidx, int system_type) {
-    int idx = 0;
-    struct icf_mapping *which_map_tbl = NULL;
-    int    map_tbl_size;
+    /* a port with one RX queue feeds it, CAN IDs sort out the rest */
+    which_que_tbl = icf_choose_sw_queue_tbl(system_type, &que_tbl_size);
+    for (idx = 0; idx < get_arr_num(que_tbl_size, sizeof(struct icf_ctrl_queue)); idx++) {
+        qidx = which_que_tbl[idx].queue_idx;
+        if (which_que_tbl[idx].direction != ICF_DIRECTION_RX || qidx < 0 || qidx >= ICF_CTRLBLK_MAXQUEUE_NUMBER)
+            continue;
+        pidx = C->qidx_to_pidx[qidx];
+        if (pidx < 0)
+            continue;
+        if (C->pidx_to_rx_qidx[pidx] == EGSE_EMPTY_SW_QIDX)
+            C->pidx_to_rx_qidx[pidx] = qidx;
+        else if (C->pidx_to_rx_qidx[pidx] != qidx)
+            C->pidx_to_rx_qidx[pidx] = ICF_RX_QIDX_BY_CANID;
+    }
 
-    which_map_tbl = icf_choose_map_tbl(system_type, &map_tbl_size);
-    while (idx < get_arr_num(map_tbl_size, sizeof(struct icf_mapping))) {
-        if (which_map_tbl[idx].sw_queue == qidx)
-            break;
-        idx++;
+    /* frames of the other ports go where the system sends unmapped traffic */
+    fallback = icf_rx_fallback_qidx(system_type);
+    for (pidx = 0; pidx < ICF_CTRLBLK_MAXPORT_NUMBER; pidx++) {
+        if (C->pidx_to_rx_qidx[pidx] == EGSE_EMPTY_SW_QIDX)
+            C->pidx_to_rx_qidx[pidx] = fallback;
     }
-    return which_map_tbl[idx].hw_port_idx;
+    return status;
 }
 
-static int icf_pidx_to_tblidx(int pidx, int system_type) {
-    int idx = 0;
-    struct icf_ctrl_port *which_port_tbl = NULL;
-    int port_tbl_size;
+/* Ethernet TCP links run over shared memory when the peers share a host */
+static int icf_port_drivers_id(struct icf_ctrlblk_t* C, struct icf_ctrl_port *ctrlport) {
+    int drv_id = C->pidx_to_drivers_id[ctrlport->hw_port_idx];
 
-    which_port_tbl = icf_choose_hw_port_tbl(system_type, &port_tbl_size);
-    while (idx < get_arr_num(port_tbl_size, sizeof(struct icf_ctrl_port))) {
-        if (which_port_tbl[idx].hw_port_idx == pidx)
-            break;
-        idx++;
+    if (C->transport == ICF_TRANSPORT_SHM && drv_id == ICF_DRIVERS_ID2)
+        drv_id = ICF_DRIVERS_ID4;
+    return drv_id;
+}
+
+int icf_ctrlblk_set_transport(struct icf_ctrlblk_t* C, int transport) {
+    if (transport != ICF_TRANSPORT_SOCKET && transport != ICF_TRANSPORT_SHM) {
+        fprintf(stderr, "[%s] unknown transport %d\n", __FUNCTION__, transport);
+        return ICF_STATUS_FAIL;
     }
-    return idx;
+    C->transport = transport;
+    return ICF_STATUS_SUCCESS;
 }
 
 int icf_ctrlblk_init(struct icf_ctrlblk_t* C, int system_type) {
     struct icf_ctrl_queue *ctrlqueue;
     struct icf_ctrl_port *ctrlport;
-    struct icf_driver_ops *drv_ops;
     int idx;
     struct icf_ctrl_queue *which_que_tbl = NULL;
     int que_tbl_size;
@@ -263,28 +297,117 @@ int icf_ctrlblk_init(struct icf_ctrlblk_t* C, int system_type) {
     int hw_port;
 
     C->system_type = system_type;
+    C->link_pending = 0;
+    C->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (C->epoll_fd < 0)
+        fprintf(stderr, "[%s] epoll_create1 fail: %s, RX falls back to select\n", __FUNCTION__, strerror(errno));
+    icf_ctrlblk_map_init(C, system_type);
     which_que_tbl = icf_choose_sw_queue_tbl(C->system_type, &que_tbl_size);
     which_port_tbl = icf_choose_hw_port_tbl(C->system_type, &port_tbl_size);
 
     for (idx = 0; idx < get_arr_num(que_tbl_size, sizeof(struct icf_ctrl_queue)); idx++) {
         ctrlqueue = &which_que_tbl[idx];
-        hw_port = icf_qidx_to_pidx(ctrlqueue->queue_idx, C->system_type);
-        ctrlqueue->port = &which_port_tbl[icf_pidx_to_tblidx(hw_port, C->system_type)];
+        hw_port = C->qidx_to_pidx[ctrlqueue->queue_idx];
+        ctrlqueue->port = &which_port_tbl[C->pidx_to_tblidx[hw_port]];
         rb_init(&ctrlqueue->data_ring, NUM_OF_CELL);
         C->ctrlqueue[ctrlqueue->queue_idx] = ctrlqueue;
+        if (ctrlqueue->direction == ICF_DIRECTION_RX) {
+            if (ctrlqueue->port->rx_pool == NULL)
+                ctrlqueue->port->rx_pool = icf_frame_pool_create();
+        } else {
+            if (ctrlqueue->port->tx_pool == NULL)
+                ctrlqueue->port->tx_pool = icf_frame_pool_create();
+        }
     }
     for (idx = 0; idx < get_arr_num(port_tbl_size, sizeof(struct icf_ctrl_port)); idx++) {
         ctrlport = &which_port_tbl[idx];
         C->ctrlport[ctrlport->hw_port_idx] = ctrlport;
-        ctrlport->drv_priv_ops = icf_drivers[icf_pidx_to_drivers_id(ctrlport->hw_port_idx, system_type)];
-        drv_ops = ctrlport->drv_priv_ops;
+        ctrlport->drv_priv_ops = icf_drivers[icf_port_drivers_id(C, ctrlport)];
         if (ctrlport->enable == 0)
             continue;
-        drv_ops->open_interface(&ctrlport->drv_priv_data, ctrlport->ifname, ctrlport->netport);
+        icf_port_open(C, ctrlport);
     }
     return 0;
 }
 
+/*
+ * Open a port without waiting for its peer. Links that need a connection
+ * start out pending and are brought up by icf_link_poll().
+ */
+int icf_port_open(struct icf_ctrlblk_t* C, struct icf_ctrl_port *ctrlport) {
+    struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
+
+    if (drv_ops->open_interface(&ctrlport->drv_priv_data, ctrlport->ifname, ctrlport->netport) < 0
+        || ctrlport->drv_priv_data == NULL) {
+        ctrlport->link_state = ICF_LINK_DOWN;
+        return ICF_STATUS_FAIL;
+    }
+    ctrlport->link_state = drv_ops->link_poll ? drv_ops->link_poll(ctrlport->drv_priv_data) : ICF_LINK_UP;
+    if (ctrlport->link_state != ICF_LINK_UP)
+        __atomic_fetch_add(&C->link_pending, 1, __ATOMIC_RELAXED);
+    /* Ethernet RX stays a blocking receive, it paces the SIL/PIL lockstep */
+    if (ctrlport->rx_pool && (ctrlport->dev_type == CAN_DEVICE_TYPE || ctrlport->dev_type == RS422_DEVICE_TYPE))
+        icf_rx_poll_add(C, ctrlport);
+    return ICF_STATUS_SUCCESS;
+}
+
+/*
+ * icf_tx_direct() also polls from sender threads (SimGen), so the state
+ * moves by compare-and-swap and only the caller that brings the port up
+ * counts it off link_pending.
+ */
+static int icf_port_link_poll(struct icf_ctrlblk_t* C, struct icf_ctrl_port *ctrlport) {
+    struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
+    uint8_t seen = __atomic_load_n(&ctrlport->link_state, __ATOMIC_ACQUIRE);
+    uint8_t state;
+
+    if (seen == ICF_LINK_UP || drv_ops->link_poll == NULL || ctrlport->drv_priv_data == NULL)
+        return seen;
+    state = drv_ops->link_poll(ctrlport->drv_priv_data);
+    if (!__atomic_compare_exchange_n(&ctrlport->link_state, &seen, state, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return seen;
+    if (state == ICF_LINK_UP)
+        __atomic_fetch_sub(&C->link_pending, 1, __ATOMIC_RELEASE);
+    return state;
+}
+
+/* One non-blocking pass over the pending links, returns how many are still down */
+int icf_link_poll(struct icf_ctrlblk_t* C) {
+    int idx;
+
+    if (__atomic_load_n(&C->link_pending, __ATOMIC_ACQUIRE) == 0)
+        return 0;
+    for (idx = 0; idx < ICF_CTRLBLK_MAXPORT_NUMBER; idx++) {
+        if (C->ctrlport[idx] && C->ctrlport[idx]->enable)
+            icf_port_link_poll(C, C->ctrlport[idx]);
+    }
+    return __atomic_load_n(&C->link_pending, __ATOMIC_ACQUIRE);
+}
+
+int icf_link_state(struct icf_ctrlblk_t* C, int pidx) {
+    if (C->ctrlport[pidx] == NULL || C->ctrlport[pidx]->enable == 0)
+        return ICF_LINK_DOWN;
+    return __atomic_load_n(&C->ctrlport[pidx]->link_state, __ATOMIC_ACQUIRE);
+}
+
+/* Bring-up barrier for lockstep runs: poll the links every millisecond */
+int icf_ctrlblk_wait_links(struct icf_ctrlblk_t* C, int timeout_ms) {
+    struct timespec tick = {0, 1000000};
+    int idx;
+
+    for (idx = 0; idx <= timeout_ms; idx++) {
+        if (icf_link_poll(C) == 0)
+            return ICF_STATUS_SUCCESS;
+        nanosleep(&tick, NULL);
+    }
+    for (idx = 0; idx < ICF_CTRLBLK_MAXPORT_NUMBER; idx++) {
+        if (C->ctrlport[idx] && C->ctrlport[idx]->enable && C->ctrlport[idx]->link_state != ICF_LINK_UP)
+            fprintf(stderr, "[%s] port %d %s:%d link still down after %d ms\n", __FUNCTION__,
+                    idx, C->ctrlport[idx]->ifname, C->ctrlport[idx]->netport, timeout_ms);
+    }
+    return ICF_STATUS_FAIL;
+}
+
 int icf_ctrlblk_deinit(struct icf_ctrlblk_t* C, int system_type) {
     struct icf_ctrl_queue *ctrlqueue;
     struct icf_ctrl_port *ctrlport;
@@ -306,11 +429,20 @@ int icf_ctrlblk_deinit(struct icf_ctrlblk_t* C, int system_type) {
     }
     for (idx = 0; idx < get_arr_num(port_tbl_size, sizeof(struct icf_ctrl_port)); idx++) {
         ctrlport = &which_port_tbl[idx];
+        icf_frame_pool_destroy(&ctrlport->rx_pool);
+        icf_frame_pool_destroy(&ctrlport->tx_pool);
         drv_ops = ctrlport->drv_priv_ops;
+        ctrlport->rx_polled = 0;
+        ctrlport->rx_ready = 0;
+        ctrlport->link_state = ICF_LINK_DOWN;
         if (ctrlport->enable == 0)
             continue;
         drv_ops->close_interface(&ctrlport->drv_priv_data);
     }
+    if (C->epoll_fd >= 0)
+        close(C->epoll_fd);
+    C->epoll_fd = -1;
+    C->link_pending = 0;
     return 0;
 }
 
@@ -321,62 +453,23 @@ int icf_rx_dequeue(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t si
     if (rxcell == NULL)
         goto empty;
     memcpy(payload, rxcell->l2frame, size);
-    icf_free_mem(&rxcell->l2frame);
-    icf_free_mem(&rxcell);
+    icf_frame_put(rxcell);
     debug_hex_dump("icf_rx_dequeue", payload, size);
     return 1;
 empty:
     return 0;
 }
 
-static int icf_dispatch_rx_frame(int system_type, void *rxframe, int hw_port_idx) {
-    int qidx = 0;
-
-    if (system_type == ICF_SYSTEM_TYPE_ESPS) {
-        qidx = ESPS_GNC_SW_QIDX;
-        debug_hex_dump("esps_dispatch", rxframe, 24);
-        return qidx;
-    }
-
-    if (system_type == ICF_SYSTEM_TYPE_SIL_ESPS) {
-        qidx = ESPS_GNC_SW_QIDX;
-        debug_hex_dump("esps_dispatch", rxframe, 24);
-        return qidx;
-    }
-
-    if (system_type == ICF_SYSTEM_TYPE_SIL_EGSE) {
-        qidx = EGSE_SIL_DOWNLINK_SW_QIDX;
-        debug_hex_dump("egse_sil_dispatch", rxframe, 24);
-        return qidx;
-    }
+/* RX queue of a frame, one array lookup, one hash probe for the EGSE CAN bus */
+int icf_dispatch_rx_frame(struct icf_ctrlblk_t* C, void *rxframe, int hw_port_idx) {
+    int qidx;
 
-    if (system_type == ICF_SYSTEM_TYPE_EGSE) {
-        debug_hex_dump("egse_dispatch", rxframe, 24);
-        switch (hw_port_idx) {
-            case HW_PORT0:
-                qidx = fc_can_cmd_dispatch(rxframe);
-                break;
-            case HW_PORT1:
-                qidx = EGSE_IMU01_RX_SW_QIDX;
-                break;
-            case HW_PORT2:
-                qidx = EGSE_RX_RATETBL_X_SW_QIDX;
-                break;
-            case HW_PORT3:
-                qidx = EGSE_RX_RATETBL_Y_SW_QIDX;
-                break;
-            case HW_PORT4:
-                qidx = EGSE_RX_RATETBL_Z_SW_QIDX;
-                break;
-            case HW_PORT5:
-                qidx = EGSE_IMU02_RX_SW_QIDX;
-                break;
-            default:
-                qidx = fc_can_cmd_dispatch(rxframe);
-        }
-        return qidx;
-    }
-    fprintf(stderr, "[%s:%d] System type not match !!\n", __FUNCTION__, __LINE__);
+    if (hw_port_idx < 0 || hw_port_idx >= ICF_CTRLBLK_MAXPORT_NUMBER)
+        return EGSE_EMPTY_SW_QIDX;
+    qidx = C->pidx_to_rx_qidx[hw_port_idx];
+    debug_hex_dump("icf_dispatch", rxframe, 24);
+    if (qidx == ICF_RX_QIDX_BY_CANID)
+        qidx = fc_can_cmd_dispatch(rxframe);
     return qidx;
 }
 
@@ -385,43 +478,157 @@ static int icf_l2frame_receive_process(struct icf_ctrlblk_t* C, struct icf_drive
     struct ringbuffer_cell_t *rxcell = NULL;
     struct icf_ctrl_queue *ctrlqueue;
     int qidx;
-    /*TODO malloc use the static memory*/
-    rxcell = icf_alloc_mem(sizeof(struct ringbuffer_cell_t));
-    if (rxcell == NULL) {
-        fprintf(stderr, "icf_rx_ctrl_job ring cell allocate fail!!\n");
-        goto empty;
+    if (ctrlport->rx_pool == NULL) {
+        fprintf(stderr, "icf_rx_ctrl_job port %d has no RX queue!!\n", ctrlport->hw_port_idx);
+        return ICF_STATUS_FAIL;
     }
-    rxcell->frame_full_size = rx_buff_size;
-    rxcell->l2frame = icf_alloc_mem(rxcell->frame_full_size);
-    if (rxcell->l2frame == NULL) {
-        fprintf(stderr, "icf_rx_ctrl_job ring cell allocate fail!!\n");
-        goto empty;
+    rxcell = icf_frame_get(ctrlport->rx_pool, rx_buff_size);
+    if (rxcell == NULL) {
+        debug_print("icf_rx_ctrl_job frame pool exhausted!!\n");
+        return ICF_STATUS_FAIL;
     }
+    memset(rxcell->l2frame, 0, rxcell->frame_full_size);
     if (drv_ops->recv_data(ctrlport->drv_priv_data, (uint8_t *)rxcell->l2frame, rxcell->frame_full_size) < 0)
         goto empty;
     debug_hex_dump("icf_rx_ctrl_job", (uint8_t *)rxcell->l2frame, rxcell->frame_full_size);
-    qidx = icf_dispatch_rx_frame(C->system_type, rxcell->l2frame, ctrlport->hw_port_idx);
+    qidx = icf_dispatch_rx_frame(C, rxcell->l2frame, ctrlport->hw_port_idx);
     if (qidx == EGSE_EMPTY_SW_QIDX)
         goto empty;
     ctrlqueue = C->ctrlqueue[qidx];
-    rb_push(&ctrlqueue->data_ring, rxcell);
+    if (rb_push(&ctrlqueue->data_ring, rxcell) < 0)
+        goto empty;
     return ICF_STATUS_SUCCESS;
 empty:
-    icf_free_mem(&rxcell->l2frame);
-    icf_free_mem(&rxcell);
+    icf_frame_put(rxcell);
     return ICF_STATUS_FAIL;
 }
 
+int icf_rx_poll_add(struct icf_ctrlblk_t* C, struct icf_ctrl_port *ctrlport) {
+    struct epoll_event ev;
+    struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
+
+    if (C->epoll_fd < 0 || drv_ops->get_fd == NULL || ctrlport->drv_priv_data == NULL)
+        return ICF_STATUS_FAIL;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.u32 = ctrlport->hw_port_idx;
+    if (epoll_ctl(C->epoll_fd, EPOLL_CTL_ADD, drv_ops->get_fd(ctrlport->drv_priv_data), &ev) < 0) {
+        fprintf(stderr, "[%s] port %d: %s\n", __FUNCTION__, ctrlport->hw_port_idx, strerror(errno));
+        return ICF_STATUS_FAIL;
+    }
+    /* data already queued before the ADD does not raise an edge */
+    ctrlport->rx_ready = 1;
+    ctrlport->rx_polled = 1;
+    return ICF_STATUS_SUCCESS;
+}
+
+/* Non-blocking sweep of the epoll set, flag the ports that saw an edge */
+int icf_rx_poll(struct icf_ctrlblk_t* C) {
+    struct epoll_event events[ICF_CTRLBLK_MAXPORT_NUMBER];
+    int idx, nfds;
+
+    nfds = epoll_wait(C->epoll_fd, events, ICF_CTRLBLK_MAXPORT_NUMBER, 0);
+    for (idx = 0; idx < nfds; idx++)
+        C->ctrlport[events[idx].data.u32]->rx_ready = 1;
+    return nfds;
+}
+
+static int icf_fd_readable(int fd) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN);
+}
+
+/*
+ * Receive up to max frames with one recv_batch call and dispatch them.
+ * Returns the number of frames received, 0 once the driver has nothing
+ * queued, or ICF_STATUS_FAIL.
+ */
+static int icf_l2frame_receive_batch(struct icf_ctrlblk_t* C, struct icf_driver_ops *drv_ops,
+                                     struct icf_ctrl_port *ctrlport, int rx_buff_size, int max) {
+    struct iovec frames[ICF_BATCH_MAX];
+    struct ringbuffer_cell_t *rxcell[ICF_BATCH_MAX];
+    int idx, ncells, nrecv, qidx;
+
+    if (max > ICF_BATCH_MAX)
+        max = ICF_BATCH_MAX;
+    for (ncells = 0; ncells < max; ncells++) {
+        if ((rxcell[ncells] = icf_frame_get(ctrlport->rx_pool, rx_buff_size)) == NULL)
+            break;
+        memset(rxcell[ncells]->l2frame, 0, rxcell[ncells]->frame_full_size);
+        frames[ncells].iov_base = rxcell[ncells]->l2frame;
+        frames[ncells].iov_len = rxcell[ncells]->frame_full_size;
+    }
+    if (ncells == 0) {
+        debug_print("icf_rx_ctrl_job frame pool exhausted!!\n");
+        return ICF_STATUS_FAIL;
+    }
+    nrecv = drv_ops->recv_batch(ctrlport->drv_priv_data, frames, ncells);
+    for (idx = 0; idx < nrecv; idx++) {
+        debug_hex_dump("icf_rx_ctrl_job", (uint8_t *)rxcell[idx]->l2frame, rxcell[idx]->frame_full_size);
+        qidx = icf_dispatch_rx_frame(C, rxcell[idx]->l2frame, ctrlport->hw_port_idx);
+        if (qidx == EGSE_EMPTY_SW_QIDX || rb_push(&C->ctrlqueue[qidx]->data_ring, rxcell[idx]) < 0)
+            icf_frame_put(rxcell[idx]);
+    }
+    for (idx = (nrecv < 0) ? 0 : nrecv; idx < ncells; idx++)
+        icf_frame_put(rxcell[idx]);
+    return (nrecv < 0) ? ICF_STATUS_FAIL : nrecv;
+}
+
+/* Edge triggered: read until the fd runs dry, or the pool / budget runs out */
+static int icf_rx_drain(struct icf_ctrlblk_t* C, struct icf_driver_ops *drv_ops,
+                        struct icf_ctrl_port *ctrlport, int rx_buff_size) {
+    int fd = drv_ops->get_fd(ctrlport->drv_priv_data);
+    int nframes = 0;
+    int ret;
+
+    if (drv_ops->recv_batch && ctrlport->rx_pool) {
+        while (nframes < ICF_RX_DRAIN_MAX) {
+            ret = icf_l2frame_receive_batch(C, drv_ops, ctrlport, rx_buff_size, ICF_RX_DRAIN_MAX - nframes);
+            if (ret < 0)
+                break;
+            nframes += ret;
+            if (ret == 0) {
+                ctrlport->rx_ready = 0;
+                break;
+            }
+        }
+        return nframes;
+    }
+
+    while (nframes < ICF_RX_DRAIN_MAX) {
+        if (!icf_fd_readable(fd)) {
+            ctrlport->rx_ready = 0;
+            break;
+        }
+        if (icf_l2frame_receive_process(C, drv_ops, ctrlport, rx_buff_size) < 0)
+            break;
+        nframes++;
+    }
+    return nframes;
+}
+
 int icf_rx_ctrl_job(struct icf_ctrlblk_t* C, int pidx, int rx_buff_size) {
     struct timeval tv;
     int ret;
-    int qidx = 0;
     struct icf_ctrl_port *ctrlport = C->ctrlport[pidx];
     struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
-    int sock, fd, nfds;
     tv.tv_sec = 0;
     tv.tv_usec = 100;
 
+    if (__atomic_load_n(&ctrlport->link_state, __ATOMIC_ACQUIRE) != ICF_LINK_UP && drv_ops->link_poll
+        && icf_port_link_poll(C, ctrlport) != ICF_LINK_UP)
+        return ICF_STATUS_SUCCESS;
+    if (ctrlport->rx_polled) {
+        if (!ctrlport->rx_ready)
+            icf_rx_poll(C);
+        if (ctrlport->rx_ready && icf_rx_drain(C, drv_ops, ctrlport, rx_buff_size) > 0)
+            debug_print("[%lf] RX Received !!\n", get_curr_time());
+        return ICF_STATUS_SUCCESS;
+    }
+
     switch (ctrlport->dev_type) {
         case CAN_DEVICE_TYPE:
         case RS422_DEVICE_TYPE:
@@ -449,7 +656,7 @@ int icf_rx_ctrl_job(struct icf_ctrlblk_t* C, int pidx, int rx_buff_size) {
 
 
 int icf_tx_direct(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t size) {
-    uint8_t *tx_buffer = NULL;
+    uint8_t tx_buffer[ICF_FRAME_SIZE];
     uint32_t frame_full_size;
     uint32_t offset = 0;
     struct icf_ctrl_port *ctrlport = C->ctrlqueue[qidx]->port;
@@ -458,11 +665,17 @@ int icf_tx_direct(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t siz
     frame_full_size = size;
     if (ctrlport->drv_priv_data == NULL)
         return ICF_STATUS_SUCCESS;
+    /* no peer yet: the frame is dropped, as on a disabled port */
+    if (__atomic_load_n(&ctrlport->link_state, __ATOMIC_ACQUIRE) != ICF_LINK_UP && drv_ops->link_poll
+        && icf_port_link_poll(C, ctrlport) != ICF_LINK_UP)
+        return ICF_STATUS_SUCCESS;
     if (drv_ops->get_header_size) {
         frame_full_size += drv_ops->get_header_size(ctrlport->drv_priv_data);
     }
-
-    tx_buffer = icf_alloc_mem(frame_full_size);
+    if (frame_full_size > ICF_FRAME_SIZE) {
+        fprintf(stderr, "[%s] frame size %u over %d!!\n", __FUNCTION__, frame_full_size, ICF_FRAME_SIZE);
+        return ICF_STATUS_FAIL;
+    }
 
     if (drv_ops->get_header_size(ctrlport->drv_priv_data)) {
         drv_ops->header_set(ctrlport->drv_priv_data, (uint8_t *) payload, size);
@@ -471,29 +684,23 @@ int icf_tx_direct(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t siz
     memcpy(tx_buffer + offset, (uint8_t *) payload, size);
     drv_ops->send_data(ctrlport->drv_priv_data, tx_buffer, frame_full_size);
     debug_hex_dump("icf_tx_direct", tx_buffer, frame_full_size);
-    icf_free_mem(&tx_buffer);
     return ICF_STATUS_SUCCESS;
 }
 
 int icf_tx_enqueue(struct icf_ctrlblk_t* C, int qidx, void *payload, uint32_t size) {
-    uint8_t *tx_buffer = NULL;
-    struct ringbuffer_t *whichring = NULL;
     struct ringbuffer_cell_t *txcell;
-    uint32_t offset = 0;
     struct icf_ctrl_queue *ctrlqueue = C->ctrlqueue[qidx];
     struct icf_ctrl_port *ctrlport = C->ctrlqueue[qidx]->port;
-    struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
-
-    whichring = &ctrlqueue->data_ring;
-    tx_buffer = icf_alloc_mem(size);
 
-    memcpy(tx_buffer, (uint8_t *) payload, size);
-
-    if (whichring) {
-        txcell = icf_alloc_mem(sizeof(struct ringbuffer_cell_t));
-        txcell->frame_full_size = size;
-        txcell->l2frame = tx_buffer;
-        rb_push(whichring, txcell);
+    txcell = icf_frame_get(ctrlport->tx_pool, size);
+    if (txcell == NULL) {
+        debug_print("icf_tx_enqueue frame pool exhausted!!\n");
+        return ICF_STATUS_FAIL;
+    }
+    memcpy(txcell->l2frame, (uint8_t *) payload, size);
+    if (rb_push(&ctrlqueue->data_ring, txcell) < 0) {
+        icf_frame_put(txcell);
+        return ICF_STATUS_FAIL;
     }
     return ICF_STATUS_SUCCESS;
 }
@@ -502,54 +709,131 @@ int icf_tx_dequeue(struct icf_ctrlblk_t* C, int qidx, void *payload) {
     struct ringbuffer_cell_t *txcell = NULL;
     struct ringbuffer_t *whichring = NULL;
     struct icf_ctrl_queue *ctrlqueue = C->ctrlqueue[qidx];
-    struct icf_ctrl_port *ctrlport = C->ctrlqueue[qidx]->port;
-    struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
     whichring = &ctrlqueue->data_ring;
-    txcell = (uint8_t *)rb_pop(whichring);
+    txcell = (struct ringbuffer_cell_t *)rb_pop(whichring);
     if (txcell) {
         memcpy(payload, txcell->l2frame, txcell->frame_full_size);
         debug_hex_dump("icf_tx_dequeue", txcell->l2frame, txcell->frame_full_size);
-        icf_free_mem(&txcell->l2frame);
-        icf_free_mem(&txcell);
+        icf_frame_put(txcell);
     }
     return ICF_STATUS_SUCCESS;
 }
 
-int icf_tx_ctrl_job(struct icf_ctrlblk_t* C, int qidx) {
-    uint8_t *tx_buffer = NULL;
+static int icf_tx_send_batch(struct icf_ctrl_port *ctrlport, struct ringbuffer_cell_t **cells, uint32_t ncells) {
+    struct iovec frames[ICF_BATCH_MAX];
+    struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
+    uint32_t idx;
+    int ret;
+
+    for (idx = 0; idx < ncells; idx++) {
+        frames[idx].iov_base = cells[idx]->l2frame;
+        frames[idx].iov_len = cells[idx]->frame_full_size;
+    }
+    ret = drv_ops->send_batch(ctrlport->drv_priv_data, frames, ncells);
+    for (idx = 0; idx < ncells; idx++) {
+        debug_hex_dump("icf_tx_ctrl_job", (uint8_t *) cells[idx]->l2frame, cells[idx]->frame_full_size);
+        icf_frame_put(cells[idx]);
+    }
+    return (ret < 0) ? ICF_STATUS_FAIL : ICF_STATUS_SUCCESS;
+}
+
+/*
+ * Flush the given TX queues of one port, in order. Drivers with send_batch
+ * and no per-frame header send straight out of the pool frames,
+ * ICF_BATCH_MAX frames per call, a batch may span queues; the others take
+ * one send_data per frame.
+ */
+static int icf_tx_flush(struct icf_ctrl_port *ctrlport, struct icf_ctrl_queue **queues, int nqueue) {
+    uint8_t tx_buffer[ICF_FRAME_SIZE];
+    struct ringbuffer_cell_t *batch[ICF_BATCH_MAX];
     struct ringbuffer_cell_t *txcell = NULL;
-    struct ringbuffer_t *whichring = NULL;
-    struct icf_ctrl_queue *ctrlqueue = C->ctrlqueue[qidx];
-    struct icf_ctrl_port *ctrlport = C->ctrlqueue[qidx]->port;
     struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
     uint32_t out_frame_size;
-    uint32_t offset = 0;
-    whichring = &ctrlqueue->data_ring;
-    txcell = (uint8_t *)rb_pop(whichring);
-    if (txcell) {
-        out_frame_size = txcell->frame_full_size;
-        if (ctrlport->drv_priv_data == NULL) {
-            icf_free_mem(&txcell->l2frame);
-            icf_free_mem(&txcell);
-            return ICF_STATUS_SUCCESS;
-        }
-        if (drv_ops->get_header_size) {
-            out_frame_size += drv_ops->get_header_size(ctrlport->drv_priv_data);
-        }
-        tx_buffer = icf_alloc_mem(out_frame_size);
+    uint32_t header_size = 0;
+    uint32_t nbatch = 0;
+    uint32_t offset;
+    int batch_enable;
+    int idx;
+    int status = ICF_STATUS_SUCCESS;
+
+    if (ctrlport->drv_priv_data && drv_ops->get_header_size)
+        header_size = drv_ops->get_header_size(ctrlport->drv_priv_data);
+    batch_enable = (ctrlport->drv_priv_data && drv_ops->send_batch && header_size == 0);
+
+    for (idx = 0; idx < nqueue; idx++) {
+        while ((txcell = (struct ringbuffer_cell_t *)rb_pop(&queues[idx]->data_ring)) != NULL) {
+            if (ctrlport->drv_priv_data == NULL) {
+                icf_frame_put(txcell);
+                continue;
+            }
+            if (batch_enable) {
+                batch[nbatch++] = txcell;
+                if (nbatch == ICF_BATCH_MAX) {
+                    if (icf_tx_send_batch(ctrlport, batch, nbatch) != ICF_STATUS_SUCCESS)
+                        status = ICF_STATUS_FAIL;
+                    nbatch = 0;
+                }
+                continue;
+            }
 
-        if (drv_ops->get_header_size(ctrlport->drv_priv_data)) {
-            drv_ops->header_set(ctrlport->drv_priv_data, (uint8_t *) txcell->l2frame, txcell->frame_full_size);
-            offset += drv_ops->header_copy(ctrlport->drv_priv_data, tx_buffer);
+            out_frame_size = txcell->frame_full_size + header_size;
+            if (out_frame_size > ICF_FRAME_SIZE) {
+                fprintf(stderr, "[%s] frame size %u over %d!!\n", __FUNCTION__, out_frame_size, ICF_FRAME_SIZE);
+                icf_frame_put(txcell);
+                status = ICF_STATUS_FAIL;
+                continue;
+            }
+
+            offset = 0;
+            if (header_size) {
+                drv_ops->header_set(ctrlport->drv_priv_data, (uint8_t *) txcell->l2frame, txcell->frame_full_size);
+                offset += drv_ops->header_copy(ctrlport->drv_priv_data, tx_buffer);
+            }
+            memcpy(tx_buffer + offset, (uint8_t *) txcell->l2frame, txcell->frame_full_size);
+            icf_frame_put(txcell);
+            drv_ops->send_data(ctrlport->drv_priv_data, tx_buffer, out_frame_size);
+            debug_hex_dump("icf_tx_ctrl_job", tx_buffer, out_frame_size);
         }
-        memcpy(tx_buffer + offset, (uint8_t *) txcell->l2frame, txcell->frame_full_size);
-        icf_free_mem(&txcell->l2frame);
-        icf_free_mem(&txcell);
-        drv_ops->send_data(ctrlport->drv_priv_data, tx_buffer, out_frame_size);
-        debug_hex_dump("icf_tx_ctrl_job", tx_buffer, out_frame_size);
-        icf_free_mem(&tx_buffer);
     }
-    return ICF_STATUS_SUCCESS;
+    if (nbatch && icf_tx_send_batch(ctrlport, batch, nbatch) != ICF_STATUS_SUCCESS)
+        status = ICF_STATUS_FAIL;
+    return status;
+}
+
+/* no peer yet: frames stay queued until the link comes up */
+static int icf_tx_link_up(struct icf_ctrlblk_t* C, struct icf_ctrl_port *ctrlport) {
+    struct icf_driver_ops *drv_ops = ctrlport->drv_priv_ops;
+    if (ctrlport->drv_priv_data && __atomic_load_n(&ctrlport->link_state, __ATOMIC_ACQUIRE) != ICF_LINK_UP && drv_ops->link_poll
+        && icf_port_link_poll(C, ctrlport) != ICF_LINK_UP)
+        return 0;
+    return 1;
+}
+
+int icf_tx_ctrl_job(struct icf_ctrlblk_t* C, int qidx) {
+    struct icf_ctrl_port *ctrlport = C->ctrlqueue[qidx]->port;
+
+    if (!icf_tx_link_up(C, ctrlport))
+        return ICF_STATUS_SUCCESS;
+    return icf_tx_flush(ctrlport, &C->ctrlqueue[qidx], 1);
+}
+
+/*
+ * Flush every enabled TX queue bound to the port in queue index order, so
+ * frames queued on different queues of one CAN bus leave in one sendmmsg.
+ */
+int icf_tx_port_job(struct icf_ctrlblk_t* C, int pidx) {
+    struct icf_ctrl_queue *queues[ICF_CTRLBLK_MAXQUEUE_NUMBER];
+    struct icf_ctrl_port *ctrlport = C->ctrlport[pidx];
+    int qidx, nqueue = 0;
+
+    if (ctrlport == NULL || !icf_tx_link_up(C, ctrlport))
+        return ICF_STATUS_SUCCESS;
+    for (qidx = 0; qidx < ICF_CTRLBLK_MAXQUEUE_NUMBER; qidx++) {
+        if (C->ctrlqueue[qidx] && C->ctrlqueue[qidx]->enable
+            && C->ctrlqueue[qidx]->direction == ICF_DIRECTION_TX && C->ctrlqueue[qidx]->port == ctrlport)
+            queues[nqueue++] = C->ctrlqueue[qidx];
+    }
+    return icf_tx_flush(ctrlport, queues, nqueue);
 }
 
 void icf_heartbeat(void) {
@@ -1,49 +1,64 @@
 #include "ringbuffer.h"
 
+#define RB_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RB_LOAD_RELAXED(p)      __atomic_load_n((p), __ATOMIC_RELAXED)
+#define RB_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
 
 int32_t rb_init(struct ringbuffer_t *rb, uint32_t size) {
     int idx;
+    if (size == 0 || size > NUM_OF_CELL || (size & (size - 1))) {
+        fprintf(stderr, "[%s] ring size %u must be a power of 2 <= %d\n", __FUNCTION__, size, NUM_OF_CELL);
+        return -1;
+    }
     rb->writer_idx = 0;
+    rb->reader_cache = 0;
+    rb->full_cnt = 0;
     rb->reader_idx = 0;
-    rb->elem_num = 0;
+    rb->writer_cache = 0;
     rb->ring_size = size;
-    rb->full_cnt = 0;
+    rb->ring_mask = size - 1;
     for (idx = 0; idx < rb->ring_size; idx++) {
         rb->pCell[idx] = NULL;
     }
-    pthread_mutex_init(&rb->ring_lock, NULL);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
     return 0;
 }
 
 void rb_deinit(struct ringbuffer_t *rb) {
-    pthread_mutex_destroy(&rb->ring_lock);
     fprintf(stderr, "[%s] Full count: %d \n", __FUNCTION__, rb->full_cnt);
 }
 
-void rb_push(struct ringbuffer_t *rb, void *payload) {
-        pthread_mutex_lock(&rb->ring_lock);
-        if (rb->writer_idx == (rb->ring_size + rb->reader_idx)) {
-            //  ring buffer is full
-            pthread_mutex_unlock(&rb->ring_lock);
-            rb->full_cnt++;
-            return;
+/* producer side only */
+int32_t rb_push(struct ringbuffer_t *rb, void *payload) {
+        uint32_t writer = RB_LOAD_RELAXED(&rb->writer_idx);
+        if (writer - rb->reader_cache == rb->ring_size) {
+            rb->reader_cache = RB_LOAD_ACQUIRE(&rb->reader_idx);
+            if (writer - rb->reader_cache == rb->ring_size) {
+                //  ring buffer is full
+                rb->full_cnt++;
+                return -1;
+            }
         }
-        rb->pCell[GET_RINGCELL_IDX(rb->writer_idx)] = payload;
-        rb->writer_idx++;
-        rb->elem_num++;
-        pthread_mutex_unlock(&rb->ring_lock);
+        rb->pCell[writer & rb->ring_mask] = payload;
+        RB_STORE_RELEASE(&rb->writer_idx, writer + 1);
+        return 0;
 }
 
+/* consumer side only */
 void *rb_pop(struct ringbuffer_t *rb) {
         void *ret;
-        pthread_mutex_lock(&rb->ring_lock);
-        if (rb->writer_idx == rb->reader_idx) {  //  ring buffer is empty
-            pthread_mutex_unlock(&rb->ring_lock);
-            return NULL;
+        uint32_t reader = RB_LOAD_RELAXED(&rb->reader_idx);
+        if (reader == rb->writer_cache) {
+            rb->writer_cache = RB_LOAD_ACQUIRE(&rb->writer_idx);
+            if (reader == rb->writer_cache)  //  ring buffer is empty
+                return NULL;
         }
-        ret = rb->pCell[GET_RINGCELL_IDX(rb->reader_idx)];
-        rb->reader_idx++;
-        rb->elem_num--;
-        pthread_mutex_unlock(&rb->ring_lock);
+        ret = rb->pCell[reader & rb->ring_mask];
+        RB_STORE_RELEASE(&rb->reader_idx, reader + 1);
         return ret;
 }
+
+/* snapshot, exact only when called from the producer or consumer thread */
+uint32_t rb_count(struct ringbuffer_t *rb) {
+    return RB_LOAD_ACQUIRE(&rb->writer_idx) - RB_LOAD_ACQUIRE(&rb->reader_idx);
+}
@@ -260,6 +260,11 @@ void rs422_fd_zero(void *priv_data) {
     FD_ZERO(dev_info->set);
 }
 
+int rs422_get_fd(void *priv_data) {
+    struct rs422_device_info_t *dev_info = priv_data;
+    return dev_info->rs422_fd;
+}
+
 struct icf_driver_ops icf_driver_rs422_ops = {
     .open_interface = rs422_serialport_init,
     .recv_data = rs422_data_recv_gather,
@@ -274,5 +279,6 @@ struct icf_driver_ops icf_driver_rs422_ops = {
     .fd_set = rs422_fd_set,
     .fd_zero = rs422_fd_zero,
     .close_interface = rs422_serialport_deinit,
+    .get_fd = rs422_get_fd,
 };
 
@@ -0,0 +1,376 @@
+#include "shm_channel.h"
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define SHM_CHANNEL_MAGIC  0x4d485343  //  "CSHM", written last by the creator
+#define SHM_RING_MASK      (SHM_CHANNEL_RING_SIZE - 1)
+
+/*
+ * head / tail are free running byte counters, each owned by one side. A
+ * side that runs out of data (or space) raises its waiters flag and sleeps
+ * on the counter it is waiting for; the other side wakes it after moving
+ * that counter, only when the flag is up.
+ */
+struct shm_ring_t {
+    uint32_t head;              //  bytes written, producer side
+    uint32_t head_waiters;      //  consumer asleep on head
+    uint8_t pad0[56];
+    uint32_t tail;              //  bytes read, consumer side
+    uint32_t tail_waiters;      //  producer asleep on tail
+    uint8_t pad1[56];
+    uint8_t data[SHM_CHANNEL_RING_SIZE];
+};
+
+struct shm_segment_t {
+    uint32_t magic;
+    uint32_t ring_size;
+    int32_t pid[2];             //  server, client; 0 once detached
+    uint8_t pad[48];
+    struct shm_ring_t ring[2];  //  [0] server -> client, [1] client -> server
+};
+
+static long shm_futex(uint32_t *addr, int op, uint32_t val, const struct timespec *timeout) {
+    return syscall(SYS_futex, addr, op, val, timeout, NULL, 0);
+}
+
+static void shm_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+static int shm_pid_alive(int32_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+static int shm_peer_alive(struct shm_channel_t *ch) {
+    return shm_pid_alive(__atomic_load_n(&ch->seg->pid[!ch->role], __ATOMIC_ACQUIRE));
+}
+
+static void shm_wake(uint32_t *word, uint32_t *waiters) {
+    if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST))
+        shm_futex(word, FUTEX_WAKE, INT_MAX, NULL);
+}
+
+/* Wait for *word to move off old. Returns its new value, or old once the peer is gone */
+static uint32_t shm_wait(struct shm_channel_t *ch, uint32_t *word, uint32_t *waiters, uint32_t old) {
+    struct timespec timeout = {0, SHM_CHANNEL_WAIT_MS * 1000000L};
+    uint32_t now;
+    int idx;
+
+    for (idx = 0; idx < ch->spin; idx++) {
+        if ((now = __atomic_load_n(word, __ATOMIC_ACQUIRE)) != old)
+            return now;
+        shm_cpu_relax();
+    }
+    for (;;) {
+        __atomic_store_n(waiters, 1, __ATOMIC_SEQ_CST);
+        if ((now = __atomic_load_n(word, __ATOMIC_SEQ_CST)) != old)
+            break;
+        shm_futex(word, FUTEX_WAIT, old, &timeout);
+        if ((now = __atomic_load_n(word, __ATOMIC_ACQUIRE)) != old)
+            break;
+        if (!shm_peer_alive(ch))
+            break;
+    }
+    __atomic_store_n(waiters, 0, __ATOMIC_RELAXED);
+    return now;
+}
+
+static void shm_map_rings(struct shm_channel_t *ch, struct shm_segment_t *seg, int role) {
+    ch->seg = seg;
+    ch->role = role;
+    ch->tx = &seg->ring[role == SHM_CHANNEL_SERVER ? 0 : 1];
+    ch->rx = &seg->ring[role == SHM_CHANNEL_SERVER ? 1 : 0];
+}
+
+/* Returns 0 once the segment is created, -1 with errno EEXIST if one is already there */
+static int shm_create(struct shm_channel_t *ch) {
+    struct shm_segment_t *seg;
+    int fd;
+
+    if ((fd = shm_open(ch->name, O_CREAT | O_EXCL | O_RDWR, 0600)) < 0)
+        return -1;
+    if (ftruncate(fd, sizeof(struct shm_segment_t)) < 0) {
+        fprintf(stderr, "[%s] %s: %s\n", __FUNCTION__, ch->name, strerror(errno));
+        close(fd);
+        shm_unlink(ch->name);
+        return -1;
+    }
+    seg = mmap(NULL, sizeof(struct shm_segment_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+        fprintf(stderr, "[%s] %s: %s\n", __FUNCTION__, ch->name, strerror(errno));
+        shm_unlink(ch->name);
+        return -1;
+    }
+    seg->ring_size = SHM_CHANNEL_RING_SIZE;
+    seg->pid[SHM_CHANNEL_SERVER] = getpid();
+    __atomic_store_n(&seg->magic, SHM_CHANNEL_MAGIC, __ATOMIC_RELEASE);
+    shm_map_rings(ch, seg, SHM_CHANNEL_SERVER);
+    ch->link_state = ICF_LINK_CONNECTING;
+    return 0;
+}
+
+/*
+ * Attach to a segment the server has finished setting up. Returns
+ * ICF_LINK_UP, ICF_LINK_DOWN to try again later, or -1 with the segment
+ * left by a server that is gone.
+ */
+static int shm_attach(struct shm_channel_t *ch) {
+    struct shm_segment_t *seg;
+    struct stat st;
+    int32_t none = 0;
+    int fd;
+
+    if ((fd = shm_open(ch->name, O_RDWR, 0600)) < 0)
+        return ICF_LINK_DOWN;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(struct shm_segment_t)) {
+        close(fd);
+        return ICF_LINK_DOWN;
+    }
+    seg = mmap(NULL, sizeof(struct shm_segment_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED)
+        return ICF_LINK_DOWN;
+    if (__atomic_load_n(&seg->magic, __ATOMIC_ACQUIRE) != SHM_CHANNEL_MAGIC
+        || seg->ring_size != SHM_CHANNEL_RING_SIZE) {
+        munmap(seg, sizeof(struct shm_segment_t));
+        return ICF_LINK_DOWN;
+    }
+    if (!shm_pid_alive(__atomic_load_n(&seg->pid[SHM_CHANNEL_SERVER], __ATOMIC_ACQUIRE))) {
+        munmap(seg, sizeof(struct shm_segment_t));
+        return -1;
+    }
+    if (!__atomic_compare_exchange_n(&seg->pid[SHM_CHANNEL_CLIENT], &none, getpid(), 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        fprintf(stderr, "[%s] %s already has a client (pid %d)\n", __FUNCTION__, ch->name, none);
+        munmap(seg, sizeof(struct shm_segment_t));
+        return ICF_LINK_DOWN;
+    }
+    shm_map_rings(ch, seg, SHM_CHANNEL_CLIENT);
+    return ICF_LINK_UP;
+}
+
+/* Never waits for the peer: the link comes up through shm_channel_poll() */
+int shm_channel_open(struct shm_channel_t **ch, const char *name, int role) {
+    struct shm_channel_t *chan;
+
+    chan = malloc(sizeof(struct shm_channel_t));
+    if (chan == NULL) {
+        fprintf(stderr, "[%s:%d]Memory allocate fail. status: %s\n", __FUNCTION__, __LINE__, strerror(errno));
+        *ch = NULL;
+        return -1;
+    }
+    memset(chan, 0, sizeof(struct shm_channel_t));
+    snprintf(chan->name, sizeof(chan->name), "%s%s", name[0] == '/' ? "" : "/", name);
+    chan->want_role = role;
+    chan->role = -1;
+    chan->link_state = ICF_LINK_DOWN;
+    chan->spin = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? SHM_CHANNEL_SPIN : 0;
+
+    if (role == SHM_CHANNEL_SERVER) {
+        shm_unlink(chan->name);     //  left over by a run that did not shut down
+        if (shm_create(chan) < 0) {
+            fprintf(stderr, "[%s] %s: %s\n", __FUNCTION__, chan->name, strerror(errno));
+            free(chan);
+            *ch = NULL;
+            return -1;
+        }
+    }
+    *ch = chan;
+    shm_channel_poll(chan);
+    return 0;
+}
+
+/* Advance the bring-up without blocking, returns ENUM_ICF_LINK_STATE */
+int shm_channel_poll(struct shm_channel_t *ch) {
+    int state;
+
+    if (ch->link_state == ICF_LINK_UP)
+        return ch->link_state;
+    if (ch->role == SHM_CHANNEL_SERVER) {
+        if (__atomic_load_n(&ch->seg->pid[SHM_CHANNEL_CLIENT], __ATOMIC_ACQUIRE) != 0)
+            ch->link_state = ICF_LINK_UP;
+        return ch->link_state;
+    }
+    if (ch->want_role == SHM_CHANNEL_ANY && shm_create(ch) == 0)
+        return ch->link_state;
+    state = shm_attach(ch);
+    if (state < 0) {
+        /* the server went away without unlinking, the next one in re-creates */
+        if (ch->want_role == SHM_CHANNEL_ANY)
+            shm_unlink(ch->name);
+        state = ICF_LINK_DOWN;
+    }
+    ch->link_state = (state == ICF_LINK_UP) ? ICF_LINK_UP : ICF_LINK_CONNECTING;
+    return ch->link_state;
+}
+
+/* Copy into the ring without publishing, unless the ring fills up */
+static int shm_put(struct shm_channel_t *ch, const uint8_t *buf, uint32_t size, uint32_t *head) {
+    struct shm_ring_t *ring = ch->tx;
+    uint32_t tail, space, n, off, first;
+
+    while (size > 0) {
+        tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        space = SHM_CHANNEL_RING_SIZE - (*head - tail);
+        if (space == 0) {
+            __atomic_store_n(&ring->head, *head, __ATOMIC_SEQ_CST);
+            shm_wake(&ring->head, &ring->head_waiters);
+            if (shm_wait(ch, &ring->tail, &ring->tail_waiters, tail) == tail)
+                return -1;
+            continue;
+        }
+        n = (size < space) ? size : space;
+        off = *head & SHM_RING_MASK;
+        first = (n < SHM_CHANNEL_RING_SIZE - off) ? n : SHM_CHANNEL_RING_SIZE - off;
+        memcpy(ring->data + off, buf, first);
+        memcpy(ring->data, buf + first, n - first);
+        *head += n;
+        buf += n;
+        size -= n;
+    }
+    return 0;
+}
+
+static void shm_publish(struct shm_channel_t *ch, uint32_t head) {
+    __atomic_store_n(&ch->tx->head, head, __ATOMIC_SEQ_CST);
+    shm_wake(&ch->tx->head, &ch->tx->head_waiters);
+}
+
+int shm_channel_write(struct shm_channel_t *ch, const void *buf, uint32_t size) {
+    uint32_t head;
+
+    if (ch->link_state != ICF_LINK_UP)
+        return -1;
+    head = ch->tx->head;
+    if (shm_put(ch, buf, size, &head) < 0)
+        return -1;
+    shm_publish(ch, head);
+    return size;
+}
+
+/* All of iov in one publish, the reader is woken once */
+int shm_channel_writev(struct shm_channel_t *ch, const struct iovec *iov, uint32_t iovcnt) {
+    uint32_t head, idx;
+    int total = 0;
+
+    if (ch->link_state != ICF_LINK_UP)
+        return -1;
+    head = ch->tx->head;
+    for (idx = 0; idx < iovcnt; idx++) {
+        if (shm_put(ch, iov[idx].iov_base, iov[idx].iov_len, &head) < 0)
+            return -1;
+        total += iov[idx].iov_len;
+    }
+    shm_publish(ch, head);
+    return total;
+}
+
+/* Blocks until size bytes are in, returns -1 once the peer is gone and the ring is dry */
+int shm_channel_read(struct shm_channel_t *ch, void *buf, uint32_t size) {
+    struct shm_ring_t *ring = ch->rx;
+    uint8_t *out = buf;
+    uint32_t head, tail, n, off, first;
+
+    if (ch->link_state != ICF_LINK_UP)
+        return -1;
+    tail = ring->tail;
+    while (size > 0) {
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (head == tail && (head = shm_wait(ch, &ring->head, &ring->head_waiters, tail)) == tail)
+            return -1;
+        n = (size < head - tail) ? size : head - tail;
+        off = tail & SHM_RING_MASK;
+        first = (n < SHM_CHANNEL_RING_SIZE - off) ? n : SHM_CHANNEL_RING_SIZE - off;
+        memcpy(out, ring->data + off, first);
+        memcpy(out + first, ring->data, n - first);
+        tail += n;
+        out += n;
+        size -= n;
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_SEQ_CST);
+        shm_wake(&ring->tail, &ring->tail_waiters);
+    }
+    return out - (uint8_t *)buf;
+}
+
+int shm_channel_close(struct shm_channel_t **ch) {
+    struct shm_channel_t *chan = *ch;
+    int idx;
+
+    if (chan == NULL)
+        return 0;
+    if (chan->seg) {
+        /* detach, then kick a peer asleep on either ring so it sees us gone */
+        __atomic_store_n(&chan->seg->pid[chan->role], 0, __ATOMIC_SEQ_CST);
+        for (idx = 0; idx < 2; idx++) {
+            shm_futex(&chan->seg->ring[idx].head, FUTEX_WAKE, INT_MAX, NULL);
+            shm_futex(&chan->seg->ring[idx].tail, FUTEX_WAKE, INT_MAX, NULL);
+        }
+        if (chan->role == SHM_CHANNEL_SERVER)
+            shm_unlink(chan->name);
+        munmap(chan->seg, sizeof(struct shm_segment_t));
+    }
+    free(chan);
+    *ch = NULL;
+    return 0;
+}
+
+/* ICF driver: ifname picks the side as for Ethernet, netport keys the segment */
+int shm_icf_init(void **priv_data, char *ifname, int netport) {
+    char name[NAME_MAX];
+
+    snprintf(name, sizeof(name), "/sirius_icf_%u_%d", (unsigned int)getuid(), netport);
+    if (shm_channel_open((struct shm_channel_t **)priv_data, name,
+                         strstr(ifname, "_server") ? SHM_CHANNEL_SERVER : SHM_CHANNEL_CLIENT) < 0)
+        errExit("shm_icf_init :Error create shared memory channel");
+    return 0;
+}
+
+int shm_icf_deinit(void **priv_data) {
+    return shm_channel_close((struct shm_channel_t **)priv_data);
+}
+
+static int shm_icf_recv(void *priv_data, uint8_t *rx_buff, uint32_t buff_size) {
+    return shm_channel_read(priv_data, rx_buff, buff_size);
+}
+
+static int shm_icf_send(void *priv_data, uint8_t *payload, uint32_t frame_len) {
+    return shm_channel_write(priv_data, payload, frame_len);
+}
+
+static int shm_icf_send_batch(void *priv_data, struct iovec *frames, uint32_t nframes) {
+    return (shm_channel_writev(priv_data, frames, nframes) < 0) ? -1 : (int)nframes;
+}
+
+static uint32_t shm_icf_get_header_size(void *priv_data) {
+    return 0;
+}
+
+static int shm_icf_is_server(void *priv_data) {
+    return ((struct shm_channel_t *)priv_data)->role == SHM_CHANNEL_SERVER;
+}
+
+static int shm_icf_link_poll(void *priv_data) {
+    return shm_channel_poll(priv_data);
+}
+
+struct icf_driver_ops icf_driver_shm_ops = {
+    .open_interface = shm_icf_init,
+    .recv_data = shm_icf_recv,
+    .send_data = shm_icf_send,
+
+    .header_set = NULL,
+    .header_copy = NULL,
+    .get_header_size = shm_icf_get_header_size,
+    .is_server = shm_icf_is_server,
+    .close_interface = shm_icf_deinit,
+    .send_batch = shm_icf_send_batch,
+    .link_poll = shm_icf_link_poll,
+};
@@ -1,12 +1,34 @@
 /************************************************************************
 PURPOSE: (Received data by CAN bus.)
 *************************************************************************/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  /* sendmmsg, recvmmsg */
+#endif
 #include "socket_can.h"
 #include "icf_drivers.h"
+#include <linux/net_tstamp.h>
+
+#define CAN_STAMP_CMSG_SIZE  CMSG_SPACE(sizeof(struct timespec) * 3)
+
+/*
+ * Ask for receive timestamps: the controller clock where the adapter
+ * stamps frames, the kernel clock otherwise. Failure only costs the stamps.
+ */
+static void socket_can_stamping_enable(struct can_device_info_t *dev_info) {
+    int flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE
+                | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+    dev_info->stamping = 0;
+    if (setsockopt(dev_info->can_fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != 0) {
+        fprintf(stderr, "%s: SO_TIMESTAMPING off: %s\n", dev_info->ifr.ifr_name, strerror(errno));
+        return;
+    }
+    dev_info->stamping = flags;
+}
 int socket_can_init(void **priv_data, char *ifname, int netport) {
     int  status = 0, setflag = 0;
     struct can_device_info_t *dev_info = NULL;
-    dev_info = malloc(sizeof(struct can_device_info_t));
+    dev_info = calloc(1, sizeof(struct can_device_info_t));
     if (dev_info == NULL) {
         fprintf(stderr, "[%s:%d]Memory allocate fail. status: %s\n", __FUNCTION__, __LINE__, strerror(errno));
         goto error;
@@ -47,6 +69,7 @@ int socket_can_init(void **priv_data, char *ifname, int netport) {
     if (status != 0) {
         fprintf(stderr, "setsockopt fail. status: %s\n", strerror(errno));
     }
+    socket_can_stamping_enable(dev_info);
 
     if (dev_info) {
         *priv_data = dev_info;
@@ -166,6 +189,119 @@ int can_frame_send(void *priv_data, uint8_t *payload, uint32_t frame_len) {
     return tx_nbytes;
 }
 
+/* one sendmmsg() per batch, each iovec one struct can_frame */
+int can_frame_send_batch(void *priv_data, struct iovec *frames, uint32_t nframes) {
+    struct mmsghdr msgs[ICF_BATCH_MAX];
+    struct can_device_info_t *dev_info = priv_data;
+    uint32_t idx, sent = 0;
+    int ret;
+
+    if (nframes > ICF_BATCH_MAX)
+        nframes = ICF_BATCH_MAX;
+    memset(msgs, 0, sizeof(struct mmsghdr) * nframes);
+    for (idx = 0; idx < nframes; idx++) {
+        msgs[idx].msg_hdr.msg_iov = &frames[idx];
+        msgs[idx].msg_hdr.msg_iovlen = 1;
+    }
+    while (sent < nframes) {
+        if ((ret = sendmmsg(dev_info->can_fd, msgs + sent, nframes - sent, 0)) < 0) {
+            if (errno == EINTR)
+                continue;
+            /* TX queue full: the rest is dropped, as can_frame_send does */
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+                return sent;
+            fprintf(stderr, "%s: %s\n", __FUNCTION__, strerror(errno));
+            return sent ? (int)sent : -1;
+        }
+        sent += ret;
+    }
+    return sent;
+}
+
+static void can_frame_stamp_parse(struct can_device_info_t *dev_info, struct msghdr *hdr, uint32_t idx) {
+    struct cmsghdr *cmsg;
+    struct timespec ts[3];
+
+    dev_info->rx_stamp[idx].tv_sec = 0;
+    dev_info->rx_stamp[idx].tv_nsec = 0;
+    dev_info->rx_stamp_hw[idx] = 0;
+    for (cmsg = CMSG_FIRSTHDR(hdr); cmsg; cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING)
+            continue;
+        /* ts[0] kernel clock, ts[2] raw controller clock */
+        memcpy(ts, CMSG_DATA(cmsg), sizeof(ts));
+        if (ts[2].tv_sec || ts[2].tv_nsec) {
+            dev_info->rx_stamp[idx] = ts[2];
+            dev_info->rx_stamp_hw[idx] = 1;
+        } else {
+            dev_info->rx_stamp[idx] = ts[0];
+        }
+    }
+}
+
+/*
+ * Whatever frames are queued, up to nframes, with one recvmmsg(). The
+ * frames land in the caller's buffers, the RX pool cells in the ICF.
+ */
+int can_frame_recv_batch(void *priv_data, struct iovec *frames, uint32_t nframes) {
+    struct mmsghdr msgs[ICF_BATCH_MAX];
+    char cmsg_buf[ICF_BATCH_MAX][CAN_STAMP_CMSG_SIZE];
+    struct can_device_info_t *dev_info = priv_data;
+    struct can_frame *pframe;
+    int idx, ret;
+
+    if (nframes > ICF_BATCH_MAX)
+        nframes = ICF_BATCH_MAX;
+    memset(msgs, 0, sizeof(struct mmsghdr) * nframes);
+    for (idx = 0; idx < (int)nframes; idx++) {
+        msgs[idx].msg_hdr.msg_iov = &frames[idx];
+        msgs[idx].msg_hdr.msg_iovlen = 1;
+        if (dev_info->stamping) {
+            msgs[idx].msg_hdr.msg_control = cmsg_buf[idx];
+            msgs[idx].msg_hdr.msg_controllen = CAN_STAMP_CMSG_SIZE;
+        }
+    }
+    dev_info->rx_stamp_cnt = 0;
+    if ((ret = recvmmsg(dev_info->can_fd, msgs, nframes, MSG_DONTWAIT, NULL)) < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return 0;
+        fprintf(stderr, "%s: %s\n", __FUNCTION__, strerror(errno));
+        return -1;
+    }
+    for (idx = 0; idx < ret; idx++) {
+        frames[idx].iov_len = msgs[idx].msg_len;
+        pframe = frames[idx].iov_base;
+        if (pframe->can_id & CAN_ERR_FLAG) {
+            fprintf(stderr, "error frame\n");
+            errExit(__FUNCTION__);
+        }
+        if (dev_info->stamping)
+            can_frame_stamp_parse(dev_info, &msgs[idx].msg_hdr, idx);
+    }
+    dev_info->rx_stamp_cnt = ret;
+    return ret;
+}
+
+/*
+ * Receive timestamps of the frames the last recv_batch returned, in the
+ * same order. Returns how many were copied, 0 with timestamping off.
+ */
+int socketcan_rx_timestamps(void *priv_data, struct timespec *stamps, uint8_t *hw, uint32_t nstamps) {
+    struct can_device_info_t *dev_info = priv_data;
+    uint32_t idx;
+
+    if (dev_info == NULL || dev_info->stamping == 0)
+        return 0;
+    if (nstamps > dev_info->rx_stamp_cnt)
+        nstamps = dev_info->rx_stamp_cnt;
+    for (idx = 0; idx < nstamps; idx++) {
+        stamps[idx] = dev_info->rx_stamp[idx];
+        if (hw)
+            hw[idx] = dev_info->rx_stamp_hw[idx];
+    }
+    return nstamps;
+}
+
 int socketcan_select(void *priv_data, struct timeval *timeout) {
     int ret = 0;
     struct can_device_info_t *dev_info = priv_data;
@@ -193,6 +329,11 @@ void socketcan_fd_zero(void *priv_data) {
     FD_ZERO(dev_info->set);
 }
 
+int socketcan_get_fd(void *priv_data) {
+    struct can_device_info_t *dev_info = priv_data;
+    return dev_info->can_fd;
+}
+
 uint32_t socketcan_get_header_size(void *priv_data) {
     struct can_device_info_t *dev_info = priv_data;
     return dev_info->header_size;
@@ -210,4 +351,7 @@ struct icf_driver_ops icf_driver_socketcan_ops = {
     .fd_zero = socketcan_fd_zero,
     .is_server = NULL,
     .close_interface = socket_can_deinit,
+    .get_fd = socketcan_get_fd,
+    .send_batch = can_frame_send_batch,
+    .recv_batch = can_frame_recv_batch,
 };
@@ -0,0 +1,262 @@
+#define _GNU_SOURCE
+#include "icf_trx_ctrl.h"
+#include "socket_can.h"
+#include <dlfcn.h>
+
+/*
+ * The socketcan driver, one frame per read()/write() against one
+ * recvmmsg()/sendmmsg() per batch:
+ *   - mock: the driver runs on one end of an AF_UNIX SOCK_SEQPACKET pair,
+ *     which keeps frame boundaries as CAN_RAW does, so it runs anywhere
+ *   - vcan0: two driver instances on the virtual bus, receive timestamps
+ *     included; skipped when the interface is not there
+ *     (ip link add dev vcan0 type vcan && ip link set up vcan0)
+ * The ESPS downlink, two TVC frames and an event frame queued on two TX
+ * queues of HW_PORT0, must leave in one sendmmsg from icf_tx_port_job().
+ * Every frame must arrive once, in order.
+ */
+
+#define ROUND       32
+#define N_ROUNDS    5000
+#define VCAN_NAME   "vcan0"
+
+/* hooks the ICF control code links against */
+double exec_get_sim_time(void) { return 0.0; }
+int fc_can_cmd_dispatch(void *rxframe) { return EGSE_EMPTY_SW_QIDX; }
+
+static long n_syscall = 0;
+
+#define COUNT_CALL(ret, name, proto, args)              \
+    ret name proto {                                    \
+        static ret (*real) proto = NULL;                \
+        if (real == NULL)                               \
+            real = dlsym(RTLD_NEXT, #name);             \
+        n_syscall++;                                    \
+        return real args;                               \
+    }
+
+COUNT_CALL(ssize_t, read, (int fd, void *buf, size_t len), (fd, buf, len))
+COUNT_CALL(ssize_t, write, (int fd, const void *buf, size_t len), (fd, buf, len))
+COUNT_CALL(int, sendmmsg, (int fd, struct mmsghdr *msg, unsigned int vlen, int flags), (fd, msg, vlen, flags))
+COUNT_CALL(int, recvmmsg, (int fd, struct mmsghdr *msg, unsigned int vlen, int flags,
+                           struct timespec *timeout), (fd, msg, vlen, flags, timeout))
+
+struct bench_result {
+    double frames_per_sec;
+    double syscalls_per_frame;
+    int lost;
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int check(const char *what, int ok) {
+    fprintf(stderr, "%s %s\n", ok ? "PASS" : "FAIL", what);
+    return !ok;
+}
+
+static void frame_fill(struct can_frame *frame, uint32_t seq) {
+    memset(frame, 0, sizeof(*frame));
+    frame->can_id = 0x100 + (seq & 0x3ff);
+    frame->can_dlc = CAN_MAX_DLEN;
+    memcpy(frame->data, &seq, sizeof(seq));
+}
+
+static int frame_seq(struct can_frame *frame) {
+    uint32_t seq;
+    memcpy(&seq, frame->data, sizeof(seq));
+    return seq;
+}
+
+/* the driver state socket_can_init() would build, around an fd of our own */
+static struct can_device_info_t *mock_open(int fd) {
+    struct can_device_info_t *dev_info = calloc(1, sizeof(struct can_device_info_t));
+    dev_info->can_fd = fd;
+    dev_info->set = calloc(1, sizeof(fd_set));
+    strncpy(dev_info->ifr.ifr_name, "mock", sizeof(dev_info->ifr.ifr_name));
+    return dev_info;
+}
+
+/* tx and rx are driver instances; ROUND frames per round */
+static struct bench_result run(struct icf_driver_ops *ops, void *tx, void *rx, int batch) {
+    struct can_frame out[ROUND], in[ROUND];
+    struct iovec txv[ROUND], rxv[ROUND];
+    struct bench_result res = {0.0, 0.0, 0};
+    uint32_t seq = 0, expect = 0;
+    long calls0 = n_syscall;
+    double t0 = now_sec();
+    int round, idx, got, n;
+
+    for (round = 0; round < N_ROUNDS; round++) {
+        for (idx = 0; idx < ROUND; idx++) {
+            frame_fill(&out[idx], seq++);
+            txv[idx].iov_base = &out[idx];
+            txv[idx].iov_len = sizeof(struct can_frame);
+        }
+        if (batch) {
+            ops->send_batch(tx, txv, ROUND);
+        } else {
+            for (idx = 0; idx < ROUND; idx++)
+                ops->send_data(tx, (uint8_t *)&out[idx], sizeof(struct can_frame));
+        }
+        for (got = 0; got < ROUND;) {
+            if (batch) {
+                for (idx = 0; idx < ROUND; idx++) {
+                    rxv[idx].iov_base = &in[idx];
+                    rxv[idx].iov_len = sizeof(struct can_frame);
+                }
+                n = ops->recv_batch(rx, rxv, ROUND - got);
+            } else {
+                n = ops->recv_data(rx, (uint8_t *)&in[0], sizeof(struct can_frame)) > 0;
+            }
+            if (n < 0 || (n == 0 && now_sec() - t0 > 30.0))
+                break;
+            for (idx = 0; idx < n; idx++) {
+                if (frame_seq(&in[idx]) != (int)expect)
+                    res.lost++;
+                expect = frame_seq(&in[idx]) + 1;
+            }
+            got += n;
+        }
+        res.lost += ROUND - got;
+    }
+    res.frames_per_sec = (double)N_ROUNDS * ROUND / (now_sec() - t0);
+    res.syscalls_per_frame = (double)(n_syscall - calls0) / ((double)N_ROUNDS * ROUND);
+    return res;
+}
+
+static int report(const char *name, struct bench_result *frame, struct bench_result *batch) {
+    fprintf(stderr, "     %-6s per-frame %9.0f frames/s %5.2f syscalls/frame\n",
+            name, frame->frames_per_sec, frame->syscalls_per_frame);
+    fprintf(stderr, "     %-6s batched   %9.0f frames/s %5.2f syscalls/frame\n",
+            name, batch->frames_per_sec, batch->syscalls_per_frame);
+    return check("every frame delivered once, in order", frame->lost == 0 && batch->lost == 0)
+           + check("batched takes fewer syscalls per frame", batch->syscalls_per_frame < frame->syscalls_per_frame);
+}
+
+/* icf_tx_port_job() on an ESPS like HW_PORT0, the mock bus underneath */
+static int port_job_test(struct icf_driver_ops *ops, void *drv, int peer_fd) {
+    static struct icf_ctrl_port port;
+    static struct icf_ctrl_queue tvc, event;
+    struct icf_ctrlblk_t ctrl;
+    struct can_frame frame[3], in;
+    long calls0;
+    int idx, failed = 0, ok = 1;
+
+    memset(&ctrl, 0, sizeof(ctrl));
+    ctrl.system_type = ICF_SYSTEM_TYPE_ESPS;
+    ctrl.epoll_fd = -1;
+    port.enable = 1;
+    port.hw_port_idx = HW_PORT0;
+    port.dev_type = CAN_DEVICE_TYPE;
+    port.drv_priv_ops = ops;
+    port.drv_priv_data = drv;
+    port.tx_pool = icf_frame_pool_create();
+    port.link_state = ICF_LINK_UP;
+    tvc.enable = event.enable = 1;
+    tvc.queue_idx = ESPS_TVC_SW_QIDX;
+    event.queue_idx = ESPS_TX_MISSION_CODE_QIDX;
+    tvc.direction = event.direction = ICF_DIRECTION_TX;
+    tvc.port = event.port = &port;
+    rb_init(&tvc.data_ring, NUM_OF_CELL);
+    rb_init(&event.data_ring, NUM_OF_CELL);
+    ctrl.ctrlport[HW_PORT0] = &port;
+    ctrl.ctrlqueue[ESPS_TVC_SW_QIDX] = &tvc;
+    ctrl.ctrlqueue[ESPS_TX_MISSION_CODE_QIDX] = &event;
+
+    for (idx = 0; idx < 3; idx++)
+        frame_fill(&frame[idx], idx);
+    icf_tx_enqueue(&ctrl, ESPS_TVC_SW_QIDX, &frame[0], sizeof(struct can_frame));
+    icf_tx_enqueue(&ctrl, ESPS_TVC_SW_QIDX, &frame[1], sizeof(struct can_frame));
+    icf_tx_enqueue(&ctrl, ESPS_TX_MISSION_CODE_QIDX, &frame[2], sizeof(struct can_frame));
+    calls0 = n_syscall;
+    icf_tx_port_job(&ctrl, HW_PORT0);
+    failed += check("icf_tx_port_job: two queues, one syscall", n_syscall - calls0 == 1);
+    for (idx = 0; idx < 3; idx++) {
+        if (recv(peer_fd, &in, sizeof(in), MSG_DONTWAIT) != sizeof(in) || memcmp(&in, &frame[idx], sizeof(in)))
+            ok = 0;
+    }
+    failed += check("icf_tx_port_job: TVC then event frames on the bus", ok);
+    failed += check("icf_tx_port_job: pool cells returned", icf_frame_pool_available(port.tx_pool) == ICF_FRAME_POOL_CELLS);
+
+    rb_deinit(&tvc.data_ring);
+    rb_deinit(&event.data_ring);
+    icf_frame_pool_destroy(&port.tx_pool);
+    return failed;
+}
+
+static int mock_test(void) {
+    struct icf_driver_ops *ops = icf_drivers[ICF_DRIVERS_ID0];
+    struct can_device_info_t *a, *b;
+    struct bench_result frame, batch;
+    int sp[2], failed = 0;
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sp) < 0) {
+        perror("socketpair");
+        return 1;
+    }
+    fcntl(sp[0], F_SETFL, fcntl(sp[0], F_GETFL) | O_NONBLOCK);
+    fcntl(sp[1], F_SETFL, fcntl(sp[1], F_GETFL) | O_NONBLOCK);
+    a = mock_open(sp[0]);
+    b = mock_open(sp[1]);
+
+    failed += port_job_test(ops, a, sp[1]);
+    frame = run(ops, a, b, 0);
+    batch = run(ops, a, b, 1);
+    failed += report("mock", &frame, &batch);
+
+    ops->close_interface((void **)&a);
+    ops->close_interface((void **)&b);
+    return failed;
+}
+
+static int vcan_test(void) {
+    struct icf_driver_ops *ops = icf_drivers[ICF_DRIVERS_ID0];
+    struct bench_result frame, batch;
+    struct can_frame out, in;
+    struct iovec txv, rxv;
+    struct timespec stamp;
+    uint8_t hw = 0;
+    void *tx = NULL, *rx = NULL;
+    int failed = 0, nstamp;
+
+    if (if_nametoindex(VCAN_NAME) == 0) {
+        fprintf(stderr, "SKIP %s not present\n", VCAN_NAME);
+        return 0;
+    }
+    ops->open_interface(&tx, VCAN_NAME, EMPTY_NETPORT);
+    ops->open_interface(&rx, VCAN_NAME, EMPTY_NETPORT);
+
+    frame = run(ops, tx, rx, 0);
+    batch = run(ops, tx, rx, 1);
+    failed += report("vcan", &frame, &batch);
+
+    frame_fill(&out, 0x5a5a);
+    txv.iov_base = &out;
+    txv.iov_len = sizeof(out);
+    rxv.iov_base = &in;
+    rxv.iov_len = sizeof(in);
+    ops->send_batch(tx, &txv, 1);
+    while (ops->recv_batch(rx, &rxv, 1) == 0)
+        usleep(100);
+    nstamp = socketcan_rx_timestamps(rx, &stamp, &hw, 1);
+    fprintf(stderr, "     vcan   rx timestamp %ld.%09ld (%s clock)\n",
+            (long)stamp.tv_sec, stamp.tv_nsec, hw ? "controller" : "kernel");
+    failed += check("vcan receive timestamp present", nstamp == 1 && (stamp.tv_sec || stamp.tv_nsec));
+
+    ops->close_interface(&tx);
+    ops->close_interface(&rx);
+    return failed;
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = 0;
+
+    fprintf(stderr, "** socketcan batch benchmark, %d rounds of %d frames **\n", N_ROUNDS, ROUND);
+    failed += mock_test();
+    failed += vcan_test();
+    return failed ? 1 : 0;
+}
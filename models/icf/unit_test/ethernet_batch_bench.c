@@ -0,0 +1,198 @@
+#define _GNU_SOURCE
+#include "icf_trx_ctrl.h"
+#include <dlfcn.h>
+
+/*
+ * Loopback UDP and TCP through the ICF Ethernet drivers, per-frame against
+ * batched: frames are queued on a TX queue, flushed by icf_tx_ctrl_job()
+ * and drained by icf_rx_ctrl_job() on an epoll registered RX port.
+ *
+ * Socket syscalls are counted by wrapping the libc entry points, and every
+ * frame must arrive once, in order.
+ */
+
+#define FRAME_SIZE  256
+#define ROUND       32
+#define N_ROUNDS    2000
+#define UDP_PORT    47121
+#define TCP_PORT    47122
+
+/* hooks the ICF control code links against */
+double exec_get_sim_time(void) { return 0.0; }
+int fc_can_cmd_dispatch(void *rxframe) { return EGSE_EMPTY_SW_QIDX; }
+
+static long n_syscall = 0;
+
+#define COUNT_CALL(ret, name, proto, args)              \
+    ret name proto {                                    \
+        static ret (*real) proto = NULL;                \
+        if (real == NULL)                               \
+            real = dlsym(RTLD_NEXT, #name);             \
+        n_syscall++;                                    \
+        return real args;                               \
+    }
+
+COUNT_CALL(ssize_t, send, (int fd, const void *buf, size_t len, int flags), (fd, buf, len, flags))
+COUNT_CALL(ssize_t, sendto, (int fd, const void *buf, size_t len, int flags,
+                             const struct sockaddr *addr, socklen_t alen), (fd, buf, len, flags, addr, alen))
+COUNT_CALL(int, sendmmsg, (int fd, struct mmsghdr *msg, unsigned int vlen, int flags), (fd, msg, vlen, flags))
+COUNT_CALL(ssize_t, writev, (int fd, const struct iovec *iov, int iovcnt), (fd, iov, iovcnt))
+COUNT_CALL(ssize_t, recv, (int fd, void *buf, size_t len, int flags), (fd, buf, len, flags))
+COUNT_CALL(ssize_t, recvfrom, (int fd, void *buf, size_t len, int flags,
+                               struct sockaddr *addr, socklen_t *alen), (fd, buf, len, flags, addr, alen))
+COUNT_CALL(int, recvmmsg, (int fd, struct mmsghdr *msg, unsigned int vlen, int flags,
+                           struct timespec *timeout), (fd, msg, vlen, flags, timeout))
+COUNT_CALL(ssize_t, recvmsg, (int fd, struct msghdr *msg, int flags), (fd, msg, flags))
+COUNT_CALL(int, poll, (struct pollfd *fds, nfds_t nfds, int timeout), (fds, nfds, timeout))
+COUNT_CALL(int, epoll_wait, (int epfd, struct epoll_event *ev, int maxev, int timeout), (epfd, ev, maxev, timeout))
+
+struct bench_link {
+    struct icf_driver_ops *ops;
+    struct icf_driver_ops frame_ops;  //  ops without the batch entry points
+    void *server;
+    void *client;
+    int netport;
+};
+
+struct bench_result {
+    double frames_per_sec;
+    double syscalls_per_frame;
+    int lost;
+};
+
+static void open_link(struct bench_link *link, int drv_id, int netport) {
+    memset(link, 0, sizeof(*link));
+    link->ops = icf_drivers[drv_id];
+    link->frame_ops = *link->ops;
+    link->frame_ops.send_batch = NULL;
+    link->frame_ops.recv_batch = NULL;
+    link->netport = netport;
+    link->ops->open_interface(&link->server, "bench_server", netport);
+    link->ops->open_interface(&link->client, "127.0.0.1", netport);
+    while (link->ops->link_poll(link->server) != ICF_LINK_UP || link->ops->link_poll(link->client) != ICF_LINK_UP)
+        usleep(1000);
+}
+
+static void close_link(struct bench_link *link) {
+    link->ops->close_interface(&link->client);
+    link->ops->close_interface(&link->server);
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* client TX queue -> icf_tx_ctrl_job -> socket -> icf_rx_ctrl_job -> server RX queue */
+static struct bench_result run(struct bench_link *link, int batch) {
+    static struct icf_ctrlblk_t tx_ctrl, rx_ctrl;
+    static struct icf_ctrl_port tx_port, rx_port;
+    static struct icf_ctrl_queue tx_queue, rx_queue;
+    struct icf_driver_ops *ops = batch ? link->ops : &link->frame_ops;
+    struct bench_result res;
+    uint32_t frame[FRAME_SIZE / 4];
+    uint32_t seq_tx = 0, seq_rx = 0;
+    long calls;
+    double t0;
+    int round, n, spin;
+
+    memset(&tx_ctrl, 0, sizeof(tx_ctrl));
+    memset(&tx_port, 0, sizeof(tx_port));
+    memset(&tx_queue, 0, sizeof(tx_queue));
+    tx_ctrl.system_type = ICF_SYSTEM_TYPE_EGSE;
+    icf_ctrlblk_map_init(&tx_ctrl, ICF_SYSTEM_TYPE_EGSE);
+    tx_ctrl.epoll_fd = -1;
+    tx_port.enable = 1;
+    tx_port.dev_type = ETHERNET_DEVICE_TYPE;
+    tx_port.drv_priv_data = link->client;
+    tx_port.drv_priv_ops = ops;
+    tx_port.tx_pool = icf_frame_pool_create();
+    tx_queue.enable = 1;
+    tx_queue.queue_idx = EGSE_FLIGHT_COMPUTER_SW_QIDX;
+    tx_queue.direction = ICF_DIRECTION_TX;
+    tx_queue.port = &tx_port;
+    rb_init(&tx_queue.data_ring, NUM_OF_CELL);
+    tx_ctrl.ctrlqueue[EGSE_FLIGHT_COMPUTER_SW_QIDX] = &tx_queue;
+
+    memset(&rx_ctrl, 0, sizeof(rx_ctrl));
+    memset(&rx_port, 0, sizeof(rx_port));
+    memset(&rx_queue, 0, sizeof(rx_queue));
+    rx_ctrl.system_type = ICF_SYSTEM_TYPE_EGSE;
+    icf_ctrlblk_map_init(&rx_ctrl, ICF_SYSTEM_TYPE_EGSE);
+    rx_ctrl.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    rx_port.enable = 1;
+    rx_port.hw_port_idx = HW_PORT1;
+    rx_port.dev_type = ETHERNET_DEVICE_TYPE;
+    rx_port.drv_priv_data = link->server;
+    rx_port.drv_priv_ops = ops;
+    rx_port.rx_pool = icf_frame_pool_create();
+    rx_queue.enable = 1;
+    rx_queue.queue_idx = EGSE_IMU01_RX_SW_QIDX;
+    rx_queue.direction = ICF_DIRECTION_RX;
+    rx_queue.port = &rx_port;
+    rb_init(&rx_queue.data_ring, NUM_OF_CELL);
+    rx_ctrl.ctrlport[HW_PORT1] = &rx_port;
+    rx_ctrl.ctrlqueue[EGSE_IMU01_RX_SW_QIDX] = &rx_queue;
+    icf_rx_poll_add(&rx_ctrl, &rx_port);
+
+    res.lost = 0;
+    calls = n_syscall;
+    t0 = now();
+    for (round = 0; round < N_ROUNDS; round++) {
+        for (n = 0; n < ROUND; n++) {
+            memset(frame, 0, sizeof(frame));
+            frame[0] = seq_tx++;
+            icf_tx_enqueue(&tx_ctrl, EGSE_FLIGHT_COMPUTER_SW_QIDX, frame, FRAME_SIZE);
+        }
+        icf_tx_ctrl_job(&tx_ctrl, EGSE_FLIGHT_COMPUTER_SW_QIDX);
+
+        n = 0;
+        for (spin = 0; n < ROUND && spin < 1000; spin++) {
+            icf_rx_ctrl_job(&rx_ctrl, HW_PORT1, FRAME_SIZE);
+            while (icf_rx_dequeue(&rx_ctrl, EGSE_IMU01_RX_SW_QIDX, frame, FRAME_SIZE) > 0) {
+                if (frame[0] != seq_rx)
+                    res.lost++;
+                seq_rx = frame[0] + 1;
+                n++;
+            }
+        }
+        res.lost += ROUND - n;
+    }
+    res.frames_per_sec = (double)ROUND * N_ROUNDS / (now() - t0);
+    res.syscalls_per_frame = (double)(n_syscall - calls) / (ROUND * N_ROUNDS);
+
+    close(rx_ctrl.epoll_fd);
+    icf_frame_pool_destroy(&tx_port.tx_pool);
+    icf_frame_pool_destroy(&rx_port.rx_pool);
+    return res;
+}
+
+static int bench(const char *name, int drv_id, int netport) {
+    struct bench_link link;
+    struct bench_result frame, batch;
+    int ok;
+
+    open_link(&link, drv_id, netport);
+    frame = run(&link, 0);
+    batch = run(&link, 1);
+    close_link(&link);
+
+    ok = (frame.lost == 0) && (batch.lost == 0) && (batch.syscalls_per_frame < frame.syscalls_per_frame);
+    fprintf(stderr, "%s %s %d x %d B frames: per-frame %.0f frames/s %.2f syscalls/frame, "
+            "batch %.0f frames/s %.2f syscalls/frame, lost %d / %d\n",
+            ok ? "PASS" : "FAIL", name, ROUND * N_ROUNDS, FRAME_SIZE,
+            frame.frames_per_sec, frame.syscalls_per_frame,
+            batch.frames_per_sec, batch.syscalls_per_frame, frame.lost, batch.lost);
+    return !ok;
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = 0;
+
+    fprintf(stderr, "** ICF Ethernet batch benchmark **\n");
+    failed += bench("UDP", ICF_DRIVERS_ID3, UDP_PORT);
+    failed += bench("TCP", ICF_DRIVERS_ID2, TCP_PORT);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+#include "icf_frame_pool.h"
+#include <sched.h>
+
+/*
+ * ICF frame pool: exhaustion / oversize accounting, and frames borrowed on
+ * one thread and returned on another (RX job -> ring -> rx_dequeue), with a
+ * second borrower hitting the same pool. Every frame carries a stamp that
+ * must survive the trip, so a cell handed out twice shows up as corruption.
+ */
+
+#define N_FRAMES  1000000UL
+#define N_TIMING  1000000UL
+
+static struct icf_frame_pool *pool;
+static struct ringbuffer_t ring;
+static volatile int done = 0;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int check_basic(void) {
+    struct ringbuffer_cell_t *cell[ICF_FRAME_POOL_CELLS];
+    int idx, fail = 0;
+
+    for (idx = 0; idx < ICF_FRAME_POOL_CELLS; idx++) {
+        cell[idx] = icf_frame_get(pool, ICF_FRAME_SIZE);
+        if (cell[idx] == NULL || cell[idx]->pool != pool || cell[idx]->frame_full_size != ICF_FRAME_SIZE)
+            fail = 1;
+    }
+    if (icf_frame_get(pool, 16) != NULL || pool->exhaust_cnt != 1 || icf_frame_pool_available(pool) != 0)
+        fail = 1;
+    for (idx = 0; idx < ICF_FRAME_POOL_CELLS; idx++)
+        icf_frame_put(cell[idx]);
+    if (icf_frame_get(pool, ICF_FRAME_SIZE + 1) != NULL || pool->oversize_cnt != 1)
+        fail = 1;
+    if (icf_frame_pool_available(pool) != ICF_FRAME_POOL_CELLS)
+        fail = 1;
+    fprintf(stderr, "%s exhaust / oversize / return\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
+
+/* RX job: borrow, stamp, push */
+static void *rx_job(void *arg) {
+    struct ringbuffer_cell_t *cell;
+    uint32_t seq;
+
+    for (seq = 1; seq <= N_FRAMES; seq++) {
+        while ((cell = icf_frame_get(pool, sizeof(uint32_t) * 2)) == NULL)
+            sched_yield();
+        ((uint32_t *)cell->l2frame)[0] = seq;
+        ((uint32_t *)cell->l2frame)[1] = ~seq;
+        while (rb_push(&ring, cell) < 0)
+            sched_yield();
+    }
+    return NULL;
+}
+
+/* rx_dequeue: pop, verify, return */
+static void *rx_dequeue(void *arg) {
+    struct ringbuffer_cell_t *cell;
+    unsigned long *n_error = arg;
+    uint32_t expect = 1;
+
+    while (expect <= N_FRAMES) {
+        cell = rb_pop(&ring);
+        if (cell == NULL) {
+            sched_yield();
+            continue;
+        }
+        if (((uint32_t *)cell->l2frame)[0] != expect || ((uint32_t *)cell->l2frame)[1] != ~expect)
+            (*n_error)++;
+        icf_frame_put(cell);
+        expect++;
+    }
+    return NULL;
+}
+
+/* another user of the same pool, borrowing and returning on its own */
+static void *tx_user(void *arg) {
+    struct ringbuffer_cell_t *cell;
+    unsigned long *n_error = arg;
+    uint32_t stamp = 0;
+
+    while (!done) {
+        cell = icf_frame_get(pool, sizeof(uint32_t));
+        if (cell == NULL) {
+            sched_yield();
+            continue;
+        }
+        *(uint32_t *)cell->l2frame = ++stamp | 0x80000000U;
+        sched_yield();
+        if (*(uint32_t *)cell->l2frame != (stamp | 0x80000000U))
+            (*n_error)++;
+        icf_frame_put(cell);
+    }
+    return NULL;
+}
+
+static void timing(void) {
+    struct ringbuffer_cell_t *cell;
+    void *frame;
+    unsigned long idx;
+    double t0, t_pool, t_heap;
+
+    t0 = now();
+    for (idx = 0; idx < N_TIMING; idx++) {
+        cell = icf_frame_get(pool, 512);
+        ((volatile uint8_t *)cell->l2frame)[0] = idx;
+        icf_frame_put(cell);
+    }
+    t_pool = now() - t0;
+
+    t0 = now();
+    for (idx = 0; idx < N_TIMING; idx++) {
+        cell = calloc(1, sizeof(struct ringbuffer_cell_t));
+        frame = calloc(1, 512);
+        ((volatile uint8_t *)frame)[0] = idx;
+        free(frame);
+        free(cell);
+    }
+    t_heap = now() - t0;
+    fprintf(stderr, "     get/put %.1f ns, calloc/free cell + frame %.1f ns\n",
+            t_pool / N_TIMING * 1e9, t_heap / N_TIMING * 1e9);
+}
+
+int main(int argc, char const *argv[]) {
+    pthread_t rx, deq, tx;
+    unsigned long n_error = 0, n_tx_error = 0;
+    int failed = 0;
+
+    fprintf(stderr, "** ICF frame pool test **\n");
+    pool = icf_frame_pool_create();
+    rb_init(&ring, NUM_OF_CELL);
+    failed += check_basic();
+
+    pthread_create(&deq, NULL, rx_dequeue, &n_error);
+    pthread_create(&tx, NULL, tx_user, &n_tx_error);
+    pthread_create(&rx, NULL, rx_job, NULL);
+    pthread_join(rx, NULL);
+    pthread_join(deq, NULL);
+    done = 1;
+    pthread_join(tx, NULL);
+
+    int ok = (n_error == 0) && (n_tx_error == 0) && (icf_frame_pool_available(pool) == ICF_FRAME_POOL_CELLS);
+    fprintf(stderr, "%s %lu frames across threads: %lu bad RX frames, %lu bad TX frames, exhausted %u times\n",
+            ok ? "PASS" : "FAIL", N_FRAMES, n_error, n_tx_error, pool->exhaust_cnt);
+    failed += !ok;
+
+    timing();
+    icf_frame_pool_destroy(&pool);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+#include "icf_trx_ctrl.h"
+
+/*
+ * The direct indexed maps built by icf_ctrlblk_map_init() against a linear
+ * scan of the mapping tables, as the ICF resolved them before, for every
+ * entry of every system; the RX dispatch against the old per-system switch;
+ * the flight computer CAN command hash against every command in its table.
+ */
+
+#define N_LOOKUPS   2000000
+
+/* hooks the ICF control code links against */
+double exec_get_sim_time(void) { return 0.0; }
+
+static const int systems[] = {
+    ICF_SYSTEM_TYPE_EGSE, ICF_SYSTEM_TYPE_ESPS, ICF_SYSTEM_TYPE_SIL_EGSE, ICF_SYSTEM_TYPE_SIL_ESPS
+};
+static const char *system_name[] = {"EGSE", "ESPS", "SIL EGSE", "SIL ESPS"};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int check(const char *what, int ok) {
+    fprintf(stderr, "%s %s\n", ok ? "PASS" : "FAIL", what);
+    return !ok;
+}
+
+/* reference: first table entry of the queue / port */
+static const struct icf_mapping *scan_qidx(const struct icf_mapping *tbl, int n, int qidx) {
+    int idx;
+    for (idx = 0; idx < n; idx++)
+        if (tbl[idx].sw_queue == qidx)
+            return &tbl[idx];
+    return NULL;
+}
+
+static const struct icf_mapping *scan_pidx(const struct icf_mapping *tbl, int n, int pidx) {
+    int idx;
+    for (idx = 0; idx < n; idx++)
+        if (tbl[idx].hw_port_idx == pidx)
+            return &tbl[idx];
+    return NULL;
+}
+
+/* reference: the RX dispatch switch the maps replace */
+static int switch_dispatch(int system_type, void *rxframe, int hw_port_idx) {
+    if (system_type == ICF_SYSTEM_TYPE_ESPS || system_type == ICF_SYSTEM_TYPE_SIL_ESPS)
+        return ESPS_GNC_SW_QIDX;
+    if (system_type == ICF_SYSTEM_TYPE_SIL_EGSE)
+        return EGSE_SIL_DOWNLINK_SW_QIDX;
+    switch (hw_port_idx) {
+        case HW_PORT1: return EGSE_IMU01_RX_SW_QIDX;
+        case HW_PORT2: return EGSE_RX_RATETBL_X_SW_QIDX;
+        case HW_PORT3: return EGSE_RX_RATETBL_Y_SW_QIDX;
+        case HW_PORT4: return EGSE_RX_RATETBL_Z_SW_QIDX;
+        case HW_PORT5: return EGSE_IMU02_RX_SW_QIDX;
+        default: return fc_can_cmd_dispatch(rxframe);
+    }
+}
+
+/* reference: linear search of the CAN command table */
+static int scan_can(const struct fc_can_info_t *cmd, int ncmd, struct can_frame *frame) {
+    int idx;
+    for (idx = 0; idx < ncmd; idx++)
+        if (cmd[idx].canid == frame->can_id && cmd[idx].taskcmd == frame->data[0])
+            return cmd[idx].sw_queue_idx;
+    return EGSE_EMPTY_SW_QIDX;
+}
+
+static int map_test(int sys) {
+    struct icf_ctrlblk_t ctrl;
+    const struct icf_mapping *tbl, *ref;
+    const struct fc_can_info_t *cmd;
+    struct can_frame frame;
+    int n, ncmd, idx, pidx, nrx = 0, bad_q = 0, bad_p = 0, bad_rx = 0, failed = 0;
+    char what[96];
+
+    memset(&ctrl, 0, sizeof(ctrl));
+    ctrl.system_type = systems[sys];
+    snprintf(what, sizeof(what), "%s: map built", system_name[sys]);
+    failed += check(what, icf_ctrlblk_map_init(&ctrl, systems[sys]) == ICF_STATUS_SUCCESS);
+    tbl = icf_mapping_table(systems[sys], &n);
+    cmd = fc_can_cmd_table(&ncmd);
+
+    for (idx = 0; idx < n; idx++) {
+        ref = scan_qidx(tbl, n, tbl[idx].sw_queue);
+        if (ctrl.qidx_to_pidx[tbl[idx].sw_queue] != ref->hw_port_idx)
+            bad_q++;
+        ref = scan_pidx(tbl, n, tbl[idx].hw_port_idx);
+        if (ctrl.pidx_to_drivers_id[tbl[idx].hw_port_idx] != ref->driver_id)
+            bad_p++;
+    }
+    snprintf(what, sizeof(what), "%s: %d entries, queue -> port", system_name[sys], n);
+    failed += check(what, bad_q == 0);
+    snprintf(what, sizeof(what), "%s: %d entries, port -> driver", system_name[sys], n);
+    failed += check(what, bad_p == 0);
+
+    /* every port, also those without an RX queue of their own, with every CAN command on it */
+    for (pidx = 0; pidx < NUM_OF_HW_PORT; pidx++) {
+        nrx++;
+        for (idx = 0; idx < ncmd; idx++) {
+            memset(&frame, 0, sizeof(frame));
+            frame.can_id = cmd[idx].canid;
+            frame.data[0] = cmd[idx].taskcmd;
+            if (icf_dispatch_rx_frame(&ctrl, &frame, pidx) != switch_dispatch(systems[sys], &frame, pidx))
+                bad_rx++;
+        }
+    }
+    snprintf(what, sizeof(what), "%s: RX dispatch on all %d ports as the switch did", system_name[sys], nrx);
+    failed += check(what, bad_rx == 0);
+    return failed;
+}
+
+static int can_hash_test(void) {
+    const struct fc_can_info_t *cmd;
+    struct can_frame frame;
+    volatile int sink = 0;
+    double t0, t_hash, t_scan;
+    int ncmd, idx, bad = 0, failed = 0;
+
+    cmd = fc_can_cmd_table(&ncmd);
+    for (idx = 0; idx < ncmd; idx++) {
+        memset(&frame, 0, sizeof(frame));
+        frame.can_id = cmd[idx].canid;
+        frame.data[0] = cmd[idx].taskcmd;
+        if (fc_can_cmd_dispatch(&frame) != cmd[idx].sw_queue_idx)
+            bad++;
+    }
+    failed += check("CAN hash: every command of the table found", bad == 0);
+    memset(&frame, 0, sizeof(frame));
+    frame.can_id = FC_to_EGSE_MISSION_EVENT_FAKE;
+    frame.data[0] = 0xff;
+    failed += check("CAN hash: unknown command misses", fc_can_cmd_dispatch(&frame) == EGSE_EMPTY_SW_QIDX);
+
+    /* the last table entry is the worst case of the scan */
+    frame.can_id = cmd[ncmd - 1].canid;
+    frame.data[0] = cmd[ncmd - 1].taskcmd;
+    t0 = now_sec();
+    for (idx = 0; idx < N_LOOKUPS; idx++)
+        sink += fc_can_cmd_dispatch(&frame);
+    t_hash = (now_sec() - t0) / N_LOOKUPS * 1e9;
+    t0 = now_sec();
+    for (idx = 0; idx < N_LOOKUPS; idx++)
+        sink += scan_can(cmd, ncmd, &frame);
+    t_scan = (now_sec() - t0) / N_LOOKUPS * 1e9;
+    fprintf(stderr, "     %d commands: hash %.1f ns, linear scan %.1f ns per lookup\n", ncmd, t_hash, t_scan);
+    return failed;
+}
+
+int main(int argc, char const *argv[]) {
+    int sys, failed = 0;
+
+    fprintf(stderr, "** ICF mapping table test **\n");
+    fc_can_hashtbl_init();
+    for (sys = 0; sys < (int)(sizeof(systems) / sizeof(systems[0])); sys++)
+        failed += map_test(sys);
+    failed += can_hash_test();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+#include "icf_trx_ctrl.h"
+#include "ethernet.h"
+
+/*
+ * ICF Ethernet TCP bring-up over loopback, without blocking in the init:
+ *   - a client opened before its server returns at once and backs off
+ *   - time-to-connected once the late server comes up
+ *   - a server opened before its client returns at once, accepts on poll
+ *   - the data path is blocking again once the link is up
+ *   - icf_ctrlblk_wait_links() gives up after its timeout
+ */
+
+#define LINK_PORT       47131
+#define PEER_DELAY_MS   300
+
+/* hooks the ICF control code links against */
+double exec_get_sim_time(void) { return 0.0; }
+int fc_can_cmd_dispatch(void *rxframe) { return EGSE_EMPTY_SW_QIDX; }
+
+struct link_end {
+    struct icf_ctrlblk_t ctrl;
+    struct icf_ctrl_port port;
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+static void sleep_ms(int ms) {
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+/* returns how long icf_port_open() took, in ms */
+static double open_end(struct link_end *end, const char *ifname, int netport) {
+    double t0;
+
+    memset(end, 0, sizeof(*end));
+    end->ctrl.system_type = ICF_SYSTEM_TYPE_SIL_EGSE;
+    end->ctrl.epoll_fd = -1;
+    end->port.enable = 1;
+    end->port.hw_port_idx = HW_PORT8;
+    strncpy(end->port.ifname, ifname, IFNAMSIZ - 1);
+    end->port.netport = netport;
+    end->port.dev_type = ETHERNET_DEVICE_TYPE;
+    end->port.drv_priv_ops = icf_drivers[ICF_DRIVERS_ID2];
+    end->ctrl.ctrlport[HW_PORT8] = &end->port;
+    t0 = now_ms();
+    icf_port_open(&end->ctrl, &end->port);
+    return now_ms() - t0;
+}
+
+static void close_end(struct link_end *end) {
+    end->port.drv_priv_ops->close_interface(&end->port.drv_priv_data);
+}
+
+/* the simulation loop: one link pass per 1 ms cycle on both ends */
+static double time_to_connected(struct link_end *a, struct link_end *b, double t0) {
+    while (icf_link_poll(&a->ctrl) + icf_link_poll(&b->ctrl) > 0) {
+        if (now_ms() - t0 > 10000)
+            return -1.0;
+        sleep_ms(1);
+    }
+    return now_ms() - t0;
+}
+
+static int check(const char *what, int ok) {
+    fprintf(stderr, "%s %s\n", ok ? "PASS" : "FAIL", what);
+    return !ok;
+}
+
+int main(int argc, char const *argv[]) {
+    struct link_end server, client;
+    uint32_t frame[4] = {0xcafe, 1, 2, 3}, rx[4];
+    struct icf_driver_ops *ops;
+    double t_open, t_conn, t0;
+    int n, failed = 0;
+
+    fprintf(stderr, "** ICF Ethernet link bring-up test **\n");
+
+    /* client first, server PEER_DELAY_MS later */
+    t_open = open_end(&client, "127.0.0.1", LINK_PORT);
+    failed += check("client init returns without a server",
+                    t_open < 50.0 && icf_link_state(&client.ctrl, HW_PORT8) != ICF_LINK_UP
+                    && client.ctrl.link_pending == 1);
+    t0 = now_ms();
+    while (now_ms() - t0 < PEER_DELAY_MS) {
+        icf_link_poll(&client.ctrl);
+        sleep_ms(1);
+    }
+    t0 = now_ms();
+    t_open = open_end(&server, "link_server", LINK_PORT);
+    t_conn = time_to_connected(&client, &server, t0);
+    fprintf(stderr, "     server %d ms late: connected %.1f ms after it started\n", PEER_DELAY_MS, t_conn);
+    failed += check("late server reached within one backoff step",
+                    t_conn >= 0.0 && t_conn < ETHERNET_BACKOFF_MAX_MS);
+
+    /* data path */
+    ops = client.port.drv_priv_ops;
+    ops->send_data(client.port.drv_priv_data, (uint8_t *)frame, sizeof(frame));
+    n = ops->recv_data(server.port.drv_priv_data, (uint8_t *)rx, sizeof(rx));
+    failed += check("frame crosses the link", n == sizeof(rx) && memcmp(frame, rx, sizeof(rx)) == 0);
+    close_end(&client);
+    close_end(&server);
+
+    /* server first, client PEER_DELAY_MS later */
+    t_open = open_end(&server, "link_server", LINK_PORT + 1);
+    failed += check("server init returns without a client",
+                    t_open < 50.0 && icf_link_state(&server.ctrl, HW_PORT8) == ICF_LINK_CONNECTING);
+    t0 = now_ms();
+    while (now_ms() - t0 < PEER_DELAY_MS) {
+        icf_link_poll(&server.ctrl);
+        sleep_ms(1);
+    }
+    t0 = now_ms();
+    open_end(&client, "127.0.0.1", LINK_PORT + 1);
+    t_conn = time_to_connected(&client, &server, t0);
+    fprintf(stderr, "     client %d ms late: connected %.1f ms after it started\n", PEER_DELAY_MS, t_conn);
+    failed += check("late client accepted on the next poll", t_conn >= 0.0 && t_conn < 20.0);
+    close_end(&client);
+    close_end(&server);
+
+    /* nobody on the other end */
+    open_end(&client, "127.0.0.1", LINK_PORT + 2);
+    t0 = now_ms();
+    n = icf_ctrlblk_wait_links(&client.ctrl, 100);
+    t_conn = now_ms() - t0;
+    failed += check("wait_links times out", n == ICF_STATUS_FAIL && t_conn >= 100.0 && t_conn < 500.0);
+    close_end(&client);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+#include "ringbuffer.h"
+#include <sched.h>
+
+/*
+ * SPSC ring against the previous mutex ring (kept here as the reference):
+ *   throughput  one producer / one consumer thread streaming N_ITEMS
+ *   latency     ping-pong round trip between two threads over two rings
+ * Waiting sides yield, so the numbers stay meaningful on a single core.
+ */
+
+#define N_ITEMS  2000000UL
+#define N_PINGS  200000UL
+
+struct mutex_ring_t {
+    volatile uint32_t writer_idx;
+    volatile uint32_t reader_idx;
+    uint32_t full_cnt;
+    pthread_mutex_t ring_lock;
+    void *pCell[NUM_OF_CELL];
+};
+
+static void mutex_rb_init(struct mutex_ring_t *rb) {
+    memset(rb, 0, sizeof(*rb));
+    pthread_mutex_init(&rb->ring_lock, NULL);
+}
+
+static void mutex_rb_push(struct mutex_ring_t *rb, void *payload) {
+    pthread_mutex_lock(&rb->ring_lock);
+    if (rb->writer_idx == (NUM_OF_CELL + rb->reader_idx)) {
+        pthread_mutex_unlock(&rb->ring_lock);
+        rb->full_cnt++;
+        return;
+    }
+    rb->pCell[rb->writer_idx & (NUM_OF_CELL - 1)] = payload;
+    rb->writer_idx++;
+    pthread_mutex_unlock(&rb->ring_lock);
+}
+
+static void *mutex_rb_pop(struct mutex_ring_t *rb) {
+    void *ret;
+    pthread_mutex_lock(&rb->ring_lock);
+    if (rb->writer_idx == rb->reader_idx) {
+        pthread_mutex_unlock(&rb->ring_lock);
+        return NULL;
+    }
+    ret = rb->pCell[rb->reader_idx & (NUM_OF_CELL - 1)];
+    rb->reader_idx++;
+    pthread_mutex_unlock(&rb->ring_lock);
+    return ret;
+}
+
+static struct ringbuffer_t spsc[2];
+static struct mutex_ring_t locked[2];
+static int use_mutex;
+
+static void push(int r, void *p) {
+    if (use_mutex)
+        mutex_rb_push(&locked[r], p);
+    else
+        rb_push(&spsc[r], p);
+}
+
+static void *pop(int r) {
+    return use_mutex ? mutex_rb_pop(&locked[r]) : rb_pop(&spsc[r]);
+}
+
+static uint32_t full_cnt(int r) {
+    return use_mutex ? locked[r].full_cnt : spsc[r].full_cnt;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *stream_producer(void *arg) {
+    uintptr_t seq;
+    uint32_t full = 0;
+    for (seq = 1; seq <= N_ITEMS; seq++) {
+        full = full_cnt(0);
+        push(0, (void *)seq);
+        while (full_cnt(0) != full) {
+            full = full_cnt(0);
+            sched_yield();
+            push(0, (void *)seq);
+        }
+    }
+    return NULL;
+}
+
+static void *stream_consumer(void *arg) {
+    unsigned long n = 0;
+    while (n < N_ITEMS) {
+        if (pop(0))
+            n++;
+        else
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void *pong(void *arg) {
+    unsigned long n = 0;
+    void *p;
+    while (n < N_PINGS) {
+        p = pop(0);
+        if (p) {
+            push(1, p);
+            n++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void run(const char *name) {
+    pthread_t a, b;
+    uintptr_t i;
+    double t0, stream, ping;
+
+    rb_init(&spsc[0], NUM_OF_CELL);
+    rb_init(&spsc[1], NUM_OF_CELL);
+    mutex_rb_init(&locked[0]);
+    mutex_rb_init(&locked[1]);
+
+    t0 = now();
+    pthread_create(&b, NULL, stream_consumer, NULL);
+    pthread_create(&a, NULL, stream_producer, NULL);
+    pthread_join(a, NULL);
+    pthread_join(b, NULL);
+    stream = now() - t0;
+
+    pthread_create(&b, NULL, pong, NULL);
+    t0 = now();
+    for (i = 1; i <= N_PINGS; i++) {
+        push(0, (void *)i);
+        while (pop(1) == NULL)
+            sched_yield();
+    }
+    ping = now() - t0;
+    pthread_join(b, NULL);
+
+    fprintf(stderr, "%-6s %7.1f Mitems/s, %6.1f ns per item, round trip %7.1f ns\n",
+            name, N_ITEMS / stream * 1e-6, stream / N_ITEMS * 1e9, ping / N_PINGS * 1e9);
+}
+
+int main(int argc, char const *argv[]) {
+    fprintf(stderr, "** ring buffer benchmark **\n");
+    use_mutex = 1;
+    run("mutex");
+    use_mutex = 0;
+    run("spsc");
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "ringbuffer.h"
+#include <sched.h>
+
+/*
+ * Two thread stress test of the SPSC ring: the producer pushes a running
+ * sequence number, retrying whenever full_cnt shows the push was dropped,
+ * and the consumer must see every number exactly once and in order.
+ */
+
+#define N_ITEMS  2000000UL
+
+static struct ringbuffer_t ring;
+static unsigned long n_retry = 0;
+
+static void *producer(void *arg) {
+    uintptr_t seq;
+    uint32_t full = 0;
+
+    for (seq = 1; seq <= N_ITEMS; seq++) {
+        rb_push(&ring, (void *)seq);
+        while (ring.full_cnt != full) {  //  dropped, ring was full
+            full = ring.full_cnt;
+            n_retry++;
+            sched_yield();
+            rb_push(&ring, (void *)seq);
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    uintptr_t expect = 1;
+    unsigned long *n_error = arg;
+    void *item;
+
+    while (expect <= N_ITEMS) {
+        item = rb_pop(&ring);
+        if (item == NULL) {
+            sched_yield();
+            continue;
+        }
+        if ((uintptr_t)item != expect) {
+            if ((*n_error)++ < 10)
+                fprintf(stderr, "got %lu, expected %lu\n", (unsigned long)(uintptr_t)item, (unsigned long)expect);
+            expect = (uintptr_t)item;
+        }
+        expect++;
+    }
+    return NULL;
+}
+
+static int check_basic(uint32_t size) {
+    uintptr_t idx;
+    int fail = 0;
+
+    rb_init(&ring, size);
+    if (rb_pop(&ring) != NULL)
+        fail = 1;
+    for (idx = 1; idx <= size + 3; idx++)
+        rb_push(&ring, (void *)idx);
+    if (ring.full_cnt != 3 || rb_count(&ring) != size)
+        fail = 1;
+    for (idx = 1; idx <= size; idx++) {
+        if (rb_pop(&ring) != (void *)idx)
+            fail = 1;
+    }
+    if (rb_pop(&ring) != NULL || rb_count(&ring) != 0)
+        fail = 1;
+    fprintf(stderr, "%s size %u: empty / full / order\n", fail ? "FAIL" : "PASS", size);
+    return fail;
+}
+
+int main(int argc, char const *argv[]) {
+    pthread_t prod, cons;
+    unsigned long n_error = 0;
+    int failed = 0;
+
+    fprintf(stderr, "** SPSC ring buffer test **\n");
+    failed += check_basic(NUM_OF_CELL);
+    failed += check_basic(4);
+    failed += (rb_init(&ring, 100) == 0);
+
+    /* wrap the 32 bit indices during the stress run */
+    rb_init(&ring, NUM_OF_CELL);
+    ring.writer_idx = ring.reader_idx = 0xffffffffU - 1000;
+    ring.reader_cache = ring.writer_cache = ring.writer_idx;
+
+    pthread_create(&cons, NULL, consumer, &n_error);
+    pthread_create(&prod, NULL, producer, NULL);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    int ok = (n_error == 0) && (ring.full_cnt == n_retry) && (rb_pop(&ring) == NULL);
+    fprintf(stderr, "%s %lu items across two threads: %lu out of order, %lu full retries (full_cnt %u)\n",
+            ok ? "PASS" : "FAIL", N_ITEMS, n_error, n_retry, ring.full_cnt);
+    failed += !ok;
+    rb_deinit(&ring);
+
+    return failed ? 1 : 0;
+}
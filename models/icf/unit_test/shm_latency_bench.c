@@ -0,0 +1,128 @@
+#include "icf_trx_ctrl.h"
+#include "shm_channel.h"
+#include <signal.h>
+#include <sys/wait.h>
+
+/*
+ * Round trip latency between two processes on one host, as SIL runs its
+ * master and slave: the ICF Ethernet TCP driver over loopback against the
+ * shared memory driver. The parent sends a frame, the forked child echoes
+ * it back, every frame must come back intact and in order.
+ */
+
+#define FRAME_SIZE  256
+#define N_WARMUP    1000
+#define N_ROUNDS    20000
+#define TCP_PORT    47141
+#define SHM_PORT    47142
+
+/* hooks the ICF control code links against */
+double exec_get_sim_time(void) { return 0.0; }
+int fc_can_cmd_dispatch(void *rxframe) { return EGSE_EMPTY_SW_QIDX; }
+
+struct latency_result {
+    double median_us;
+    double p99_us;
+    double max_us;
+    int bad;
+};
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void *open_end(struct icf_driver_ops *ops, char *ifname, int netport) {
+    void *priv = NULL;
+    double t0 = now_us();
+
+    ops->open_interface(&priv, ifname, netport);
+    while (ops->link_poll(priv) != ICF_LINK_UP) {
+        if (now_us() - t0 > 5e6) {
+            fprintf(stderr, "%s:%d link never came up\n", ifname, netport);
+            _exit(1);
+        }
+        usleep(1000);
+    }
+    return priv;
+}
+
+static void echo_child(struct icf_driver_ops *ops, int netport) {
+    uint8_t frame[FRAME_SIZE];
+    void *priv = open_end(ops, "127.0.0.1", netport);
+    int idx;
+
+    for (idx = 0; idx < N_WARMUP + N_ROUNDS; idx++) {
+        if (ops->recv_data(priv, frame, FRAME_SIZE) != FRAME_SIZE)
+            break;
+        ops->send_data(priv, frame, FRAME_SIZE);
+    }
+    ops->close_interface(&priv);
+    _exit(0);
+}
+
+static struct latency_result run(struct icf_driver_ops *ops, int netport) {
+    static double rtt[N_ROUNDS];
+    struct latency_result res = {0.0, 0.0, 0.0, 0};
+    uint32_t frame[FRAME_SIZE / 4], echo[FRAME_SIZE / 4];
+    void *priv;
+    pid_t child;
+    double t0;
+    int idx;
+
+    priv = NULL;
+    ops->open_interface(&priv, "bench_server", netport);
+    child = fork();
+    if (child == 0)
+        echo_child(ops, netport);
+    while (ops->link_poll(priv) != ICF_LINK_UP)
+        usleep(1000);
+
+    for (idx = 0; idx < N_WARMUP + N_ROUNDS; idx++) {
+        memset(frame, idx & 0xff, sizeof(frame));
+        frame[0] = idx;
+        t0 = now_us();
+        ops->send_data(priv, (uint8_t *)frame, FRAME_SIZE);
+        if (ops->recv_data(priv, (uint8_t *)echo, FRAME_SIZE) != FRAME_SIZE
+            || memcmp(frame, echo, FRAME_SIZE) != 0) {
+            res.bad++;
+            break;
+        }
+        if (idx >= N_WARMUP)
+            rtt[idx - N_WARMUP] = now_us() - t0;
+    }
+    waitpid(child, NULL, 0);
+    ops->close_interface(&priv);
+
+    qsort(rtt, N_ROUNDS, sizeof(double), cmp_double);
+    res.median_us = rtt[N_ROUNDS / 2];
+    res.p99_us = rtt[N_ROUNDS * 99 / 100];
+    res.max_us = rtt[N_ROUNDS - 1];
+    return res;
+}
+
+static void report(const char *name, struct latency_result *res) {
+    fprintf(stderr, "     %-14s round trip median %7.2f us  p99 %7.2f us  max %8.2f us\n",
+            name, res->median_us, res->p99_us, res->max_us);
+}
+
+int main(int argc, char const *argv[]) {
+    struct latency_result tcp, shm;
+    int ok;
+
+    fprintf(stderr, "** ICF shared memory latency benchmark, %d x %d B round trips **\n", N_ROUNDS, FRAME_SIZE);
+    tcp = run(icf_drivers[ICF_DRIVERS_ID2], TCP_PORT);
+    shm = run(icf_drivers[ICF_DRIVERS_ID4], SHM_PORT);
+    report("TCP loopback", &tcp);
+    report("shared memory", &shm);
+
+    ok = tcp.bad == 0 && shm.bad == 0 && shm.median_us < tcp.median_us;
+    fprintf(stderr, "%s frames echoed intact, shared memory median below TCP\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
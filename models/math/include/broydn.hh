@@ -0,0 +1,99 @@
+#ifndef __BROYDN_HH__
+#define __BROYDN_HH__
+/********************************* TRICK HEADER *******************************
+PURPOSE:
+      (Globally convergent Broyden solver for nonlinear systems with a
+       persistent workspace, after Numerical Recipes in C 9.7)
+LIBRARY DEPENDENCY:
+      ((../src/broydn.cpp)
+       (../src/nrutil.cpp))
+*******************************************************************************/
+
+#include <functional>
+
+/**
+ * \brief Broyden's method with line search, Numerical Recipes broydn().
+ *
+ * All vectors and matrices are kept in the solver and sized once for
+ * MAX_N unknowns, so solve() does no heap allocation.  Vectors are 1-based
+ * like the nrutil vectors they replace: x[1..n].
+ *
+ * With warm start enabled, solve() starts from the solution of the previous
+ * call when the system size is unchanged, instead of the x passed in.
+ *
+ * The Jacobian at each restart is a forward difference of funcv (n calls)
+ * unless a Jacobian function is passed to solve().
+ */
+class BroydnSolver {
+ public:
+    enum { MAX_N = 12 };
+
+    typedef std::function<void(int n, double *x, double *fvec)> Function;
+    /* df[1..n][1..n] at x, where fvec = funcv(x) */
+    typedef std::function<void(int n, double *x, double *fvec, double **df)> Jacobian;
+
+    BroydnSolver();
+    BroydnSolver(const BroydnSolver& other);
+
+    BroydnSolver& operator=(const BroydnSolver& other);
+
+    /* Returns check: 0 on a normal return, 1 if converged to a local minimum of f_min */
+    int solve(double x[], int n, const Function& funcv);
+    int solve(double x[], int n, const Function& funcv, const Jacobian& jacobian);
+
+    /* Forward difference Jacobian of the function of the running solve() */
+    void fdjac(int n, double x[], double fvec[], double **df);
+
+    void set_warm_start(bool enable);
+    void reset_warm_start();
+
+    /* Warm start and statistics for a Checkpoint (checkpoint.hh), the workspace is rebuilt by every solve() */
+    template <typename Visitor> void checkpoint(Visitor &cp) {
+        cp(warm_start, x_prev_n, x_prev, its, fcalls, wall_time);
+    }
+
+    int get_iterations();       /* Broyden iterations of the last solve() */
+    int get_function_calls();   /* Function evaluations of the last solve() */
+    double get_wall_time();     /* Wall time of the last solve(), second */
+
+ private:
+    void bind_rows();
+    void rsolv(double **a, int n, double d[], double b[]);
+    double f_min(double x[]);
+    void lnsrch(int n, double xold[], double fold, double g[], double p[], double x[],
+                double *f, double stpmax, int *check);
+    void qrdcmp(double **a, int n, double *c, double *d, int *sing);
+    void qrupdt(double **r, double **qt, int n, double u[], double v[]);
+    void rotate(double **r, double **qt, int n, int i, double a, double b);
+
+    const Function *func;   /* ** function of the running solve() */
+    const Jacobian *jac;    /* ** Jacobian of the running solve(), NULL for fdjac() */
+    int nn;                 /* ** size of the running solve() */
+
+    bool warm_start;
+    int x_prev_n;
+    double x_prev[MAX_N + 1];
+
+    int its;
+    int fcalls;
+    double wall_time;
+
+    /* workspace, index 0 unused */
+    double c[MAX_N + 1];
+    double d[MAX_N + 1];
+    double fvcold[MAX_N + 1];
+    double g[MAX_N + 1];
+    double p[MAX_N + 1];
+    double s[MAX_N + 1];
+    double t[MAX_N + 1];
+    double w[MAX_N + 1];
+    double xold[MAX_N + 1];
+    double fvec[MAX_N + 1];
+    double ff[MAX_N + 1];
+    double qt_mem[MAX_N + 1][MAX_N + 1];
+    double r_mem[MAX_N + 1][MAX_N + 1];
+    double *qt[MAX_N + 1];  /* ** row pointers into qt_mem */
+    double *r[MAX_N + 1];   /* ** row pointers into r_mem */
+};
+
+#endif  // __BROYDN_HH__
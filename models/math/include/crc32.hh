@@ -0,0 +1,18 @@
+#ifndef __CRC32_HH__
+#define __CRC32_HH__
+/********************************* TRICK HEADER *******************************
+PURPOSE:
+      (CRC-32 of binary decks, checkpoints and frames)
+LIBRARY DEPENDENCY:
+      ((../src/crc32.cpp))
+*******************************************************************************/
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * \brief CRC-32 (IEEE 802.3, reflected, as zlib) of a buffer, slice-by-8.
+ * Not the ICF frame crc32() of icf_utility.h.
+ */
+uint32_t crc32_ieee(const void *buf, size_t len);
+
+#endif  // __CRC32_HH__
@@ -0,0 +1,58 @@
+#ifndef __RK4_HH__
+#define __RK4_HH__
+/********************************* TRICK HEADER *******************************
+PURPOSE:
+      (Classic fourth order Runge-Kutta step over a flat state vector)
+ICG: (No)
+*******************************************************************************/
+
+/**
+ * \brief One RK4 step of y[0..N-1] over h, stage storage on the stack.
+ *
+ * The model owns the state, so the step is driven by two callbacks:
+ *   deriv(dy)   dy/dt at the state currently loaded in the model
+ *   load(y)     load state y into the model
+ * deriv() is first called on the state already loaded, load() is called
+ * after every stage update and once with the final state.
+ *
+ * Stage sums are accumulated as k1 + 2 k2 + 2 k3 + k4, left to right.
+ */
+template <int N, class Deriv, class Load>
+inline void rk4_step(double y[], double h, Deriv deriv, Load load) {
+    double y0[N], k[N], sum[N];
+    const double half_h = 0.5 * h;
+    const double sixth_h = h / 6.0;
+    int i;
+
+    for (i = 0; i < N; i++) y0[i] = y[i];
+
+    deriv(k);
+    for (i = 0; i < N; i++) {
+        sum[i] = k[i];
+        y[i] = y0[i] + half_h * k[i];
+    }
+    load(y);
+
+    deriv(k);
+    for (i = 0; i < N; i++) {
+        sum[i] += 2.0 * k[i];
+        y[i] = y0[i] + half_h * k[i];
+    }
+    load(y);
+
+    deriv(k);
+    for (i = 0; i < N; i++) {
+        sum[i] += 2.0 * k[i];
+        y[i] = y0[i] + h * k[i];
+    }
+    load(y);
+
+    deriv(k);
+    for (i = 0; i < N; i++) {
+        sum[i] += k[i];
+        y[i] = y0[i] + sixth_h * sum[i];
+    }
+    load(y);
+}
+
+#endif  // __RK4_HH__
@@ -0,0 +1,107 @@
+#ifndef __SIMD_DOUBLE_HH__
+#define __SIMD_DOUBLE_HH__
+/********************************* TRICK HEADER *******************************
+PURPOSE:
+      (Packed double lanes for structure-of-arrays kernels)
+ICG: (No)
+*******************************************************************************/
+
+/**
+ * \brief WIDTH doubles operated on as one value.
+ *
+ * AVX-512F packs 8 lanes, AVX 4 lanes, anything else falls back to 4 lanes
+ * of plain doubles. Only the correctly rounded IEEE operations are provided
+ * (+ - * / sqrt), so a kernel written once as a template over double and
+ * simd_double gives every lane the bits of the scalar instance as long as
+ * neither is compiled with floating point contraction (-ffp-contract=off).
+ *
+ * Loads and stores are unaligned; structure-of-arrays storage only has to
+ * be padded to a multiple of WIDTH.
+ */
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+#include <cmath>
+
+#if defined(__AVX512F__)
+
+struct simd_double {
+    static const int WIDTH = 8;
+    __m512d v;
+
+    simd_double() {}
+    simd_double(double s) : v(_mm512_set1_pd(s)) {}
+    explicit simd_double(__m512d x) : v(x) {}
+
+    static simd_double load(const double *p) { return simd_double(_mm512_loadu_pd(p)); }
+    void store(double *p) const { _mm512_storeu_pd(p, v); }
+};
+
+inline simd_double operator+(simd_double a, simd_double b) { return simd_double(_mm512_add_pd(a.v, b.v)); }
+inline simd_double operator-(simd_double a, simd_double b) { return simd_double(_mm512_sub_pd(a.v, b.v)); }
+inline simd_double operator*(simd_double a, simd_double b) { return simd_double(_mm512_mul_pd(a.v, b.v)); }
+inline simd_double operator/(simd_double a, simd_double b) { return simd_double(_mm512_div_pd(a.v, b.v)); }
+inline simd_double operator-(simd_double a) {
+    return simd_double(_mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a.v),
+                                                            _mm512_set1_epi64(0x8000000000000000LL))));
+}
+inline simd_double sqrt(simd_double a) { return simd_double(_mm512_mask_sqrt_pd(a.v, 0xFF, a.v)); }
+
+#elif defined(__AVX__)
+
+struct simd_double {
+    static const int WIDTH = 4;
+    __m256d v;
+
+    simd_double() {}
+    simd_double(double s) : v(_mm256_set1_pd(s)) {}
+    explicit simd_double(__m256d x) : v(x) {}
+
+    static simd_double load(const double *p) { return simd_double(_mm256_loadu_pd(p)); }
+    void store(double *p) const { _mm256_storeu_pd(p, v); }
+};
+
+inline simd_double operator+(simd_double a, simd_double b) { return simd_double(_mm256_add_pd(a.v, b.v)); }
+inline simd_double operator-(simd_double a, simd_double b) { return simd_double(_mm256_sub_pd(a.v, b.v)); }
+inline simd_double operator*(simd_double a, simd_double b) { return simd_double(_mm256_mul_pd(a.v, b.v)); }
+inline simd_double operator/(simd_double a, simd_double b) { return simd_double(_mm256_div_pd(a.v, b.v)); }
+inline simd_double operator-(simd_double a) { return simd_double(_mm256_xor_pd(a.v, _mm256_set1_pd(-0.0))); }
+inline simd_double sqrt(simd_double a) { return simd_double(_mm256_sqrt_pd(a.v)); }
+
+#else
+
+struct simd_double {
+    static const int WIDTH = 4;
+    double v[WIDTH];
+
+    simd_double() {}
+    simd_double(double s) { for (int i = 0; i < WIDTH; i++) v[i] = s; }
+
+    static simd_double load(const double *p) {
+        simd_double r;
+        for (int i = 0; i < WIDTH; i++) r.v[i] = p[i];
+        return r;
+    }
+    void store(double *p) const { for (int i = 0; i < WIDTH; i++) p[i] = v[i]; }
+};
+
+#define SIMD_DOUBLE_LANEWISE(expr) \
+    simd_double r; \
+    for (int i = 0; i < simd_double::WIDTH; i++) r.v[i] = (expr); \
+    return r;
+
+inline simd_double operator+(simd_double a, simd_double b) { SIMD_DOUBLE_LANEWISE(a.v[i] + b.v[i]) }
+inline simd_double operator-(simd_double a, simd_double b) { SIMD_DOUBLE_LANEWISE(a.v[i] - b.v[i]) }
+inline simd_double operator*(simd_double a, simd_double b) { SIMD_DOUBLE_LANEWISE(a.v[i] * b.v[i]) }
+inline simd_double operator/(simd_double a, simd_double b) { SIMD_DOUBLE_LANEWISE(a.v[i] / b.v[i]) }
+inline simd_double operator-(simd_double a) { SIMD_DOUBLE_LANEWISE(-a.v[i]) }
+inline simd_double sqrt(simd_double a) { SIMD_DOUBLE_LANEWISE(std::sqrt(a.v[i])) }
+
+#undef SIMD_DOUBLE_LANEWISE
+
+#endif
+
+inline simd_double &operator+=(simd_double &a, simd_double b) { return a = a + b; }
+inline simd_double &operator-=(simd_double &a, simd_double b) { return a = a - b; }
+
+#endif  // __SIMD_DOUBLE_HH__
@@ -6,6 +6,7 @@ PURPOSE:
 LIBRARY DEPENDENCY:
       ((../src/stochastic.cpp))
 *******************************************************************************/
+#include <stdint.h>
 
 /**
  * \brief Generating an exponential distribution with a given mean density.
@@ -77,11 +78,58 @@ double rayleigh(double mode);
 double uniform(double min, double max);
 
 /**
- * \brief Generating uniform random distribution between 0-1 based on
- *        C function rand().
+ * \brief Generating uniform random distribution between 0-1, from the
+ *        default stream of the calling thread.
  */
 double unituni();
 
+/**
+ * \brief Seed of the default streams behind the functions above.
+ * The calling thread's stream is reset to stream 0 of the seed; threads
+ * that draw for the first time afterwards get streams 1, 2, ... in that
+ * order. Objects that must not depend on thread order own a RngStream.
+ */
+void stochastic_seed(uint64_t seed);
+
+/**
+ * \brief Counter based random stream, Philox4x32-10.
+ * Ref: Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC11
+ *
+ * Block b of stream s under seed k is philox(counter = {b, s}, key = k), so
+ * a stream is a pure function of (seed, stream, position): streams of one
+ * seed never overlap, any position can be reached without drawing up to
+ * it, and the state to checkpoint is four integers and two spares. A block
+ * gives one pair of (0, 1) uniforms, or one pair of normals through
+ * Box-Muller. gauss_fill(out, n) gives the same values as n calls of
+ * gauss(); it transforms four blocks per pass in vector lanes.
+ */
+class RngStream {
+ public:
+    explicit RngStream(uint64_t seed = 0, uint64_t stream = 0);
+
+    void set_seed(uint64_t seed, uint64_t stream);
+    void set_position(uint64_t block);
+    uint64_t get_position() const { return block; }
+
+    double uniform();
+    double gauss(double mean, double sig);
+    void gauss_fill(double *out, int n, double mean = 0.0, double sig = 1.0);
+
+    static void philox4x32(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]);
+
+    uint64_t seed;          /* *io (--)     Key of the stream */
+    uint64_t stream;        /* *io (--)     Stream id, high half of the counter */
+    uint64_t block;         /* *io (--)     Next block, low half of the counter */
+
+ private:
+    void next_pair(double *u0, double *u1);
+
+    double spare_gauss;     /* *io (--)     Second normal of the last block */
+    double spare_uni;       /* *io (--)     Second uniform of the last block */
+    int has_spare_gauss;    /* *io (--)     spare_gauss not used yet */
+    int has_spare_uni;      /* *io (--)     spare_uni not used yet */
+};
+
 
 
 #endif  // __STOCHASTIC_UTIL_HH__
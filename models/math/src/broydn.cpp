@@ -0,0 +1,414 @@
+#include "broydn.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#define NRANSI
+#include "nrutil.h"
+
+#define MAXITS 20000000
+#define ALF 1.0e-4
+#define EPS 1.0e-7  // 1.0e-7
+#define TOLF 1.0e-8  // 1.0e-4
+#define TOLX 1.0e-9
+#define STPMX 100.0
+#define TOLMIN 1.0e-10  // 1.0e-6
+
+BroydnSolver::BroydnSolver()
+    :   func(NULL), jac(NULL), nn(0), warm_start(false), x_prev_n(0),
+        its(0), fcalls(0), wall_time(0.0) {
+    bind_rows();
+}
+
+BroydnSolver::BroydnSolver(const BroydnSolver& other) {
+    bind_rows();
+    *this = other;
+}
+
+/* Copies the settings and the warm start solution, never the row pointers */
+BroydnSolver& BroydnSolver::operator=(const BroydnSolver& other) {
+    if (&other == this)
+        return *this;
+
+    this->func = NULL;
+    this->jac = NULL;
+    this->nn = 0;
+    this->warm_start = other.warm_start;
+    this->x_prev_n = other.x_prev_n;
+    memcpy(this->x_prev, other.x_prev, sizeof(x_prev));
+    this->its = other.its;
+    this->fcalls = other.fcalls;
+    this->wall_time = other.wall_time;
+
+    return *this;
+}
+
+void BroydnSolver::bind_rows() {
+    for (int i = 0; i <= MAX_N; i++) {
+        qt[i] = qt_mem[i];
+        r[i] = r_mem[i];
+    }
+}
+
+void BroydnSolver::set_warm_start(bool enable) {
+    warm_start = enable;
+    x_prev_n = 0;
+}
+
+void BroydnSolver::reset_warm_start() { x_prev_n = 0; }
+
+int BroydnSolver::get_iterations() { return its; }
+int BroydnSolver::get_function_calls() { return fcalls; }
+double BroydnSolver::get_wall_time() { return wall_time; }
+
+int BroydnSolver::solve(double x[], int n, const Function& funcv) {
+    return solve(x, n, funcv, Jacobian());
+}
+
+int BroydnSolver::solve(double x[], int n, const Function& funcv, const Jacobian& jacobian) {
+    int i, j, k, restrt, sing, skip;
+    int check = 0;
+    double den, fff, fold, stpmax, sum, temp, test;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (n < 1 || n > MAX_N)
+        nrerror(const_cast<char *>("system size out of range in broydn"));
+
+    func = &funcv;
+    jac = jacobian ? &jacobian : NULL;
+    nn = n;
+    its = 0;
+    fcalls = 0;
+
+    if (warm_start && x_prev_n == n) {
+        for (i = 1; i <= n; i++) x[i] = x_prev[i];
+    }
+
+    fff = f_min(x);
+    test = 0.0;
+    for (i = 1; i <= n; i++)
+        if (fabs(fvec[i]) > test)test = fabs(fvec[i]);
+    if (test < 0.01 * TOLF) {
+        check = 0;
+        goto done;
+    }
+    for (sum = 0.0, i = 1; i <= n; i++) sum += DSQR(x[i]);
+    stpmax = STPMX * DMAX(sqrt(sum), (double)n);
+    restrt = 1;
+    for (its = 1; its <= MAXITS; its++) {
+        if (restrt) {
+            if (jac)
+                (*jac)(n, x, fvec, r);
+            else
+                fdjac(n, x, fvec, r);
+            qrdcmp(r, n, c, d, &sing);
+            if (sing) nrerror(const_cast<char *>("singular Jacobian in broydn : qrdcmp"));
+            for (i = 1; i <= n; i++) {
+                for (j = 1; j <= n; j++) qt[i][j] = 0.0;
+                qt[i][i] = 1.0;
+            }
+            for (k = 1; k < n; k++) {
+                if (c[k]) {
+                    for (j = 1; j <= n; j++) {
+                        sum = 0.0;
+                        for (i = k; i <= n; i++)
+                            sum += r[i][k] * qt[i][j];
+                        sum /= c[k];
+                        for (i = k; i <= n; i++)
+                            qt[i][j] -= sum * r[i][k];
+                    }
+                }
+            }
+            for (i = 1; i <= n; i++) {
+                r[i][i] = d[i];
+                for (j = 1; j < i; j++) r[i][j] = 0.0;
+            }
+        } else {
+            for (i = 1; i <= n; i++) s[i] = x[i] - xold[i];
+            for (i = 1; i <= n; i++) {
+                for (sum = 0.0, j = i; j <= n; j++) sum += r[i][j] * s[j];
+                t[i] = sum;
+            }
+            skip = 1;
+            for (i = 1; i <= n; i++) {
+                for (sum = 0.0, j = 1; j <= n; j++) sum += qt[j][i] * t[j];
+                w[i] = fvec[i] - fvcold[i] - sum;
+                if (fabs(w[i]) >= EPS * (fabs(fvec[i]) + fabs(fvcold[i]))) {
+                    skip = 0;
+                } else {
+                    w[i] = 0.0;
+                }
+            }
+            if (!skip) {
+                for (i = 1; i <= n; i++) {
+                    for (sum = 0.0, j = 1; j <= n; j++) sum += qt[i][j] * w[j];
+                    t[i] = sum;
+                }
+                for (den = 0.0, i = 1; i <= n; i++) den += DSQR(s[i]);
+                for (i = 1; i <= n; i++) s[i] /= den;
+                qrupdt(r, qt, n, t, s);
+                for (i = 1; i <= n; i++) {
+                    if (r[i][i] == 0.0) nrerror(const_cast<char *>("r singular in broydn : qrupdt"));
+                    d[i] = r[i][i];
+                }
+            }
+        }
+        for (i = 1; i <= n; i++) {
+            for (sum = 0.0, j = 1; j <= n; j++) sum += qt[i][j] * fvec[j];
+            p[i] = -sum;
+        }
+        for (i = n; i >= 1; i--) {
+            for (sum = 0.0, j = 1; j <= i; j++) sum -= r[j][i] * p[j];
+            g[i] = sum;
+        }
+        for (i = 1; i <= n; i++) {
+            xold[i] = x[i];
+            fvcold[i] = fvec[i];
+        }
+        fold = fff;
+        rsolv(r, n, d, p);
+        lnsrch(n, xold, fold, g, p, x, &fff, stpmax, &check);
+        test = 0.0;
+        for (i = 1; i <= n; i++)
+            if (fabs(fvec[i]) > test) test = fabs(fvec[i]);
+        if (test < TOLF) {
+            check = 0;
+            goto done;
+        }
+        if (check) {
+            if (restrt) {
+                goto done;
+            } else {
+                test = 0.0;
+                den = DMAX(fff, 0.5 * n);
+                for (i = 1; i <= n; i++) {
+                    temp = fabs(g[i]) * DMAX(fabs(x[i]), 1.0) / den;
+                    if (temp > test) {
+                        test = temp;
+                    }
+                }
+                if (test < TOLMIN) {
+                    goto done;
+                } else {
+                    restrt = 1;
+                }
+            }
+        } else {
+            restrt = 0;
+            test = 0.0;
+            for (i = 1; i <= n; i++) {
+                temp = (fabs(x[i] - xold[i])) / DMAX(fabs(x[i]), 1.0);
+                if (temp > test) test = temp;
+            }
+            if (test < EPS) goto done;
+        }
+    }
+    nrerror(const_cast<char *>("MAXITS exceeded in broydn"));
+
+done:
+    if (warm_start) {
+        for (i = 1; i <= n; i++) x_prev[i] = x[i];
+        x_prev_n = n;
+    }
+    func = NULL;
+    jac = NULL;
+    wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return check;
+}
+
+void BroydnSolver::rsolv(double **a, int n, double d[], double b[]) {
+    int i, j;
+    double sum;
+
+    b[n] /= d[n];
+    for (i = n - 1; i >= 1; i--) {
+        for (sum = 0.0, j = i + 1; j <= n; j++) sum += a[i][j] * b[j];
+        b[i] = (b[i] - sum) / d[i];
+    }
+}
+
+void BroydnSolver::fdjac(int n, double x[], double fvec[], double **df) {
+    int i, j;
+    double h, temp;
+
+    for (j = 1; j <= n; j++) {
+        temp = x[j];
+        h = EPS * fabs(temp);
+        if (h == 0.0) h = EPS;
+        x[j] = temp + h;
+        h = x[j] - temp;
+        (*func)(n, x, ff);
+        fcalls++;
+        x[j] = temp;
+        for (i = 1; i <= n; i++) {
+            df[i][j] = (ff[i] - fvec[i]) / h;
+        }
+    }
+}
+
+double BroydnSolver::f_min(double x[]) {
+    int i;
+    double sum;
+
+    (*func)(nn, x, fvec);
+    fcalls++;
+    for (sum = 0.0, i = 1; i <= nn; i++) sum += DSQR(fvec[i]);
+    return 0.5 * sum;
+}
+
+void BroydnSolver::lnsrch(int n, double xold[], double fold, double g[], double p[], double x[],
+                          double *f, double stpmax, int *check) {
+    int i;
+    double a, alam, alam2 = 0.0, alamin, b, disc, f2 = 0.0, rhs1, rhs2, slope, sum, temp,
+           test, tmplam;
+
+    *check = 0;
+    for (sum = 0.0, i = 1; i <= n; i++) sum += p[i] * p[i];
+    sum = sqrt(sum);
+    if (sum > stpmax) {
+        for (i = 1; i <= n; i++) p[i] *= stpmax / sum;
+    }
+    for (slope = 0.0, i = 1; i <= n; i++)
+        slope += g[i] * p[i];
+    if (slope >= 0.0) {
+        nrerror(const_cast<char *>("Roundoff problem in lnsrch."));
+    }
+    test = 0.0;
+    for (i = 1; i <= n; i++) {
+        temp = fabs(p[i]) / DMAX(fabs(xold[i]), 1.0);
+        if (temp > test) {
+            test = temp;
+        }
+    }
+    alamin = TOLX / test;
+    alam = 1.0;
+    for (;;) {
+        for (i = 1; i <= n; i++) x[i] = xold[i] + alam * p[i];
+        *f = f_min(x);
+        if (alam < alamin) {
+            for (i = 1; i <= n; i++) x[i] = xold[i];
+            *check = 1;
+            return;
+        } else if (*f <= fold + ALF * alam * slope) {
+            return;
+        } else {
+            if (alam == 1.0) {
+                tmplam = -slope / (2.0 * (*f - fold - slope));
+            } else {
+                rhs1 = *f - fold - alam * slope;
+                rhs2 = f2 - fold - alam2 * slope;
+                a = (rhs1 / (alam * alam) - rhs2 / (alam2 * alam2)) / (alam - alam2);
+                b = (-alam2 * rhs1 / (alam * alam) + alam * rhs2 / (alam2 * alam2)) / (alam - alam2);
+                if (a == 0.0) {
+                    tmplam = -slope / (2.0 * b);
+                } else {
+                    disc = b * b - 3.0 * a * slope;
+                    if (disc < 0.0) {
+                        tmplam = 0.5 * alam;
+                    } else if (b <= 0.0) {
+                        tmplam = (-b + sqrt(disc)) / (3.0 * a);
+                    } else {
+                    tmplam = -slope / (b + sqrt(disc));
+                    }
+                }
+                if (tmplam > 0.5 * alam) {
+                    tmplam = 0.5 * alam;
+                }
+            }
+        }
+        alam2 = alam;
+        f2 = *f;
+        alam = DMAX(tmplam, 0.1 * alam);
+    }
+}
+
+void BroydnSolver::qrdcmp(double **a, int n, double *c, double *d, int *sing) {
+    int i, j, k;
+    double scale, sigma, sum, tau;
+
+    *sing = 0;
+    for (k = 1; k < n; k++) {
+        scale = 0.0;
+        for (i = k; i <= n; i++) scale = DMAX(scale, fabs(a[i][k]));
+        if (scale == 0.0) {
+            *sing = 1;
+            c[k] = d[k] = 0.0;
+        } else {
+            for (i = k; i <= n; i++) a[i][k] /= scale;
+            for (sum = 0.0, i = k; i <= n; i++) sum += DSQR(a[i][k]);
+            sigma = SIGN(sqrt(sum), a[k][k]);
+            a[k][k] += sigma;
+            c[k] = sigma * a[k][k];
+            d[k] = -scale * sigma;
+            for (j = k + 1; j <= n; j++) {
+                for (sum = 0.0, i = k; i <= n; i++) sum += a[i][k] * a[i][j];
+                tau = sum / c[k];
+                for (i = k; i <= n; i++) a[i][j] -= tau * a[i][k];
+            }
+        }
+    }
+    d[n] = a[n][n];
+    if (d[n] == 0.0) *sing = 1;
+}
+
+void BroydnSolver::qrupdt(double **r, double **qt, int n, double u[], double v[]) {
+    int i, j, k;
+
+    for (k = n; k >= 1; k--) {
+        if (u[k]) break;
+    }
+    if (k < 1) k = 1;
+    for (i = k - 1; i >= 1; i--) {
+        rotate(r, qt, n, i, u[i], -u[i + 1]);
+        if (u[i] == 0.0) {
+            u[i] = fabs(u[i + 1]);
+        } else if (fabs(u[i]) > fabs(u[i + 1])) {
+            u[i] = fabs(u[i]) * sqrt(1.0 + DSQR(u[i + 1] / u[i]));
+        } else {
+            u[i] = fabs(u[i + 1]) * sqrt(1.0 + DSQR(u[i] / u[i + 1]));
+        }
+    }
+    for (j = 1; j <= n; j++) r[1][j] += u[1] * v[j];
+    for (i = 1; i < k; i++)
+        rotate(r, qt, n, i, r[i][i], -r[i + 1][i]);
+}
+
+void BroydnSolver::rotate(double **r, double **qt, int n, int i, double a, double b) {
+    int j;
+    double c, fact, s, w, y;
+
+    if (a == 0.0) {
+        c = 0.0;
+        s = (b >= 0.0 ? 1.0 : -1.0);
+    } else if (fabs(a) > fabs(b)) {
+        fact = b / a;
+        c = SIGN(1.0 / sqrt(1.0 + (fact * fact)), a);
+        s = fact * c;
+    } else {
+        fact = a / b;
+        s = SIGN(1.0 / sqrt(1.0 + (fact * fact)), b);
+        c = fact * s;
+    }
+    for (j = i; j <= n; j++) {
+        y = r[i][j];
+        w = r[i + 1][j];
+        r[i][j] = c * y - s * w;
+        r[i + 1][j] = s * y + c * w;
+    }
+    for (j = 1; j <= n; j++) {
+        y = qt[i][j];
+        w = qt[i + 1][j];
+        qt[i][j] = c * y - s * w;
+        qt[i + 1][j] = s * y + c * w;
+    }
+}
+
+#undef MAXITS
+#undef ALF
+#undef EPS
+#undef TOLF
+#undef TOLMIN
+#undef TOLX
+#undef STPMX
+#undef NRANSI
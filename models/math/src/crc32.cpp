@@ -0,0 +1,42 @@
+#include "crc32.hh"
+
+#include <cstring>
+
+/* The slice-by-8 loop takes the bytes in as little-endian 32 bit words */
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "crc32_ieee() slice-by-8 needs a little-endian host"
+#endif
+
+struct crc32_tables {
+    uint32_t table[8][256];
+    crc32_tables() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            table[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++)
+            for (int k = 1; k < 8; k++)
+                table[k][i] = table[0][table[k - 1][i] & 0xff] ^ (table[k - 1][i] >> 8);
+    }
+};
+
+uint32_t crc32_ieee(const void *buf, size_t len) {
+    static const crc32_tables tables;
+    const uint32_t (*table)[256] = tables.table;
+    const uint8_t *p = static_cast<const uint8_t*>(buf);
+    uint32_t crc = 0xffffffff;
+
+    for (; len >= 8; len -= 8, p += 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, p, sizeof(lo));
+        memcpy(&hi, p + 4, sizeof(hi));
+        lo ^= crc;
+        crc = table[7][lo & 0xff] ^ table[6][(lo >> 8) & 0xff] ^ table[5][(lo >> 16) & 0xff] ^ table[4][lo >> 24]
+            ^ table[3][hi & 0xff] ^ table[2][(hi >> 8) & 0xff] ^ table[1][(hi >> 16) & 0xff] ^ table[0][hi >> 24];
+    }
+    for (; len > 0; len--, p++)
+        crc = table[0][(crc ^ *p) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffff;
+}
@@ -3,8 +3,17 @@
 #include <cmath>
 #include <cassert>
 #include <cstdlib>
-#include <ctime>
-#include <random>
+#include <atomic>
+
+// Default streams of the free functions: one per thread, seeded from
+// default_seed, stream ids in order of first use
+static std::atomic<uint64_t> default_seed(0);
+static std::atomic<uint64_t> next_default_stream(0);
+
+static RngStream &default_stream() {
+    static thread_local RngStream rng(default_seed.load(), next_default_stream.fetch_add(1));
+    return rng;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // Generating an exponential distribution with a given mean density
@@ -44,28 +53,10 @@ double exponential(double density) {
 //
 // 010913 Created by Peter H Zipfel
 // 010914 Normalized gauss tested with a 2000 sample: mean=0.0054, sigma=0.9759
+// Drawn from the default stream of the calling thread, see RngStream
 ///////////////////////////////////////////////////////////////////////////////
 double gauss(double mean, double sig) {
-    static int iset = 0;
-    static double gset;
-    double fac, rsq, v1, v2, value;
-
-    if (iset == 0) {
-        do {
-            v1 = 2. * unituni() - 1.;
-            v2 = 2. * unituni() - 1.;
-            rsq = v1 * v1 + v2 * v2;
-        } while (rsq >= 1.0 || rsq == 0);
-
-        fac = sqrt(-2. * log(rsq) / rsq);
-        gset = v1 * fac;
-        iset = 1;
-        value = v2 * fac;
-    } else {
-        iset = 0;
-        value = gset;
-    }
-    return value * sig + mean;
+    return default_stream().gauss(mean, sig);
 }
 ///////////////////////////////////////////////////////////////////////////////
 // Generating a time-correlated Gaussian variable with zero mean
@@ -140,13 +131,273 @@ double uniform(double min, double max) {
     return value;
 }
 ///////////////////////////////////////////////////////////////////////////////
-// Generating uniform random distribution between 0-1 based on C function rand()
+// Generating uniform random distribution between 0-1, default stream of the
+// calling thread
 //
 // 010913 Created by Peter H Zipfel
 ///////////////////////////////////////////////////////////////////////////////
 double unituni() {
-    std::random_device r;
-    std::default_random_engine e(r());
-    std::uniform_real_distribution<double> uniform_dist(0, 1);
-    return uniform_dist(e);
+    return default_stream().uniform();
+}
+
+void stochastic_seed(uint64_t seed) {
+    default_seed.store(seed);
+    default_stream().set_seed(seed, 0);
+    next_default_stream.store(1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RngStream, Philox4x32-10
+// Ref: Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC11,
+//      constants and round function of the Random123 library
+///////////////////////////////////////////////////////////////////////////////
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+static const double TWO_M53 = 1.0 / 9007199254740992.0;     // 2^-53
+static const double LN2_HI = 6.93147180369123816490e-01;    // ln 2, high bits, e * LN2_HI exact
+static const double LN2_LO = 1.90821492927058770002e-10;    // ln 2 - LN2_HI
+
+static inline void philox_round(uint32_t c[4], const uint32_t k[2]) {
+    uint64_t p0 = (uint64_t)PHILOX_M0 * c[0];
+    uint64_t p1 = (uint64_t)PHILOX_M1 * c[2];
+    uint32_t c0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k[0];
+    uint32_t c2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k[1];
+    c[1] = (uint32_t)p1;
+    c[3] = (uint32_t)p0;
+    c[0] = c0;
+    c[2] = c2;
+}
+
+void RngStream::philox4x32(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t k[2] = {key[0], key[1]};
+    int r;
+    out[0] = ctr[0];
+    out[1] = ctr[1];
+    out[2] = ctr[2];
+    out[3] = ctr[3];
+    for (r = 0; r < 10; r++) {
+        if (r) {
+            k[0] += PHILOX_W0;
+            k[1] += PHILOX_W1;
+        }
+        philox_round(out, k);
+    }
+}
+
+/* two 53 bit uniforms of one block, open interval (0, 1) */
+static inline void philox_uniforms(uint64_t seed, uint64_t stream, uint64_t block, double *u0, double *u1) {
+    const uint32_t ctr[4] = {(uint32_t)block, (uint32_t)(block >> 32), (uint32_t)stream, (uint32_t)(stream >> 32)};
+    const uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+    uint32_t out[4];
+    RngStream::philox4x32(ctr, key, out);
+    *u0 = ((((uint64_t)out[0] << 32) | out[1]) >> 11) * TWO_M53 + 0.5 * TWO_M53;
+    *u1 = ((((uint64_t)out[2] << 32) | out[3]) >> 11) * TWO_M53 + 0.5 * TWO_M53;
+}
+
+/*
+ * Box-Muller on GAUSS_LANES blocks at once (GCC vector extensions: one AVX
+ * register, two SSE ones on a plain x86-64 build). log, sin and cos are
+ * evaluated here with + - * / and bit operations only, not by libm, so
+ * gauss() goes through the same lanes and gives the values of gauss_fill().
+ */
+static const int GAUSS_LANES = 4;
+typedef double lane_double __attribute__((vector_size(GAUSS_LANES * sizeof(double))));
+typedef int64_t lane_int __attribute__((vector_size(GAUSS_LANES * sizeof(int64_t))));
+typedef uint64_t lane_uint __attribute__((vector_size(GAUSS_LANES * sizeof(uint64_t))));
+
+/* philox4x32 of blocks block .. block + GAUSS_LANES - 1, the 32 bit words in 64 bit lanes */
+static inline void philox_lanes(uint64_t seed, uint64_t stream, uint64_t block, lane_uint c[4]) {
+    uint64_t k0 = (uint32_t)seed, k1 = seed >> 32;
+    lane_uint blk;
+    int l, r;
+    for (l = 0; l < GAUSS_LANES; l++)
+        blk[l] = block + l;
+    c[0] = blk & 0xFFFFFFFFu;
+    c[1] = blk >> 32;
+    c[2] = (lane_uint){} + (uint32_t)stream;
+    c[3] = (lane_uint){} + (stream >> 32);
+    for (r = 0; r < 10; r++) {
+        if (r) {
+            k0 = (uint32_t)(k0 + PHILOX_W0);
+            k1 = (uint32_t)(k1 + PHILOX_W1);
+        }
+        lane_uint p0 = c[0] * PHILOX_M0;
+        lane_uint p1 = c[2] * PHILOX_M1;
+        c[0] = (p1 >> 32) ^ c[1] ^ k0;
+        c[2] = (p0 >> 32) ^ c[3] ^ k1;
+        c[1] = p1 & 0xFFFFFFFFu;
+        c[3] = p0 & 0xFFFFFFFFu;
+    }
+}
+
+/*
+ * Integers below 2^52 to double with the 2^52 exponent trick, exact; SSE2
+ * has no vector conversion between 64 bit integers and doubles.
+ */
+static const double TWO_52 = 4503599627370496.0;
+static const uint64_t TWO_52_BITS = 0x4330000000000000u;
+
+static inline void small_uint_to_double(const lane_uint &k, lane_double *d) {
+    *d = (lane_double)(k | TWO_52_BITS) - TWO_52;
+}
+
+/* 53 bit uniform of two 32 bit words, open interval (0, 1), as philox_uniforms() */
+static inline void uniform_lanes(const lane_uint &hi, const lane_uint &lo, lane_double *u) {
+    lane_double dh, dl;
+    small_uint_to_double(hi, &dh);
+    small_uint_to_double(lo >> 11, &dl);
+    *u = (dh * 2097152.0 + dl) * TWO_M53 + 0.5 * TWO_M53;     // dh 2^21 + dl exact, < 2^53
+}
+
+/* log(u) for u in (0, 1): u = m 2^e, m in [sqrt(1/2), sqrt(2)), log(m) = 2 atanh((m - 1) / (m + 1)) */
+static inline void log_lanes(const lane_double &u, lane_double *out) {
+    lane_uint bits = (lane_uint)u;
+    lane_double ed;
+    small_uint_to_double(bits >> 52, &ed);
+    ed -= 1023.0;
+    lane_double m = (lane_double)((bits & 0x000FFFFFFFFFFFFFu) | 0x3FF0000000000000u);
+    lane_int big = m > M_SQRT2;
+    m = big ? m * 0.5 : m;
+    ed = big ? ed + 1.0 : ed;
+
+    lane_double s = (m - 1.0) / (m + 1.0);
+    lane_double z = s * s;
+    lane_double p = (lane_double){} + 1.0 / 23.0;
+    p = p * z + 1.0 / 21.0;
+    p = p * z + 1.0 / 19.0;
+    p = p * z + 1.0 / 17.0;
+    p = p * z + 1.0 / 15.0;
+    p = p * z + 1.0 / 13.0;
+    p = p * z + 1.0 / 11.0;
+    p = p * z + 1.0 / 9.0;
+    p = p * z + 1.0 / 7.0;
+    p = p * z + 1.0 / 5.0;
+    p = p * z + 1.0 / 3.0;
+    *out = ed * LN2_HI + (2.0 * s + 2.0 * s * z * p + ed * LN2_LO);
+}
+
+/* sin and cos of 2 pi u for u in (0, 1): quadrant q nearest 4u, Taylor series on r in [-pi/4, pi/4] */
+static inline void sincos_2pi_lanes(const lane_double &u, lane_double *sn, lane_double *cs) {
+    lane_double t = u * 4.0;
+    lane_double qd = t + TWO_52;                        // rounds t to the nearest integer
+    lane_int q = (lane_int)((lane_uint)qd & 7u);
+    lane_double r = (t - (qd - TWO_52)) * M_PI_2;       // t - q is exact
+    lane_double r2 = r * r;
+
+    lane_double ps = (lane_double){} + 1.0 / 355687428096000.0;
+    ps = ps * r2 - 1.0 / 1307674368000.0;
+    ps = ps * r2 + 1.0 / 6227020800.0;
+    ps = ps * r2 - 1.0 / 39916800.0;
+    ps = ps * r2 + 1.0 / 362880.0;
+    ps = ps * r2 - 1.0 / 5040.0;
+    ps = ps * r2 + 1.0 / 120.0;
+    ps = ps * r2 - 1.0 / 6.0;
+    lane_double sin_r = r + r * r2 * ps;
+
+    lane_double pc = (lane_double){} - 1.0 / 6402373705728000.0;
+    pc = pc * r2 + 1.0 / 20922789888000.0;
+    pc = pc * r2 - 1.0 / 87178291200.0;
+    pc = pc * r2 + 1.0 / 479001600.0;
+    pc = pc * r2 - 1.0 / 3628800.0;
+    pc = pc * r2 + 1.0 / 40320.0;
+    pc = pc * r2 - 1.0 / 720.0;
+    pc = pc * r2 + 1.0 / 24.0;
+    lane_double cos_r = 1.0 - 0.5 * r2 + r2 * r2 * pc;
+
+    // q = 1: (cos r, -sin r), q = 2: (-sin r, -cos r), q = 3: (-cos r, sin r)
+    lane_int swap = (q & 1) != 0;
+    lane_double a = swap ? cos_r : sin_r;
+    lane_double b = swap ? sin_r : cos_r;
+    *sn = (lane_double)((lane_uint)a ^ ((lane_uint)(q & 2) << 62));
+    *cs = (lane_double)((lane_uint)b ^ ((lane_uint)((q + 1) & 2) << 62));
+}
+
+static inline void box_muller_lanes(const lane_double &u0, const lane_double &u1, lane_double *z0, lane_double *z1) {
+    lane_double r, sn, cs;
+    int l;
+    log_lanes(u0, &r);
+    r = -2.0 * r;
+    for (l = 0; l < GAUSS_LANES; l++)
+        r[l] = sqrt(r[l]);
+    sincos_2pi_lanes(u1, &sn, &cs);
+    *z0 = r * cs;
+    *z1 = r * sn;
+}
+
+RngStream::RngStream(uint64_t seed, uint64_t stream) {
+    set_seed(seed, stream);
+}
+
+void RngStream::set_seed(uint64_t seed, uint64_t stream) {
+    this->seed = seed;
+    this->stream = stream;
+    set_position(0);
+}
+
+void RngStream::set_position(uint64_t block) {
+    this->block = block;
+    has_spare_gauss = 0;
+    has_spare_uni = 0;
+    spare_gauss = 0.0;
+    spare_uni = 0.0;
+}
+
+void RngStream::next_pair(double *u0, double *u1) {
+    philox_uniforms(seed, stream, block++, u0, u1);
+}
+
+double RngStream::uniform() {
+    double u0;
+    if (has_spare_uni) {
+        has_spare_uni = 0;
+        return spare_uni;
+    }
+    next_pair(&u0, &spare_uni);
+    has_spare_uni = 1;
+    return u0;
+}
+
+double RngStream::gauss(double mean, double sig) {
+    double u0, u1;
+    lane_double z0, z1;
+    if (has_spare_gauss) {
+        has_spare_gauss = 0;
+        return spare_gauss * sig + mean;
+    }
+    next_pair(&u0, &u1);
+    box_muller_lanes((lane_double){} + u0, (lane_double){} + u1, &z0, &z1);
+    spare_gauss = z1[0];
+    has_spare_gauss = 1;
+    return z0[0] * sig + mean;
+}
+
+/* GAUSS_LANES blocks per pass, the last pass masked to what is left */
+void RngStream::gauss_fill(double *out, int n, double mean, double sig) {
+    lane_uint c[4];
+    lane_double u0, u1, z0, z1;
+    int idx = 0, nblk, l;
+
+    if (n > 0 && has_spare_gauss) {
+        out[idx++] = spare_gauss * sig + mean;
+        has_spare_gauss = 0;
+    }
+    while (n - idx >= 2) {
+        nblk = (n - idx) / 2;
+        if (nblk > GAUSS_LANES)
+            nblk = GAUSS_LANES;
+        philox_lanes(seed, stream, block, c);
+        uniform_lanes(c[0], c[1], &u0);
+        uniform_lanes(c[2], c[3], &u1);
+        box_muller_lanes(u0, u1, &z0, &z1);
+        for (l = 0; l < nblk; l++) {
+            out[idx + 2 * l] = z0[l] * sig + mean;
+            out[idx + 2 * l + 1] = z1[l] * sig + mean;
+        }
+        block += nblk;
+        idx += 2 * nblk;
+    }
+    if (idx < n)
+        out[idx] = gauss(mean, sig);
 }
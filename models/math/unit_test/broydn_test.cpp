@@ -0,0 +1,143 @@
+#include "broydn.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+ * BroydnSolver on a 12 unknown system shaped like the Forces generalized
+ * acceleration equations: a diagonally dominant mass matrix, a small
+ * nonlinear coupling, and a right hand side that drifts from step to step.
+ *
+ * Every heap allocation is counted through a malloc() interposer; after the
+ * first step the solver must not allocate at all.
+ */
+
+static long n_alloc = 0;
+static bool counting = false;
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size) {
+    if (counting) n_alloc++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+    if (counting) n_alloc++;
+    return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+    if (counting) n_alloc++;
+    return __libc_realloc(ptr, size);
+}
+
+static const int N = BroydnSolver::MAX_N;
+static const int N_STEPS = 2000;
+
+static double M[N + 1][N + 1];
+static double rhs[N + 1];
+
+static void build_system() {
+    for (int i = 1; i <= N; i++) {
+        for (int j = 1; j <= N; j++)
+            M[i][j] = (i == j) ? 50.0 + i : 1.0 / (i + j);
+    }
+}
+
+static void set_rhs(int step) {
+    for (int i = 1; i <= N; i++)
+        rhs[i] = 10.0 * sin(0.001 * step + i) + i;
+}
+
+static void funcv(int n, double *x, double *f) {
+    for (int i = 1; i <= n; i++) {
+        double sum = 0.0;
+        for (int j = 1; j <= n; j++) sum += M[i][j] * x[j];
+        f[i] = sum + 0.5 * sin(x[i]) * x[(i % n) + 1] - rhs[i];
+    }
+}
+
+static void jacobian(int n, double *x, double *fvec, double **df) {
+    for (int i = 1; i <= n; i++) {
+        for (int j = 1; j <= n; j++) df[i][j] = M[i][j];
+        int k = (i % n) + 1;
+        df[i][i] += 0.5 * cos(x[i]) * x[k];
+        df[i][k] += 0.5 * sin(x[i]);
+    }
+}
+
+static double residual(int n, double *x) {
+    double f[N + 1], max = 0.0;
+    funcv(n, x, f);
+    for (int i = 1; i <= n; i++) max = fmax(max, fabs(f[i]));
+    return max;
+}
+
+static int run(bool warm_start, bool analytic, long *its, long *fcalls, double *ns_per_call, double *max_res) {
+    BroydnSolver solver;
+    BroydnSolver::Function func(funcv);
+    BroydnSolver::Jacobian jac;
+    double x[N + 1];
+    double wall = 0.0;
+    long allocs = 0;
+
+    solver.set_warm_start(warm_start);
+    if (analytic)
+        jac = jacobian;
+    *its = *fcalls = 0;
+    *max_res = 0.0;
+    for (int step = 0; step < N_STEPS; step++) {
+        set_rhs(step);
+        for (int i = 1; i <= N; i++) x[i] = 0.0;
+
+        n_alloc = 0;
+        counting = (step > 0);
+        solver.solve(x, N, func, jac);
+        counting = false;
+        allocs += n_alloc;
+
+        *its += solver.get_iterations();
+        *fcalls += solver.get_function_calls();
+        wall += solver.get_wall_time();
+        *max_res = fmax(*max_res, residual(N, x));
+    }
+    *ns_per_call = wall / N_STEPS * 1e9;
+    return allocs;
+}
+
+int main(int argc, char const *argv[]) {
+    long its, fcalls;
+    double ns, res;
+    int failed = 0;
+
+    build_system();
+    fprintf(stderr, "** Broyden solver workspace test **\n");
+
+    /* make sure the interposer sees allocations at all */
+    n_alloc = 0;
+    counting = true;
+    free(malloc(16));
+    delete new double;
+    counting = false;
+    if (n_alloc != 2) {
+        fprintf(stderr, "FAIL allocation counter inactive (%ld)\n", n_alloc);
+        return 1;
+    }
+
+    const char *mode[] = {"cold start", "warm start", "warm start, analytic Jacobian"};
+    for (int m = 0; m < 3; m++) {
+        long allocs = run(m >= 1, m == 2, &its, &fcalls, &ns, &res);
+        /* solve() also stops on a relative step below 1e-7, so allow a few TOLF */
+        int ok = (allocs == 0) && (res < 1e-6);
+        fprintf(stderr, "%s %s: %ld allocations, %.2f iterations, %.1f function calls, %8.1f ns per solve, max residual %.1e\n",
+                ok ? "PASS" : "FAIL", mode[m], allocs,
+                static_cast<double>(its) / N_STEPS, static_cast<double>(fcalls) / N_STEPS, ns, res);
+        failed += !ok;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+#include "rk4.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+ * rk4_step() against the stage-by-stage RK4 Rocket_Flight_DM used before,
+ * on a model with the same 17 element state: inertial velocity / position,
+ * body rate, quaternion with the 50 * erq normalisation term, and the two
+ * slosh pendulums.
+ *
+ * The final state must stay within the ci_test.py threshold (5e-5) of the
+ * reference after a full flight, and a step must not touch the heap.
+ */
+
+static long n_alloc = 0;
+static bool counting = false;
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size) {
+    if (counting) n_alloc++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+    if (counting) n_alloc++;
+    return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+    if (counting) n_alloc++;
+    return __libc_realloc(ptr, size);
+}
+
+enum { V = 0, S = 3, W = 6, Q = 9, DTHT = 13, THT = 14, DPSI = 15, PSI = 16, N = 17 };
+
+static const double DT = 0.005;
+static const int N_STEPS = 20000;
+
+/* model state, laid out like the Rocket_Flight_DM members */
+struct Model {
+    double VBIIP[3], SBIIP[3], WBIB[3], TBI_Q[4];
+    double dang_slosh_theta, ang_slosh_theta, dang_slosh_psi, ang_slosh_psi;
+    double TBI[3][3];
+    double t;
+};
+
+static void quaternion_to_matrix(Model &m) {
+    const double *q = m.TBI_Q;
+    m.TBI[0][0] = q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3];
+    m.TBI[0][1] = 2. * (q[1] * q[2] + q[0] * q[3]);
+    m.TBI[0][2] = 2. * (q[1] * q[3] - q[0] * q[2]);
+    m.TBI[1][0] = 2. * (q[1] * q[2] - q[0] * q[3]);
+    m.TBI[1][1] = q[0] * q[0] - q[1] * q[1] + q[2] * q[2] - q[3] * q[3];
+    m.TBI[1][2] = 2. * (q[2] * q[3] + q[0] * q[1]);
+    m.TBI[2][0] = 2. * (q[1] * q[3] + q[0] * q[2]);
+    m.TBI[2][1] = 2. * (q[2] * q[3] - q[0] * q[1]);
+    m.TBI[2][2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+/* derivatives, ordered as RK4F: dV, dS, dW, dQ, slosh */
+static void derivatives(const Model &m, double *dy) {
+    const double *w = m.WBIB, *q = m.TBI_Q;
+    const double fspb[3] = {-25.0 - 0.001 * m.t, 0.3 * m.ang_slosh_psi, -0.3 * m.ang_slosh_theta};
+    const double r = sqrt(m.SBIIP[0] * m.SBIIP[0] + m.SBIIP[1] * m.SBIIP[1] + m.SBIIP[2] * m.SBIIP[2]);
+    const double gm = 3.986004418e14 / (r * r * r);
+    const double erq = 1. - (q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+    for (int i = 0; i < 3; i++) {
+        double a = 0.0;
+        for (int j = 0; j < 3; j++) a += m.TBI[j][i] * fspb[j];
+        dy[V + i] = a - gm * m.SBIIP[i];
+        dy[S + i] = m.VBIIP[i];
+    }
+    dy[W + 0] = 0.02 * sin(0.5 * m.t) - 0.1 * w[0];
+    dy[W + 1] = -0.4 * m.ang_slosh_theta - 0.9 * w[1] * w[2];
+    dy[W + 2] = -0.4 * m.ang_slosh_psi + 0.9 * w[0] * w[1];
+
+    dy[Q + 0] = 0.5 * (-w[0] * q[1] - w[1] * q[2] - w[2] * q[3]) + 50. * erq * q[0];
+    dy[Q + 1] = 0.5 * (w[0] * q[0] + w[2] * q[2] - w[1] * q[3]) + 50. * erq * q[1];
+    dy[Q + 2] = 0.5 * (w[1] * q[0] - w[2] * q[1] + w[0] * q[3]) + 50. * erq * q[2];
+    dy[Q + 3] = 0.5 * (w[2] * q[0] + w[1] * q[1] - w[0] * q[2]) + 50. * erq * q[3];
+
+    dy[DTHT] = -4.0 * sin(m.ang_slosh_theta) - 0.02 * m.dang_slosh_theta + 0.05 * dy[W + 1];
+    dy[THT] = m.dang_slosh_theta;
+    dy[DPSI] = -4.0 * sin(m.ang_slosh_psi) - 0.02 * m.dang_slosh_psi + 0.05 * dy[W + 2];
+    dy[PSI] = m.dang_slosh_psi;
+}
+
+static void save(const Model &m, double *y) {
+    for (int i = 0; i < 3; i++) {
+        y[V + i] = m.VBIIP[i];
+        y[S + i] = m.SBIIP[i];
+        y[W + i] = m.WBIB[i];
+    }
+    for (int i = 0; i < 4; i++) y[Q + i] = m.TBI_Q[i];
+    y[DTHT] = m.dang_slosh_theta;
+    y[THT] = m.ang_slosh_theta;
+    y[DPSI] = m.dang_slosh_psi;
+    y[PSI] = m.ang_slosh_psi;
+}
+
+static void load(Model &m, const double *y) {
+    for (int i = 0; i < 3; i++) {
+        m.VBIIP[i] = y[V + i];
+        m.SBIIP[i] = y[S + i];
+        m.WBIB[i] = y[W + i];
+    }
+    for (int i = 0; i < 4; i++) m.TBI_Q[i] = y[Q + i];
+    m.dang_slosh_theta = y[DTHT];
+    m.ang_slosh_theta = y[THT];
+    m.dang_slosh_psi = y[DPSI];
+    m.ang_slosh_psi = y[PSI];
+    quaternion_to_matrix(m);
+}
+
+static void initial_state(Model &m) {
+    const double q[4] = {0.9, 0.1, -0.3, 0.2};
+    double y[N] = {7500.0, 150.0, -20.0, 6.6e6, 1.0e5, 2.0e4, 0.01, -0.02, 0.005};
+    double nq = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+    for (int i = 0; i < 4; i++) y[Q + i] = q[i] / nq;
+    y[DTHT] = 0.1;
+    y[THT] = 0.05;
+    y[DPSI] = -0.08;
+    y[PSI] = 0.02;
+    load(m, y);
+    m.t = 0.0;
+}
+
+/* stage by stage, the way Rocket_Flight_DM::RK4 was written */
+static void reference_step(Model &m, double h) {
+    double y0[N], y[N], k1[N], k2[N], k3[N], k4[N];
+    int i;
+
+    save(m, y0);
+    derivatives(m, k1);
+    for (i = 0; i < N; i++) y[i] = y0[i] + k1[i] * 0.5 * h;
+    load(m, y);
+    derivatives(m, k2);
+    for (i = 0; i < N; i++) y[i] = y0[i] + k2[i] * 0.5 * h;
+    load(m, y);
+    derivatives(m, k3);
+    for (i = 0; i < N; i++) y[i] = y0[i] + k3[i] * h;
+    load(m, y);
+    derivatives(m, k4);
+    for (i = 0; i < N; i++) y[i] = y0[i] + (h / 6.0) * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]);
+    load(m, y);
+}
+
+static void step(Model &m, double h) {
+    double y[N];
+
+    save(m, y);
+    rk4_step<N>(y, h,
+                [&m](double *dy) { derivatives(m, dy); },
+                [&m](const double *ys) { load(m, ys); });
+}
+
+int main(int argc, char const *argv[]) {
+    Model ref, m;
+    double y_ref[N], y[N], err = 0.0;
+    int failed = 0;
+
+    fprintf(stderr, "** RK4 step test **\n");
+
+    n_alloc = 0;
+    counting = true;
+    free(malloc(16));
+    delete new double;
+    counting = false;
+    if (n_alloc != 2) {
+        fprintf(stderr, "FAIL allocation counter inactive (%ld)\n", n_alloc);
+        return 1;
+    }
+
+    initial_state(ref);
+    initial_state(m);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < N_STEPS; i++) {
+        reference_step(ref, DT);
+        ref.t += DT;
+    }
+    double ref_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    n_alloc = 0;
+    start = std::chrono::steady_clock::now();
+    counting = true;
+    for (int i = 0; i < N_STEPS; i++) {
+        step(m, DT);
+        m.t += DT;
+    }
+    counting = false;
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    save(ref, y_ref);
+    save(m, y);
+    for (int i = 0; i < N; i++)
+        err += fabs(y[i] - y_ref[i]) / fmax(1.0, fabs(y_ref[i]));
+    err /= N;
+
+    int ok = (err < 5e-5) && (n_alloc == 0);
+    fprintf(stderr, "%s %d steps: mean relative error %.1e, %ld allocations, %.1f ns per step (reference %.1f)\n",
+            ok ? "PASS" : "FAIL", N_STEPS, err, n_alloc, ns / N_STEPS, ref_ns / N_STEPS);
+    failed += !ok;
+
+    return failed ? 1 : 0;
+}
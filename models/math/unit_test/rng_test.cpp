@@ -0,0 +1,243 @@
+#include "stochastic.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+/*
+ * RngStream against the Random123 known answers for Philox4x32-10, then:
+ * reproducible per (seed, stream, position), gauss_fill() the same as
+ * gauss() calls, threads on their own streams the same as one thread, and
+ * the usual moments / Kolmogorov-Smirnov / chi-square / correlation checks
+ * on N draws. Last, normals per second of the gauss() this replaced
+ * (Marsaglia polar on a std::random_device seeded engine per uniform),
+ * std::normal_distribution and the stream.
+ */
+
+#define N_STAT      2000000
+#define N_BENCH     2000000
+#define N_SLOW      20000
+
+static int check(const char *what, bool ok) {
+    fprintf(stderr, "%s %s\n", ok ? "PASS" : "FAIL", what);
+    return !ok;
+}
+
+/* the gauss() / unituni() pair before RngStream */
+static double old_unituni() {
+    std::random_device r;
+    std::default_random_engine e(r());
+    std::uniform_real_distribution<double> uniform_dist(0, 1);
+    return uniform_dist(e);
+}
+
+static double old_gauss(double mean, double sig) {
+    static int iset = 0;
+    static double gset;
+    double fac, rsq, v1, v2, value;
+
+    if (iset == 0) {
+        do {
+            v1 = 2. * old_unituni() - 1.;
+            v2 = 2. * old_unituni() - 1.;
+            rsq = v1 * v1 + v2 * v2;
+        } while (rsq >= 1.0 || rsq == 0);
+        fac = sqrt(-2. * log(rsq) / rsq);
+        gset = v1 * fac;
+        iset = 1;
+        value = v2 * fac;
+    } else {
+        iset = 0;
+        value = gset;
+    }
+    return value * sig + mean;
+}
+
+static int kat_test() {
+    /* Random123 kat_vectors, philox4x32 10 rounds */
+    static const uint32_t ctr[3][4] = {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+        {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+    static const uint32_t key[3][2] = {
+        {0x00000000, 0x00000000}, {0xffffffff, 0xffffffff}, {0xa4093822, 0x299f31d0}};
+    static const uint32_t expect[3][4] = {
+        {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+        {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+        {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+    uint32_t out[4];
+    bool ok = true;
+
+    for (int v = 0; v < 3; v++) {
+        RngStream::philox4x32(ctr[v], key[v], out);
+        for (int w = 0; w < 4; w++)
+            ok = ok && out[w] == expect[v][w];
+    }
+    return check("Philox4x32-10 known answers", ok);
+}
+
+static int stream_test() {
+    RngStream a(12345, 7), b(12345, 7), c(12345, 8), d(12346, 7), e(12345, 7);
+    std::vector<double> ref(1001), fill(1001);
+    bool same = true, differ_stream = true, differ_seed = true, jump = true, filled = true;
+    int failed = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        double x = a.gauss(0.0, 1.0);
+        same = same && x == b.gauss(0.0, 1.0);
+        differ_stream = differ_stream && x != c.gauss(0.0, 1.0);
+        differ_seed = differ_seed && x != d.gauss(0.0, 1.0);
+    }
+    failed += check("same seed and stream, same draws", same);
+    failed += check("other stream or seed, other draws", differ_stream && differ_seed);
+
+    /* draw 2k of a fresh stream is from block k */
+    a.set_seed(99, 3);
+    for (int i = 0; i < 600; i++)
+        ref[i] = a.gauss(0.0, 1.0);
+    b.set_seed(99, 3);
+    b.set_position(250);
+    for (int i = 500; i < 600; i++)
+        jump = jump && b.gauss(0.0, 1.0) == ref[i];
+    failed += check("set_position() jumps straight to a block", jump);
+
+    /* odd lengths and a pending spare, against plain gauss() calls */
+    a.set_seed(5, 1);
+    b.set_seed(5, 1);
+    for (int round = 0, n = 1; round < 40; round++, n = (n * 7 + 3) % 211) {
+        for (int i = 0; i < n; i++)
+            ref[i] = a.gauss(1.5, 0.25);
+        e = b;
+        b.gauss_fill(fill.data(), n, 1.5, 0.25);
+        for (int i = 0; i < n; i++)
+            filled = filled && fill[i] == ref[i];
+        filled = filled && e.get_position() <= b.get_position();
+    }
+    failed += check("gauss_fill() gives the gauss() sequence", filled && a.get_position() == b.get_position());
+    return failed;
+}
+
+static void thread_draw(uint64_t stream, double *out, int n) {
+    RngStream rng(2024, stream);
+    for (int i = 0; i < n; i += 6)
+        rng.gauss_fill(out + i, std::min(6, n - i));
+}
+
+static int thread_test() {
+    const int n_thread = 4, n = 60000;
+    std::vector<double> par(n_thread * n), seq(n_thread * n);
+    std::vector<std::thread> pool;
+    int failed = 0;
+
+    for (int t = 0; t < n_thread; t++)
+        pool.emplace_back(thread_draw, (uint64_t)t, &par[t * n], n);
+    for (auto &th : pool)
+        th.join();
+    for (int t = 0; t < n_thread; t++)
+        thread_draw(t, &seq[t * n], n);
+    failed += check("threads on their own streams, same as one thread", par == seq);
+
+    stochastic_seed(42);
+    double g0 = gauss(0.0, 1.0), u0 = unituni();
+    stochastic_seed(42);
+    failed += check("stochastic_seed() makes gauss() / unituni() repeat", g0 == gauss(0.0, 1.0) && u0 == unituni());
+    return failed;
+}
+
+static double normal_cdf(double x) {
+    return 0.5 * erfc(-x / sqrt(2.0));
+}
+
+static int stat_test() {
+    RngStream rng(20181010, 0), other(20181010, 1);
+    std::vector<double> z(N_STAT), w(N_STAT);
+    double sum = 0, sum2 = 0, sum3 = 0, sum4 = 0, cross = 0, lag = 0, d_max = 0, chi2 = 0;
+    const int n_bin = 100;
+    std::vector<int> bins(n_bin, 0);
+    int failed = 0;
+    char what[160];
+
+    rng.gauss_fill(z.data(), N_STAT);
+    other.gauss_fill(w.data(), N_STAT);
+    for (int i = 0; i < N_STAT; i++) {
+        sum += z[i];
+        sum2 += z[i] * z[i];
+        sum3 += z[i] * z[i] * z[i];
+        sum4 += z[i] * z[i] * z[i] * z[i];
+        cross += z[i] * w[i];
+        if (i)
+            lag += z[i] * z[i - 1];
+    }
+    double mean = sum / N_STAT, var = sum2 / N_STAT - mean * mean;
+    double skew = sum3 / N_STAT, kurt = sum4 / N_STAT - 3.0;
+    double se = 1.0 / sqrt((double)N_STAT);
+    /* 5 sigma bounds: mean 1, variance sqrt(2), skew sqrt(6), kurtosis sqrt(24) */
+    snprintf(what, sizeof(what), "moments of %d normals: mean %+.5f var %.5f skew %+.5f kurt %+.5f",
+             N_STAT, mean, var, skew, kurt);
+    failed += check(what, fabs(mean) < 5 * se && fabs(var - 1) < 5 * sqrt(2.0) * se
+                          && fabs(skew) < 5 * sqrt(6.0) * se && fabs(kurt) < 5 * sqrt(24.0) * se);
+    snprintf(what, sizeof(what), "correlation: streams 0/1 %+.5f, lag 1 %+.5f", cross / N_STAT, lag / N_STAT);
+    failed += check(what, fabs(cross / N_STAT) < 5 * se && fabs(lag / N_STAT) < 5 * se);
+
+    std::sort(z.begin(), z.end());
+    for (int i = 0; i < N_STAT; i++) {
+        double f = normal_cdf(z[i]);
+        d_max = std::max(d_max, std::max(f - (double)i / N_STAT, (double)(i + 1) / N_STAT - f));
+    }
+    /* 1.949: Kolmogorov distribution at p = 0.001 */
+    snprintf(what, sizeof(what), "Kolmogorov-Smirnov against N(0,1): sqrt(n) D = %.3f", d_max * sqrt((double)N_STAT));
+    failed += check(what, d_max * sqrt((double)N_STAT) < 1.949);
+
+    for (int i = 0; i < N_STAT; i++)
+        bins[(int)(rng.uniform() * n_bin)]++;
+    for (int b = 0; b < n_bin; b++) {
+        double e = (double)N_STAT / n_bin;
+        chi2 += (bins[b] - e) * (bins[b] - e) / e;
+    }
+    /* 148.2: chi-square 99 dof at p = 0.001 */
+    snprintf(what, sizeof(what), "uniform chi-square, %d bins: %.1f", n_bin, chi2);
+    failed += check(what, chi2 < 148.2);
+    return failed;
+}
+
+template <typename F>
+static double ns_per(int n, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+static int bench() {
+    RngStream rng(1, 0);
+    std::mt19937_64 mt(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> out(N_BENCH);
+    volatile double sink = 0;
+    double t_old, t_std, t_gauss, t_fill;
+
+    t_old = ns_per(N_SLOW, [&] { for (int i = 0; i < N_SLOW; i++) sink = sink + old_gauss(0.0, 1.0); });
+    t_std = ns_per(N_BENCH, [&] { for (int i = 0; i < N_BENCH; i++) sink = sink + normal(mt); });
+    t_gauss = ns_per(N_BENCH, [&] { for (int i = 0; i < N_BENCH; i++) sink = sink + rng.gauss(0.0, 1.0); });
+    t_fill = ns_per(N_BENCH, [&] { rng.gauss_fill(out.data(), N_BENCH); });
+    fprintf(stderr, "     old gauss()                  %9.1f ns/normal\n", t_old);
+    fprintf(stderr, "     std::normal_distribution     %9.1f ns/normal\n", t_std);
+    fprintf(stderr, "     RngStream::gauss()           %9.1f ns/normal\n", t_gauss);
+    fprintf(stderr, "     RngStream::gauss_fill()      %9.1f ns/normal\n", t_fill);
+    return check("stream faster than the old gauss()", t_gauss < t_old && t_fill < t_old);
+}
+
+int main() {
+    int failed = 0;
+
+    fprintf(stderr, "** RngStream test **\n");
+    failed += kat_test();
+    failed += stream_test();
+    failed += thread_test();
+    failed += stat_test();
+    failed += bench();
+    return failed ? 1 : 0;
+}
@@ -9,6 +9,7 @@ PURPOSE:
 #include "global_constants.hh"
 #include "icf_trx_ctrl.h"
 #include "stochastic.hh"
+#include "checkpoint.hh"
 
 namespace sensor {
 class Accelerometer {
@@ -22,10 +23,18 @@ class Accelerometer {
     virtual ~Accelerometer() {}
 
     virtual void propagate_error(double int_step, struct icf_ctrlblk_t*) {}
+    /* noise stream of the models that have one, from the input file */
+    virtual void set_noise_seed(uint64_t seed, uint64_t stream) {}
     virtual void update_diagnostic_attributes(double int_step) {}
 
     std::function<arma::vec3()> grab_FSPB;
 
+    /* Outputs, the models with error states add theirs, see checkpoint.hh */
+    virtual void checkpoint(Checkpoint &cp) {
+        cp.section("ACCEL");
+        cp(FSPCB, EFSPB, HIGH, LOW);
+    }
+
     virtual arma::vec3 get_computed_FSPB() { return FSPCB; }
     virtual arma::vec3 get_error_of_computed_FSPB() { return EFSPB; }
     virtual arma::vec3 get_HIGH() { return HIGH; }
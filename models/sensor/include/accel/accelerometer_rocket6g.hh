@@ -4,7 +4,8 @@
 PURPOSE:
       (Non-Ideal Accelerometer Implementation from Rocket6G)
 LIBRARY DEPENDENCY:
-      ((../../src/accel/accelerometer_rocket6g.cpp))
+      ((../../src/accel/accelerometer_rocket6g.cpp)
+       (../../../aux/src/checkpoint.cpp))
 *******************************************************************************/
 
 #include <armadillo>
@@ -21,7 +22,11 @@ class AccelerometerRocket6G : public Accelerometer {
 
     virtual ~AccelerometerRocket6G() {}
 
-    virtual void propagate_error(double int_step);
+    virtual void propagate_error(double int_step, struct icf_ctrlblk_t* C);
+    virtual void set_noise_seed(uint64_t seed, uint64_t stream) { noise.set_seed(seed, stream); }
+    virtual void checkpoint(Checkpoint &cp);
+
+    static const uint64_t DEFAULT_NOISE_STREAM = 2;
 
  private:
     arma::vec EWALKA;    /* *o   (m/s2)  Acceleration random noise */
@@ -44,6 +49,8 @@ class AccelerometerRocket6G : public Accelerometer {
 
     arma::vec BETA;
     double _BETA[3];
+
+    RngStream noise;     /* *io (--)     ARW / RRW noise stream */
 };
 }  // namespace sensor
 
@@ -9,6 +9,7 @@ PURPOSE:
 #include <aux.hh>
 #include "global_constants.hh"
 #include "stochastic.hh"
+#include "checkpoint.hh"
 
 namespace sensor {
 class Gyro {
@@ -22,6 +23,8 @@ class Gyro {
     virtual ~Gyro() {}
 
     virtual void propagate_error(double int_step) {}
+    /* noise stream of the models that have one, from the input file */
+    virtual void set_noise_seed(uint64_t seed, uint64_t stream) {}
     virtual void update_diagnostic_attributes(double int_step) {
             // decomposing computed body rates
             ppcx = get_ppcx();
@@ -29,6 +32,12 @@ class Gyro {
             qqcx = get_qqcx();
     }
 
+    /* Outputs, the models with error states add theirs, see checkpoint.hh */
+    virtual void checkpoint(Checkpoint &cp) {
+        cp.section("GYRO");
+        cp(WBICB, EWBIB, HIGH, LOW, qqcx, rrcx, ppcx);
+    }
+
     virtual arma::vec3 get_computed_WBIB() { return WBICB; }
     virtual arma::vec3 get_error_of_computed_WBIB() { return EWBIB; }
 
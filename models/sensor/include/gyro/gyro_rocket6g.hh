@@ -4,7 +4,8 @@
 PURPOSE:
       (Non-Ideal Gyro Implementation from Rocket6G)
 LIBRARY DEPENDENCY:
-      ((../../src/gyro/gyro_rocket6g.cpp))
+      ((../../src/gyro/gyro_rocket6g.cpp)
+       (../../../aux/src/checkpoint.cpp))
 *******************************************************************************/
 
 #include <armadillo>
@@ -22,7 +23,10 @@ class GyroRocket6G : public Gyro {
     virtual ~GyroRocket6G() {}
 
     virtual void propagate_error(double int_step);
-    std::default_random_engine generator;
+    virtual void set_noise_seed(uint64_t seed, uint64_t stream) { noise.set_seed(seed, stream); }
+    virtual void checkpoint(Checkpoint &cp);
+
+    static const uint64_t DEFAULT_NOISE_STREAM = 1;
 
  private:
     /* Routing components */
@@ -55,6 +59,8 @@ class GyroRocket6G : public Gyro {
 
     arma::vec BETA;
     double _BETA[3];
+
+    RngStream noise;     /* *io (--)     ARW / RRW noise stream */
 };
 }  // namespace sensor
 
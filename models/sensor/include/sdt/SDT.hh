@@ -3,6 +3,7 @@
 #include <armadillo>
 #include <functional>
 #include "aux.hh"
+#include "checkpoint.hh"
 
 class SDT {
     TRICK_INTERFACE(SDT);
@@ -12,6 +13,11 @@ class SDT {
     virtual ~SDT() {};
 
     virtual void compute(double int_step) {}
+    /* Outputs, the models add their integration states, see checkpoint.hh */
+    virtual void checkpoint(Checkpoint &cp) {
+        cp.section("SDT");
+        cp(PHI, DELTA_VEL, PHI_HIGH, PHI_LOW);
+    }
 
     std::function<arma::vec3()> grab_WBICB;
     std::function<arma::vec3()> grab_FSPCB;
@@ -4,7 +4,8 @@
 PURPOSE:
       (Sensor Data Transport module)
 LIBRARY DEPENDENCY:
-      ((../../src/SDT_ideal.cpp))
+      ((../../src/SDT_ideal.cpp)
+       (../../../aux/src/checkpoint.cpp))
 *******************************************************************************/
 #include <armadillo>
 #include <functional>
@@ -18,6 +19,7 @@ class SDT_ideal : public SDT {
     SDT_ideal();
 
     void compute(double int_step);
+    void checkpoint(Checkpoint &cp);
 
  private:
     arma::mat33 build_321_rotation_matrix(arma::vec3 angle);
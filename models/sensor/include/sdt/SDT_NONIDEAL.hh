@@ -4,7 +4,8 @@
 PURPOSE:
       (Sensor Data Transport module)
 LIBRARY DEPENDENCY:
-      ((../../src/SDT_nonideal.cpp))
+      ((../../src/SDT_nonideal.cpp)
+       (../../../aux/src/checkpoint.cpp))
 *******************************************************************************/
 #include <armadillo>
 #include <functional>
@@ -18,6 +19,7 @@ class SDT_NONIDEAL : public SDT{
     SDT_NONIDEAL();
 
     virtual void compute(double int_step);
+    virtual void checkpoint(Checkpoint &cp);
 
  private:
     arma::mat33 build_321_rotation_matrix(arma::vec3 angle);
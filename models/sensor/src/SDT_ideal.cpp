@@ -28,6 +28,13 @@ SDT_ideal::SDT_ideal()
             DELTA_ALPHA.zeros();
         }
 
+void SDT_ideal::checkpoint(Checkpoint &cp) {
+    SDT::checkpoint(cp);
+    cp.section("SDTIDEAL");
+    cp(WBISB, WBISB_old, DELTA_ALPHA, DELTA_ALPHA_old, DELTA_BETA, ALPHA, BETA, FSPSB, FSPSB_old,
+       cross2_old, cross3_old, sculling_old, VEL, k);
+}
+
 void SDT_ideal::compute(double int_step) {
     WBISB = grab_WBICB();
     FSPSB = grab_FSPCB();
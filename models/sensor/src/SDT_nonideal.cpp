@@ -59,6 +59,13 @@ SDT_NONIDEAL::SDT_NONIDEAL()
 //     this->PHI = other.PHI;
 // }
 
+void SDT_NONIDEAL::checkpoint(Checkpoint &cp) {
+    SDT::checkpoint(cp);
+    cp.section("SDTNONID");
+    cp(WBISB, WBISB_old, DELTA_ALPHA, DELTA_ALPHA_old, DELTA_BETA, ALPHA, BETA, FSPSB, FSPSB_old,
+       cross2_old, cross3_old, sculling_old, VEL, k, PHI_HIGH_OLD, PHI_LOW_OLD);
+}
+
 void SDT_NONIDEAL::compute(double int_step) {
     WBISB = grab_WBICB();
     FSPSB = grab_FSPCB();
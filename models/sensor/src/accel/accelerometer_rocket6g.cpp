@@ -9,16 +9,17 @@ sensor::AccelerometerRocket6G::AccelerometerRocket6G(double emisa[3], double esc
         VECTOR_INIT(EBIASA, 3),
         VECTOR_INIT(ITA1, 3),
         VECTOR_INIT(ITA2, 3),
-        VECTOR_INIT(BETA, 3) {
+        VECTOR_INIT(BETA, 3),
+        noise(0, DEFAULT_NOISE_STREAM) {
     snprintf(name, sizeof(name), "Rocket6G Non-Ideal Accelerometer Sensor");
-    srand(static_cast<unsigned int>(time(NULL)));
     EWALKA.zeros();
-    EMISA.zeros();
-    ESCALA.zeros();
-    EBIASA.zeros();
-    // EMISA  = arma::vec3(emisa);
-    // ESCALA = arma::vec3(escala);
-    // EBIASA = arma::vec3(ebiasa);
+    ITA1.zeros();
+    ITA2.zeros();
+    BETA.zeros();
+    // static errors, drawn per run by the caller (MonteVarRandom in monte.py)
+    EMISA  = arma::vec3(emisa);
+    ESCALA = arma::vec3(escala);
+    EBIASA = arma::vec3(ebiasa);
 
     // srand((unsigned)time(NULL));
     // for (int i = 0; i < 3; i++) {
@@ -28,34 +29,35 @@ sensor::AccelerometerRocket6G::AccelerometerRocket6G(double emisa[3], double esc
     // }
 }
 
-void sensor::AccelerometerRocket6G::propagate_error(double int_step) {
+void sensor::AccelerometerRocket6G::propagate_error(double int_step, struct icf_ctrlblk_t* C) {
     arma::vec3 FSPB = grab_FSPB();
 
     // accelerometer error (bias,scale factor,misalignment)
     // acceleration measurement with random walk effect
     //-------------------------------------------------------------------------
     // computing accelerometer erros without random walk (done in 'ins()')
-    // arma::mat33 EAB = diagmat(ESCALA) + skew_sym(EMISA);
-    // this->EFSPB = EWALKA + EBIASA + EAB * FSPB;
-    // //-------------------------------------------------------------------------
+    arma::mat33 EAB = diagmat(ESCALA) + skew_sym(EMISA);
+    //-------------------------------------------------------------------------
     double sig(1.0);
 
     double RRW(0.01647856578);  // 0.4422689813  7.6072577e-3
     double ARW(0.01025304833);  // 0.07071067812  7.90569415e-3
     double Freq(200.0);
+    double z[6];
     // for (int i = 0; i < 3; i++) {
     //     ITA2(i) = gauss(0, sig) * RRW * RAD;
     //     BETA(i) = 0.999 * BETA_old(i) + ITA2(i) * int_step;
     //     ITA1(i) = gauss(0, sig) * (ARW * sqrt(Freq) / 60 * (1 / sig)) * RAD;
     // }
+    noise.gauss_fill(z, 6);
     for (int i = 0; i < 3; i++) {
-        ITA2(i) = gauss(0, 1.0) * RRW;
+        ITA2(i) = z[2 * i] * RRW;
         BETA(i) = 0.9999 * BETA(i) + ITA2(i) * int_step;
-        ITA1(i) = gauss(0, 1.0) * (ARW * sqrt(Freq) / 60 * (1 / sig));
+        ITA1(i) = z[2 * i + 1] * (ARW * sqrt(Freq) / 60 * (1 / sig));
     }
 
     // combining all uncertainties
-    this->EFSPB = ITA1 + BETA;  // EMSBG + EUG + EWG;
+    this->EFSPB = ITA1 + BETA + EBIASA + EAB * FSPB;
 
     // this->FSPCB = FSPB + EFSPB;
 
@@ -66,3 +68,10 @@ void sensor::AccelerometerRocket6G::propagate_error(double int_step) {
     HIGH = floor((FSPB + EFSPB) / AMSB);
     LOW = floor(((FSPB + EFSPB) - tmp) / ALSB);
 }
+
+/* EMISA, ESCALA and EBIASA are left out: the static errors are drawn per run, not propagated */
+void sensor::AccelerometerRocket6G::checkpoint(Checkpoint &cp) {
+    Accelerometer::checkpoint(cp);
+    cp.section("ACCEL6G");
+    cp(EWALKA, ITA1, ITA2, BETA, noise);
+}
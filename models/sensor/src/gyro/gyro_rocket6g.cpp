@@ -7,10 +7,6 @@
 
 #include "stochastic.hh"
 
-#include <ctime>
-
-
-
 sensor::GyroRocket6G::GyroRocket6G(double emisg[3], double escalg[3], double ebiasg[3])
     :   VECTOR_INIT(EUG    , 3),
         VECTOR_INIT(EWG    , 3),
@@ -21,9 +17,20 @@ sensor::GyroRocket6G::GyroRocket6G(double emisg[3], double escalg[3], double ebi
         VECTOR_INIT(EBIASG , 3),
         VECTOR_INIT(ITA1, 3),
         VECTOR_INIT(ITA2, 3),
-        VECTOR_INIT(BETA, 3) {
+        VECTOR_INIT(BETA, 3),
+        noise(0, DEFAULT_NOISE_STREAM) {
     snprintf(name, sizeof(name), "Rocket6G Gyro Sensor Model");
-    srand(static_cast<unsigned int>(time(NULL)));
+    EUG.zeros();
+    EWG.zeros();
+    EWALKG.zeros();
+    EUNBG.zeros();
+    ITA1.zeros();
+    ITA2.zeros();
+    BETA.zeros();
+    // static errors, drawn per run by the caller (MonteVarRandom in monte.py)
+    EMISG  = arma::vec3(emisg);
+    ESCALG = arma::vec3(escalg);
+    EBIASG = arma::vec3(ebiasg);
 }
 
 void sensor::GyroRocket6G::propagate_error(double int_step) {
@@ -37,15 +44,20 @@ void sensor::GyroRocket6G::propagate_error(double int_step) {
     double RRW(0.0130848811);  // 0.4422689813  7.6072577e-3
     double ARW(0.2828427125);  // 0.07071067812  7.90569415e-3
     double Freq(200.0);
+    double z[6];
 
+    noise.gauss_fill(z, 6);
     for (int i = 0; i < 3; i++) {
-        ITA2(i) = gauss(0, 1.0) * RRW * RAD;  // distribution(generator) * RRW * RAD;
+        ITA2(i) = z[2 * i] * RRW * RAD;
         BETA(i) = 0.9999 * BETA(i) + ITA2(i) * int_step;
-        ITA1(i) = gauss(0, 1.0) * (ARW * sqrt(Freq) / 60 * (1 / sig)) * RAD;  // distribution(generator) * (ARW * sqrt(Freq) / 60 * (1 / sig)) * RAD;
+        ITA1(i) = z[2 * i + 1] * (ARW * sqrt(Freq) / 60 * (1 / sig)) * RAD;
     }
 
+    // bias, scale factor and misalignment
+    arma::mat33 EGB = diagmat(ESCALG) + skew_sym(EMISG);
+
     // combining all uncertainties
-    this->EWBIB = ITA1 + BETA;  // EMSBG + EUG + EWG;
+    this->EWBIB = ITA1 + BETA + EBIASG + EGB * WBIB;
 
     arma::vec3 tmp = floor((WBIB + EWBIB) / GMSB) * GMSB;
     arma::vec3 tmp2 = floor(((WBIB + EWBIB) - tmp) / GLSB) * GLSB;
@@ -56,3 +68,10 @@ void sensor::GyroRocket6G::propagate_error(double int_step) {
 
     return;
 }
+
+/* EMISG, ESCALG and EBIASG are left out: the static errors are drawn per run, not propagated */
+void sensor::GyroRocket6G::checkpoint(Checkpoint &cp) {
+    Gyro::checkpoint(cp);
+    cp.section("GYRO6G");
+    cp(EUG, EWG, EWALKG, EUNBG, ITA1, ITA2, BETA, noise);
+}